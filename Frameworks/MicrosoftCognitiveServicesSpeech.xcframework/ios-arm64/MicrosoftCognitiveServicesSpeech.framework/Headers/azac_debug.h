@@ -76,6 +76,29 @@
 #define __AZAC_TRACE_LEVEL_ERROR        0x02 // Trace_Error
 #define __AZAC_TRACE_LEVEL_VERBOSE      0x10 // Trace_Verbose
 
+#define __AZAC_TRACE_LEVEL_ALL          (__AZAC_TRACE_LEVEL_ERROR | __AZAC_TRACE_LEVEL_WARNING | __AZAC_TRACE_LEVEL_INFO | __AZAC_TRACE_LEVEL_VERBOSE)
+
+//-----------------------------------------------------------
+//  Compile time trace level policy
+//
+//  AZAC_CONFIG_TRACE_LEVEL_MASK is the set of levels that are
+//  compiled in. Trace calls for any other level are a constant
+//  false branch: the compiler drops them, and their arguments
+//  are never evaluated. The built-in implementation prints only
+//  in debug builds, so release builds compile all levels out
+//  unless a custom __AZAC_DO_TRACE_IMPL is provided.
+//-----------------------------------------------------------
+
+#ifndef AZAC_CONFIG_TRACE_LEVEL_MASK
+#if defined(__AZAC_DO_TRACE_IMPL) || defined(DEBUG) || defined(_DEBUG)
+#define AZAC_CONFIG_TRACE_LEVEL_MASK    __AZAC_TRACE_LEVEL_ALL
+#else
+#define AZAC_CONFIG_TRACE_LEVEL_MASK    0
+#endif
+#endif
+
+#define __AZAC_TRACE_LEVEL_ENABLED(level) (((level) & (AZAC_CONFIG_TRACE_LEVEL_MASK)) != 0)
+
 #ifndef __AZAC_DO_TRACE_IMPL
 #ifdef __cplusplus
 #include <algorithm>
@@ -145,10 +168,123 @@ inline void __azac_do_trace_message(int level, const char* pszTitle, const char*
 #endif // __cplusplus
 #endif
 
-#define __AZAC_DOTRACE(level, title, fileName, lineNumber, ...)                     \
-    do {                                                                            \
-        __AZAC_DO_TRACE_IMPL(level, title, fileName, lineNumber, ##__VA_ARGS__);    \
-    } while (0)
+//-----------------------------------------------------------
+//  Per call site trace counters and sampling (C++ only)
+//
+//  Every compiled-in trace call site counts how often it is hit
+//  and how often it was emitted. A sample rate of N per level
+//  emits one in N hits of each call site; errors and warnings
+//  default to every hit, info and verbose to
+//  AZAC_CONFIG_TRACE_SAMPLE_RATE. The table can be dumped with
+//  __azac_trace_dump_call_sites to find hot trace sites.
+//-----------------------------------------------------------
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdio.h>
+#include <vector>
+
+#ifndef AZAC_CONFIG_TRACE_SAMPLE_RATE
+#define AZAC_CONFIG_TRACE_SAMPLE_RATE   1
+#endif
+
+inline std::atomic<uint32_t>& __azac_trace_sample_rate(int level)
+{
+    static std::atomic<uint32_t> rates[4] = { {1}, {1}, {AZAC_CONFIG_TRACE_SAMPLE_RATE}, {AZAC_CONFIG_TRACE_SAMPLE_RATE} };
+    switch (level)
+    {
+    case __AZAC_TRACE_LEVEL_ERROR: return rates[0];
+    case __AZAC_TRACE_LEVEL_WARNING: return rates[1];
+    case __AZAC_TRACE_LEVEL_INFO: return rates[2];
+    default: return rates[3];
+    }
+}
+
+inline void __azac_trace_set_sample_rate(int level, uint32_t everyNth)
+{
+    __azac_trace_sample_rate(level).store(everyNth == 0 ? 1 : everyNth, std::memory_order_relaxed);
+}
+
+struct __azac_trace_call_site
+{
+    __azac_trace_call_site(int level, const char* title, const char* fileName, int lineNumber) throw() :
+        level(level), title(title), fileName(fileName), lineNumber(lineNumber), hits(0), emitted(0), next(nullptr)
+    {
+        auto& head = Head();
+        next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    bool Sample() throw()
+    {
+        auto hit = hits.fetch_add(1, std::memory_order_relaxed);
+        auto rate = __azac_trace_sample_rate(level).load(std::memory_order_relaxed);
+        if (rate > 1 && hit % rate != 0)
+        {
+            return false;
+        }
+        emitted.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    static std::atomic<__azac_trace_call_site*>& Head() throw()
+    {
+        static std::atomic<__azac_trace_call_site*> head{ nullptr };
+        return head;
+    }
+
+    const int level;
+    const char* const title;
+    const char* const fileName;
+    const int lineNumber;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> emitted;
+    __azac_trace_call_site* next;
+};
+
+inline void __azac_trace_dump_call_sites(FILE* file) throw()
+{
+    try
+    {
+        std::vector<__azac_trace_call_site*> sites;
+        for (auto site = __azac_trace_call_site::Head().load(std::memory_order_acquire); site != nullptr; site = site->next)
+        {
+            sites.push_back(site);
+        }
+
+        std::sort(sites.begin(), sites.end(), [](__azac_trace_call_site* a, __azac_trace_call_site* b) {
+            return a->hits.load(std::memory_order_relaxed) > b->hits.load(std::memory_order_relaxed);
+        });
+
+        for (auto site : sites)
+        {
+            fprintf(file, "%12" PRIu64 " %12" PRIu64 "  %s%s:%d\n",
+                site->hits.load(std::memory_order_relaxed), site->emitted.load(std::memory_order_relaxed),
+                site->title, site->fileName, site->lineNumber);
+        }
+    }
+    catch (...)
+    {
+    }
+}
+
+#define __AZAC_TRACE_SAMPLE(level, title, fileName, lineNumber)                                                 \
+    static __azac_trace_call_site __azac_trace_site(level, title, fileName, lineNumber);                         \
+    if (!__azac_trace_site.Sample()) break
+#else // __cplusplus
+#define __AZAC_TRACE_SAMPLE(level, title, fileName, lineNumber)
+#endif // __cplusplus
+
+#define __AZAC_DOTRACE(level, title, fileName, lineNumber, ...)                         \
+    do {                                                                                \
+        if (__AZAC_TRACE_LEVEL_ENABLED(level)) {                                        \
+            __AZAC_TRACE_SAMPLE(level, title, fileName, lineNumber);                    \
+            __AZAC_DO_TRACE_IMPL(level, title, fileName, lineNumber, ##__VA_ARGS__);    \
+    } } while (0)
 
 #define __AZAC_TRACE_INFO(title, fileName, lineNumber, msg, ...) __AZAC_DOTRACE(__AZAC_TRACE_LEVEL_INFO, title, fileName, lineNumber, msg, ##__VA_ARGS__)
 #define __AZAC_TRACE_INFO_IF(cond, title, fileName, lineNumber, msg, ...)           \
@@ -0,0 +1,434 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_async_executor.h: Public API declarations for the executor used by the C++ *Async methods
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Interface of the executor that runs the work items behind every *Async method of the C++ API.
+/// Applications can install their own implementation through <see cref="AsyncExecutor::SetDefault"/>.
+/// </summary>
+/// <remarks>
+/// Work items typically block on the native wait functions until the operation completes,
+/// so an implementation must not assume that work items are short.
+/// *Async calls made from inside a work item do not go through the executor: they run on their own thread, as
+/// with std::async, so that a work item waiting for a nested operation cannot starve or deadlock a bounded executor.
+/// </remarks>
+class AsyncExecutor
+{
+public:
+
+    /// <summary>
+    /// Work item type accepted by the executor.
+    /// </summary>
+    using WorkItem = std::function<void()>;
+
+    /// <summary>
+    /// Virtual destructor.
+    /// </summary>
+    virtual ~AsyncExecutor() = default;
+
+    /// <summary>
+    /// Schedules a work item for execution. The work item must be run exactly once.
+    /// </summary>
+    /// <param name="work">The work item.</param>
+    virtual void Post(WorkItem work) = 0;
+
+    /// <summary>
+    /// Gets the executor currently used by the *Async methods.
+    /// </summary>
+    /// <returns>The current executor.</returns>
+    static std::shared_ptr<AsyncExecutor> GetDefault();
+
+    /// <summary>
+    /// Replaces the executor used by subsequent *Async calls. Operations already started are not affected.
+    /// </summary>
+    /// <param name="executor">The executor to use, or nullptr to restore the built-in thread pool.</param>
+    static void SetDefault(std::shared_ptr<AsyncExecutor> executor);
+};
+
+/// <summary>
+/// Executor that runs every work item on a new thread, which matches the behavior of std::async(std::launch::async, ...).
+/// </summary>
+class ThreadPerTaskExecutor : public AsyncExecutor
+{
+public:
+
+    /// <summary>
+    /// Runs the work item on a new detached thread.
+    /// </summary>
+    /// <param name="work">The work item.</param>
+    void Post(WorkItem work) override
+    {
+        std::thread(std::move(work)).detach();
+    }
+};
+
+/// <summary>
+/// Bounded work-stealing thread pool. This is the default executor of the *Async methods.
+/// </summary>
+/// <remarks>
+/// Workers are started on demand when no worker is idle, up to the maximum thread count.
+/// Workers above the core thread count exit after being idle for the idle timeout.
+/// Work posted from a worker thread goes to that worker's local queue; idle workers steal from the others.
+/// </remarks>
+class ThreadPoolExecutor : public AsyncExecutor
+{
+public:
+
+    /// <summary>
+    /// Creates a thread pool.
+    /// </summary>
+    /// <param name="maxThreads">Maximum number of worker threads; 0 selects a default based on the hardware concurrency.</param>
+    /// <param name="coreThreads">Number of worker threads kept alive when idle; 0 selects the hardware concurrency.</param>
+    /// <param name="idleTimeout">Time after which an idle worker above the core thread count exits.</param>
+    explicit ThreadPoolExecutor(size_t maxThreads = 0, size_t coreThreads = 0, std::chrono::milliseconds idleTimeout = std::chrono::seconds(30)) :
+        m_coreThreads(coreThreads != 0 ? coreThreads : HardwareConcurrency()),
+        m_idleTimeout(idleTimeout),
+        m_slots(maxThreads != 0 ? maxThreads : std::max<size_t>(32, 4 * HardwareConcurrency()))
+    {
+        m_coreThreads = std::min(m_coreThreads, m_slots.size());
+        for (auto& slot : m_slots)
+        {
+            slot.reset(new WorkerSlot());
+        }
+    }
+
+    /// <summary>
+    /// Destructor. Runs the work items still queued, then joins all worker threads.
+    /// </summary>
+    ~ThreadPoolExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeUp.notify_all();
+
+        for (auto& slot : m_slots)
+        {
+            if (slot->thread.joinable())
+            {
+                slot->thread.join();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Schedules a work item on the pool.
+    /// </summary>
+    /// <param name="work">The work item.</param>
+    void Post(WorkItem work) override
+    {
+        auto current = CurrentWorker();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (current != nullptr && current->owner == this)
+        {
+            std::lock_guard<std::mutex> slotLock(current->mutex);
+            current->queue.push_back(std::move(work));
+        }
+        else
+        {
+            m_injected.push_back(std::move(work));
+        }
+        m_pending++;
+
+        if (m_idle > 0 || !StartWorker())
+        {
+            lock.unlock();
+            m_wakeUp.notify_one();
+        }
+    }
+
+    /// <summary>
+    /// Gets the number of worker threads currently running.
+    /// </summary>
+    /// <returns>The number of worker threads.</returns>
+    size_t GetThreadCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_running;
+    }
+
+    /// <summary>
+    /// Gets the maximum number of worker threads.
+    /// </summary>
+    /// <returns>The maximum number of worker threads.</returns>
+    size_t GetMaxThreadCount() const { return m_slots.size(); }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(ThreadPoolExecutor);
+
+    struct WorkerSlot
+    {
+        ThreadPoolExecutor* owner = nullptr;
+        std::mutex mutex;
+        std::deque<WorkItem> queue;
+        std::thread thread;
+        bool active = false;
+    };
+
+    static size_t HardwareConcurrency()
+    {
+        return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    static WorkerSlot*& CurrentWorker()
+    {
+        static thread_local WorkerSlot* current = nullptr;
+        return current;
+    }
+
+    // Must be called with m_mutex held.
+    bool StartWorker()
+    {
+        if (m_stopping || m_running >= m_slots.size())
+        {
+            return false;
+        }
+
+        auto it = std::find_if(m_slots.begin(), m_slots.end(), [](const std::unique_ptr<WorkerSlot>& slot) { return !slot->active; });
+        auto slot = it->get();
+
+        // A retired worker has already left its loop; joining only waits for the thread to finish exiting.
+        if (slot->thread.joinable())
+        {
+            slot->thread.join();
+        }
+
+        slot->owner = this;
+        slot->active = true;
+        m_running++;
+        slot->thread = std::thread([this, slot]() { WorkerLoop(slot); });
+        return true;
+    }
+
+    bool TryPop(WorkerSlot* self, WorkItem& work)
+    {
+        {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (!self->queue.empty())
+            {
+                work = std::move(self->queue.back());
+                self->queue.pop_back();
+                return true;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_injected.empty())
+            {
+                work = std::move(m_injected.front());
+                m_injected.pop_front();
+                return true;
+            }
+        }
+
+        for (auto& slot : m_slots)
+        {
+            auto victim = slot.get();
+            if (victim == self)
+            {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(victim->mutex);
+            if (!victim->queue.empty())
+            {
+                work = std::move(victim->queue.front());
+                victim->queue.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void WorkerLoop(WorkerSlot* self)
+    {
+        CurrentWorker() = self;
+
+        for (;;)
+        {
+            WorkItem work;
+            if (TryPop(self, work))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_pending--;
+                }
+                work();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_pending > 0)
+            {
+                // An item was counted but not yet popped by its taker; retry instead of sleeping.
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (!m_stopping)
+            {
+                m_idle++;
+                auto woken = m_wakeUp.wait_for(lock, m_idleTimeout, [this]() { return m_pending > 0 || m_stopping; });
+                m_idle--;
+
+                if (woken || m_running <= m_coreThreads)
+                {
+                    continue;
+                }
+            }
+
+            // Stopping, or idle above the core thread count: retire this worker. Lock order is m_mutex, then slot mutex.
+            std::lock_guard<std::mutex> slotLock(self->mutex);
+            if (!self->queue.empty())
+            {
+                continue;
+            }
+
+            self->active = false;
+            m_running--;
+            break;
+        }
+
+        CurrentWorker() = nullptr;
+    }
+
+    size_t m_coreThreads;
+    std::chrono::milliseconds m_idleTimeout;
+    std::vector<std::unique_ptr<WorkerSlot>> m_slots;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::deque<WorkItem> m_injected;
+    size_t m_pending = 0;
+    size_t m_idle = 0;
+    size_t m_running = 0;
+    bool m_stopping = false;
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+// Set while a work item posted by Utils::RunAsync runs on the current thread.
+inline bool& InAsyncWorkItem()
+{
+    static thread_local bool inWorkItem = false;
+    return inWorkItem;
+}
+
+struct AsyncWorkItemScope
+{
+    AsyncWorkItemScope() : m_outer(InAsyncWorkItem()) { InAsyncWorkItem() = true; }
+    ~AsyncWorkItemScope() { InAsyncWorkItem() = m_outer; }
+
+private:
+    bool m_outer;
+};
+
+struct AsyncExecutorRegistry
+{
+    std::mutex mutex;
+    std::shared_ptr<AsyncExecutor> executor;
+
+    static AsyncExecutorRegistry& Instance()
+    {
+        // Intentionally leaked, so that operations still running at process exit never observe a destroyed pool.
+        static AsyncExecutorRegistry* instance = new AsyncExecutorRegistry();
+        return *instance;
+    }
+
+    static std::shared_ptr<AsyncExecutor> BuiltIn()
+    {
+        static std::shared_ptr<AsyncExecutor>* pool = new std::shared_ptr<AsyncExecutor>(std::make_shared<ThreadPoolExecutor>());
+        return *pool;
+    }
+};
+
+}
+
+/*! \endcond */
+
+inline std::shared_ptr<AsyncExecutor> AsyncExecutor::GetDefault()
+{
+    auto& registry = Details::AsyncExecutorRegistry::Instance();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (registry.executor != nullptr)
+        {
+            return registry.executor;
+        }
+    }
+    return Details::AsyncExecutorRegistry::BuiltIn();
+}
+
+inline void AsyncExecutor::SetDefault(std::shared_ptr<AsyncExecutor> executor)
+{
+    auto& registry = Details::AsyncExecutorRegistry::Instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.executor = std::move(executor);
+}
+
+namespace Utils {
+
+/// <summary>
+/// Runs the function on the default <see cref="AsyncExecutor"/> and returns a future for its result.
+/// </summary>
+/// <remarks>
+/// Unlike std::async, the returned future does not block in its destructor: discarding the result of an *Async
+/// method starts the operation in the background instead of waiting for it. Call get() or wait() on the future to
+/// keep the previous synchronous behavior.
+/// Called from inside a work item of the executor, the function runs on a new thread through std::async, and the
+/// returned future keeps the std::async semantics, including the blocking destructor. A work item that waits for
+/// a nested operation therefore never waits for a slot of the executor it occupies.
+/// </remarks>
+/// <param name="fn">The function to run.</param>
+/// <returns>A future that receives the result or the exception of the function.</returns>
+template<typename F, typename TResult = decltype(std::declval<typename std::decay<F>::type&>()())>
+std::future<TResult> RunAsync(F&& fn)
+{
+    if (Speech::Details::InAsyncWorkItem())
+    {
+        return std::async(std::launch::async, std::forward<F>(fn));
+    }
+
+    auto task = std::make_shared<std::packaged_task<TResult()>>(std::forward<F>(fn));
+    auto future = task->get_future();
+    AsyncExecutor::GetDefault()->Post([task]() {
+        Speech::Details::AsyncWorkItemScope scope;
+        (*task)();
+    });
+    return future;
+}
+
+}
+
+} } } // Microsoft::CognitiveServices::Speech
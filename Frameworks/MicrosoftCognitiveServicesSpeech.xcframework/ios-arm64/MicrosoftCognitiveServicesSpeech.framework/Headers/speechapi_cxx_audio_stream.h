@@ -6,12 +6,24 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <future>
+#include <initializer_list>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 #include <cstring>
+#if defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_smart_handle.h"
 #include "speechapi_cxx_audio_stream_format.h"
@@ -187,7 +199,7 @@ protected:
     /// <summary>
     /// Internal helper method to get the audio stream format handle.
     /// </summary>
-    static SPXAUDIOSTREAMFORMATHANDLE GetFormatHandle(std::shared_ptr<AudioStreamFormat> format) { return (SPXAUDIOSTREAMFORMATHANDLE)(*format.get()); }
+    static SPXAUDIOSTREAMFORMATHANDLE GetFormatHandle(const std::shared_ptr<AudioStreamFormat>& format) { return (SPXAUDIOSTREAMFORMATHANDLE)(*format.get()); }
 
     /// <summary>
     /// Internal member variable that holds the smart handle.
@@ -219,10 +231,27 @@ public:
     {
         if (audio_stream_is_handle_valid(m_haudioStream))
         {
+            FlushPending();
             CloseStream();
         }
     }
 
+    /// <summary>
+    /// A contiguous piece of audio data, used to write several buffers at once.
+    /// </summary>
+    struct Segment
+    {
+        /// <summary>
+        /// Pointer to the audio data.
+        /// </summary>
+        const uint8_t* data;
+
+        /// <summary>
+        /// Size of the audio data in bytes.
+        /// </summary>
+        uint32_t size;
+    };
+
     /// <summary>
     /// Creates a memory backed PushAudioInputStream using the default format (16 kHz, 16 bit, mono PCM).
     /// </summary>
@@ -256,7 +285,123 @@ public:
     /// <param name="size">The size of the buffer.</param>
     void Write(uint8_t* dataBuffer, uint32_t size)
     {
-        SPX_THROW_ON_FAIL(push_audio_input_stream_write(m_haudioStream, dataBuffer, size));
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        WriteBytes(dataBuffer, size);
+    }
+
+    /// <summary>
+    /// Writes 16-bit PCM samples, without an intermediate copy unless writes are batched.
+    /// The stream format must be 16-bit PCM.
+    /// </summary>
+    /// <param name="samples">The samples.</param>
+    /// <param name="count">The number of samples.</param>
+    void WriteSamples(const int16_t* samples, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        WriteBytes(reinterpret_cast<const uint8_t*>(samples), ByteCount(count, sizeof(int16_t)));
+    }
+
+    /// <summary>
+    /// Writes float samples in the range [-1, 1], converted to 16-bit PCM by the wrapper; values outside the range are clipped.
+    /// The stream format must be 16-bit PCM.
+    /// </summary>
+    /// <param name="samples">The samples.</param>
+    /// <param name="count">The number of samples.</param>
+    void WriteSamples(const float* samples, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        m_converted.resize(count);
+        ConvertToPcm16(samples, count, m_converted.data());
+        WriteBytes(reinterpret_cast<const uint8_t*>(m_converted.data()), ByteCount(count, sizeof(int16_t)));
+    }
+
+    /// <summary>
+    /// Writes several buffers, e.g. the two segments of a ring buffer, with a single call into the native stream.
+    /// The buffers are gathered into a wrapper-owned buffer, since the native stream takes one contiguous buffer per call.
+    /// </summary>
+    /// <param name="segments">The buffers, in stream order.</param>
+    /// <param name="count">The number of buffers.</param>
+    void WriteSegments(const Segment* segments, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        if (count == 1)
+        {
+            WriteBytes(segments[0].data, segments[0].size);
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            m_pending.insert(m_pending.end(), segments[i].data, segments[i].data + segments[i].size);
+        }
+        if (m_pending.size() >= m_batchSize)
+        {
+            FlushPendingLocked();
+        }
+    }
+
+    /// <summary>
+    /// Writes several buffers with a single call into the native stream, see <see cref="WriteSegments"/>.
+    /// </summary>
+    /// <param name="segments">The buffers, in stream order.</param>
+    void Write(std::initializer_list<Segment> segments)
+    {
+        WriteSegments(segments.begin(), segments.size());
+    }
+
+#if defined(__cpp_lib_span)
+    /// <summary>
+    /// Writes 16-bit PCM samples, see <see cref="WriteSamples"/>.
+    /// </summary>
+    /// <param name="samples">The samples.</param>
+    void Write(std::span<const int16_t> samples)
+    {
+        WriteSamples(samples.data(), samples.size());
+    }
+
+    /// <summary>
+    /// Writes float samples in the range [-1, 1] converted to 16-bit PCM, see <see cref="WriteSamples"/>.
+    /// </summary>
+    /// <param name="samples">The samples.</param>
+    void Write(std::span<const float> samples)
+    {
+        WriteSamples(samples.data(), samples.size());
+    }
+
+    /// <summary>
+    /// Writes several buffers with a single call into the native stream, see <see cref="WriteSegments"/>.
+    /// </summary>
+    /// <param name="segments">The buffers, in stream order.</param>
+    void Write(std::span<const Segment> segments)
+    {
+        WriteSegments(segments.data(), segments.size());
+    }
+#endif
+
+    /// <summary>
+    /// Sets the batch size. Writes are coalesced in the wrapper until at least this many bytes are pending,
+    /// and then passed to the native stream in a single call. Pending data is also written by <see cref="Flush"/> and <see cref="Close"/>.
+    /// The default is 0, i.e. every write goes to the native stream immediately.
+    /// </summary>
+    /// <param name="minBytes">Minimum number of bytes per native write.</param>
+    void SetWriteBatchSize(uint32_t minBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        m_batchSize = minBytes;
+        m_pending.reserve(minBytes);
+        if (m_pending.size() >= m_batchSize)
+        {
+            FlushPendingLocked();
+        }
+    }
+
+    /// <summary>
+    /// Writes the data pending because of batching to the native stream.
+    /// </summary>
+    void Flush()
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        FlushPendingLocked();
     }
 
     /// <summary>
@@ -284,7 +429,11 @@ public:
     /// <summary>
     /// Closes the stream.
     /// </summary>
-    void Close() { SPX_THROW_ON_FAIL(CloseStream()); }
+    void Close()
+    {
+        Flush();
+        SPX_THROW_ON_FAIL(CloseStream());
+    }
 
 
 protected:
@@ -303,6 +452,69 @@ private:
     DISABLE_COPY_AND_MOVE(PushAudioInputStream);
 
     SPXHR CloseStream() { return push_audio_input_stream_close(m_haudioStream); }
+
+    static uint32_t ByteCount(size_t count, size_t elementSize)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, count > (std::numeric_limits<uint32_t>::max)() / elementSize);
+        return static_cast<uint32_t>(count * elementSize);
+    }
+
+    // Written without branches on the sample values, so that compilers turn it into vector min/max/convert instructions.
+    static void ConvertToPcm16(const float* samples, size_t count, int16_t* pcm)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            auto value = samples[i] * 32767.0f;
+            value = (std::max)(-32768.0f, value); // also maps NaN to -32768
+            value = (std::min)(32767.0f, value);
+            pcm[i] = static_cast<int16_t>(value);
+        }
+    }
+
+    // Must be called with m_writeMutex held. Writes go straight to the native stream unless they are batched.
+    void WriteBytes(const uint8_t* data, uint32_t size)
+    {
+        if (size == 0 || (m_pending.empty() && size >= m_batchSize))
+        {
+            // An empty write is passed through as before, after the pending data.
+            FlushPendingLocked();
+
+            // the native stream copies the data, it does not modify it
+            SPX_THROW_ON_FAIL(push_audio_input_stream_write(m_haudioStream, const_cast<uint8_t*>(data), size));
+            return;
+        }
+
+        m_pending.insert(m_pending.end(), data, data + size);
+        if (m_pending.size() >= m_batchSize)
+        {
+            FlushPendingLocked();
+        }
+    }
+
+    // Must be called with m_writeMutex held.
+    void FlushPendingLocked()
+    {
+        if (!m_pending.empty())
+        {
+            SPX_THROW_ON_FAIL(push_audio_input_stream_write(m_haudioStream, m_pending.data(), static_cast<uint32_t>(m_pending.size())));
+            m_pending.clear();
+        }
+    }
+
+    void FlushPending()
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        if (!m_pending.empty())
+        {
+            push_audio_input_stream_write(m_haudioStream, m_pending.data(), static_cast<uint32_t>(m_pending.size()));
+            m_pending.clear();
+        }
+    }
+
+    std::mutex m_writeMutex;
+    uint32_t m_batchSize = 0;
+    std::vector<uint8_t> m_pending;
+    std::vector<int16_t> m_converted;
 };
 
 
@@ -758,6 +970,95 @@ class PullAudioOutputStream : public AudioOutputStream
 public:
     friend class Dialog::ActivityReceivedEventArgs;
 
+    /// <summary>
+    /// Destructor. Stops the ring buffer pump, if any.
+    /// </summary>
+    /// <remarks>
+    /// A pump blocked in the native read is not waited for: it takes over the native stream handle and releases it
+    /// once the read returns, which happens when the synthesizer writes more audio or closes the stream.
+    /// </remarks>
+    virtual ~PullAudioOutputStream()
+    {
+        if (!m_pump.joinable())
+        {
+            return;
+        }
+
+        bool inNativeRead;
+        {
+            std::lock_guard<std::mutex> lock(m_ring->mutex);
+            m_ring->stopping = true;
+            inNativeRead = m_ring->inNativeRead;
+            if (inNativeRead)
+            {
+                m_ring->orphanedHandle = m_haudioStream.release();
+            }
+        }
+
+        if (inNativeRead)
+        {
+            m_pump.detach();
+        }
+        else
+        {
+            // The pump checks for stopping under the lock before every native read, so it exits without another one.
+            m_ring->spaceAvailable.notify_all();
+            m_pump.join();
+        }
+    }
+
+    /// <summary>
+    /// A contiguous piece of the audio data held in the ring buffer, see <see cref="ReadView"/>.
+    /// </summary>
+    struct View
+    {
+        /// <summary>
+        /// Pointer to the audio data; valid until <see cref="Consume"/> is called.
+        /// </summary>
+        const uint8_t* data;
+
+        /// <summary>
+        /// Size of the audio data in bytes; 0 if the read timed out or the stream ended.
+        /// </summary>
+        uint32_t size;
+    };
+
+    /// <summary>
+    /// Statistics of the ring buffer.
+    /// </summary>
+    struct Stats
+    {
+        /// <summary>
+        /// Capacity of the ring buffer in bytes.
+        /// </summary>
+        uint32_t capacity;
+
+        /// <summary>
+        /// Number of bytes currently held in the ring buffer.
+        /// </summary>
+        uint32_t fillLevel;
+
+        /// <summary>
+        /// Number of reads that found the ring buffer empty before the end of the stream.
+        /// </summary>
+        uint64_t underruns;
+
+        /// <summary>
+        /// Number of times the fill level reached the high-water mark and the pump paused.
+        /// </summary>
+        uint64_t highWaterMarkHits;
+
+        /// <summary>
+        /// Total number of bytes read or consumed.
+        /// </summary>
+        uint64_t bytesRead;
+
+        /// <summary>
+        /// True if the native stream ended and the ring buffer holds all remaining data.
+        /// </summary>
+        bool endOfStream;
+    };
+
     /// <summary>
     /// Creates a memory backed PullAudioOutputStream.
     /// </summary>
@@ -771,6 +1072,27 @@ public:
         return std::shared_ptr<PullAudioOutputStream>(stream);
     }
 
+    /// <summary>
+    /// Creates a memory backed PullAudioOutputStream read through a bounded ring buffer.
+    /// A background pump moves the audio from the native stream into the ring buffer while the fill level is below
+    /// the high-water mark, and pauses above it.
+    /// </summary>
+    /// <remarks>
+    /// The ring buffer bounds the memory of this wrapper only. The native stream keeps buffering whatever the
+    /// synthesizer writes while the pump is paused, without limit, and the synthesizer is not slowed down.
+    /// </remarks>
+    /// <param name="capacity">Capacity of the ring buffer in bytes.</param>
+    /// <param name="highWaterMark">Fill level in bytes at which the pump pauses; 0 or a value above the capacity selects the capacity.</param>
+    /// <returns>A shared pointer to PullAudioOutputStream</returns>
+    static std::shared_ptr<PullAudioOutputStream> Create(uint32_t capacity, uint32_t highWaterMark = 0)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, capacity == 0);
+
+        auto stream = Create();
+        stream->StartPump(capacity, highWaterMark == 0 || highWaterMark > capacity ? capacity : highWaterMark);
+        return stream;
+    }
+
     /// <summary>
     /// Reads a chunk of the audio data and fill it to given buffer
     /// </summary>
@@ -779,12 +1101,113 @@ public:
     /// <returns>Size of data filled to the buffer, 0 means end of stream</returns>
     inline uint32_t Read(uint8_t* buffer, uint32_t bufferSize)
     {
-        uint32_t filledSize = 0;
-        SPX_THROW_ON_FAIL(pull_audio_output_stream_read(m_haudioStream, buffer, bufferSize, &filledSize));
+        if (m_ring == nullptr)
+        {
+            uint32_t filledSize = 0;
+            SPX_THROW_ON_FAIL(pull_audio_output_stream_read(m_haudioStream, buffer, bufferSize, &filledSize));
 
-        return filledSize;
+            return filledSize;
+        }
+
+        return Read(buffer, bufferSize, std::chrono::milliseconds::max());
     }
 
+    /// <summary>
+    /// Reads a chunk of the audio data from the ring buffer, waiting at most for the given time for data to arrive.
+    /// Requires a stream created with a ring buffer.
+    /// </summary>
+    /// <param name="buffer">A buffer to receive read data.</param>
+    /// <param name="bufferSize">Size of the buffer.</param>
+    /// <param name="timeout">Maximum time to wait; 0 makes the read non-blocking.</param>
+    /// <returns>Size of data filled to the buffer; 0 means the read timed out, or the stream ended if <see cref="IsEndOfStream"/> returns true.</returns>
+    uint32_t Read(uint8_t* buffer, uint32_t bufferSize, std::chrono::milliseconds timeout)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_ring == nullptr);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, buffer == nullptr && bufferSize > 0);
+
+        auto& ring = *m_ring;
+        std::unique_lock<std::mutex> lock(ring.mutex);
+        if (!WaitForData(lock, timeout) || bufferSize == 0)
+        {
+            return 0;
+        }
+
+        auto size = std::min(bufferSize, ring.fill);
+        auto first = std::min(size, ring.capacity - ring.readPos);
+        std::memcpy(buffer, ring.buffer.get() + ring.readPos, first);
+        std::memcpy(buffer + first, ring.buffer.get(), size - first);
+
+        ConsumeLocked(size);
+        lock.unlock();
+        ring.spaceAvailable.notify_one();
+        return size;
+    }
+
+    /// <summary>
+    /// Returns the largest contiguous piece of the audio data at the read position of the ring buffer, without copying it.
+    /// The data stays in the ring buffer until <see cref="Consume"/> is called. Requires a stream created with a ring buffer.
+    /// </summary>
+    /// <param name="timeout">Maximum time to wait for data; 0 makes the call non-blocking.</param>
+    /// <returns>The data; empty if the wait timed out or the stream ended, see <see cref="IsEndOfStream"/>.</returns>
+    View ReadView(std::chrono::milliseconds timeout = std::chrono::milliseconds::max())
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_ring == nullptr);
+
+        auto& ring = *m_ring;
+        std::unique_lock<std::mutex> lock(ring.mutex);
+        if (!WaitForData(lock, timeout))
+        {
+            return View{ nullptr, 0 };
+        }
+
+        // Only the reader frees space, so the view stays valid while the pump keeps writing behind it.
+        return View{ ring.buffer.get() + ring.readPos, std::min(ring.fill, ring.capacity - ring.readPos) };
+    }
+
+    /// <summary>
+    /// Releases data returned by <see cref="ReadView"/> so that the pump can reuse its space.
+    /// </summary>
+    /// <param name="size">Number of bytes to release; at most the size of the last view.</param>
+    void Consume(uint32_t size)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_ring == nullptr);
+        {
+            std::lock_guard<std::mutex> lock(m_ring->mutex);
+            SPX_THROW_HR_IF(SPXERR_INVALID_ARG, size > m_ring->fill);
+            ConsumeLocked(size);
+        }
+        m_ring->spaceAvailable.notify_one();
+    }
+
+    /// <summary>
+    /// Checks whether all audio data was read. Always false for a stream without a ring buffer.
+    /// </summary>
+    /// <returns>True if the native stream ended and the ring buffer is empty.</returns>
+    bool IsEndOfStream() const
+    {
+        if (m_ring == nullptr)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_ring->mutex);
+        return m_ring->endOfStream && m_ring->fill == 0;
+    }
+
+    /// <summary>
+    /// Gets the statistics of the ring buffer; all zero for a stream without a ring buffer.
+    /// </summary>
+    /// <returns>The statistics.</returns>
+    Stats GetStats() const
+    {
+        if (m_ring == nullptr)
+        {
+            return Stats{ 0, 0, 0, 0, 0, false };
+        }
+
+        std::lock_guard<std::mutex> lock(m_ring->mutex);
+        return Stats{ m_ring->capacity, m_ring->fill, m_ring->underruns, m_ring->highWaterMarkHits, m_ring->bytesRead, m_ring->endOfStream };
+    }
 
 protected:
 
@@ -797,25 +1220,133 @@ protected:
 
     /*! \endcond */
 
-
 private:
 
-    template <class T>
-    static std::shared_ptr<T> SpxAllocSharedBuffer(size_t sizeInBytes)
+    // State shared with the pump, which outlives the stream when the stream is destroyed during a native read.
+    struct Ring
+    {
+        Ring(uint32_t capacity, uint32_t highWaterMark) : buffer(new uint8_t[capacity]), capacity(capacity), highWaterMark(highWaterMark) { }
+
+        std::unique_ptr<uint8_t[]> buffer;
+        uint32_t capacity;
+        uint32_t highWaterMark;
+        uint32_t readPos = 0;
+        uint32_t fill = 0;
+        uint64_t underruns = 0;
+        uint64_t highWaterMarkHits = 0;
+        uint64_t bytesRead = 0;
+        bool endOfStream = false;
+        bool stopping = false;
+        bool inNativeRead = false;
+        SPXHR pumpError = SPX_NOERROR;
+
+        // Native stream handle handed over by the destructor of the stream, released by the pump.
+        SPXAUDIOSTREAMHANDLE orphanedHandle = SPXHANDLE_INVALID;
+
+        mutable std::mutex mutex;
+        std::condition_variable dataAvailable;
+        std::condition_variable spaceAvailable;
+    };
+
+    void StartPump(uint32_t capacity, uint32_t highWaterMark)
+    {
+        m_ring = std::make_shared<Ring>(capacity, highWaterMark);
+        m_pump = std::thread(PumpLoop, m_ring, m_haudioStream.get());
+    }
+
+    static void PumpLoop(std::shared_ptr<Ring> ring, SPXAUDIOSTREAMHANDLE haudioStream)
+    {
+        std::unique_lock<std::mutex> lock(ring->mutex);
+        for (;;)
+        {
+            if (ring->fill >= ring->highWaterMark && !ring->stopping)
+            {
+                ring->highWaterMarkHits++;
+                ring->spaceAvailable.wait(lock, [&ring]() { return ring->fill < ring->highWaterMark || ring->stopping; });
+            }
+            if (ring->stopping)
+            {
+                break;
+            }
+
+            // The pump is the only writer, and the reader never touches the free space, so the native read runs unlocked.
+            auto writePos = (ring->readPos + ring->fill) % ring->capacity;
+            auto contiguous = std::min(ring->highWaterMark - ring->fill, ring->capacity - writePos);
+            ring->inNativeRead = true;
+            lock.unlock();
+
+            uint32_t filledSize = 0;
+            auto hr = pull_audio_output_stream_read(haudioStream, ring->buffer.get() + writePos, contiguous, &filledSize);
+
+            lock.lock();
+            ring->inNativeRead = false;
+            if (ring->stopping)
+            {
+                // The stream was destroyed during the read and left the handle to the pump.
+                auto orphanedHandle = ring->orphanedHandle;
+                ring->orphanedHandle = SPXHANDLE_INVALID;
+                lock.unlock();
+                audio_stream_release(orphanedHandle);
+                return;
+            }
+
+            ring->fill += filledSize;
+            if (SPX_FAILED(hr) || filledSize == 0)
+            {
+                ring->pumpError = hr;
+                ring->endOfStream = true;
+            }
+
+            if (filledSize > 0 || ring->endOfStream)
+            {
+                ring->dataAvailable.notify_all();
+            }
+            if (ring->endOfStream)
+            {
+                break;
+            }
+        }
+    }
+
+    // Must be called with the ring mutex held. Returns true when data is available.
+    bool WaitForData(std::unique_lock<std::mutex>& lock, std::chrono::milliseconds timeout)
     {
-        auto ptr = reinterpret_cast<T*>(new uint8_t[sizeInBytes]);
-        auto deleter = [](T* p) { delete[] reinterpret_cast<uint8_t*>(p); };
+        auto& ring = *m_ring;
+        if (ring.fill == 0 && !ring.endOfStream)
+        {
+            ring.underruns++;
+            auto ready = [&ring]() { return ring.fill > 0 || ring.endOfStream; };
+            if (timeout == std::chrono::milliseconds::max())
+            {
+                ring.dataAvailable.wait(lock, ready);
+            }
+            else
+            {
+                ring.dataAvailable.wait_for(lock, timeout, ready);
+            }
+        }
 
-        std::shared_ptr<T> buffer(ptr, deleter);
-        return buffer;
+        if (ring.fill == 0)
+        {
+            SPX_THROW_ON_FAIL(ring.pumpError);
+        }
+        return ring.fill > 0;
     }
 
+    // Must be called with the ring mutex held.
+    void ConsumeLocked(uint32_t size)
+    {
+        m_ring->readPos = (m_ring->readPos + size) % m_ring->capacity;
+        m_ring->fill -= size;
+        m_ring->bytesRead += size;
+    }
 
 private:
 
     DISABLE_COPY_AND_MOVE(PullAudioOutputStream);
 
-    std::vector<uint8_t> m_audioData;
+    std::shared_ptr<Ring> m_ring;
+    std::thread m_pump;
 };
 
 
@@ -5,6 +5,8 @@
 
 #pragma once
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_object_pool.h"
 #include "speechapi_cxx_recognizer.h"
 #include "speechapi_cxx_eventsignal.h"
 #include "speechapi_cxx_connection_eventargs.h"
@@ -150,7 +152,7 @@ public:
     std::future<void> SendMessageAsync(const SPXSTRING& path, const SPXSTRING& payload)
     {
         auto keep_alive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keep_alive, this, path, payload]() -> void {
+        auto future = Utils::RunAsync([keep_alive, this, path, payload]() -> void {
             SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, m_connectionHandle == SPXHANDLE_INVALID);
             SPX_THROW_ON_FAIL(::connection_send_message(m_connectionHandle, Utils::ToUTF8(path.c_str()), Utils::ToUTF8(payload.c_str())));
         });
@@ -169,7 +171,7 @@ public:
     std::future<void> SendMessageAsync(const SPXSTRING& path, uint8_t* payload, uint32_t size)
     {
         auto keep_alive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keep_alive, this, path, payload, size]() -> void {
+        auto future = Utils::RunAsync([keep_alive, this, path, payload, size]() -> void {
             SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, m_connectionHandle == SPXHANDLE_INVALID);
             SPX_THROW_ON_FAIL(::connection_send_message_data(m_connectionHandle, Utils::ToUTF8(path.c_str()), payload, size));
         });
@@ -200,11 +202,18 @@ public:
         Connected(GetConnectionEventConnectionsChangedCallback(), GetConnectionEventConnectionsChangedCallback()),
         Disconnected(GetConnectionEventConnectionsChangedCallback(), GetConnectionEventConnectionsChangedCallback()),
         MessageReceived(GetConnectionMessageEventConnectionsChangedCallback(), GetConnectionMessageEventConnectionsChangedCallback()),
-        m_connectionHandle(handle)
+        m_connectionHandle(handle),
+        m_eventArgsPool(std::make_shared<Utils::ObjectPool>())
     {
         SPX_DBG_TRACE_FUNCTION();
     }
 
+    /// <summary>
+    /// Internal operator used to get underlying handle value.
+    /// </summary>
+    /// <returns>A handle.</returns>
+    explicit operator SPXCONNECTIONHANDLE() const { return m_connectionHandle; }
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -239,14 +248,16 @@ private:
 
     SPXCONNECTIONHANDLE m_connectionHandle;
 
+    // Recycles the storage of the event arguments and messages created for every event.
+    std::shared_ptr<Utils::ObjectPool> m_eventArgsPool;
+
     static void FireConnectionEvent(bool firingConnectedEvent, SPXEVENTHANDLE event, void* context)
     {
         std::exception_ptr p;
         try
         {
-            std::unique_ptr<ConnectionEventArgs> connectionEvent{ new ConnectionEventArgs(event) };
-
             auto connection = static_cast<Connection*>(context);
+            auto connectionEvent = Utils::MakePooledEventArgs<ConnectionEventArgs>(connection->m_eventArgsPool, event);
             auto keepAlive = connection->shared_from_this();
             if (firingConnectedEvent)
             {
@@ -293,9 +304,8 @@ private:
 
     static void FireEvent_MessageReceived(SPXEVENTHANDLE event, void* context)
     {
-        std::unique_ptr<ConnectionMessageEventArgs> connectionEvent { new ConnectionMessageEventArgs(event) };
-
         auto connection = static_cast<Connection*>(context);
+        auto connectionEvent = Utils::MakePooledEventArgs<ConnectionMessageEventArgs>(connection->m_eventArgsPool, event);
         auto keepAlive = connection->shared_from_this();
         connection->MessageReceived.Signal(*connectionEvent.get());
     }
@@ -6,8 +6,17 @@
 //
 
 #pragma once
+#include <mutex>
 #include <string>
 #include <vector>
+#if defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#endif
+#if __has_include(<string_view>)
+#include <string_view>
+#endif
+#endif
 #include "speechapi_c_connection.h"
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_properties.h"
@@ -42,14 +51,21 @@ private:
                 SPXPROPERTYBAGHANDLE hpropbag = SPXHANDLE_INVALID;
                 ::connection_message_get_property_bag(hcm, &hpropbag);
                 return hpropbag;
-            }())
+            }(), true)
         {
         }
+
+        using PropertyCollection::GetUncachedProperty;
     };
 
     SPXCONNECTIONMESSAGEHANDLE m_hcm;
     PrivatePropertyCollection m_properties;
 
+    mutable std::once_flag m_textOnce;
+    mutable std::string m_text;
+    mutable std::once_flag m_dataOnce;
+    mutable std::vector<uint8_t> m_data;
+
     /*! \endcond */
 
 public:
@@ -65,13 +81,29 @@ public:
     {
     };
 
+    /// <summary>
+    /// Move constructor. The message takes over the handle of the other message, which must not be used afterwards.
+    /// The payloads cached by <see cref="GetTextMessageRef"/> and <see cref="GetBinaryMessageRef"/> are read again on first use.
+    /// </summary>
+    /// <param name="other">The message to move from.</param>
+    ConnectionMessage(ConnectionMessage&& other) :
+        m_hcm(other.m_hcm),
+        m_properties(std::move(other.m_properties)),
+        Properties(m_properties)
+    {
+        other.m_hcm = SPXHANDLE_INVALID;
+    }
+
     /// <summary>
     /// Destructor.
     /// </summary>
     virtual ~ConnectionMessage()
     {
         SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)m_hcm);
-        SPX_THROW_ON_FAIL(::connection_message_handle_release(m_hcm));
+        if (m_hcm != SPXHANDLE_INVALID)
+        {
+            SPX_THROW_ON_FAIL(::connection_message_handle_release(m_hcm));
+        }
     }
 
     /// <summary>
@@ -114,8 +146,7 @@ public:
     /// <returns>An std::string containing the text message.</returns>
     std::string GetTextMessage() const
     {
-        SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, m_hcm == SPXHANDLE_INVALID);
-        return m_properties.GetProperty("connection.message.text.message");
+        return GetTextMessageRef();
     }
 
     /// <summary>
@@ -133,6 +164,57 @@ public:
         return message;
     }
 
+    /// <summary>
+    /// Gets the text message payload without copying it on every call.
+    /// The payload is read from the native message once and kept until the <see cref="ConnectionMessage"/> is destroyed.
+    /// It bypasses the property cache of <see cref="Properties"/>, so the message holds a single copy of the text.
+    /// </summary>
+    /// <returns>A reference to the text message, valid for the lifetime of this object.</returns>
+    const std::string& GetTextMessageRef() const
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, m_hcm == SPXHANDLE_INVALID);
+        std::call_once(m_textOnce, [this]() { m_text = m_properties.GetUncachedProperty("connection.message.text.message"); });
+        return m_text;
+    }
+
+    /// <summary>
+    /// Gets the binary message payload without copying it on every call.
+    /// The payload is read from the native message once and kept until the <see cref="ConnectionMessage"/> is destroyed.
+    /// </summary>
+    /// <returns>A reference to the binary message, valid for the lifetime of this object.</returns>
+    const std::vector<uint8_t>& GetBinaryMessageRef() const
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, m_hcm == SPXHANDLE_INVALID);
+        std::call_once(m_dataOnce, [this]() {
+            auto size = ::connection_message_get_data_size(m_hcm);
+            m_data.resize(size);
+            SPX_THROW_ON_FAIL(::connection_message_get_data(m_hcm, m_data.data(), size));
+        });
+        return m_data;
+    }
+
+#if defined(__cpp_lib_string_view)
+    /// <summary>
+    /// Gets a view of the text message payload, see <see cref="GetTextMessageRef"/>.
+    /// </summary>
+    /// <returns>A view of the text message, valid for the lifetime of this object.</returns>
+    std::string_view GetTextMessageView() const
+    {
+        return GetTextMessageRef();
+    }
+#endif
+
+#if defined(__cpp_lib_span)
+    /// <summary>
+    /// Gets a view of the binary message payload, see <see cref="GetBinaryMessageRef"/>.
+    /// </summary>
+    /// <returns>A view of the binary message, valid for the lifetime of this object.</returns>
+    std::span<const uint8_t> GetBinaryMessageView() const
+    {
+        return GetBinaryMessageRef();
+    }
+#endif
+
     /// <summary>
     /// A collection of properties and their values defined for this <see cref="ConnectionMessage"/>.
     /// Message headers can be accessed via this collection (e.g. "Content-Type").
@@ -143,7 +225,7 @@ private:
 
     /*! \cond PRIVATE */
 
-    DISABLE_COPY_AND_MOVE(ConnectionMessage);
+    DISABLE_COPY_AND_ASSIGNMENT(ConnectionMessage);
 
     /*! \endcond */
 };
@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_c.h"
 #include "speechapi_cxx_recognizer.h"
@@ -133,7 +134,7 @@ public:
     std::future<void> StartTranscribingAsync()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
         SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStartContinuous)); // close any unfinished previous attempt
 
@@ -158,7 +159,7 @@ public:
     std::future<void> StopTranscribingAsync()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStopContinuous)); // close any unfinished previous attempt
 
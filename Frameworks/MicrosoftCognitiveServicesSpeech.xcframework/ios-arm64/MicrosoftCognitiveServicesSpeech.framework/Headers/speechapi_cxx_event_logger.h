@@ -8,6 +8,7 @@
 #include <sstream>
 #include <iterator>
 #include <functional>
+#include <memory>
 #include "azac_api_c_diagnostics.h"
 #include "azac_api_cxx_common.h"
 #include "speechapi_cxx_log_level.h"
@@ -86,14 +87,19 @@ public:
     }
 
 private:
-    static CallbackFunction_Type SetOrGet(bool set, CallbackFunction_Type callback)
+    // The native callback runs on SDK threads while SetCallback may run on any other thread, so the callback is
+    // published through an atomically replaced shared pointer; a line in flight keeps the callback it loaded alive.
+    static std::shared_ptr<CallbackFunction_Type> SetOrGet(bool set, CallbackFunction_Type callback)
     {
-        static CallbackFunction_Type staticCallback = nullptr;
+        // Intentionally leaked: the native callback may still run on another thread while the process exits.
+        static auto staticCallback = new Details::AtomicSharedPtr<CallbackFunction_Type>();
         if (set)
         {
-            staticCallback = callback;
+            auto newCallback = nullptr == callback ? nullptr : std::make_shared<CallbackFunction_Type>(std::move(callback));
+            staticCallback->store(newCallback);
+            return newCallback;
         }
-        return staticCallback;
+        return staticCallback->load();
     }
 
     static void LineLogged(const char* line)
@@ -101,7 +107,7 @@ private:
         auto callback = SetOrGet(false, nullptr);
         if (nullptr != callback)
         {
-            callback(line);
+            (*callback)(line);
         }
     }
 };
@@ -0,0 +1,454 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_json.h: Public API declarations for the read-only JSON view over the native JSON parser
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#if defined(__has_include)
+#if __has_include(<string_view>)
+#include <string_view>
+#endif
+#endif
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_c_json.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Utils {
+
+/// <summary>
+/// Key of a JSON object member. Keys built from string literals have their length computed at compile time,
+/// so that comparing them against member names is a length check plus a memcmp.
+/// </summary>
+class JsonKey
+{
+public:
+
+    /// <summary>
+    /// Creates a key from a string literal.
+    /// </summary>
+    /// <param name="key">The string literal.</param>
+    template<size_t N>
+    constexpr JsonKey(const char (&key)[N]) : m_data(key), m_size(N - 1) {}
+
+    /// <summary>
+    /// Gets the key; always null terminated.
+    /// </summary>
+    /// <returns>The key.</returns>
+    constexpr const char* Data() const { return m_data; }
+
+    /// <summary>
+    /// Gets the length of the key.
+    /// </summary>
+    /// <returns>The length in bytes.</returns>
+    constexpr size_t Size() const { return m_size; }
+
+private:
+
+    const char* m_data;
+    size_t m_size;
+};
+
+/// <summary>
+/// Non-owning reference to a string inside the parsed JSON text. Escape sequences are not decoded;
+/// use <see cref="JsonValue::AsString"/> when the value may contain them.
+/// </summary>
+class JsonString
+{
+public:
+
+    /// <summary>
+    /// Creates a reference to a piece of JSON text.
+    /// </summary>
+    /// <param name="data">Pointer to the text, or nullptr if there is no string.</param>
+    /// <param name="size">Length of the text in bytes.</param>
+    JsonString(const char* data = nullptr, size_t size = 0) : m_data(data), m_size(size) {}
+
+    /// <summary>
+    /// Gets a pointer to the text; not null terminated.
+    /// </summary>
+    /// <returns>The pointer, or nullptr if there is no string.</returns>
+    const char* Data() const { return m_data; }
+
+    /// <summary>
+    /// Gets the length of the text.
+    /// </summary>
+    /// <returns>The length in bytes.</returns>
+    size_t Size() const { return m_size; }
+
+    /// <summary>
+    /// Checks whether the value referenced a string.
+    /// </summary>
+    explicit operator bool() const { return m_data != nullptr; }
+
+    /// <summary>
+    /// Copies the text into a std::string.
+    /// </summary>
+    /// <returns>The text.</returns>
+    std::string ToString() const { return m_data != nullptr ? std::string(m_data, m_size) : std::string(); }
+
+#if defined(__cpp_lib_string_view)
+    /// <summary>
+    /// Converts to a std::string_view.
+    /// </summary>
+    operator std::string_view() const { return std::string_view(m_data, m_size); }
+#endif
+
+    /// <summary>
+    /// Compares the text with a key.
+    /// </summary>
+    bool operator==(const JsonKey& key) const
+    {
+        return m_data != nullptr && m_size == key.Size() && std::memcmp(m_data, key.Data(), m_size) == 0;
+    }
+
+    /// <summary>
+    /// Compares the text with a key.
+    /// </summary>
+    bool operator!=(const JsonKey& key) const { return !(*this == key); }
+
+    /// <summary>
+    /// Compares the text with a string literal, whose length is known at compile time.
+    /// </summary>
+    template<size_t N>
+    bool operator==(const char (&key)[N]) const { return *this == JsonKey(key); }
+
+    /// <summary>
+    /// Compares the text with a string literal, whose length is known at compile time.
+    /// </summary>
+    template<size_t N>
+    bool operator!=(const char (&key)[N]) const { return !(*this == JsonKey(key)); }
+
+    /// <summary>
+    /// Compares the text with a std::string.
+    /// </summary>
+    bool operator==(const std::string& other) const
+    {
+        return m_data != nullptr && m_size == other.size() && std::memcmp(m_data, other.data(), m_size) == 0;
+    }
+
+    /// <summary>
+    /// Compares the text with a std::string.
+    /// </summary>
+    bool operator!=(const std::string& other) const { return !(*this == other); }
+
+private:
+
+    const char* m_data;
+    size_t m_size;
+};
+
+/// <summary>
+/// Read-only view of a value inside a document parsed by <see cref="JsonDocument"/>. Views are cheap to copy and
+/// are valid as long as the document that produced them.
+/// </summary>
+/// <remarks>
+/// Objects and arrays can be iterated with a range-based for loop. For object members, <see cref="Name"/> returns
+/// the member name.
+/// </remarks>
+class JsonValue
+{
+public:
+
+    class Iterator;
+
+    /// <summary>
+    /// Creates an invalid view.
+    /// </summary>
+    JsonValue() : m_parser(SPXHANDLE_INVALID), m_item(-1) {}
+
+    /// <summary>
+    /// Internal constructor. Creates a view of an item of the given parser.
+    /// </summary>
+    JsonValue(SPXHANDLE parser, int item) : m_parser(parser), m_item(item) {}
+
+    /// <summary>
+    /// Checks whether the view refers to a value, e.g. whether a lookup found its member.
+    /// </summary>
+    /// <returns>True if the view refers to a value.</returns>
+    bool IsValid() const { return m_parser != SPXHANDLE_INVALID && m_item >= 0; }
+
+    /// <summary>
+    /// Checks whether the view refers to a value.
+    /// </summary>
+    explicit operator bool() const { return IsValid(); }
+
+    /// <summary>
+    /// Gets the number of members of an object or elements of an array.
+    /// </summary>
+    /// <returns>The number of children; 0 for other values.</returns>
+    int Count() const { return IsValid() ? ai_core_json_item_count(m_parser, m_item) : 0; }
+
+    /// <summary>
+    /// Gets an element of an array, or a member of an object by position.
+    /// </summary>
+    /// <param name="index">The index.</param>
+    /// <returns>The value; invalid if there is no such child.</returns>
+    JsonValue operator[](int index) const
+    {
+        return IsValid() ? JsonValue(m_parser, ai_core_json_item_at(m_parser, m_item, index, nullptr)) : JsonValue();
+    }
+
+    /// <summary>
+    /// Looks up a member of an object by name.
+    /// </summary>
+    /// <param name="key">The member name.</param>
+    /// <returns>The value; invalid if there is no such member.</returns>
+    JsonValue operator[](const JsonKey& key) const { return Find(key.Data()); }
+
+    /// <summary>
+    /// Looks up a member of an object by name.
+    /// </summary>
+    /// <param name="name">The member name; must be null terminated.</param>
+    /// <returns>The value; invalid if there is no such member.</returns>
+    JsonValue Find(const char* name) const
+    {
+        return IsValid() ? JsonValue(m_parser, ai_core_json_item_at(m_parser, m_item, 0, name)) : JsonValue();
+    }
+
+    /// <summary>
+    /// Gets the name of an object member, as returned while iterating over an object.
+    /// </summary>
+    /// <returns>The name; empty if the value is not an object member.</returns>
+    JsonString Name() const
+    {
+        return NameValue().AsStringView();
+    }
+
+    /// <summary>
+    /// Gets the name of an object member as a string value, e.g. to decode it with <see cref="AsString"/>.
+    /// </summary>
+    /// <returns>The name; invalid if the value is not an object member.</returns>
+    JsonValue NameValue() const
+    {
+        return IsValid() ? JsonValue(m_parser, ai_core_json_item_name(m_parser, m_item)) : JsonValue();
+    }
+
+    /// <summary>
+    /// Gets a string value without copying it. Escape sequences are not decoded.
+    /// </summary>
+    /// <returns>The string; empty if the value is not a string.</returns>
+    JsonString AsStringView() const
+    {
+        if (!IsValid())
+        {
+            return JsonString();
+        }
+
+        size_t size = 0;
+        auto data = ai_core_json_value_as_string_ptr(m_parser, m_item, &size);
+        return JsonString(data, data != nullptr ? size : 0);
+    }
+
+    /// <summary>
+    /// Gets a string value as a UTF-8 std::string, with escape sequences decoded.
+    /// </summary>
+    /// <param name="defaultValue">Value returned if the value is not a string.</param>
+    /// <returns>The string.</returns>
+    std::string AsString(const char* defaultValue = "") const
+    {
+        if (!IsValid())
+        {
+            return defaultValue;
+        }
+
+        auto copy = ai_core_json_value_as_string_copy(m_parser, m_item, defaultValue);
+        if (copy == nullptr)
+        {
+            return defaultValue;
+        }
+
+        std::string value(copy);
+        ai_core_string_free(copy);
+        return value;
+    }
+
+    /// <summary>
+    /// Gets the JSON text of the value, e.g. of a nested object.
+    /// </summary>
+    /// <returns>The JSON text.</returns>
+    std::string AsJson() const
+    {
+        auto copy = IsValid() ? ai_core_json_value_as_json_copy(m_parser, m_item) : nullptr;
+        if (copy == nullptr)
+        {
+            return std::string();
+        }
+
+        std::string value(copy);
+        ai_core_string_free(copy);
+        return value;
+    }
+
+    /// <summary>
+    /// Gets a boolean value.
+    /// </summary>
+    /// <param name="defaultValue">Value returned if the value is not a boolean.</param>
+    /// <returns>The value.</returns>
+    bool AsBool(bool defaultValue = false) const { return IsValid() ? ai_core_json_value_as_bool(m_parser, m_item, defaultValue) : defaultValue; }
+
+    /// <summary>
+    /// Gets a number as a double.
+    /// </summary>
+    /// <param name="defaultValue">Value returned if the value is not a number.</param>
+    /// <returns>The value.</returns>
+    double AsDouble(double defaultValue = 0) const { return IsValid() ? ai_core_json_value_as_double(m_parser, m_item, defaultValue) : defaultValue; }
+
+    /// <summary>
+    /// Gets a number as a signed integer.
+    /// </summary>
+    /// <param name="defaultValue">Value returned if the value is not a number.</param>
+    /// <returns>The value.</returns>
+    int64_t AsInt(int64_t defaultValue = 0) const { return IsValid() ? ai_core_json_value_as_int(m_parser, m_item, defaultValue) : defaultValue; }
+
+    /// <summary>
+    /// Gets a number as an unsigned integer.
+    /// </summary>
+    /// <param name="defaultValue">Value returned if the value is not a number.</param>
+    /// <returns>The value.</returns>
+    uint64_t AsUInt(uint64_t defaultValue = 0) const { return IsValid() ? ai_core_json_value_as_uint(m_parser, m_item, defaultValue) : defaultValue; }
+
+    /// <summary>
+    /// Gets an iterator to the first member or element.
+    /// </summary>
+    Iterator begin() const;
+
+    /// <summary>
+    /// Gets the end iterator.
+    /// </summary>
+    Iterator end() const;
+
+private:
+
+    SPXHANDLE m_parser;
+    int m_item;
+};
+
+/// <summary>
+/// Forward iterator over the members of an object or the elements of an array.
+/// </summary>
+class JsonValue::Iterator
+{
+public:
+
+    /// <summary>
+    /// Internal constructor.
+    /// </summary>
+    Iterator(SPXHANDLE parser, int item, int remaining) : m_parser(parser), m_item(item), m_remaining(remaining) {}
+
+    /// <summary>
+    /// Gets the current member or element.
+    /// </summary>
+    JsonValue operator*() const { return JsonValue(m_parser, m_item); }
+
+    /// <summary>
+    /// Advances to the next member or element.
+    /// </summary>
+    Iterator& operator++()
+    {
+        // Bounded by the count, so the end of the list never depends on what item_next returns past the last child.
+        m_item = --m_remaining > 0 ? ai_core_json_item_next(m_parser, m_item) : -1;
+        return *this;
+    }
+
+    /// <summary>
+    /// Compares two iterators over the same value.
+    /// </summary>
+    bool operator==(const Iterator& other) const { return m_remaining == other.m_remaining; }
+
+    /// <summary>
+    /// Compares two iterators over the same value.
+    /// </summary>
+    bool operator!=(const Iterator& other) const { return m_remaining != other.m_remaining; }
+
+private:
+
+    SPXHANDLE m_parser;
+    int m_item;
+    int m_remaining;
+};
+
+inline JsonValue::Iterator JsonValue::begin() const
+{
+    auto count = Count();
+    return Iterator(m_parser, count > 0 ? ai_core_json_item_at(m_parser, m_item, 0, nullptr) : -1, count > 0 ? count : 0);
+}
+
+inline JsonValue::Iterator JsonValue::end() const
+{
+    return Iterator(m_parser, -1, 0);
+}
+
+/// <summary>
+/// Parsed JSON document. Owns the native parser; the text passed to it must outlive the document,
+/// since string views point into it.
+/// </summary>
+class JsonDocument
+{
+public:
+
+    /// <summary>
+    /// Parses JSON text.
+    /// </summary>
+    /// <param name="json">The JSON text.</param>
+    /// <param name="size">Length of the text in bytes.</param>
+    JsonDocument(const char* json, size_t size)
+    {
+        m_root = ai_core_json_parser_create(&m_parser, json, size);
+        if (!ai_core_json_parser_handle_is_valid(m_parser))
+        {
+            m_parser = SPXHANDLE_INVALID;
+        }
+    }
+
+    /// <summary>
+    /// Parses JSON text.
+    /// </summary>
+    /// <param name="json">The JSON text.</param>
+    explicit JsonDocument(const std::string& json) : JsonDocument(json.c_str(), json.size()) {}
+
+    /// <summary>
+    /// Deleted, since string views of the document would point into the temporary text.
+    /// </summary>
+    explicit JsonDocument(std::string&&) = delete;
+
+    /// <summary>
+    /// Destructor. Releases the native parser.
+    /// </summary>
+    ~JsonDocument()
+    {
+        if (m_parser != SPXHANDLE_INVALID)
+        {
+            ai_core_json_parser_handle_release(m_parser);
+        }
+    }
+
+    /// <summary>
+    /// Checks whether the text was parsed successfully.
+    /// </summary>
+    /// <returns>True if the document is valid.</returns>
+    bool IsValid() const { return m_parser != SPXHANDLE_INVALID; }
+
+    /// <summary>
+    /// Gets the root value.
+    /// </summary>
+    /// <returns>The root value; invalid if parsing failed.</returns>
+    JsonValue Root() const { return IsValid() ? JsonValue(m_parser, m_root) : JsonValue(); }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(JsonDocument);
+
+    SPXHANDLE m_parser = SPXHANDLE_INVALID;
+    int m_root = -1;
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Utils
@@ -0,0 +1,265 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_object_pool.h: Public API declarations for the pool recycling event arguments and result objects
+//
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Utils {
+
+/// <summary>
+/// Thread-safe pool of memory blocks, used by recognizers, synthesizers and connections to recycle the storage of
+/// the event arguments and result objects they create for every event.
+/// </summary>
+/// <remarks>
+/// Blocks are kept in one free list per block size. A block is returned to its free list when the object stored in it
+/// is destroyed, i.e. right after dispatch, or, for a result a subscriber kept a std::shared_ptr to, when the last
+/// reference is released. Keeping the std::shared_ptr is all it takes to keep (pin) a result.
+/// </remarks>
+class ObjectPool
+{
+public:
+
+    /// <summary>
+    /// Creates a pool.
+    /// </summary>
+    /// <param name="maxFreeBlocksPerSize">Maximum number of free blocks kept per block size; extra blocks are freed.</param>
+    explicit ObjectPool(size_t maxFreeBlocksPerSize = 16) : m_maxFreeBlocksPerSize(maxFreeBlocksPerSize)
+    {
+    }
+
+    /// <summary>
+    /// Destructor. Frees the blocks in the free lists.
+    /// </summary>
+    ~ObjectPool()
+    {
+        for (auto& list : m_freeLists)
+        {
+            for (auto block : list.blocks)
+            {
+                ::operator delete(block);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Gets a block of the given size, from the free list if possible.
+    /// </summary>
+    /// <param name="size">Size of the block in bytes.</param>
+    /// <returns>The block.</returns>
+    void* Allocate(size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& blocks = FreeList(size);
+            if (!blocks.empty())
+            {
+                auto block = blocks.back();
+                blocks.pop_back();
+                return block;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    /// <summary>
+    /// Returns a block obtained from <see cref="Allocate"/> with the same size.
+    /// </summary>
+    /// <param name="block">The block.</param>
+    /// <param name="size">Size of the block in bytes.</param>
+    void Deallocate(void* block, size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& blocks = FreeList(size);
+            if (blocks.size() < m_maxFreeBlocksPerSize)
+            {
+                blocks.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(ObjectPool);
+
+    struct SizedFreeList
+    {
+        size_t size;
+        std::vector<void*> blocks;
+    };
+
+    // Must be called with m_mutex held. There are only a handful of distinct sizes per owner, so a linear search is fine.
+    std::vector<void*>& FreeList(size_t size)
+    {
+        for (auto& list : m_freeLists)
+        {
+            if (list.size == size)
+            {
+                return list.blocks;
+            }
+        }
+
+        m_freeLists.push_back(SizedFreeList{ size, {} });
+        m_freeLists.back().blocks.reserve(m_maxFreeBlocksPerSize);
+        return m_freeLists.back().blocks;
+    }
+
+    const size_t m_maxFreeBlocksPerSize;
+    std::mutex m_mutex;
+    std::vector<SizedFreeList> m_freeLists;
+};
+
+/// <summary>
+/// Allocator drawing single objects from an <see cref="ObjectPool"/>, for use with std::allocate_shared.
+/// Each allocation keeps the pool alive, so objects may outlive their owner.
+/// </summary>
+template<class T>
+class PoolAllocator
+{
+public:
+
+    using value_type = T;
+
+    explicit PoolAllocator(std::shared_ptr<ObjectPool> pool) : m_pool(std::move(pool)) {}
+
+    template<class U>
+    PoolAllocator(const PoolAllocator<U>& other) : m_pool(other.m_pool) {}
+
+    T* allocate(size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types cannot be pooled");
+        return static_cast<T*>(n == 1 ? m_pool->Allocate(sizeof(T)) : ::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (n == 1)
+        {
+            m_pool->Deallocate(p, sizeof(T));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+
+    template<class U>
+    bool operator==(const PoolAllocator<U>& other) const { return m_pool == other.m_pool; }
+
+    template<class U>
+    bool operator!=(const PoolAllocator<U>& other) const { return m_pool != other.m_pool; }
+
+private:
+
+    template<class U> friend class PoolAllocator;
+
+    std::shared_ptr<ObjectPool> m_pool;
+};
+
+/// <summary>
+/// Deleter returning the storage of an object created by <see cref="MakePooled"/> to its pool.
+/// </summary>
+template<class T>
+struct PoolDeleter
+{
+    ObjectPool* pool;
+
+    void operator()(T* p) const
+    {
+        p->~T();
+        pool->Deallocate(p, sizeof(T));
+    }
+};
+
+/// <summary>
+/// Unique pointer to an object stored in an <see cref="ObjectPool"/>. The pool must outlive the pointer.
+/// </summary>
+template<class T>
+using PooledPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+/// <summary>
+/// Creates an object in storage drawn from the pool.
+/// </summary>
+/// <param name="pool">The pool; must outlive the returned pointer.</param>
+/// <param name="args">Constructor arguments.</param>
+/// <returns>The object.</returns>
+template<class T, class... Args>
+PooledPtr<T> MakePooled(ObjectPool& pool, Args&&... args)
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types cannot be pooled");
+
+    auto block = pool.Allocate(sizeof(T));
+    try
+    {
+        return PooledPtr<T>(::new (block) T(std::forward<Args>(args)...), PoolDeleter<T>{ &pool });
+    }
+    catch (...)
+    {
+        pool.Deallocate(block, sizeof(T));
+        throw;
+    }
+}
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+template<class TEventArgs, class THandle>
+PooledPtr<TEventArgs> MakePooledEventArgs(const std::shared_ptr<ObjectPool>& pool, THandle hevent, std::true_type)
+{
+    return MakePooled<TEventArgs>(*pool, hevent, pool);
+}
+
+template<class TEventArgs, class THandle>
+PooledPtr<TEventArgs> MakePooledEventArgs(const std::shared_ptr<ObjectPool>& pool, THandle hevent, std::false_type)
+{
+    return MakePooled<TEventArgs>(*pool, hevent);
+}
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// Creates event arguments for an event handle in storage drawn from the pool.
+/// Event arguments that have a constructor accepting the pool also create their result in it.
+/// </summary>
+/// <param name="pool">The pool; must outlive the returned pointer.</param>
+/// <param name="hevent">The event handle.</param>
+/// <returns>The event arguments.</returns>
+template<class TEventArgs, class THandle>
+PooledPtr<TEventArgs> MakePooledEventArgs(const std::shared_ptr<ObjectPool>& pool, THandle hevent)
+{
+    return Details::MakePooledEventArgs<TEventArgs>(pool, hevent, std::is_constructible<TEventArgs, THandle, const std::shared_ptr<ObjectPool>&>());
+}
+
+/// <summary>
+/// Creates a shared object, together with its reference counts, in storage drawn from the pool.
+/// </summary>
+/// <param name="pool">The pool; it is kept alive until the object is released.</param>
+/// <param name="args">Constructor arguments.</param>
+/// <returns>The object.</returns>
+template<class T, class... Args>
+std::shared_ptr<T> MakePooledShared(const std::shared_ptr<ObjectPool>& pool, Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(pool), std::forward<Args>(args)...);
+}
+
+} } } } // Microsoft::CognitiveServices::Speech::Utils
@@ -11,7 +11,7 @@
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_pattern_matching_intent.h"
 #include "speechapi_cxx_pattern_matching_entity.h"
-#include "speechapi_c_json.h"
+#include "speechapi_cxx_json.h"
 #include "speechapi_c.h"
 #include <fstream>
 
@@ -123,194 +123,136 @@ namespace Intent {
         static std::shared_ptr<PatternMatchingModel> ParseJSONFile(const std::string& fileContents)
         {
             auto model = std::shared_ptr<PatternMatchingModel>(new PatternMatchingModel(""));
-            AZAC_HANDLE parserHandle;
-            auto root = ai_core_json_parser_create(&parserHandle, fileContents.c_str(), fileContents.size());
-            if (!ai_core_json_parser_handle_is_valid(parserHandle))
+            Utils::JsonDocument document(fileContents);
+            if (!document.IsValid())
             {
                 SPX_TRACE_ERROR("Attempt to parse language understanding json file failed.", SPXERR_UNSUPPORTED_FORMAT);
                 return nullptr;
             }
-            int count = ai_core_json_item_count(parserHandle, root);
-            for (int i = 0; i < count; i++)
+            for (auto item : document.Root())
             {
-                auto itemInt = ai_core_json_item_at(parserHandle, root, i, nullptr);
-                auto nameInt = ai_core_json_item_name(parserHandle, itemInt);
-                size_t nameSize;
-                auto name = ai_core_json_value_as_string_ptr(parserHandle, nameInt, &nameSize);
+                auto name = item.Name();
+                if (!name)
+                {
+                    continue;
+                }
 
-                size_t valueSize = 0;
-                auto value = ai_core_json_value_as_string_ptr(parserHandle, itemInt, &valueSize);
-                if (name != nullptr)
+                if (name == "luis_schema_version")
                 {
-                    auto nameStr = std::string(name, nameSize);
-                    if (nameStr == "luis_schema_version")
-                    {
-                        // We support any version that we are able to pull data out of.
-                    }
-                    else if (nameStr == "prebuiltEntities")
-                    {
-                        int prebuiltcount = ai_core_json_item_count(parserHandle, itemInt);
-                        for (int j = 0; j < prebuiltcount; j++)
-                        {
-                            ParsePrebuiltEntityJson(parserHandle, model, itemInt, j);
-                        }
-                    }
-                    else if (nameStr == "name")
+                    // We support any version that we are able to pull data out of.
+                }
+                else if (name == "prebuiltEntities")
+                {
+                    for (auto entity : item)
                     {
-                        model->m_modelId = std::string(value, valueSize);
+                        ParsePrebuiltEntityJson(model, entity);
                     }
-                    else if (nameStr == "patternAnyEntities" || nameStr == "entities")
+                }
+                else if (name == "name")
+                {
+                    model->m_modelId = item.AsStringView().ToString();
+                }
+                else if (name == "patternAnyEntities" || name == "entities")
+                {
+                    for (auto entity : item)
                     {
-                        int anyCount = ai_core_json_item_count(parserHandle, itemInt);
-                        for (int j = 0; j < anyCount; j++)
-                        {
-                            ParseEntityJson(parserHandle, model, itemInt, j);
-                        }
+                        ParseEntityJson(model, entity);
                     }
-                    else if (nameStr == "patterns")
+                }
+                else if (name == "patterns")
+                {
+                    for (auto pattern : item)
                     {
-                        int patternCount = ai_core_json_item_count(parserHandle, itemInt);
-                        for (int j = 0; j < patternCount; j++)
-                        {
-                            ParsePatternJson(parserHandle, model, itemInt, j);
-                        }
+                        ParsePatternJson(model, pattern);
                     }
-                    else if (nameStr == "closedLists")
+                }
+                else if (name == "closedLists")
+                {
+                    for (auto list : item)
                     {
-                        int listCount = ai_core_json_item_count(parserHandle, itemInt);
-                        for (int j = 0; j < listCount; j++)
-                        {
-                            ParseListEntityJson(parserHandle, model, itemInt, j);
-                        }
+                        ParseListEntityJson(model, list);
                     }
                 }
             }
             return model;
         }
 
-        static void ParsePrebuiltEntityJson(AZAC_HANDLE parserHandle, std::shared_ptr<PatternMatchingModel> model, int itemInt, int index)
+        static void ParsePrebuiltEntityJson(const std::shared_ptr<PatternMatchingModel>& model, Utils::JsonValue entity)
         {
-            auto subItemInt = ai_core_json_item_at(parserHandle, itemInt, index, nullptr);
-            int subItemCount = ai_core_json_item_count(parserHandle, subItemInt);
-            size_t nameSize = 0;
-            size_t valueSize = 0;
-            for (int subItemIndex = 0; subItemIndex < subItemCount; subItemIndex++)
+            for (auto prebuiltPair : entity)
             {
-                auto prebuiltPairInt = ai_core_json_item_at(parserHandle, subItemInt, subItemIndex, nullptr);
-                auto nameInt = ai_core_json_item_name(parserHandle, prebuiltPairInt);
-                auto name = ai_core_json_value_as_string_ptr(parserHandle, nameInt, &nameSize);
-                if (name != nullptr)
+                auto value = prebuiltPair.AsStringView();
+                if (prebuiltPair.Name() == "name" && value)
                 {
-                    auto nameStr = std::string(name, nameSize);
-                    auto value = ai_core_json_value_as_string_ptr(parserHandle, prebuiltPairInt, &valueSize);
-                    if (nameStr == "name" && value != nullptr)
+                    if (value == "number")
                     {
-                        auto valueStr = std::string(value, valueSize);
-                        if (valueStr == "number")
-                        {
-                            model->Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
-                        }
-                        // ignore any other prebuilt types as they are not supported.
+                        model->Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
                     }
+                    // ignore any other prebuilt types as they are not supported.
                 }
             }
         }
 
-        static void ParseEntityJson(AZAC_HANDLE parserHandle, std::shared_ptr<PatternMatchingModel> model, int itemInt, int index)
+        static void ParseEntityJson(const std::shared_ptr<PatternMatchingModel>& model, Utils::JsonValue entity)
         {
-            auto subItemInt = ai_core_json_item_at(parserHandle, itemInt, index, nullptr);
-            int subItemCount = ai_core_json_item_count(parserHandle, subItemInt);
-            size_t nameSize = 0;
-            size_t valueSize = 0;
-            for (int subItemIndex = 0; subItemIndex < subItemCount; subItemIndex++)
+            for (auto entityPair : entity)
             {
-                auto entityPairInt = ai_core_json_item_at(parserHandle, subItemInt, subItemIndex, nullptr);
-                auto nameInt = ai_core_json_item_name(parserHandle, entityPairInt);
-                auto name = ai_core_json_value_as_string_ptr(parserHandle, nameInt, &nameSize);
-                if (name != nullptr)
+                auto value = entityPair.AsStringView();
+                if (entityPair.Name() == "name" && value)
                 {
-                    auto nameStr = std::string(name, nameSize);
-                    auto value = ai_core_json_value_as_string_ptr(parserHandle, entityPairInt, &valueSize);
-                    if (nameStr == "name" && value != nullptr)
-                    {
-                        model->Entities.push_back({ std::string(value, valueSize), EntityType::Any, EntityMatchMode::Basic, {}});
-                    }
-                    // ignore any other pairs since we only care about the name.
+                    model->Entities.push_back({ value.ToString(), EntityType::Any, EntityMatchMode::Basic, {}});
                 }
+                // ignore any other pairs since we only care about the name.
             }
         }
 
-        static void ParseListEntityJson(AZAC_HANDLE parserHandle, std::shared_ptr<PatternMatchingModel> model, int itemInt, int index)
+        static void ParseListEntityJson(const std::shared_ptr<PatternMatchingModel>& model, Utils::JsonValue list)
         {
-            auto subItemInt = ai_core_json_item_at(parserHandle, itemInt, index, nullptr);
-            int subItemCount = ai_core_json_item_count(parserHandle, subItemInt);
-            size_t nameSize = 0;
-            size_t valueSize = 0;
             // Default to Strict matching.
             PatternMatchingEntity entity{ "", EntityType::List, EntityMatchMode::Strict, {} };
-            for (int subItemIndex = 0; subItemIndex < subItemCount; subItemIndex++)
+            for (auto listPair : list)
             {
-                auto listPairInt = ai_core_json_item_at(parserHandle, subItemInt, subItemIndex, nullptr);
-                auto nameInt = ai_core_json_item_name(parserHandle, listPairInt);
-                auto name = ai_core_json_value_as_string_ptr(parserHandle, nameInt, &nameSize);
-                if (name != nullptr)
+                auto name = listPair.Name();
+                if (name == "name")
                 {
-                    auto nameStr = std::string(name, nameSize);
-                    if (nameStr == "name")
-                    {
-                        auto value = ai_core_json_value_as_string_ptr(parserHandle, listPairInt, &valueSize);
-                        if (value != nullptr)
-                        {
-                            entity.Id = std::string(value, valueSize);
-                        }
-                    }
-                    if (nameStr == "subLists")
+                    auto value = listPair.AsStringView();
+                    if (value)
                     {
-                        ParseSubList(parserHandle, entity, listPairInt);
+                        entity.Id = value.ToString();
                     }
-                    // ignore any other pairs since we only care about the name.
                 }
+                else if (name == "subLists")
+                {
+                    ParseSubList(entity, listPair);
+                }
+                // ignore any other pairs since we only care about the name.
             }
-            model->Entities.push_back(entity);
+            model->Entities.push_back(std::move(entity));
         }
 
-        static void ParseSubList(AZAC_HANDLE parserHandle, PatternMatchingEntity& entity, int listPairInt) 
+        static void ParseSubList(PatternMatchingEntity& entity, Utils::JsonValue subLists)
         {
-            size_t nameSize = 0;
-            size_t valueSize = 0;
-            auto subListCount = ai_core_json_item_count(parserHandle, listPairInt);
-            for (int subListIndex = 0; subListIndex < subListCount; subListIndex++)
+            for (auto subList : subLists)
             {
-                auto subListItemInt = ai_core_json_item_at(parserHandle, listPairInt, subListIndex, nullptr);
-                auto subListItemCount = ai_core_json_item_count(parserHandle, subListItemInt);
-                for (int subListItemIndex = 0; subListItemIndex < subListItemCount; subListItemIndex++)
+                for (auto subListPair : subList)
                 {
-                    auto subListPairInt = ai_core_json_item_at(parserHandle, subListItemInt, subListItemIndex, nullptr);
-                    auto nameInt = ai_core_json_item_name(parserHandle, subListPairInt);
-                    auto name = ai_core_json_value_as_string_ptr(parserHandle, nameInt, &nameSize);
-                    if (name != nullptr)
+                    auto name = subListPair.Name();
+                    if (name == "canonicalForm")
                     {
-                        auto nameStr = std::string(name, nameSize);
-                        if (nameStr == "canonicalForm")
+                        auto value = subListPair.AsStringView();
+                        if (value)
                         {
-                            auto value = ai_core_json_value_as_string_ptr(parserHandle, subListPairInt, &valueSize);
-                            if (value != nullptr)
-                            {
-                                entity.Phrases.push_back(std::string(value, valueSize));
-                            }
+                            entity.Phrases.push_back(value.ToString());
                         }
-                        else if (nameStr == "list")
+                    }
+                    else if (name == "list")
+                    {
+                        for (auto synonym : subListPair)
                         {
-                            auto subListSynonymInt = ai_core_json_item_at(parserHandle, subListItemInt, subListItemIndex, nullptr);
-                            auto subListSynonymItemCount = ai_core_json_item_count(parserHandle, subListSynonymInt);
-                            for (int subListSynonymIndex = 0; subListSynonymIndex < subListSynonymItemCount; subListSynonymIndex++)
+                            auto value = synonym.AsStringView();
+                            if (value)
                             {
-                                auto subListSynonymEntryInt = ai_core_json_item_at(parserHandle, subListSynonymInt, subListSynonymIndex, nullptr);
-                                auto value = ai_core_json_value_as_string_ptr(parserHandle, subListSynonymEntryInt, &valueSize);
-                                if (value != nullptr)
-                                {
-                                    entity.Phrases.push_back(std::string(value, valueSize));
-                                }
+                                entity.Phrases.push_back(value.ToString());
                             }
                         }
                     }
@@ -318,52 +260,33 @@ namespace Intent {
             }
         }
 
-        static void ParsePatternJson(AZAC_HANDLE parserHandle, std::shared_ptr<PatternMatchingModel> model, int itemInt, int index)
+        static void ParsePatternJson(const std::shared_ptr<PatternMatchingModel>& model, Utils::JsonValue pattern)
         {
-            auto subItemInt = ai_core_json_item_at(parserHandle, itemInt, index, nullptr);
-            int subItemCount = ai_core_json_item_count(parserHandle, subItemInt);
-            size_t nameSize = 0;
-            size_t valueSize = 0;
-            std::string patternStr, intentIdStr;
-            for (int subItemIndex = 0; subItemIndex < subItemCount; subItemIndex++)
+            Utils::JsonString patternStr, intentIdStr;
+            for (auto entityPair : pattern)
             {
-                auto entityPairInt = ai_core_json_item_at(parserHandle, subItemInt, subItemIndex, nullptr);
-                auto nameInt = ai_core_json_item_name(parserHandle, entityPairInt);
-                auto name = ai_core_json_value_as_string_ptr(parserHandle, nameInt, &nameSize);
-                if (name != nullptr)
+                auto name = entityPair.Name();
+                if (name == "pattern")
                 {
-                    auto nameStr = std::string(name, nameSize);
-                    auto value = ai_core_json_value_as_string_ptr(parserHandle, entityPairInt, &valueSize);
-                    if (value != nullptr)
-                    {
-                        if (nameStr == "pattern")
-                        {
-                            patternStr = std::string(value, valueSize);
-                        }
-                        else if (nameStr == "intent")
-                        {
-                            intentIdStr = std::string(value, valueSize);
-                        }
-                    }
-                    // ignore any other pairs since we only care about the name.
+                    patternStr = entityPair.AsStringView();
+                }
+                else if (name == "intent")
+                {
+                    intentIdStr = entityPair.AsStringView();
                 }
+                // ignore any other pairs since we only care about the name.
             }
-            if (!patternStr.empty() && !intentIdStr.empty())
+            if (patternStr.Size() > 0 && intentIdStr.Size() > 0)
             {
-                bool added = false;
                 for (auto& intent : model->Intents)
                 {
-                    if (intent.Id == intentIdStr)
+                    if (intentIdStr == intent.Id)
                     {
-                        intent.Phrases.push_back(patternStr);
-                        added = true;
-                        break;
+                        intent.Phrases.push_back(patternStr.ToString());
+                        return;
                     }
                 }
-                if (!added)
-                {
-                    model->Intents.push_back({ {patternStr}, intentIdStr});
-                }
+                model->Intents.push_back({ {patternStr.ToString()}, intentIdStr.ToString() });
             }
         }
 
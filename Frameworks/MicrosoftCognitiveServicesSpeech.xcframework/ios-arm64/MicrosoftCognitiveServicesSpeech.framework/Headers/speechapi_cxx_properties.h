@@ -1,5 +1,12 @@
 #pragma once
 
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <string>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
@@ -17,6 +24,13 @@ class KeywordRecognizer;
 /// <summary>
 /// Class to retrieve or set a property value from a property collection.
 /// </summary>
+/// <remarks>
+/// The property collections of results (recognition, synthesis, speaker recognition, voice profile and voice list
+/// results) and of connection messages cache each property the first time it is read, including whether it is defined,
+/// so later reads of that property do not call into the native property bag. SetProperty drops the cached value of the
+/// property it sets. Other property collections, such as those of configurations and recognizers, are not cached.
+/// Property collections cannot be copied. The ones held by results are moved along with their result.
+/// </remarks>
 class PropertyCollection
 {
 public:
@@ -40,7 +54,8 @@ public:
     /// <param name="value">value to set</param>
     void SetProperty(PropertyId propertyID, const SPXSTRING& value)
     {
-        property_bag_set_string(m_propbag, (int)propertyID, NULL, Utils::ToUTF8(value).c_str());
+        property_bag_set_string(PropertyBag(), (int)propertyID, NULL, Utils::ToUTF8(value).c_str());
+        InvalidateCachedValue(static_cast<int>(propertyID), nullptr);
     }
 
     /// <summary>
@@ -50,7 +65,9 @@ public:
     /// <param name="value">value to set</param>
     void SetProperty(const SPXSTRING& propertyName, const SPXSTRING& value)
     {
-        property_bag_set_string(m_propbag, -1, Utils::ToUTF8(propertyName).c_str(), Utils::ToUTF8(value).c_str());
+        auto name = Utils::ToUTF8(propertyName);
+        property_bag_set_string(PropertyBag(), -1, name.c_str(), Utils::ToUTF8(value).c_str());
+        InvalidateCachedValue(-1, name.c_str());
     }
 
     /// <summary>
@@ -62,7 +79,19 @@ public:
     /// <returns>value of the property.</returns>
     SPXSTRING GetProperty(PropertyId propertyID, const SPXSTRING& defaultValue = SPXSTRING()) const
     {
-        const char* propCch = property_bag_get_string(m_propbag, static_cast<int>(propertyID), nullptr, Utils::ToUTF8(defaultValue).c_str());
+        if (m_cacheReads)
+        {
+            SPXSTRING value;
+            bool defined = false;
+            ReadProperty(static_cast<int>(propertyID), nullptr, [&](const char* cached) { if (cached != nullptr) { value = Utils::ToSPXString(cached); defined = true; } });
+            if (!defined)
+            {
+                value = defaultValue;
+            }
+            return value;
+        }
+
+        const char* propCch = property_bag_get_string(PropertyBag(), static_cast<int>(propertyID), nullptr, Utils::ToUTF8(defaultValue).c_str());
         return Utils::ToSPXString(Utils::CopyAndFreePropertyString(propCch));
     }
 
@@ -75,10 +104,153 @@ public:
     /// <returns>value of the property.</returns>
     SPXSTRING GetProperty(const SPXSTRING& propertyName, const SPXSTRING& defaultValue = SPXSTRING()) const
     {
-        const char* propCch = property_bag_get_string(m_propbag, -1, Utils::ToUTF8(propertyName).c_str(), Utils::ToUTF8(defaultValue).c_str());
+        if (m_cacheReads)
+        {
+            SPXSTRING value;
+            bool defined = false;
+            ReadProperty(-1, Utils::ToUTF8(propertyName).c_str(), [&](const char* cached) { if (cached != nullptr) { value = Utils::ToSPXString(cached); defined = true; } });
+            if (!defined)
+            {
+                value = defaultValue;
+            }
+            return value;
+        }
+
+        const char* propCch = property_bag_get_string(PropertyBag(), -1, Utils::ToUTF8(propertyName).c_str(), Utils::ToUTF8(defaultValue).c_str());
         return Utils::ToSPXString(Utils::CopyAndFreePropertyString(propCch));
     }
 
+    /// <summary>
+    /// Returns value of a property.
+    /// If the property value is not defined, the specified default value is returned.
+    /// Unlike the SPXSTRING overload, the default value is only copied when it is returned.
+    /// </summary>
+    /// <param name="propertyID">The id of the property. See <see cref="PropertyId"/></param>
+    /// <param name="defaultValue">The UTF-8 default value which is returned if no value is defined for the property.</param>
+    /// <returns>value of the property.</returns>
+    SPXSTRING GetProperty(PropertyId propertyID, const char* defaultValue) const
+    {
+        SPXSTRING value;
+        ReadProperty(static_cast<int>(propertyID), nullptr, [&](const char* raw) { value = Utils::ToSPXString(raw != nullptr ? raw : defaultValue); });
+        return value;
+    }
+
+    /// <summary>
+    /// Returns value of a property.
+    /// If the property value is not defined, the specified default value is returned.
+    /// Unlike the SPXSTRING overload, neither the name nor the default value is copied to look up the property.
+    /// </summary>
+    /// <param name="propertyName">The UTF-8 name of the property.</param>
+    /// <param name="defaultValue">The UTF-8 default value which is returned if no value is defined for the property (empty string by default).</param>
+    /// <returns>value of the property.</returns>
+    SPXSTRING GetProperty(const char* propertyName, const char* defaultValue = "") const
+    {
+        SPXSTRING value;
+        ReadProperty(-1, propertyName, [&](const char* raw) { value = Utils::ToSPXString(raw != nullptr ? raw : defaultValue); });
+        return value;
+    }
+
+#if defined(__cpp_lib_string_view)
+    /// <summary>
+    /// Returns value of a property.
+    /// If the property value is not defined, the specified default value is returned.
+    /// Unlike the SPXSTRING overload, the default value is only copied when it is returned.
+    /// </summary>
+    /// <param name="propertyID">The id of the property. See <see cref="PropertyId"/></param>
+    /// <param name="defaultValue">The UTF-8 default value which is returned if no value is defined for the property.</param>
+    /// <returns>value of the property.</returns>
+    SPXSTRING GetProperty(PropertyId propertyID, std::string_view defaultValue) const
+    {
+        SPXSTRING value;
+        ReadProperty(static_cast<int>(propertyID), nullptr, [&](const char* raw) { value = raw != nullptr ? Utils::ToSPXString(raw) : Utils::ToSPXString(defaultValue); });
+        return value;
+    }
+#endif
+
+    /// <summary>
+    /// Returns value of a property as an integer, without allocating a string.
+    /// If the property value is not defined, is empty or is not an integer, the specified default value is returned.
+    /// </summary>
+    /// <param name="propertyID">The id of the property. See <see cref="PropertyId"/></param>
+    /// <param name="defaultValue">The default value.</param>
+    /// <returns>value of the property.</returns>
+    int GetInt(PropertyId propertyID, int defaultValue = 0) const
+    {
+        int value = defaultValue;
+        ReadProperty(static_cast<int>(propertyID), nullptr, [&](const char* raw) { ParseInt(raw, value); });
+        return value;
+    }
+
+    /// <summary>
+    /// Returns value of a property as an integer, without allocating a string.
+    /// If the property value is not defined, is empty or is not an integer, the specified default value is returned.
+    /// </summary>
+    /// <param name="propertyName">The UTF-8 name of the property.</param>
+    /// <param name="defaultValue">The default value.</param>
+    /// <returns>value of the property.</returns>
+    int GetInt(const char* propertyName, int defaultValue = 0) const
+    {
+        int value = defaultValue;
+        ReadProperty(-1, propertyName, [&](const char* raw) { ParseInt(raw, value); });
+        return value;
+    }
+
+    /// <summary>
+    /// Returns value of a property as a boolean ("true"/"false" or "1"/"0", case insensitive), without allocating a string.
+    /// If the property value is not defined, is empty or is not a boolean, the specified default value is returned.
+    /// </summary>
+    /// <param name="propertyID">The id of the property. See <see cref="PropertyId"/></param>
+    /// <param name="defaultValue">The default value.</param>
+    /// <returns>value of the property.</returns>
+    bool GetBool(PropertyId propertyID, bool defaultValue = false) const
+    {
+        bool value = defaultValue;
+        ReadProperty(static_cast<int>(propertyID), nullptr, [&](const char* raw) { ParseBool(raw, value); });
+        return value;
+    }
+
+    /// <summary>
+    /// Returns value of a property as a boolean ("true"/"false" or "1"/"0", case insensitive), without allocating a string.
+    /// If the property value is not defined, is empty or is not a boolean, the specified default value is returned.
+    /// </summary>
+    /// <param name="propertyName">The UTF-8 name of the property.</param>
+    /// <param name="defaultValue">The default value.</param>
+    /// <returns>value of the property.</returns>
+    bool GetBool(const char* propertyName, bool defaultValue = false) const
+    {
+        bool value = defaultValue;
+        ReadProperty(-1, propertyName, [&](const char* raw) { ParseBool(raw, value); });
+        return value;
+    }
+
+    /// <summary>
+    /// Returns value of a property holding a number of milliseconds (e.g. the *TimeoutMs properties), without allocating a string.
+    /// If the property value is not defined, is empty or is not an integer, the specified default value is returned.
+    /// </summary>
+    /// <param name="propertyID">The id of the property. See <see cref="PropertyId"/></param>
+    /// <param name="defaultValue">The default value.</param>
+    /// <returns>value of the property.</returns>
+    std::chrono::milliseconds GetDuration(PropertyId propertyID, std::chrono::milliseconds defaultValue = std::chrono::milliseconds(0)) const
+    {
+        auto value = defaultValue;
+        ReadProperty(static_cast<int>(propertyID), nullptr, [&](const char* raw) { ParseDuration(raw, value); });
+        return value;
+    }
+
+    /// <summary>
+    /// Returns value of a property holding a number of milliseconds, without allocating a string.
+    /// If the property value is not defined, is empty or is not an integer, the specified default value is returned.
+    /// </summary>
+    /// <param name="propertyName">The UTF-8 name of the property.</param>
+    /// <param name="defaultValue">The default value.</param>
+    /// <returns>value of the property.</returns>
+    std::chrono::milliseconds GetDuration(const char* propertyName, std::chrono::milliseconds defaultValue = std::chrono::milliseconds(0)) const
+    {
+        auto value = defaultValue;
+        ReadProperty(-1, propertyName, [&](const char* raw) { ParseDuration(raw, value); });
+        return value;
+    }
+
 protected:
     friend class KeywordRecognizer;
 
@@ -86,13 +258,213 @@ protected:
 
     PropertyCollection(SPXPROPERTYBAGHANDLE propbag) : m_propbag(propbag) {}
 
+    // Used by result property collections, which do not change after creation; values read from them are cached.
+    PropertyCollection(SPXPROPERTYBAGHANDLE propbag, bool cacheReads) : m_propbag(propbag), m_cacheReads(cacheReads) {}
+
+    // Defers getting the property bag until the first property access, for results that are often never inspected.
+    PropertyCollection(std::function<SPXPROPERTYBAGHANDLE()> getPropertyBag, bool cacheReads) :
+        m_propbag(SPXHANDLE_INVALID), m_getPropertyBag(std::move(getPropertyBag)), m_cacheReads(cacheReads) {}
+
+    // Takes over the property bag and the cached values; the source must not be in use. It is left without a property bag.
+    PropertyCollection(PropertyCollection&& other) :
+        m_propbag(other.m_propbag),
+        m_getPropertyBag(std::move(other.m_getPropertyBag)),
+        m_cacheReads(other.m_cacheReads),
+        m_cachedById(std::move(other.m_cachedById)),
+        m_cachedByName(std::move(other.m_cachedByName))
+    {
+        other.m_propbag = SPXHANDLE_INVALID;
+        other.m_getPropertyBag = nullptr;
+    }
+
+    // Reads a property from the native property bag without caching it, for values the caller keeps itself.
+    std::string GetUncachedProperty(const char* name) const
+    {
+        PropertyString raw(property_bag_get_string(PropertyBag(), -1, name, ""));
+        return raw.value != nullptr ? raw.value : "";
+    }
+
     /*! \endcond */
 
 private:
 
-    DISABLE_COPY_AND_MOVE(PropertyCollection);
+    DISABLE_COPY_AND_ASSIGNMENT(PropertyCollection);
+
+    struct CachedProperty
+    {
+        bool defined;
+        std::string value;
+    };
+
+    SPXPROPERTYBAGHANDLE PropertyBag() const
+    {
+        if (m_getPropertyBag != nullptr)
+        {
+            // A collection moved after its first access already holds the property bag.
+            std::call_once(m_getPropertyBagOnce, [this]() {
+                if (m_propbag == SPXHANDLE_INVALID)
+                {
+                    m_propbag = m_getPropertyBag();
+                }
+            });
+        }
+        return m_propbag;
+    }
+
+    // Invokes fn with the UTF-8 value of the property, which may be empty, or with nullptr if it is not defined.
+    // fn must not keep the pointer.
+    template<class F>
+    void ReadProperty(int id, const char* name, F&& fn) const
+    {
+        if (m_cacheReads)
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            const CachedProperty& cached = (id >= 0) ? CachedValue(m_cachedById, id, id, name) : CachedValue(m_cachedByName, name, id, name);
+            fn(cached.defined ? cached.value.c_str() : nullptr);
+            return;
+        }
+
+        PropertyString raw(GetDefinedString(id, name));
+        fn(raw.value);
+    }
+
+    // Must be called with m_cacheMutex held.
+    template<class TMap, class TKey>
+    const CachedProperty& CachedValue(TMap& cache, const TKey& key, int id, const char* name) const
+    {
+        auto it = cache.find(key);
+        if (it == cache.end())
+        {
+            PropertyString raw(GetDefinedString(id, name));
+            it = cache.emplace(key, CachedProperty{ raw.value != nullptr, raw.value != nullptr ? raw.value : "" }).first;
+        }
+        return it->second;
+    }
+
+    // Returns the value of the property, to be freed with property_bag_free_string, or nullptr if it is not defined.
+    // The C API returns the default value for a property that is not defined, so an empty value is read again with a
+    // default value that is not empty: a defined empty value is still returned as empty.
+    const char* GetDefinedString(int id, const char* name) const
+    {
+        auto value = property_bag_get_string(PropertyBag(), id, name, "");
+        if (value == nullptr || *value != '\0')
+        {
+            return value;
+        }
+
+        PropertyString probe(property_bag_get_string(PropertyBag(), id, name, "\x01"));
+        if (probe.value == nullptr || *probe.value != '\0')
+        {
+            property_bag_free_string(value);
+            return nullptr;
+        }
+        return value;
+    }
+
+    void InvalidateCachedValue(int id, const char* name)
+    {
+        if (m_cacheReads)
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            if (id >= 0)
+            {
+                m_cachedById.erase(id);
+            }
+            else
+            {
+                auto it = m_cachedByName.find(name);
+                if (it != m_cachedByName.end())
+                {
+                    m_cachedByName.erase(it);
+                }
+            }
+        }
+    }
+
+    static void ParseInt(const char* raw, int& value)
+    {
+        long long parsed = 0;
+        if (ParseInteger(raw, parsed) && parsed >= (std::numeric_limits<int>::min)() && parsed <= (std::numeric_limits<int>::max)())
+        {
+            value = static_cast<int>(parsed);
+        }
+    }
+
+    static void ParseDuration(const char* raw, std::chrono::milliseconds& value)
+    {
+        long long parsed = 0;
+        if (ParseInteger(raw, parsed))
+        {
+            value = std::chrono::milliseconds(parsed);
+        }
+    }
+
+    static bool ParseInteger(const char* raw, long long& value)
+    {
+        if (raw == nullptr)
+        {
+            return false;
+        }
+
+        // strtoll clamps a value out of its range and reports it through errno
+        char* end = nullptr;
+        errno = 0;
+        auto parsed = std::strtoll(raw, &end, 10);
+        if (end == raw || *end != '\0' || errno == ERANGE)
+        {
+            return false;
+        }
+
+        value = parsed;
+        return true;
+    }
+
+    static void ParseBool(const char* raw, bool& value)
+    {
+        if (raw == nullptr)
+        {
+            return;
+        }
+
+        if (EqualsIgnoreCase(raw, "true") || EqualsIgnoreCase(raw, "1"))
+        {
+            value = true;
+        }
+        else if (EqualsIgnoreCase(raw, "false") || EqualsIgnoreCase(raw, "0"))
+        {
+            value = false;
+        }
+    }
+
+    static bool EqualsIgnoreCase(const char* a, const char* b)
+    {
+        for (; *a != '\0' && *b != '\0'; a++, b++)
+        {
+            auto ca = (*a >= 'A' && *a <= 'Z') ? *a - 'A' + 'a' : *a;
+            if (ca != *b)
+            {
+                return false;
+            }
+        }
+        return *a == *b;
+    }
+
+    // Frees a string returned by property_bag_get_string.
+    struct PropertyString
+    {
+        explicit PropertyString(const char* v) : value(v) {}
+        ~PropertyString() { property_bag_free_string(value); }
+        const char* value;
+    };
+
+    mutable SPXPROPERTYBAGHANDLE m_propbag;
+    std::function<SPXPROPERTYBAGHANDLE()> m_getPropertyBag;
+    mutable std::once_flag m_getPropertyBagOnce;
 
-    SPXPROPERTYBAGHANDLE m_propbag;
+    bool m_cacheReads = false;
+    mutable std::mutex m_cacheMutex;
+    mutable std::map<int, CachedProperty> m_cachedById;
+    mutable std::map<std::string, CachedProperty, std::less<>> m_cachedByName;
 };
 
 
@@ -9,9 +9,12 @@
 #include <future>
 #include <memory>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_object_pool.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_eventsignal.h"
 #include "speechapi_cxx_recognizer.h"
+#include "speechapi_cxx_utils.h"
 #include "speechapi_cxx_session_eventargs.h"
 #include "speechapi_cxx_recognition_eventargs.h"
 #include "speechapi_cxx_keyword_recognition_model.h"
@@ -118,7 +121,8 @@ protected:
         m_hasyncStartContinuous(SPXHANDLE_INVALID),
         m_hasyncStopContinuous(SPXHANDLE_INVALID),
         m_hasyncStartKeyword(SPXHANDLE_INVALID),
-        m_hasyncStopKeyword(SPXHANDLE_INVALID)
+        m_hasyncStopKeyword(SPXHANDLE_INVALID),
+        m_eventArgsPool(std::make_shared<Utils::ObjectPool>())
     {
         SPX_DBG_TRACE_SCOPE(__FUNCTION__, __FUNCTION__);
     };
@@ -159,7 +163,7 @@ protected:
     std::future<std::shared_ptr<RecoResult>> RecognizeOnceAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> std::shared_ptr<RecoResult> {
+        auto future = Utils::RunAsync([keepAlive, this]() -> std::shared_ptr<RecoResult> {
             SPX_INIT_HR(hr);
 
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
@@ -174,7 +178,7 @@ protected:
     std::future<void> StartContinuousRecognitionAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStartContinuous)); // close any unfinished previous attempt
 
@@ -195,7 +199,7 @@ protected:
     std::future<void> StopContinuousRecognitionAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStopContinuous)); // close any unfinished previous attempt
 
@@ -216,7 +220,7 @@ protected:
     std::future<void> StartKeywordRecognitionAsyncInternal(std::shared_ptr<KeywordRecognitionModel> model)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, model, this]() -> void {
+        auto future = Utils::RunAsync([keepAlive, model, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStartKeyword)); // close any unfinished previous attempt
 
@@ -238,7 +242,7 @@ protected:
     std::future<void> StopKeywordRecognitionAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStopKeyword)); // close any unfinished previous attempt
 
@@ -327,65 +331,72 @@ protected:
     static void FireEvent_SessionStarted(SPXRECOHANDLE hreco, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hreco);
-        std::unique_ptr<SessionEventArgs> sessionEvent { new SessionEventArgs(hevent) };
+
+        // SessionEventArgs doesn't hold hevent, and thus can't release it properly ... release it on the way out
+        auto releaseEvent = Utils::MakeScopeGuard([hevent]() {
+            SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
+            recognizer_event_handle_release(hevent);
+        });
 
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
+        auto sessionEvent = Utils::MakePooledEventArgs<SessionEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->SessionStarted.Signal(*sessionEvent.get());
-
-        // SessionEventArgs doesn't hold hevent, and thus can't release it properly ... release it here
-        SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
-        recognizer_event_handle_release(hevent);
     }
 
     static void FireEvent_SessionStopped(SPXRECOHANDLE hreco, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hreco);
-        std::unique_ptr<SessionEventArgs> sessionEvent { new SessionEventArgs(hevent) };
+
+        // SessionEventArgs doesn't hold hevent, and thus can't release it properly ... release it on the way out
+        auto releaseEvent = Utils::MakeScopeGuard([hevent]() {
+            SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
+            recognizer_event_handle_release(hevent);
+        });
 
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
+        auto sessionEvent = Utils::MakePooledEventArgs<SessionEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->SessionStopped.Signal(*sessionEvent.get());
-
-        // SessionEventArgs doesn't hold hevent, and thus can't release it properly ... release it here
-        SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
-        recognizer_event_handle_release(hevent);
     }
 
     static void FireEvent_SpeechStartDetected(SPXRECOHANDLE hreco, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hreco);
-        std::unique_ptr<RecognitionEventArgs> recoEvent{ new RecognitionEventArgs(hevent) };
+
+        // RecognitionEventArgs doesn't hold hevent, and thus can't release it properly ... release it on the way out
+        auto releaseEvent = Utils::MakeScopeGuard([hevent]() {
+            SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
+            recognizer_event_handle_release(hevent);
+        });
 
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
+        auto recoEvent = Utils::MakePooledEventArgs<RecognitionEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->SpeechStartDetected.Signal(*recoEvent.get());
-
-        // RecognitionEventArgs doesn't hold hevent, and thus can't release it properly ... release it here
-        SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
-        recognizer_event_handle_release(hevent);
     }
 
     static void FireEvent_SpeechEndDetected(SPXRECOHANDLE hreco, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hreco);
-        std::unique_ptr<RecognitionEventArgs> recoEvent{ new RecognitionEventArgs(hevent) };
+
+        // RecognitionEventArgs doesn't hold hevent, and thus can't release it properly ... release it on the way out
+        auto releaseEvent = Utils::MakeScopeGuard([hevent]() {
+            SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
+            recognizer_event_handle_release(hevent);
+        });
 
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
+        auto recoEvent = Utils::MakePooledEventArgs<RecognitionEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->SpeechEndDetected.Signal(*recoEvent.get());
-
-        // RecognitionEventArgs doesn't hold hevent, and thus can't release it properly ... release it here
-        SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
-        recognizer_event_handle_release(hevent);
     }
 
     static void FireEvent_Recognizing(SPXRECOHANDLE hreco, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hreco);
-        std::unique_ptr<RecoEventArgs> recoEvent { new RecoEventArgs(hevent) };
-
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
+        auto recoEvent = Utils::MakePooledEventArgs<RecoEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->Recognizing.Signal(*recoEvent.get());
     }
@@ -393,9 +404,8 @@ protected:
     static void FireEvent_Recognized(SPXRECOHANDLE hreco, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hreco);
-        std::unique_ptr<RecoEventArgs> recoEvent { new RecoEventArgs(hevent) };
-
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
+        auto recoEvent = Utils::MakePooledEventArgs<RecoEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->Recognized.Signal(*recoEvent.get());
     }
@@ -404,12 +414,10 @@ protected:
     {
         UNUSED(hreco);
 
-        auto ptr = new RecoCanceledEventArgs(hevent);
-        std::shared_ptr<RecoCanceledEventArgs> recoEvent(ptr);
-
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
+        auto recoEvent = Utils::MakePooledEventArgs<RecoCanceledEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
-        pThis->Canceled.Signal(*ptr);
+        pThis->Canceled.Signal(*recoEvent.get());
     }
 
     class PrivatePropertyCollection : public PropertyCollection
@@ -434,6 +442,9 @@ protected:
     SPXASYNCHANDLE m_hasyncStartKeyword;
     SPXASYNCHANDLE m_hasyncStopKeyword;
 
+    // Recycles the storage of the event arguments, and of the results they carry, created for every event.
+    std::shared_ptr<Utils::ObjectPool> m_eventArgsPool;
+
     template <typename Handle, typename Config>
     static Handle HandleOrInvalid(std::shared_ptr<Config> audioInput)
     {
@@ -6,6 +6,7 @@
 //
 
 #pragma once
+#include <mutex>
 #include <string>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
@@ -38,7 +39,7 @@ private:
                 SPXPROPERTYBAGHANDLE hpropbag = SPXHANDLE_INVALID;
                 result_get_property_bag(hresult, &hpropbag);
                 return hpropbag;
-            }())
+            }, true)
         {
         }
     };
@@ -78,14 +79,14 @@ public:
     /// A single tick represents one hundred nanoseconds or one ten-millionth of a second.
     /// </summary>
     /// <returns>Duration of recognized speech in ticks.</returns>
-    uint64_t Duration() const { return m_duration; }
+    uint64_t Duration() const { PopulateTimingFields(); return m_duration; }
 
     /// <summary>
     /// Offset of the recognized speech in ticks.
     /// A single tick represents one hundred nanoseconds or one ten-millionth of a second.
     /// </summary>
     /// <returns>Offset of the recognized speech in ticks.</returns>
-    uint64_t Offset() const { return m_offset; }
+    uint64_t Offset() const { PopulateTimingFields(); return m_offset; }
 
     /// <summary>
     /// Collection of additional RecognitionResult properties.
@@ -115,13 +116,30 @@ protected:
         PopulateResultFields(hresult, &m_resultId, &m_reason, &m_text);
     }
 
+    // Takes over the result handle; the source is left without one. Offset and duration are read again on first use.
+    RecognitionResult(RecognitionResult&& other) :
+        m_properties(std::move(other.m_properties)),
+        ResultId(m_resultId),
+        Reason(m_reason),
+        Text(m_text),
+        Properties(m_properties),
+        Handle(m_hresult),
+        m_hresult(other.m_hresult),
+        m_resultId(std::move(other.m_resultId)),
+        m_reason(other.m_reason),
+        m_text(std::move(other.m_text))
+    {
+        other.m_hresult = SPXHANDLE_INVALID;
+    }
+
     const SPXRESULTHANDLE& Handle;
 
     /*! \endcond */
 
 private:
 
-    DISABLE_DEFAULT_CTORS(RecognitionResult);
+    RecognitionResult() = delete;
+    DISABLE_COPY_AND_ASSIGNMENT(RecognitionResult);
 
     void PopulateResultFields(SPXRESULTHANDLE hresult, SPXSTRING* resultId, Speech::ResultReason* reason, SPXSTRING* text)
     {
@@ -149,9 +167,15 @@ private:
             SPX_THROW_ON_FAIL(hr = result_get_text(hresult, sz, maxCharCount));
             *text = Utils::ToSPXString(sz);
         }
+    }
 
-        SPX_THROW_ON_FAIL(hr = result_get_offset(hresult, &m_offset));
-        SPX_THROW_ON_FAIL(hr = result_get_duration(hresult, &m_duration));
+    // Offset and duration are read from the native result on first use, since most intermediate results never ask for them.
+    void PopulateTimingFields() const
+    {
+        std::call_once(m_timingOnce, [this]() {
+            SPX_THROW_ON_FAIL(result_get_offset(m_hresult, &m_offset));
+            SPX_THROW_ON_FAIL(result_get_duration(m_hresult, &m_duration));
+        });
     }
 
     SPXRESULTHANDLE m_hresult;
@@ -159,8 +183,9 @@ private:
     SPXSTRING m_resultId;
     Speech::ResultReason m_reason;
     SPXSTRING m_text;
-    uint64_t m_offset;
-    uint64_t m_duration;
+    mutable uint64_t m_offset = 0;
+    mutable uint64_t m_duration = 0;
+    mutable std::once_flag m_timingOnce;
 };
 
 
@@ -0,0 +1,432 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "azac_api_c_diagnostics.h"
+#include "azac_api_cxx_common.h"
+#include "speechapi_cxx_log_level.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Diagnostics {
+namespace Logging {
+
+/// <summary>
+/// Class with static methods to control a fixed-size, in-process ring buffer of SDK log lines.
+/// Logging threads never block and never allocate: each line is copied as a binary record into a slot claimed with
+/// a single atomic increment, and the oldest records are overwritten when the ring is full.
+/// Records are formatted only when they are dumped, one at a time, so a dump does not hold all lines in memory.
+/// </summary>
+/// <remarks>Like <see cref="EventLogger"/>, the ring logger receives the process wide log callback of the SDK,
+/// so the two cannot be used at the same time. Lines longer than <see cref="MaxLineLength"/> bytes are truncated.
+/// While filters are set, each line reads the current filters through a shared pointer; where the standard library
+/// has no std::atomic&lt;std::shared_ptr&gt;, that read takes a short lock.</remarks>
+class RingLogger
+{
+public:
+
+    /// <summary>
+    /// Maximum number of bytes kept per line.
+    /// </summary>
+    static constexpr size_t MaxLineLength = 240;
+
+    /// <summary>
+    /// Maximum number of filters.
+    /// </summary>
+    static constexpr size_t MaxFilters = 8;
+
+    /// <summary>
+    /// Counters of the ring logger.
+    /// </summary>
+    struct Counters
+    {
+        /// <summary>
+        /// Number of lines logged per level, indexed by <see cref="Level"/>.
+        /// </summary>
+        uint64_t lines[4];
+
+        /// <summary>
+        /// Number of lines that matched each filter, in the order the filters were set.
+        /// </summary>
+        uint64_t filterMatches[MaxFilters];
+
+        /// <summary>
+        /// Number of lines dropped because they matched no filter.
+        /// </summary>
+        uint64_t filteredOut;
+
+        /// <summary>
+        /// Number of lines truncated to <see cref="MaxLineLength"/>.
+        /// </summary>
+        uint64_t truncated;
+
+        /// <summary>
+        /// Number of lines dropped because a producer a full lap ahead or behind held their slot.
+        /// </summary>
+        uint64_t dropped;
+    };
+
+    /// <summary>
+    /// Starts logging into the ring buffer.
+    /// </summary>
+    /// <param name="capacity">Number of lines kept, rounded up to a power of two. Only the first call allocates the ring;
+    /// later calls keep its capacity.</param>
+    static void Start(size_t capacity = 2048)
+    {
+        auto ring = Ring::Instance(capacity);
+        ring->accepting.store(true, std::memory_order_release);
+        AZAC_THROW_ON_FAIL(diagnostics_logmessage_set_callback(LineLogged));
+    }
+
+    /// <summary>
+    /// Stops logging. The records stay in the ring buffer and can still be dumped.
+    /// </summary>
+    static void Stop()
+    {
+        AZAC_THROW_ON_FAIL(diagnostics_logmessage_set_callback(nullptr));
+        if (auto ring = Ring::Current())
+        {
+            ring->accepting.store(false, std::memory_order_release);
+        }
+    }
+
+    /// <summary>
+    /// Sets the level of the messages to be captured by the logger
+    /// </summary>
+    /// <param name="level">Maximum level of detail to be captured by the logger.</param>
+    static void SetLevel(Level level)
+    {
+        const auto levelStr = Details::LevelToString(level);
+        diagnostics_set_log_level("event", levelStr);
+    }
+
+    /// <summary>
+    /// Sets or clears filters. Once filters are set, only lines containing at least one of them are kept.
+    /// The match is case sensitive. Must be called while the logger is stopped.
+    /// </summary>
+    /// <param name="filters">Up to <see cref="MaxFilters"/> filters, or an empty list to clear previously set filters.</param>
+    /// <remarks>A native line still in flight after <see cref="Stop"/> keeps using the filters it read.</remarks>
+    static void SetFilters(std::initializer_list<std::string> filters = {})
+    {
+        auto ring = Ring::Current();
+        AZAC_THROW_HR_IF(AZAC_ERR_INVALID_STATE, ring != nullptr && ring->accepting.load(std::memory_order_acquire));
+        AZAC_THROW_HR_IF(AZAC_ERR_INVALID_ARG, filters.size() > MaxFilters);
+
+        auto& filterSet = FilterSet::Instance();
+        filterSet.patterns.store(filters.size() > 0 ? std::make_shared<const std::vector<std::string>>(filters) : nullptr);
+        filterSet.active.store(filters.size() > 0, std::memory_order_release);
+        for (auto& count : filterSet.matches)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /// <summary>
+    /// Adds a line from application code to the ring buffer.
+    /// </summary>
+    /// <param name="level">Level of the line.</param>
+    /// <param name="line">The line; need not be null terminated.</param>
+    /// <param name="length">Length of the line in bytes.</param>
+    /// <remarks>The line is dropped while the logger is stopped.</remarks>
+    static void Log(Level level, const char* line, size_t length)
+    {
+        auto ring = Ring::Current();
+        if (ring != nullptr && ring->accepting.load(std::memory_order_acquire))
+        {
+            ring->Append(level, line, length);
+        }
+    }
+
+    /// <summary>
+    /// Writes the records in the ring buffer, oldest first, formatting one record at a time.
+    /// Records overwritten while the dump runs are skipped.
+    /// </summary>
+    /// <param name="outStream">The stream to write to.</param>
+    static void Dump(std::ostream& outStream)
+    {
+        if (auto ring = Ring::Current())
+        {
+            ring->Dump(outStream);
+        }
+    }
+
+    /// <summary>
+    /// Writes the records in the ring buffer to a file, see <see cref="Dump(std::ostream&)"/>.
+    /// </summary>
+    /// <param name="filePath">Path of the file; it is overwritten.</param>
+    static void Dump(const std::string& filePath)
+    {
+        AZAC_THROW_HR_IF(AZAC_ERR_INVALID_ARG, filePath.empty());
+
+        std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+        AZAC_THROW_HR_IF(AZAC_ERR_FILE_OPEN_FAILED, !file.is_open());
+        Dump(file);
+    }
+
+    /// <summary>
+    /// Gets the counters.
+    /// </summary>
+    /// <returns>The counters; all zero before the first start.</returns>
+    static Counters GetCounters()
+    {
+        Counters counters{};
+        auto& filterSet = FilterSet::Instance();
+        for (size_t i = 0; i < MaxFilters; i++)
+        {
+            counters.filterMatches[i] = filterSet.matches[i].load(std::memory_order_relaxed);
+        }
+
+        if (auto ring = Ring::Current())
+        {
+            for (size_t i = 0; i < 4; i++)
+            {
+                counters.lines[i] = ring->lineCounts[i].load(std::memory_order_relaxed);
+            }
+            counters.filteredOut = ring->filteredOut.load(std::memory_order_relaxed);
+            counters.truncated = ring->truncated.load(std::memory_order_relaxed);
+            counters.dropped = ring->dropped.load(std::memory_order_relaxed);
+        }
+        return counters;
+    }
+
+private:
+
+    static constexpr size_t WordsPerLine = (MaxLineLength + 7) / 8;
+
+    // The text is kept in atomic words so that a dump racing with a producer that overwrites the slot reads stale
+    // bytes instead of causing a data race; the sequence number then tells the dump to discard them.
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{ 0 };
+        std::atomic<uint64_t> meta{ 0 };
+        std::atomic<int64_t> time{ 0 };
+        std::atomic<uint64_t> text[WordsPerLine];
+    };
+
+    // Kept apart from the ring so that filters can be set before the first start without allocating the ring.
+    // The patterns are an immutable snapshot replaced as a whole, so a line being filtered on an SDK thread never
+    // sees them change; active spares lines the load of the snapshot while no filter is set.
+    struct FilterSet
+    {
+        static FilterSet& Instance()
+        {
+            static FilterSet* filterSet = new FilterSet();
+            return *filterSet;
+        }
+
+        Details::AtomicSharedPtr<const std::vector<std::string>> patterns;
+        std::atomic<bool> active{ false };
+        std::atomic<uint64_t> matches[MaxFilters] = {};
+    };
+
+    struct Ring
+    {
+        explicit Ring(size_t capacity) : slots(capacity), mask(capacity - 1), start(std::chrono::steady_clock::now())
+        {
+        }
+
+        static Ring* Instance(size_t capacity)
+        {
+            // Intentionally leaked: the native callback may still run on another thread while the process exits.
+            static Ring* ring = new Ring(RoundUpToPowerOfTwo(capacity));
+            Holder().store(ring, std::memory_order_release);
+            return ring;
+        }
+
+        static Ring* Current()
+        {
+            return Holder().load(std::memory_order_acquire);
+        }
+
+        static std::atomic<Ring*>& Holder()
+        {
+            static std::atomic<Ring*> holder{ nullptr };
+            return holder;
+        }
+
+        static size_t RoundUpToPowerOfTwo(size_t value)
+        {
+            size_t capacity = 1;
+            while (capacity < value)
+            {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        void Append(Level level, const char* line, size_t length)
+        {
+            uint32_t filterMask = 0;
+            auto& filterSet = FilterSet::Instance();
+            auto patterns = filterSet.active.load(std::memory_order_acquire) ? filterSet.patterns.load() : nullptr;
+            if (patterns != nullptr)
+            {
+                for (size_t i = 0; i < patterns->size(); i++)
+                {
+                    if (Contains(line, length, (*patterns)[i]))
+                    {
+                        filterMask |= 1u << i;
+                        filterSet.matches[i].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                if (filterMask == 0)
+                {
+                    filteredOut.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+
+            lineCounts[static_cast<size_t>(level) & 3].fetch_add(1, std::memory_order_relaxed);
+            if (length > MaxLineLength)
+            {
+                length = MaxLineLength;
+                truncated.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            auto ticket = head.fetch_add(1, std::memory_order_relaxed);
+            auto& slot = slots[ticket & mask];
+
+            // The sequence number stamps the slot with the ticket of its record: 2 * ticket + 1 while it is written and
+            // 2 * ticket + 2 once it is complete. A producer takes the slot only from a complete older record, so no
+            // two producers ever write a slot at the same time; one lapped by or lapping another drops its line.
+            auto writing = 2 * ticket + 1;
+            auto current = slot.sequence.load(std::memory_order_relaxed);
+            do
+            {
+                if (current > writing || (current & 1) != 0)
+                {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            } while (!slot.sequence.compare_exchange_weak(current, writing, std::memory_order_acquire, std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot.meta.store(static_cast<uint64_t>(level) | (static_cast<uint64_t>(length) << 8) | (static_cast<uint64_t>(filterMask) << 32), std::memory_order_relaxed);
+            slot.time.store(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+            for (size_t word = 0; word * 8 < length; word++)
+            {
+                uint64_t value = 0;
+                std::memcpy(&value, line + word * 8, std::min<size_t>(8, length - word * 8));
+                slot.text[word].store(value, std::memory_order_relaxed);
+            }
+
+            slot.sequence.store(writing + 1, std::memory_order_release);
+        }
+
+        void Dump(std::ostream& outStream) const
+        {
+            auto newest = head.load(std::memory_order_acquire);
+            auto oldest = newest > slots.size() ? newest - slots.size() : 0;
+
+            char text[WordsPerLine * 8 + 1];
+            char prefix[64];
+            for (auto ticket = oldest; ticket < newest; ticket++)
+            {
+                const auto& slot = slots[ticket & mask];
+                auto expected = 2 * ticket + 2;
+                if (slot.sequence.load(std::memory_order_acquire) != expected)
+                {
+                    continue;
+                }
+
+                auto meta = slot.meta.load(std::memory_order_relaxed);
+                auto time = slot.time.load(std::memory_order_relaxed);
+                auto length = static_cast<size_t>((meta >> 8) & 0xFFFF);
+                for (size_t word = 0; word * 8 < length; word++)
+                {
+                    auto value = slot.text[word].load(std::memory_order_relaxed);
+                    std::memcpy(text + word * 8, &value, 8);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != expected)
+                {
+                    continue;
+                }
+
+                auto level = static_cast<Level>(meta & 0xFF);
+                std::snprintf(prefix, sizeof(prefix), "[%lld.%06lld] [%s] ", static_cast<long long>(time / 1000000), static_cast<long long>(time % 1000000), Details::LevelToString(level));
+                outStream << prefix;
+                outStream.write(text, static_cast<std::streamsize>(length));
+                if (length == 0 || text[length - 1] != '\n')
+                {
+                    outStream << '\n';
+                }
+            }
+        }
+
+        static bool Contains(const char* line, size_t length, const std::string& filter)
+        {
+            if (filter.empty() || filter.size() > length)
+            {
+                return filter.empty();
+            }
+
+            for (size_t i = 0; i + filter.size() <= length; i++)
+            {
+                if (line[i] == filter[0] && std::memcmp(line + i, filter.data(), filter.size()) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<Slot> slots;
+        const uint64_t mask;
+        const std::chrono::steady_clock::time_point start;
+        std::atomic<uint64_t> head{ 0 };
+        std::atomic<bool> accepting{ false };
+
+        std::atomic<uint64_t> lineCounts[4] = {};
+        std::atomic<uint64_t> filteredOut{ 0 };
+        std::atomic<uint64_t> truncated{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+    };
+
+    // The native lines carry their level only in the trace title, e.g. "SPX_TRACE_WARNING:", near the start of the line.
+    static Level LevelOfLine(const char* line, size_t length)
+    {
+        auto searched = std::min<size_t>(length, 128);
+        if (Ring::Contains(line, searched, "TRACE_ERROR"))
+        {
+            return Level::Error;
+        }
+        if (Ring::Contains(line, searched, "TRACE_WARNING"))
+        {
+            return Level::Warning;
+        }
+        if (Ring::Contains(line, searched, "TRACE_INFO"))
+        {
+            return Level::Info;
+        }
+        return Level::Verbose;
+    }
+
+    static void LineLogged(const char* line)
+    {
+        auto ring = Ring::Current();
+        if (ring != nullptr && line != nullptr && ring->accepting.load(std::memory_order_acquire))
+        {
+            auto length = std::strlen(line);
+            ring->Append(LevelOfLine(line, length), line, length);
+        }
+    }
+};
+
+}}}}}
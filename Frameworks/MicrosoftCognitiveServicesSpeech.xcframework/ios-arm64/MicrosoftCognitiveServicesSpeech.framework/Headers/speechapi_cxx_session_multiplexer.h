@@ -0,0 +1,1190 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_session_multiplexer.h: Public API declarations for recognizing batches of sessions over shared connections
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_eventsignal.h"
+#include "speechapi_cxx_speech_config.h"
+#include "speechapi_cxx_audio_config.h"
+#include "speechapi_cxx_audio_stream.h"
+#include "speechapi_cxx_speech_recognizer.h"
+#include "speechapi_cxx_connection.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+class BatchSessionMultiplexer;
+class MultiplexedSession;
+
+/// <summary>
+/// Event arguments of the events of a <see cref="MultiplexedSession"/>.
+/// </summary>
+class MultiplexedSessionEventArgs
+{
+public:
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="sessionId">Identifier of the session.</param>
+    /// <param name="result">The recognition result, or nullptr.</param>
+    /// <param name="offset">Offset of the result in the audio of the session, in ticks.</param>
+    MultiplexedSessionEventArgs(uint64_t sessionId, std::shared_ptr<SpeechRecognitionResult> result, uint64_t offset) :
+        SessionId(sessionId),
+        Result(std::move(result)),
+        Offset(offset)
+    {
+    }
+
+    /// <summary>
+    /// Identifier of the session, as returned by <see cref="MultiplexedSession::GetId"/>.
+    /// </summary>
+    const uint64_t SessionId;
+
+    /// <summary>
+    /// The recognition result. Null for <see cref="MultiplexedSession::SessionStopped"/>.
+    /// The offset of the result itself is relative to the shared connection; use <see cref="Offset"/> instead.
+    /// </summary>
+    const std::shared_ptr<SpeechRecognitionResult> Result;
+
+    /// <summary>
+    /// Offset of the result in the audio written to the session, in ticks (100 nanoseconds).
+    /// </summary>
+    const uint64_t Offset;
+
+private:
+
+    DISABLE_DEFAULT_CTORS(MultiplexedSessionEventArgs);
+};
+
+/// <summary>
+/// Event arguments of <see cref="MultiplexedSession::Canceled"/>.
+/// </summary>
+class MultiplexedSessionCanceledEventArgs final : public MultiplexedSessionEventArgs
+{
+private:
+
+    std::shared_ptr<CancellationDetails> m_cancellation;
+
+public:
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="sessionId">Identifier of the session.</param>
+    /// <param name="result">The canceled result of the connection the session was sent on.</param>
+    /// <param name="offset">Offset of the end of the audio of the session taken by the connection, in ticks.</param>
+    MultiplexedSessionCanceledEventArgs(uint64_t sessionId, std::shared_ptr<SpeechRecognitionResult> result, uint64_t offset) :
+        MultiplexedSessionEventArgs(sessionId, result, offset),
+        m_cancellation(CancellationDetails::FromResult(result)),
+        Reason(m_cancellation->Reason),
+        ErrorCode(m_cancellation->ErrorCode),
+        ErrorDetails(m_cancellation->ErrorDetails)
+    {
+    }
+
+    /// <summary>
+    /// The reason the connection was canceled.
+    /// </summary>
+    const CancellationReason Reason;
+
+    /// <summary>
+    /// The error code of the connection.
+    /// </summary>
+    const CancellationErrorCode ErrorCode;
+
+    /// <summary>
+    /// The error message of the connection.
+    /// </summary>
+    const SPXSTRING ErrorDetails;
+
+    /// <summary>
+    /// Gets the cancellation details of the connection.
+    /// </summary>
+    /// <returns>The cancellation details.</returns>
+    std::shared_ptr<CancellationDetails> GetCancellationDetails() const { return m_cancellation; }
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+class MultiplexerChannel;
+
+// Part of the audio of one session written to a channel during one turn, in bytes.
+struct MultiplexerSegment
+{
+    uint64_t ChannelBegin;
+    uint64_t ChannelEnd;
+    uint64_t SessionBegin;
+    std::shared_ptr<MultiplexedSession> Session;
+};
+
+// Runs the work items of one owner one at a time, in order, on a shared executor.
+class MultiplexerStrand
+{
+public:
+
+    explicit MultiplexerStrand(AsyncExecutor* executor) : m_executor(executor) {}
+
+    void Post(std::function<void()> work, std::shared_ptr<void> keepAlive)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(work));
+            if (m_running)
+            {
+                return;
+            }
+            m_running = true;
+        }
+        m_executor->Post([this, keepAlive]() { Drain(); });
+    }
+
+private:
+
+    void Drain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_queue.empty())
+        {
+            auto work = std::move(m_queue.front());
+            m_queue.pop_front();
+            lock.unlock();
+            work();
+            lock.lock();
+        }
+        m_running = false;
+    }
+
+    AsyncExecutor* m_executor;
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_queue;
+    bool m_running = false;
+};
+
+// Checks the channels that went idle once the idle timeout has passed, on one thread shared by the channels.
+class MultiplexerIdleTimer
+{
+public:
+
+    explicit MultiplexerIdleTimer(std::chrono::milliseconds timeout) : m_timeout(timeout), m_thread([this]() { Run(); }) {}
+
+    ~MultiplexerIdleTimer()
+    {
+        Stop();
+    }
+
+    std::chrono::milliseconds GetTimeout() const { return m_timeout; }
+
+    void Schedule(std::chrono::steady_clock::time_point deadline, std::weak_ptr<MultiplexerChannel> channel)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_stopped)
+        {
+            m_entries.emplace(deadline, std::move(channel));
+            m_changed.notify_one();
+        }
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopped)
+            {
+                return;
+            }
+            m_stopped = true;
+            m_entries.clear();
+            m_changed.notify_one();
+        }
+        m_thread.join();
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(MultiplexerIdleTimer);
+
+    void Run();
+
+    const std::chrono::milliseconds m_timeout;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::multimap<std::chrono::steady_clock::time_point, std::weak_ptr<MultiplexerChannel>> m_entries;
+    bool m_stopped = false;
+    std::thread m_thread;
+};
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// A logical recognition session of a <see cref="BatchSessionMultiplexer"/>.
+/// </summary>
+/// <remarks>
+/// The audio must be 16 kHz, 16-bit, mono PCM. Events are raised in order on the worker threads of the multiplexer,
+/// never concurrently for the same session, and never on the SDK callback thread that received the result.
+/// </remarks>
+class MultiplexedSession : public std::enable_shared_from_this<MultiplexedSession>
+{
+public:
+
+    /// <summary>
+    /// Writes audio to the session. The audio is sent once a full turn is buffered, or when the session is closed.
+    /// Audio written after <see cref="Canceled"/> is discarded.
+    /// </summary>
+    /// <param name="dataBuffer">The audio.</param>
+    /// <param name="size">Size of the audio, in bytes.</param>
+    void Write(const uint8_t* dataBuffer, uint32_t size);
+
+    /// <summary>
+    /// Ends the audio of the session. <see cref="SessionStopped"/> is raised once the audio has been recognized, which
+    /// is known when the connection recognizes the audio of a later turn, when the connection has been idle for the
+    /// idle timeout of the multiplexer, or when the multiplexer is stopped.
+    /// </summary>
+    void Close();
+
+    /// <summary>
+    /// Gets the identifier of the session, unique within its multiplexer.
+    /// </summary>
+    /// <returns>The identifier.</returns>
+    uint64_t GetId() const { return m_id; }
+
+    /// <summary>
+    /// Signal for events containing intermediate recognition results.
+    /// </summary>
+    EventSignal<const MultiplexedSessionEventArgs&> Recognizing;
+
+    /// <summary>
+    /// Signal for events containing final recognition results, including NoMatch results.
+    /// </summary>
+    EventSignal<const MultiplexedSessionEventArgs&> Recognized;
+
+    /// <summary>
+    /// Signal raised when the connection of the session fails while it holds audio of the session that has not been
+    /// recognized. That audio is lost, and <see cref="SessionStopped"/> follows. Sessions of the failed connection
+    /// with no audio in flight move to another connection with their buffered audio instead, without an event.
+    /// </summary>
+    EventSignal<const MultiplexedSessionCanceledEventArgs&> Canceled;
+
+    /// <summary>
+    /// Signal raised once after the session is closed and all of its audio has been recognized, after
+    /// <see cref="Canceled"/>, or when the multiplexer is stopped.
+    /// </summary>
+    EventSignal<const MultiplexedSessionEventArgs&> SessionStopped;
+
+    /*! \cond PROTECTED */
+
+    MultiplexedSession(uint64_t id, std::shared_ptr<Details::MultiplexerChannel> channel, AsyncExecutor* executor) :
+        m_id(id),
+        m_delivery(executor),
+        m_channel(std::move(channel))
+    {
+    }
+
+    ~MultiplexedSession();
+
+    /*! \endcond */
+
+private:
+
+    DISABLE_COPY_AND_MOVE(MultiplexedSession);
+
+    friend class Details::MultiplexerChannel;
+    friend class BatchSessionMultiplexer;
+
+    // Moves up to maxBytes of buffered audio into turn. Returns true if the session must stay queued for another turn.
+    bool TakeTurn(size_t maxBytes, std::vector<uint8_t>& turn, uint64_t& sessionBegin)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto size = std::min(maxBytes, m_pending.size());
+        if (!m_closed)
+        {
+            size &= ~size_t(1);
+        }
+        turn.assign(m_pending.begin(), m_pending.begin() + size);
+        m_pending.erase(m_pending.begin(), m_pending.begin() + size);
+        sessionBegin = m_sessionBytes;
+        m_sessionBytes += size;
+        m_outstanding++;
+
+        m_queued = m_pending.size() >= maxBytes || (m_closed && !m_pending.empty());
+        return m_queued;
+    }
+
+    void Deliver(EventSignal<const MultiplexedSessionEventArgs&> MultiplexedSession::* signal, std::shared_ptr<SpeechRecognitionResult> result, uint64_t offset)
+    {
+        auto self = shared_from_this();
+        m_delivery.Post([this, signal, result, offset]() {
+            MultiplexedSessionEventArgs e(m_id, result, offset);
+            (this->*signal).Signal(e);
+        }, self);
+    }
+
+    // Called when the recognizer has moved past a segment of the session.
+    void Acknowledge();
+
+    // Raises Canceled, then SessionStopped, unless the session has already stopped.
+    void Cancel(const std::shared_ptr<SpeechRecognitionResult>& cancellation);
+
+    // Moves the session from a failed channel to another one. Returns false if the other channel cannot take it.
+    bool MoveTo(Details::MultiplexerChannel* from, const std::shared_ptr<Details::MultiplexerChannel>& to);
+
+    // Raises SessionStopped if the session is closed and all of its audio has been recognized. Must be called with m_mutex held.
+    bool TryStop(bool force);
+
+    void RaiseStopped();
+
+    // Offset of the end of the audio taken from the session, in ticks. Must be called with m_mutex held.
+    uint64_t GetTicks() const;
+
+    const uint64_t m_id;
+    Details::MultiplexerStrand m_delivery;
+
+    // The channel changes only when its connection fails; it is read and changed with m_mutex held.
+    std::mutex m_mutex;
+    std::shared_ptr<Details::MultiplexerChannel> m_channel;
+    std::vector<uint8_t> m_pending;
+    uint64_t m_sessionBytes = 0;
+    size_t m_outstanding = 0;
+    bool m_queued = false;
+    bool m_closed = false;
+    bool m_stopped = false;
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+// One shared connection: a push stream feeding a recognizer in continuous recognition, written one session turn at a time.
+class MultiplexerChannel : public std::enable_shared_from_this<MultiplexerChannel>
+{
+public:
+
+    static constexpr uint64_t BytesPerSecond = 32000;
+    static constexpr uint64_t TicksPerSecond = 10000000;
+
+    // Moves a session of a failed channel to another channel; returns false if no channel can take it.
+    using Reassign = std::function<bool(MultiplexerChannel* from, const std::shared_ptr<MultiplexedSession>& session)>;
+
+    MultiplexerChannel(AsyncExecutor* executor, MultiplexerIdleTimer* idleTimer, size_t turnBytes, size_t separatorBytes, Reassign reassign) :
+        m_executor(executor),
+        m_idleTimer(idleTimer),
+        m_turnBytes(turnBytes),
+        m_separator(separatorBytes, 0),
+        m_reassign(std::move(reassign))
+    {
+    }
+
+    std::future<void> Start(const std::shared_ptr<SpeechConfig>& config, std::chrono::milliseconds silenceTimeout)
+    {
+        m_stream = Audio::AudioInputStream::CreatePushStream();
+        m_recognizer = SpeechRecognizer::FromConfig(config, Audio::AudioConfig::FromStreamInput(m_stream));
+        m_recognizer->Properties.SetProperty(PropertyId::Speech_SegmentationSilenceTimeoutMs, std::to_string(silenceTimeout.count()));
+
+        m_recognizer->Recognizing.Connect([this](const SpeechRecognitionEventArgs& e) { Route(e.Result, false); });
+        m_recognizer->Recognized.Connect([this](const SpeechRecognitionEventArgs& e) { Route(e.Result, true); });
+        m_recognizer->Canceled.Connect([this](const SpeechRecognitionCanceledEventArgs& e) { SetCanceled(e.Result); });
+        m_recognizer->SessionStopped.Connect([this](const SessionEventArgs&) { SetEnded(); });
+
+        m_connection = Connection::FromRecognizer(m_recognizer);
+        m_connection->Open(true);
+        auto started = m_recognizer->StartContinuousRecognitionAsync();
+        m_started = true;
+        return started;
+    }
+
+    size_t GetLoad() const { return m_load; }
+
+    bool IsFailed()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_cancellation != nullptr;
+    }
+
+    size_t GetTurnBytes() const { return m_turnBytes; }
+
+    std::shared_ptr<MultiplexedSession> OpenSession(uint64_t id)
+    {
+        auto session = std::make_shared<MultiplexedSession>(id, shared_from_this(), m_executor);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_stopping);
+        if (m_cancellation != nullptr)
+        {
+            return nullptr;
+        }
+        m_sessions.emplace(id, session);
+        m_load++;
+        return session;
+    }
+
+    // Called with the mutex of the session held. Once the connection has failed, Fail moves the session instead.
+    void Enqueue(std::shared_ptr<MultiplexedSession> session)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_cancellation != nullptr)
+            {
+                return;
+            }
+            m_ready.push_back(std::move(session));
+            if (m_pumping)
+            {
+                return;
+            }
+            m_pumping = true;
+        }
+        PostPump();
+    }
+
+    // Takes a session over from a failed channel. Called with the mutex of the session held.
+    bool Adopt(std::shared_ptr<MultiplexedSession> session, bool queued)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping || m_cancellation != nullptr)
+            {
+                return false;
+            }
+            m_sessions.emplace(session->GetId(), session);
+            m_load++;
+            if (!queued)
+            {
+                return true;
+            }
+            m_ready.push_back(std::move(session));
+            if (m_pumping)
+            {
+                return true;
+            }
+            m_pumping = true;
+        }
+        PostPump();
+        return true;
+    }
+
+    void Release(uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_sessions.erase(id) != 0)
+        {
+            m_load--;
+        }
+    }
+
+    // Closes the sessions and waits for the end of their audio. Called for every channel before Finish.
+    void Drain()
+    {
+        if (!m_started)
+        {
+            return;
+        }
+
+        std::vector<std::shared_ptr<MultiplexedSession>> sessions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& entry : m_sessions)
+            {
+                if (auto session = entry.second.lock())
+                {
+                    sessions.push_back(std::move(session));
+                }
+            }
+        }
+        for (auto& session : sessions)
+        {
+            session->Close();
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_changed.wait(lock, [this]() { return !m_pumping; });
+        lock.unlock();
+
+        m_stream->Close();
+    }
+
+    // Stops the recognizer once it has reached the end of the stream, then stops the remaining sessions. If the
+    // connection failed while stopping, the sessions still running lost their audio and are canceled instead.
+    void Finish()
+    {
+        if (!m_started)
+        {
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_changed.wait(lock, [this]() { return m_ended; });
+        }
+        m_recognizer->StopContinuousRecognitionAsync().get();
+        m_connection->Close();
+
+        std::shared_ptr<SpeechRecognitionResult> cancellation;
+        std::deque<MultiplexerSegment> segments;
+        std::vector<std::shared_ptr<MultiplexedSession>> sessions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            cancellation = m_cancellation;
+            segments.swap(m_segments);
+            for (auto& entry : m_sessions)
+            {
+                if (auto session = entry.second.lock())
+                {
+                    sessions.push_back(std::move(session));
+                }
+            }
+        }
+        for (auto& segment : segments)
+        {
+            if (cancellation != nullptr)
+            {
+                segment.Session->Cancel(cancellation);
+                continue;
+            }
+            segment.Session->Acknowledge();
+        }
+        for (auto& session : sessions)
+        {
+            if (cancellation != nullptr)
+            {
+                session->Cancel(cancellation);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(session->m_mutex);
+            if (session->TryStop(true))
+            {
+                lock.unlock();
+                session->RaiseStopped();
+            }
+        }
+
+        m_connection.reset();
+        m_recognizer.reset();
+        m_stream.reset();
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(MultiplexerChannel);
+
+    friend class MultiplexerIdleTimer;
+
+    void PostPump()
+    {
+        auto self = shared_from_this();
+        m_executor->Post([self]() { self->Pump(); });
+    }
+
+    void PostFail()
+    {
+        auto self = shared_from_this();
+        m_executor->Post([self]() { self->Fail(); });
+    }
+
+    // Writes one turn, then posts itself again while sessions are ready, so that channels share the workers fairly.
+    // Once no session is ready, schedules the idle check. Once the connection has failed, runs Fail instead.
+    void Pump()
+    {
+        std::shared_ptr<MultiplexedSession> session;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_cancellation == nullptr)
+            {
+                session = std::move(m_ready.front());
+                m_ready.pop_front();
+            }
+        }
+        if (session == nullptr)
+        {
+            Fail();
+            return;
+        }
+
+        // A turn taken after the connection failed is in the segments, so its session is canceled with the others.
+        uint64_t sessionBegin = 0;
+        bool failed = false;
+        auto requeue = session->TakeTurn(m_turnBytes, m_turn, sessionBegin);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_segments.push_back({ m_channelBytes, m_channelBytes + m_turn.size(), sessionBegin, session });
+            m_channelBytes += m_turn.size() + m_separator.size();
+            if (requeue)
+            {
+                m_ready.push_back(session);
+            }
+            failed = m_cancellation != nullptr;
+        }
+
+        if (!failed)
+        {
+            if (!m_turn.empty())
+            {
+                m_stream->Write(m_turn.data(), static_cast<uint32_t>(m_turn.size()));
+            }
+            m_stream->Write(m_separator.data(), static_cast<uint32_t>(m_separator.size()));
+        }
+
+        bool more = false;
+        bool scheduleIdle = false;
+        std::chrono::steady_clock::time_point idleDeadline;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastActivity = std::chrono::steady_clock::now();
+            more = !m_ready.empty() || m_cancellation != nullptr;
+            if (!more)
+            {
+                m_pumping = false;
+                m_changed.notify_all();
+                scheduleIdle = !m_idleScheduled;
+                m_idleScheduled = true;
+                idleDeadline = m_lastActivity + m_idleTimer->GetTimeout();
+            }
+        }
+
+        if (more)
+        {
+            PostPump();
+        }
+        else if (scheduleIdle)
+        {
+            m_idleTimer->Schedule(idleDeadline, shared_from_this());
+        }
+    }
+
+    // Called by the idle timer. Without a later turn, no result acknowledges the last segments, so once neither
+    // audio nor results have passed for the idle timeout, the recognizer is taken to be done with them.
+    void CheckIdle()
+    {
+        std::deque<MultiplexerSegment> segments;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pumping || m_segments.empty() || m_cancellation != nullptr)
+            {
+                m_idleScheduled = false;
+                return;
+            }
+
+            auto deadline = m_lastActivity + m_idleTimer->GetTimeout();
+            if (std::chrono::steady_clock::now() < deadline)
+            {
+                m_idleTimer->Schedule(deadline, shared_from_this());
+                return;
+            }
+            segments.swap(m_segments);
+            m_idleScheduled = false;
+        }
+
+        for (auto& segment : segments)
+        {
+            segment.Session->Acknowledge();
+        }
+    }
+
+    // Runs on the SDK callback thread of the recognizer; the session events are posted to the session's strand.
+    void Route(const std::shared_ptr<SpeechRecognitionResult>& result, bool final)
+    {
+        auto offset = result->Offset() * BytesPerSecond / TicksPerSecond;
+
+        std::shared_ptr<MultiplexedSession> session;
+        uint64_t sessionOffset = 0;
+        std::vector<std::shared_ptr<MultiplexedSession>> acknowledged;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastActivity = std::chrono::steady_clock::now();
+            auto it = std::upper_bound(m_segments.begin(), m_segments.end(), offset,
+                [](uint64_t value, const MultiplexerSegment& segment) { return value < segment.ChannelBegin; });
+            if (it == m_segments.begin())
+            {
+                return;
+            }
+            --it;
+            session = it->Session;
+            sessionOffset = (it->SessionBegin + offset - it->ChannelBegin) * TicksPerSecond / BytesPerSecond;
+
+            // A final result in a segment means the recognizer is done with the segments before it.
+            auto previous = final ? it - m_segments.begin() : 0;
+            for (; previous > 0 && m_segments.front().ChannelEnd <= offset; previous--)
+            {
+                acknowledged.push_back(std::move(m_segments.front().Session));
+                m_segments.pop_front();
+            }
+        }
+
+        session->Deliver(final ? &MultiplexedSession::Recognized : &MultiplexedSession::Recognizing, result, sessionOffset);
+        for (auto& previous : acknowledged)
+        {
+            previous->Acknowledge();
+        }
+    }
+
+    void SetEnded()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ended = true;
+        m_changed.notify_all();
+    }
+
+    // Runs on the SDK callback thread. A cancellation other than the end of the stream closed by Drain means the
+    // connection failed: Fail runs in place of the next turn, or at once if no turn is running.
+    void SetCanceled(const std::shared_ptr<SpeechRecognitionResult>& result)
+    {
+        bool post = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ended = true;
+            m_changed.notify_all();
+            if (m_cancellation != nullptr || CancellationDetails::FromResult(result)->Reason == CancellationReason::EndOfStream)
+            {
+                return;
+            }
+            m_cancellation = result;
+            if (!m_pumping && !m_stopping)
+            {
+                m_pumping = post = true;
+            }
+        }
+        if (post)
+        {
+            PostFail();
+        }
+    }
+
+    // Runs in place of Pump once the connection has failed. The sessions with segments in flight lost that audio and
+    // are canceled; the others move to another channel with their buffered audio.
+    void Fail()
+    {
+        std::shared_ptr<SpeechRecognitionResult> cancellation;
+        std::deque<MultiplexerSegment> segments;
+        std::vector<std::shared_ptr<MultiplexedSession>> sessions;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            cancellation = m_cancellation;
+            segments.swap(m_segments);
+            m_ready.clear();
+            for (auto& entry : m_sessions)
+            {
+                if (auto session = entry.second.lock())
+                {
+                    sessions.push_back(std::move(session));
+                }
+            }
+            m_sessions.clear();
+            m_load = 0;
+        }
+
+        for (auto& segment : segments)
+        {
+            segment.Session->Cancel(cancellation);
+        }
+        for (auto& session : sessions)
+        {
+            if (!m_reassign(this, session))
+            {
+                session->Cancel(cancellation);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pumping = false;
+        m_changed.notify_all();
+    }
+
+    AsyncExecutor* m_executor;
+    MultiplexerIdleTimer* m_idleTimer;
+    const size_t m_turnBytes;
+    std::vector<uint8_t> m_separator;
+    std::vector<uint8_t> m_turn;
+    Reassign m_reassign;
+
+    std::shared_ptr<Audio::PushAudioInputStream> m_stream;
+    std::shared_ptr<SpeechRecognizer> m_recognizer;
+    std::shared_ptr<Connection> m_connection;
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::unordered_map<uint64_t, std::weak_ptr<MultiplexedSession>> m_sessions;
+    std::deque<std::shared_ptr<MultiplexedSession>> m_ready;
+    std::deque<MultiplexerSegment> m_segments;
+    uint64_t m_channelBytes = 0;
+    std::chrono::steady_clock::time_point m_lastActivity;
+    std::atomic<size_t> m_load { 0 };
+    std::shared_ptr<SpeechRecognitionResult> m_cancellation;
+    bool m_started = false;
+    bool m_pumping = false;
+    bool m_idleScheduled = false;
+    bool m_stopping = false;
+    bool m_ended = false;
+};
+
+inline void MultiplexerIdleTimer::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopped)
+    {
+        if (m_entries.empty())
+        {
+            m_changed.wait(lock);
+            continue;
+        }
+
+        auto next = m_entries.begin();
+        if (std::chrono::steady_clock::now() < next->first)
+        {
+            m_changed.wait_until(lock, next->first);
+            continue;
+        }
+
+        auto channel = next->second.lock();
+        m_entries.erase(next);
+        lock.unlock();
+        if (channel != nullptr)
+        {
+            channel->CheckIdle();
+        }
+        channel.reset();
+        lock.lock();
+    }
+}
+
+}
+
+/*! \endcond */
+
+inline MultiplexedSession::~MultiplexedSession()
+{
+    m_channel->Release(m_id);
+}
+
+// The session is enqueued with m_mutex held, so that it cannot move to another channel in between.
+inline void MultiplexedSession::Write(const uint8_t* dataBuffer, uint32_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_closed);
+    if (m_stopped)
+    {
+        return;
+    }
+    m_pending.insert(m_pending.end(), dataBuffer, dataBuffer + size);
+    if (!m_queued && m_pending.size() >= m_channel->GetTurnBytes())
+    {
+        m_queued = true;
+        m_channel->Enqueue(shared_from_this());
+    }
+}
+
+inline void MultiplexedSession::Close()
+{
+    bool stopped = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed)
+        {
+            return;
+        }
+        m_closed = true;
+        if (!m_queued && !m_pending.empty())
+        {
+            m_queued = true;
+            m_channel->Enqueue(shared_from_this());
+        }
+        stopped = TryStop(false);
+    }
+    if (stopped)
+    {
+        RaiseStopped();
+    }
+}
+
+inline void MultiplexedSession::Acknowledge()
+{
+    bool stopped = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_outstanding--;
+        stopped = TryStop(false);
+    }
+    if (stopped)
+    {
+        RaiseStopped();
+    }
+}
+
+inline bool MultiplexedSession::TryStop(bool force)
+{
+    if (m_stopped || (!force && (!m_closed || m_queued || m_outstanding != 0)))
+    {
+        return false;
+    }
+    m_stopped = true;
+    return true;
+}
+
+inline void MultiplexedSession::RaiseStopped()
+{
+    uint64_t offset = 0;
+    std::shared_ptr<Details::MultiplexerChannel> channel;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        offset = GetTicks();
+        channel = m_channel;
+    }
+    Deliver(&MultiplexedSession::SessionStopped, nullptr, offset);
+    channel->Release(m_id);
+}
+
+inline void MultiplexedSession::Cancel(const std::shared_ptr<SpeechRecognitionResult>& cancellation)
+{
+    uint64_t offset = 0;
+    std::shared_ptr<Details::MultiplexerChannel> channel;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopped)
+        {
+            return;
+        }
+        m_stopped = true;
+        m_queued = false;
+        m_pending.clear();
+        offset = GetTicks();
+        channel = m_channel;
+    }
+
+    auto self = shared_from_this();
+    m_delivery.Post([this, cancellation, offset]() {
+        MultiplexedSessionCanceledEventArgs e(m_id, cancellation, offset);
+        Canceled.Signal(e);
+    }, self);
+    Deliver(&MultiplexedSession::SessionStopped, nullptr, offset);
+    channel->Release(m_id);
+}
+
+inline bool MultiplexedSession::MoveTo(Details::MultiplexerChannel* from, const std::shared_ptr<Details::MultiplexerChannel>& to)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopped || m_channel.get() != from)
+    {
+        return true;
+    }
+    if (!to->Adopt(shared_from_this(), m_queued))
+    {
+        return false;
+    }
+    m_channel = to;
+    return true;
+}
+
+inline uint64_t MultiplexedSession::GetTicks() const
+{
+    return m_sessionBytes * Details::MultiplexerChannel::TicksPerSecond / Details::MultiplexerChannel::BytesPerSecond;
+}
+
+/// <summary>
+/// Recognizes a batch of recorded audio sessions, such as call recordings, through a bounded set of shared connections
+/// and worker threads. It is for offline transcription: it cannot keep up with live audio, as explained below.
+/// </summary>
+/// <remarks>
+/// A recognizer streams one audio stream over its connection, so sessions cannot be interleaved within a connection.
+/// Instead, each connection is time-shared: sessions buffer their audio, and each connection sends one turn of one
+/// session at a time, followed by a separator of silence longer than the segmentation silence timeout, so that no
+/// phrase spans two turns. Results are routed back to their session by their offset in the connection's audio.
+/// The trade-offs are:
+/// - A phrase longer than a turn, or crossing a turn boundary, is split in two results.
+/// - Audio is only sent once a full turn is buffered, which adds up to one turn of latency.
+/// - The audio of every session must be 16 kHz, 16-bit, mono PCM.
+/// - Throughput is bounded by the connections, not the sessions: the service recognizes the audio of a connection at
+///   about real time, and every turn carries a separator. A batch of N seconds of audio on M connections therefore
+///   takes about N * (turn + separator) / (turn * M) seconds. Live sessions do not fit: they would need more
+///   connections than sessions, 13 for 10 sessions with the default 2 s turns and 600 ms separators, so use one
+///   <see cref="SpeechRecognizer"/> per live stream instead.
+/// - The last turn of a connection is only known to be recognized once the connection has been idle for the idle
+///   timeout, so the last sessions to close receive <see cref="MultiplexedSession::SessionStopped"/> that much later.
+///   A result arriving after the timeout is dropped, so the timeout must cover the worst latency of the service.
+/// - If a connection fails, the sessions whose audio it holds receive <see cref="MultiplexedSession::Canceled"/>. Its
+///   other sessions move to the remaining connections, and new sessions are no longer opened on it.
+/// The recognizer events are routed on the SDK callback threads. The per-session events run on the worker threads of
+/// the multiplexer, which are separate from the default <see cref="AsyncExecutor"/>. One more thread runs the idle
+/// timer.
+/// </remarks>
+class BatchSessionMultiplexer
+{
+public:
+
+    /// <summary>
+    /// Creates a multiplexer and starts continuous recognition on all of its connections.
+    /// </summary>
+    /// <param name="config">Speech configuration shared by the connections.</param>
+    /// <param name="connections">Number of connections.</param>
+    /// <param name="workerThreads">Maximum number of worker threads; 0 selects a default based on the hardware concurrency.</param>
+    /// <param name="turnDuration">Maximum duration of the audio of a session sent in one turn.</param>
+    /// <param name="separatorDuration">Silence sent between two turns; the segmentation silence timeout is set 100 ms shorter.</param>
+    /// <param name="idleTimeout">Time without audio sent or results received after which a connection takes the audio it
+    /// has sent as recognized; it must cover the latency of the service.</param>
+    /// <returns>The multiplexer.</returns>
+    static std::shared_ptr<BatchSessionMultiplexer> FromConfig(std::shared_ptr<SpeechConfig> config, uint32_t connections, uint32_t workerThreads = 0,
+        std::chrono::milliseconds turnDuration = std::chrono::seconds(2), std::chrono::milliseconds separatorDuration = std::chrono::milliseconds(600),
+        std::chrono::milliseconds idleTimeout = std::chrono::seconds(3))
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, config == nullptr || connections == 0);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, separatorDuration < std::chrono::milliseconds(200) || turnDuration < separatorDuration);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, idleTimeout <= std::chrono::milliseconds::zero());
+
+        auto multiplexer = std::shared_ptr<BatchSessionMultiplexer>(new BatchSessionMultiplexer(workerThreads, idleTimeout));
+        auto turnBytes = static_cast<size_t>(turnDuration.count() * Details::MultiplexerChannel::BytesPerSecond / 1000) & ~size_t(1);
+        auto separatorBytes = static_cast<size_t>(separatorDuration.count() * Details::MultiplexerChannel::BytesPerSecond / 1000) & ~size_t(1);
+
+        std::vector<std::future<void>> started;
+        for (uint32_t i = 0; i < connections; i++)
+        {
+            auto channel = std::make_shared<Details::MultiplexerChannel>(multiplexer->m_executor.get(), multiplexer->m_idleTimer.get(), turnBytes, separatorBytes,
+                [self = multiplexer.get()](Details::MultiplexerChannel* from, const std::shared_ptr<MultiplexedSession>& session) { return self->Reassign(from, session); });
+            multiplexer->m_channels.push_back(channel);
+            started.push_back(channel->Start(config, separatorDuration - std::chrono::milliseconds(100)));
+        }
+        for (auto& future : started)
+        {
+            future.get();
+        }
+        return multiplexer;
+    }
+
+    /// <summary>
+    /// Destructor. Stops the multiplexer, then joins the worker threads.
+    /// </summary>
+    ~BatchSessionMultiplexer()
+    {
+        Stop();
+        m_idleTimer.reset();
+        m_executor.reset();
+    }
+
+    /// <summary>
+    /// Opens a session on the least loaded connection that has not failed.
+    /// Throws if the multiplexer is stopped or every connection has failed.
+    /// </summary>
+    /// <returns>The session.</returns>
+    std::shared_ptr<MultiplexedSession> OpenSession()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_stopped);
+        for (;;)
+        {
+            auto channel = GetLeastLoaded();
+            SPX_THROW_HR_IF(SPXERR_INVALID_STATE, channel == nullptr);
+            // Null if the connection failed since GetLeastLoaded; it is then skipped.
+            if (auto session = channel->OpenSession(m_lastSessionId + 1))
+            {
+                m_lastSessionId++;
+                return session;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Closes every session, waits until their audio has been recognized, then stops the connections.
+    /// Every session receives <see cref="MultiplexedSession::SessionStopped"/> before this method returns or shortly after.
+    /// </summary>
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopped)
+            {
+                return;
+            }
+            m_stopped = true;
+        }
+        // Finish acknowledges whatever the idle timer has not.
+        m_idleTimer->Stop();
+        for (auto& channel : m_channels)
+        {
+            channel->Drain();
+        }
+        for (auto& channel : m_channels)
+        {
+            channel->Finish();
+        }
+    }
+
+    /// <summary>
+    /// Gets the number of connections.
+    /// </summary>
+    /// <returns>The number of connections.</returns>
+    size_t GetConnectionCount() const { return m_channels.size(); }
+
+    /// <summary>
+    /// Gets the number of worker threads currently running.
+    /// </summary>
+    /// <returns>The number of worker threads.</returns>
+    size_t GetThreadCount() const { return m_executor->GetThreadCount(); }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(BatchSessionMultiplexer);
+
+    BatchSessionMultiplexer(uint32_t workerThreads, std::chrono::milliseconds idleTimeout) :
+        m_executor(new ThreadPoolExecutor(workerThreads, workerThreads)),
+        m_idleTimer(new Details::MultiplexerIdleTimer(idleTimeout))
+    {
+    }
+
+    // Must be called with m_mutex held. Returns null if every connection has failed.
+    std::shared_ptr<Details::MultiplexerChannel> GetLeastLoaded() const
+    {
+        std::shared_ptr<Details::MultiplexerChannel> leastLoaded;
+        for (auto& channel : m_channels)
+        {
+            if (!channel->IsFailed() && (leastLoaded == nullptr || channel->GetLoad() < leastLoaded->GetLoad()))
+            {
+                leastLoaded = channel;
+            }
+        }
+        return leastLoaded;
+    }
+
+    // Called by a failed channel for each of its sessions with no audio in flight.
+    bool Reassign(Details::MultiplexerChannel* from, const std::shared_ptr<MultiplexedSession>& session)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopped)
+        {
+            return false;
+        }
+        auto channel = GetLeastLoaded();
+        return channel != nullptr && session->MoveTo(from, channel);
+    }
+
+    std::unique_ptr<ThreadPoolExecutor> m_executor;
+    std::unique_ptr<Details::MultiplexerIdleTimer> m_idleTimer;
+    std::vector<std::shared_ptr<Details::MultiplexerChannel>> m_channels;
+    std::mutex m_mutex;
+    uint64_t m_lastSessionId = 0;
+    bool m_stopped = false;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
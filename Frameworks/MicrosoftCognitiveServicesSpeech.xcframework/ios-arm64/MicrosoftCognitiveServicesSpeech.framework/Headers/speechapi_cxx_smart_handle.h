@@ -6,6 +6,7 @@
 //
 
 #pragma once
+#include <memory>
 #include "speechapi_cxx_common.h"
 
 
@@ -20,6 +21,10 @@ typedef SPXHR(SPXAPI_CALLTYPE *SmartHandleCloseFunction)(SPXHANDLE);
 /// <summary>
 /// Smart handle class.
 /// </summary>
+/// <remarks>
+/// A smart handle is the only owner of its handle. It cannot be copied; moving it transfers the ownership and leaves
+/// the source invalid.
+/// </remarks>
 template <typename T, SmartHandleCloseFunction closeFunction>
 class SmartHandle
 {
@@ -28,6 +33,18 @@ public:
     SmartHandle(T handle = SPXHANDLE_INVALID) : m_handle(handle) { };
     ~SmartHandle() { reset(); }
 
+    SmartHandle(SmartHandle&& other) noexcept : m_handle(other.release()) { }
+
+    SmartHandle& operator=(SmartHandle&& other) noexcept
+    {
+        if (this != std::addressof(other)) // operator& is overloaded
+        {
+            reset();
+            m_handle = other.release();
+        }
+        return *this;
+    }
+
     explicit operator T&() const { return m_handle; }
 
     T get() const { return m_handle; }
@@ -48,11 +65,19 @@ public:
         }
     }
 
+    // Gives up the ownership of the handle without closing it.
+    T release() noexcept
+    {
+        T handle = m_handle;
+        m_handle = SPXHANDLE_INVALID;
+        return handle;
+    }
+
 private:
 
     static bool InvalidHandle(T t) { return t == nullptr || t == SPXHANDLE_INVALID; }
 
-    DISABLE_COPY_AND_MOVE(SmartHandle);
+    DISABLE_COPY(SmartHandle);
     T m_handle;
 };
 
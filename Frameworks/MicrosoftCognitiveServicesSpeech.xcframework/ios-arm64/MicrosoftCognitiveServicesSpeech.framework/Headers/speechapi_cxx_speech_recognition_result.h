@@ -31,6 +31,15 @@ public:
         SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p) -- resultid=%s; reason=0x%x; text=%s", __FUNCTION__, (void*)this, (void*)Handle, Utils::ToUTF8(ResultId).c_str(), Reason, Utils::ToUTF8(Text).c_str());
     }
 
+    /// <summary>
+    /// Move constructor. The result takes over the handle of the other result, which must not be used afterwards.
+    /// </summary>
+    /// <param name="other">The result to move from.</param>
+    SpeechRecognitionResult(SpeechRecognitionResult&& other) :
+        RecognitionResult(std::move(other))
+    {
+    }
+
     virtual ~SpeechRecognitionResult()
     {
         SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)Handle);
@@ -38,7 +47,8 @@ public:
 
 
 private:
-    DISABLE_DEFAULT_CTORS(SpeechRecognitionResult);
+    SpeechRecognitionResult() = delete;
+    DISABLE_COPY_AND_ASSIGNMENT(SpeechRecognitionResult);
 };
 
 
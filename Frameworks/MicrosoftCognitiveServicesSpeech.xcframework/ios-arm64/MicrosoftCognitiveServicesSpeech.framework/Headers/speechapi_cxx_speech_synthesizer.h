@@ -9,6 +9,8 @@
 #include <future>
 #include <memory>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_object_pool.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_c.h"
 #include "speechapi_cxx_properties.h"
@@ -64,6 +66,11 @@ private:
     /// </summary>
     PrivatePropertyCollection m_properties;
 
+    /// <summary>
+    /// Internal member variable that recycles the storage of the event arguments and results created for every event.
+    /// </summary>
+    std::shared_ptr<Utils::ObjectPool> m_eventArgsPool;
+
     /*! \endcond */
 
 public:
@@ -285,7 +292,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this, text]() -> std::shared_ptr<SpeechSynthesisResult> {
+        auto future = Utils::RunAsync([keepAlive, this, text]() -> std::shared_ptr<SpeechSynthesisResult> {
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
             SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesizer_speak_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), &hasync));
@@ -321,7 +328,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this, ssml]() -> std::shared_ptr<SpeechSynthesisResult> {
+        auto future = Utils::RunAsync([keepAlive, this, ssml]() -> std::shared_ptr<SpeechSynthesisResult> {
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
             SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesizer_speak_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), &hasync));
@@ -360,7 +367,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this, request]() -> std::shared_ptr<SpeechSynthesisResult> {
+        auto future = Utils::RunAsync([keepAlive, this, request]() -> std::shared_ptr<SpeechSynthesisResult> {
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
             SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesizer_speak_request_async(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), &hasync));
@@ -449,7 +456,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this, text]() -> std::shared_ptr<SpeechSynthesisResult> {
+        auto future = Utils::RunAsync([keepAlive, this, text]() -> std::shared_ptr<SpeechSynthesisResult> {
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
             SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesizer_start_speaking_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), &hasync));
@@ -485,7 +492,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this, ssml]() -> std::shared_ptr<SpeechSynthesisResult> {
+        auto future = Utils::RunAsync([keepAlive, this, ssml]() -> std::shared_ptr<SpeechSynthesisResult> {
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
             SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesizer_start_speaking_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), &hasync));
@@ -521,7 +528,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this]() -> void {
             SPXASYNCHANDLE hasyncStop = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesizer_stop_speaking_async(m_hsynth, &hasyncStop));
             SPX_EXITFN_ON_FAIL(::synthesizer_stop_speaking_async_wait_for(hasyncStop, UINT32_MAX));
@@ -544,7 +551,7 @@ public:
     {
         const auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, locale, this]() -> std::shared_ptr<SynthesisVoicesResult> {
+        auto future = Utils::RunAsync([keepAlive, locale, this]() -> std::shared_ptr<SynthesisVoicesResult> {
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
             SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesizer_get_voices_list_async(m_hsynth, Utils::ToUTF8(locale).c_str(), &hasync));
@@ -583,6 +590,12 @@ public:
         return Properties.GetProperty(PropertyId::SpeechServiceAuthorization_Token, SPXSTRING());
     }
 
+    /// <summary>
+    /// Internal operator used to get underlying handle value.
+    /// </summary>
+    /// <returns>A handle.</returns>
+    explicit operator SPXSYNTHHANDLE() const { return m_hsynth; }
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -654,6 +667,7 @@ private:
     explicit SpeechSynthesizer(SPXSYNTHHANDLE hsynth) :
         m_hsynth(hsynth),
         m_properties(hsynth),
+        m_eventArgsPool(std::make_shared<Utils::ObjectPool>()),
         Properties(m_properties),
         SynthesisStarted(GetSpeechSynthesisEventConnectionsChangedCallback()),
         Synthesizing(GetSpeechSynthesisEventConnectionsChangedCallback()),
@@ -721,9 +735,8 @@ private:
     static void FireEvent_SynthesisStarted(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
+        auto synthEvent = Utils::MakePooledEventArgs<SpeechSynthesisEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->SynthesisStarted.Signal(*synthEvent.get());
     }
@@ -731,9 +744,8 @@ private:
     static void FireEvent_Synthesizing(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
+        auto synthEvent = Utils::MakePooledEventArgs<SpeechSynthesisEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->Synthesizing.Signal(*synthEvent.get());
     }
@@ -741,9 +753,8 @@ private:
     static void FireEvent_SynthesisCompleted(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
+        auto synthEvent = Utils::MakePooledEventArgs<SpeechSynthesisEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->SynthesisCompleted.Signal(*synthEvent.get());
     }
@@ -751,9 +762,8 @@ private:
     static void FireEvent_SynthesisCanceled(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
+        auto synthEvent = Utils::MakePooledEventArgs<SpeechSynthesisEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->SynthesisCanceled.Signal(*synthEvent.get());
     }
@@ -761,9 +771,8 @@ private:
     static void FireEvent_WordBoundary(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisWordBoundaryEventArgs> wordBoundaryEvent{ new SpeechSynthesisWordBoundaryEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
+        auto wordBoundaryEvent = Utils::MakePooledEventArgs<SpeechSynthesisWordBoundaryEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->WordBoundary.Signal(*wordBoundaryEvent.get());
     }
@@ -771,9 +780,8 @@ private:
     static void FireEvent_VisemeReceived(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisVisemeEventArgs> visemeReceivedEvent{ new SpeechSynthesisVisemeEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
+        auto visemeReceivedEvent = Utils::MakePooledEventArgs<SpeechSynthesisVisemeEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->VisemeReceived.Signal(*visemeReceivedEvent.get());
     }
@@ -781,9 +789,8 @@ private:
     static void FireEvent_BookmarkReached(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisBookmarkEventArgs> bookmarkReachedEvent{ new SpeechSynthesisBookmarkEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
+        auto bookmarkReachedEvent = Utils::MakePooledEventArgs<SpeechSynthesisBookmarkEventArgs>(pThis->m_eventArgsPool, hevent);
         auto keepAlive = pThis->shared_from_this();
         pThis->BookmarkReached.Signal(*bookmarkReachedEvent.get());
     }
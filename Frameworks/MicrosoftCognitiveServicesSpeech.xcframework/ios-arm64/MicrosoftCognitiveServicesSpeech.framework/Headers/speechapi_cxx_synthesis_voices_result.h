@@ -44,7 +44,7 @@ private:
             SPXPROPERTYBAGHANDLE hpropbag = SPXHANDLE_INVALID;
             synthesis_voices_result_get_property_bag(hresult, &hpropbag);
             return hpropbag;
-        }())
+        }(), true)
         {
         }
     };
@@ -75,13 +75,21 @@ public:
 
         uint32_t voiceNum;
         SPX_THROW_ON_FAIL(::synthesis_voices_result_get_voice_num(hresult, &voiceNum));
-        m_voices = std::vector<std::shared_ptr<VoiceInfo>>(voiceNum);
 
+        // The voices are stored inline in a single vector; the shared pointers in Voices share its ownership.
+        auto voiceInfos = std::make_shared<std::vector<VoiceInfo>>();
+        voiceInfos->reserve(voiceNum);
         for (uint32_t i = 0; i < voiceNum; ++i)
         {
             SPXRESULTHANDLE hVoice = SPXHANDLE_INVALID;
             SPX_THROW_ON_FAIL(::synthesis_voices_result_get_voice_info(m_hresult, i, &hVoice));
-            m_voices[i] = std::make_shared<VoiceInfo>(hVoice);
+            voiceInfos->emplace_back(hVoice);
+        }
+
+        m_voices.reserve(voiceNum);
+        for (auto& voiceInfo : *voiceInfos)
+        {
+            m_voices.push_back(std::shared_ptr<VoiceInfo>(voiceInfos, &voiceInfo));
         }
 
         const size_t maxCharCount = 1024;
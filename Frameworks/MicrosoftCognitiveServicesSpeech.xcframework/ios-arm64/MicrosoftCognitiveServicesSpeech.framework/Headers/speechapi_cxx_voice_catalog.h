@@ -0,0 +1,768 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_voice_catalog.h: Public API declarations for the VoiceCatalog and VoiceCatalogCache C++ classes
+//
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#if defined(__has_include)
+#if __has_include(<string_view>)
+#include <string_view>
+#endif
+#endif
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_string_helpers.h"
+#include "speechapi_cxx_synthesis_voices_result.h"
+#include "speechapi_cxx_speech_synthesizer.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Compact, immutable list of synthesis voices. All voices are stored as fixed-size records plus one string table,
+/// in the same layout in memory and on disk, so a saved catalog is memory-mapped on load instead of being parsed.
+/// </summary>
+/// <remarks>
+/// Lookups by short name and by locale are hash table lookups that do not allocate. The hash tables are part of the
+/// saved catalog, so loading one builds nothing. Voices are sorted by locale, so the voices of a locale are a contiguous range.
+/// </remarks>
+class VoiceCatalog
+{
+public:
+
+    /// <summary>
+    /// A voice of the catalog. The strings point into the catalog and are valid as long as the catalog.
+    /// </summary>
+    struct Voice
+    {
+        /// <summary>
+        /// Voice name.
+        /// </summary>
+        const char* Name;
+
+        /// <summary>
+        /// Locale of the voice.
+        /// </summary>
+        const char* Locale;
+
+        /// <summary>
+        /// Short name of the voice, e.g. en-US-JennyNeural.
+        /// </summary>
+        const char* ShortName;
+
+        /// <summary>
+        /// Local name of the voice.
+        /// </summary>
+        const char* LocalName;
+
+        /// <summary>
+        /// Styles of the voice, separated by '|'.
+        /// </summary>
+        const char* StyleList;
+
+        /// <summary>
+        /// Path of an offline voice.
+        /// </summary>
+        const char* VoicePath;
+
+        /// <summary>
+        /// Gender of the voice.
+        /// </summary>
+        SynthesisVoiceGender Gender;
+
+        /// <summary>
+        /// Type of the voice.
+        /// </summary>
+        SynthesisVoiceType VoiceType;
+
+        /// <summary>
+        /// Status of the voice.
+        /// </summary>
+        SynthesisVoiceStatus Status;
+    };
+
+    /// <summary>
+    /// Destructor. Unmaps the catalog file, if the catalog was loaded from one.
+    /// </summary>
+    ~VoiceCatalog()
+    {
+#if !defined(_WIN32)
+        if (m_mapping != nullptr)
+        {
+            munmap(m_mapping, m_size);
+        }
+#endif
+    }
+
+    /// <summary>
+    /// Creates a catalog from the result of <see cref="SpeechSynthesizer::GetVoicesAsync"/>.
+    /// </summary>
+    /// <param name="result">The voices result.</param>
+    /// <returns>A shared pointer to the catalog.</returns>
+    static std::shared_ptr<VoiceCatalog> FromResult(const SynthesisVoicesResult& result)
+    {
+        return FromResult(result, std::chrono::system_clock::now());
+    }
+
+    /// <summary>
+    /// Loads a catalog saved by <see cref="Save"/>. The file is memory-mapped where the platform supports it.
+    /// </summary>
+    /// <param name="path">Path of the catalog file.</param>
+    /// <returns>A shared pointer to the catalog, or nullptr if the file does not exist or is not a valid catalog.</returns>
+    static std::shared_ptr<VoiceCatalog> Load(const std::string& path)
+    {
+        std::shared_ptr<VoiceCatalog> catalog(new VoiceCatalog());
+#if !defined(_WIN32)
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(FileHeader)))
+        {
+            auto mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                catalog->m_mapping = mapping;
+                catalog->m_data = static_cast<const uint8_t*>(mapping);
+                catalog->m_size = static_cast<size_t>(info.st_size);
+            }
+        }
+        close(fd);
+#else
+        auto file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            return nullptr;
+        }
+
+        uint8_t chunk[4096];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            catalog->m_owned.insert(catalog->m_owned.end(), chunk, chunk + read);
+        }
+        std::fclose(file);
+        catalog->m_data = catalog->m_owned.data();
+        catalog->m_size = catalog->m_owned.size();
+#endif
+        return catalog->Validate() ? catalog : nullptr;
+    }
+
+    /// <summary>
+    /// Saves the catalog. The file is written under a temporary name and then renamed, so readers never see a partial file.
+    /// On Windows a rename does not replace an existing file, so the previous catalog is removed first and a reader in
+    /// between finds no catalog, as on the first start.
+    /// </summary>
+    /// <param name="path">Path of the catalog file.</param>
+    /// <returns>True if the catalog was saved.</returns>
+    bool Save(const std::string& path) const
+    {
+        auto temporary = path + ".tmp";
+        auto file = std::fopen(temporary.c_str(), "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        auto written = std::fwrite(m_data, 1, m_size, file);
+        auto closed = std::fclose(file) == 0;
+#if defined(_WIN32)
+        if (written == m_size && closed)
+        {
+            std::remove(path.c_str());
+        }
+#endif
+        if (written != m_size || !closed || std::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Gets the number of voices.
+    /// </summary>
+    /// <returns>The number of voices.</returns>
+    size_t Size() const { return m_header.voiceCount; }
+
+    /// <summary>
+    /// Gets a voice by position.
+    /// </summary>
+    /// <param name="index">The position, less than <see cref="Size"/>.</param>
+    /// <returns>The voice.</returns>
+    Voice At(size_t index) const
+    {
+        SPX_THROW_HR_IF(SPXERR_OUT_OF_RANGE, index >= Size());
+
+        const auto& record = m_records[index];
+        return Voice{
+            String(record.name), String(record.locale), String(record.shortName), String(record.localName), String(record.styleList), String(record.voicePath),
+            static_cast<SynthesisVoiceGender>(record.gender), static_cast<SynthesisVoiceType>(record.voiceType), static_cast<SynthesisVoiceStatus>(record.status) };
+    }
+
+    /// <summary>
+    /// Looks up a voice by short name, e.g. to validate a configured voice.
+    /// </summary>
+    /// <param name="shortName">The short name.</param>
+    /// <param name="voice">Receives the voice if found.</param>
+    /// <returns>True if the voice was found.</returns>
+    bool FindByShortName(const char* shortName, Voice& voice) const
+    {
+        return FindByShortName(shortName, std::strlen(shortName), voice);
+    }
+
+    /// <summary>
+    /// Looks up a voice by short name, see <see cref="FindByShortName(const char*, Voice&)"/>.
+    /// </summary>
+    /// <param name="shortName">The short name.</param>
+    /// <param name="voice">Receives the voice if found.</param>
+    /// <returns>True if the voice was found.</returns>
+    bool FindByShortName(const std::string& shortName, Voice& voice) const
+    {
+        return FindByShortName(shortName.data(), shortName.size(), voice);
+    }
+
+#if defined(__cpp_lib_string_view)
+    /// <summary>
+    /// Looks up a voice by short name, see <see cref="FindByShortName(const char*, Voice&)"/>.
+    /// </summary>
+    /// <param name="shortName">The short name.</param>
+    /// <param name="voice">Receives the voice if found.</param>
+    /// <returns>True if the voice was found.</returns>
+    bool FindByShortName(std::string_view shortName, Voice& voice) const
+    {
+        return FindByShortName(shortName.data(), shortName.size(), voice);
+    }
+#endif
+
+    /// <summary>
+    /// Gets the positions of the voices of a locale; they are <c>first</c> to <c>first + count - 1</c>.
+    /// </summary>
+    /// <param name="locale">The locale, e.g. en-US.</param>
+    /// <param name="first">Receives the position of the first voice.</param>
+    /// <param name="count">Receives the number of voices; 0 if the locale has none.</param>
+    void FindByLocale(const char* locale, size_t& first, size_t& count) const
+    {
+        FindByLocale(locale, std::strlen(locale), first, count);
+    }
+
+    /// <summary>
+    /// Gets the positions of the voices of a locale, see <see cref="FindByLocale(const char*, size_t&, size_t&)"/>.
+    /// </summary>
+    /// <param name="locale">The locale, e.g. en-US.</param>
+    /// <param name="first">Receives the position of the first voice.</param>
+    /// <param name="count">Receives the number of voices; 0 if the locale has none.</param>
+    void FindByLocale(const std::string& locale, size_t& first, size_t& count) const
+    {
+        FindByLocale(locale.data(), locale.size(), first, count);
+    }
+
+#if defined(__cpp_lib_string_view)
+    /// <summary>
+    /// Gets the positions of the voices of a locale, see <see cref="FindByLocale(const char*, size_t&, size_t&)"/>.
+    /// </summary>
+    /// <param name="locale">The locale, e.g. en-US.</param>
+    /// <param name="first">Receives the position of the first voice.</param>
+    /// <param name="count">Receives the number of voices; 0 if the locale has none.</param>
+    void FindByLocale(std::string_view locale, size_t& first, size_t& count) const
+    {
+        FindByLocale(locale.data(), locale.size(), first, count);
+    }
+#endif
+
+    /// <summary>
+    /// Gets the time the voice list was fetched from the service.
+    /// </summary>
+    /// <returns>The fetch time.</returns>
+    std::chrono::system_clock::time_point GetFetchTime() const
+    {
+        return std::chrono::system_clock::time_point(std::chrono::seconds(m_header.fetchedAt));
+    }
+
+    /// <summary>
+    /// Gets a hash of the voices, which changes whenever the voice list changes. It plays the role of an entity tag.
+    /// </summary>
+    /// <returns>The hash.</returns>
+    uint64_t GetFingerprint() const { return m_header.fingerprint; }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(VoiceCatalog);
+
+    friend class VoiceCatalogCache;
+
+    static constexpr uint32_t Magic = 0x43565053; // "SPVC"
+    static constexpr uint32_t Version = 2;
+
+    // The file holds the header, the records, the locale ranges, the short name index, the locale index and the
+    // string table, in this order. The indexes are hash tables built when the catalog is created, so a loaded
+    // catalog is searched in place.
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t voiceCount;
+        uint32_t localeCount;
+        uint32_t shortNameSlotCount;
+        uint32_t localeSlotCount;
+        uint32_t stringTableSize;
+        uint32_t reserved;
+        uint64_t fetchedAt;
+        uint64_t fingerprint;
+    };
+
+    struct Record
+    {
+        uint32_t name;
+        uint32_t locale;
+        uint32_t shortName;
+        uint32_t localName;
+        uint32_t styleList;
+        uint32_t voicePath;
+        uint8_t gender;
+        uint8_t voiceType;
+        uint8_t status;
+        uint8_t reserved;
+    };
+
+    struct LocaleRange
+    {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    static constexpr uint64_t FnvOffsetBasis = 14695981039346656037ull;
+
+    static uint64_t Fnv1a(uint64_t hash, const void* data, size_t size)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // An index has no slots for no entries, and otherwise a power of two more slots than entries, so that a probe
+    // always ends at an empty slot.
+    static uint32_t SlotCount(uint32_t count)
+    {
+        uint32_t slots = count > 0 ? 2 : 0;
+        while (slots > 0 && slots < 2 * static_cast<uint64_t>(count))
+        {
+            slots *= 2;
+        }
+        return slots;
+    }
+
+    static uint32_t Slot(const char* data, size_t size, uint32_t slotCount)
+    {
+        return static_cast<uint32_t>(Fnv1a(FnvOffsetBasis, data, size)) & (slotCount - 1);
+    }
+
+    // Open addressing with linear probing. A slot holds the position of an entry plus one; 0 marks an empty slot.
+    template <class Key>
+    static std::vector<uint32_t> BuildIndex(uint32_t count, Key key)
+    {
+        std::vector<uint32_t> slots(SlotCount(count), 0);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const std::string& value = key(i);
+            auto slot = Slot(value.data(), value.size(), static_cast<uint32_t>(slots.size()));
+            while (slots[slot] != 0)
+            {
+                slot = (slot + 1) & static_cast<uint32_t>(slots.size() - 1);
+            }
+            slots[slot] = i + 1;
+        }
+        return slots;
+    }
+
+    // Probes an index built by BuildIndex for the entry whose key, a null terminated string, equals the given text.
+    template <class Key>
+    static bool FindInIndex(const uint32_t* slots, uint32_t slotCount, const char* data, size_t size, Key key, uint32_t& position)
+    {
+        if (slotCount == 0)
+        {
+            return false;
+        }
+
+        for (auto slot = Slot(data, size, slotCount); slots[slot] != 0; slot = (slot + 1) & (slotCount - 1))
+        {
+            auto candidate = key(slots[slot] - 1);
+            if (std::strlen(candidate) == size && std::memcmp(candidate, data, size) == 0)
+            {
+                position = slots[slot] - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    VoiceCatalog() = default;
+
+    static std::shared_ptr<VoiceCatalog> FromResult(const SynthesisVoicesResult& result, std::chrono::system_clock::time_point fetchedAt)
+    {
+        struct Entry
+        {
+            std::string fields[6];
+            Record record;
+        };
+
+        std::vector<Entry> entries;
+        entries.reserve(result.Voices.size());
+        for (const auto& voice : result.Voices)
+        {
+            std::string styles;
+            for (const auto& style : voice->StyleList)
+            {
+                styles += (styles.empty() ? "" : "|") + Utils::ToUTF8(style);
+            }
+
+            Record record{};
+            record.gender = static_cast<uint8_t>(voice->Gender);
+            record.voiceType = static_cast<uint8_t>(voice->VoiceType);
+            record.status = static_cast<uint8_t>(voice->Status);
+            entries.push_back(Entry{ { Utils::ToUTF8(voice->Name), Utils::ToUTF8(voice->Locale), Utils::ToUTF8(voice->ShortName),
+                Utils::ToUTF8(voice->LocalName), styles, Utils::ToUTF8(voice->VoicePath) }, record });
+        }
+
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.fields[1] < b.fields[1]; });
+
+        // Strings are null terminated and deduplicated, which folds the many repeated locales and empty fields.
+        std::vector<char> strings;
+        std::unordered_map<std::string, uint32_t> offsets;
+        auto intern = [&](const std::string& value) {
+            auto it = offsets.find(value);
+            if (it != offsets.end())
+            {
+                return it->second;
+            }
+            auto offset = static_cast<uint32_t>(strings.size());
+            strings.insert(strings.end(), value.begin(), value.end());
+            strings.push_back('\0');
+            offsets.emplace(value, offset);
+            return offset;
+        };
+
+        std::vector<Record> records;
+        std::vector<LocaleRange> locales;
+        records.reserve(entries.size());
+        for (auto& entry : entries)
+        {
+            entry.record.name = intern(entry.fields[0]);
+            entry.record.locale = intern(entry.fields[1]);
+            entry.record.shortName = intern(entry.fields[2]);
+            entry.record.localName = intern(entry.fields[3]);
+            entry.record.styleList = intern(entry.fields[4]);
+            entry.record.voicePath = intern(entry.fields[5]);
+
+            auto position = static_cast<uint32_t>(records.size());
+            if (locales.empty() || entries[locales.back().first].fields[1] != entry.fields[1])
+            {
+                locales.push_back(LocaleRange{ position, 0 });
+            }
+            locales.back().count++;
+            records.push_back(entry.record);
+        }
+
+        auto shortNameSlots = BuildIndex(static_cast<uint32_t>(entries.size()), [&](uint32_t i) -> const std::string& { return entries[i].fields[2]; });
+        auto localeSlots = BuildIndex(static_cast<uint32_t>(locales.size()), [&](uint32_t i) -> const std::string& { return entries[locales[i].first].fields[1]; });
+
+        FileHeader header{};
+        header.magic = Magic;
+        header.version = Version;
+        header.voiceCount = static_cast<uint32_t>(records.size());
+        header.localeCount = static_cast<uint32_t>(locales.size());
+        header.shortNameSlotCount = static_cast<uint32_t>(shortNameSlots.size());
+        header.localeSlotCount = static_cast<uint32_t>(localeSlots.size());
+        header.stringTableSize = static_cast<uint32_t>(strings.size());
+        header.fetchedAt = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(fetchedAt.time_since_epoch()).count());
+        header.fingerprint = Fnv1a(Fnv1a(FnvOffsetBasis, records.data(), records.size() * sizeof(Record)), strings.data(), strings.size());
+
+        std::shared_ptr<VoiceCatalog> catalog(new VoiceCatalog());
+        auto& owned = catalog->m_owned;
+        owned.reserve(sizeof(FileHeader) + records.size() * sizeof(Record) + locales.size() * sizeof(LocaleRange) +
+            (shortNameSlots.size() + localeSlots.size()) * sizeof(uint32_t) + strings.size());
+        auto append = [&owned](const void* data, size_t size) {
+            auto bytes = static_cast<const uint8_t*>(data);
+            owned.insert(owned.end(), bytes, bytes + size);
+        };
+        append(&header, sizeof(FileHeader));
+        append(records.data(), records.size() * sizeof(Record));
+        append(locales.data(), locales.size() * sizeof(LocaleRange));
+        append(shortNameSlots.data(), shortNameSlots.size() * sizeof(uint32_t));
+        append(localeSlots.data(), localeSlots.size() * sizeof(uint32_t));
+        append(strings.data(), strings.size());
+        catalog->m_data = owned.data();
+        catalog->m_size = owned.size();
+
+        SPX_THROW_HR_IF(SPXERR_UNEXPECTED_CREATE_OBJECT_FAILURE, !catalog->Validate());
+        return catalog;
+    }
+
+    // Checks the layout in place. Every offset and position is checked, since the file may be truncated or stale.
+    bool Validate()
+    {
+        if (m_data == nullptr || m_size < sizeof(FileHeader))
+        {
+            return false;
+        }
+
+        std::memcpy(&m_header, m_data, sizeof(FileHeader));
+        const auto& header = m_header;
+        if (header.magic != Magic || header.version != Version ||
+            header.shortNameSlotCount != SlotCount(header.voiceCount) || header.localeSlotCount != SlotCount(header.localeCount) ||
+            m_size != sizeof(FileHeader) + static_cast<uint64_t>(header.voiceCount) * sizeof(Record) + static_cast<uint64_t>(header.localeCount) * sizeof(LocaleRange) +
+                (static_cast<uint64_t>(header.shortNameSlotCount) + header.localeSlotCount) * sizeof(uint32_t) + header.stringTableSize ||
+            (header.stringTableSize > 0 && m_data[m_size - 1] != '\0'))
+        {
+            return false;
+        }
+
+        auto position = m_data + sizeof(FileHeader);
+        m_records = reinterpret_cast<const Record*>(position);
+        position += header.voiceCount * sizeof(Record);
+        m_locales = reinterpret_cast<const LocaleRange*>(position);
+        position += header.localeCount * sizeof(LocaleRange);
+        m_shortNameSlots = reinterpret_cast<const uint32_t*>(position);
+        position += header.shortNameSlotCount * sizeof(uint32_t);
+        m_localeSlots = reinterpret_cast<const uint32_t*>(position);
+        position += header.localeSlotCount * sizeof(uint32_t);
+        m_strings = reinterpret_cast<const char*>(position);
+
+        for (uint32_t i = 0; i < header.voiceCount; i++)
+        {
+            const auto& record = m_records[i];
+            for (auto offset : { record.name, record.locale, record.shortName, record.localName, record.styleList, record.voicePath })
+            {
+                if (offset >= header.stringTableSize)
+                {
+                    return false;
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < header.localeCount; i++)
+        {
+            if (m_locales[i].count == 0 || m_locales[i].first > header.voiceCount || m_locales[i].count > header.voiceCount - m_locales[i].first)
+            {
+                return false;
+            }
+        }
+
+        return ValidateIndex(m_shortNameSlots, header.shortNameSlotCount, header.voiceCount) &&
+            ValidateIndex(m_localeSlots, header.localeSlotCount, header.localeCount);
+    }
+
+    // Positions must be in range, and no more slots may be used than there are entries, so probes terminate.
+    static bool ValidateIndex(const uint32_t* slots, uint32_t slotCount, uint32_t count)
+    {
+        uint32_t used = 0;
+        for (uint32_t i = 0; i < slotCount; i++)
+        {
+            if (slots[i] > count || (slots[i] != 0 && ++used > count))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool FindByShortName(const char* data, size_t size, Voice& voice) const
+    {
+        uint32_t position;
+        if (!FindInIndex(m_shortNameSlots, m_header.shortNameSlotCount, data, size, [this](uint32_t i) { return String(m_records[i].shortName); }, position))
+        {
+            return false;
+        }
+
+        voice = At(position);
+        return true;
+    }
+
+    void FindByLocale(const char* data, size_t size, size_t& first, size_t& count) const
+    {
+        uint32_t position;
+        auto found = FindInIndex(m_localeSlots, m_header.localeSlotCount, data, size, [this](uint32_t i) { return String(m_records[m_locales[i].first].locale); }, position);
+        first = found ? m_locales[position].first : 0;
+        count = found ? m_locales[position].count : 0;
+    }
+
+    const char* String(uint32_t offset) const { return m_strings + offset; }
+
+    FileHeader m_header{};
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_mapping = nullptr;
+    std::vector<uint8_t> m_owned;
+
+    const Record* m_records = nullptr;
+    const LocaleRange* m_locales = nullptr;
+    const uint32_t* m_shortNameSlots = nullptr;
+    const uint32_t* m_localeSlots = nullptr;
+    const char* m_strings = nullptr;
+};
+
+/// <summary>
+/// Voice catalog persisted in a file and refreshed from the service in the background.
+/// </summary>
+/// <remarks>
+/// The saved catalog is loaded when the cache is created, so voices are available without a network round trip.
+/// <see cref="RefreshAsync"/> asks the service again only when the catalog is older than the maximum age, and replaces
+/// the catalog only when the fingerprint of the new voice list differs; the C API offers no conditional request,
+/// so the fingerprint takes the place of an entity tag.
+/// </remarks>
+class VoiceCatalogCache
+{
+public:
+
+    /// <summary>
+    /// Creates a cache and loads the saved catalog, if any.
+    /// </summary>
+    /// <param name="path">Path of the catalog file.</param>
+    /// <param name="maxAge">Age after which <see cref="RefreshAsync"/> fetches the voice list again.</param>
+    explicit VoiceCatalogCache(std::string path, std::chrono::seconds maxAge = std::chrono::hours(24)) :
+        m_path(std::move(path)),
+        m_maxAge(maxAge),
+        m_catalog(VoiceCatalog::Load(m_path))
+    {
+    }
+
+    /// <summary>
+    /// Gets the current catalog.
+    /// </summary>
+    /// <returns>The catalog, or nullptr if none was saved or fetched yet.</returns>
+    std::shared_ptr<const VoiceCatalog> Get() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_catalog;
+    }
+
+    /// <summary>
+    /// Checks whether the current catalog is missing or older than the maximum age.
+    /// </summary>
+    /// <returns>True if a refresh would fetch the voice list.</returns>
+    bool IsStale() const
+    {
+        auto catalog = Get();
+        return catalog == nullptr || std::chrono::system_clock::now() - catalog->GetFetchTime() >= m_maxAge;
+    }
+
+    /// <summary>
+    /// Fetches the voice list in the background if the catalog is stale. Concurrent calls share one fetch.
+    /// </summary>
+    /// <remarks>
+    /// The fetch runs on a thread of its own and calls the C API directly. It neither waits for an executor thread
+    /// nor holds one while waiting for the service, so it completes even when the executor is saturated, and the
+    /// destructor only ever waits for the service.
+    /// </remarks>
+    /// <param name="synthesizer">Synthesizer used to fetch the voice list.</param>
+    /// <param name="force">True to fetch even if the catalog is fresh.</param>
+    /// <returns>A future that is true if the catalog changed.</returns>
+    std::shared_future<bool> RefreshAsync(std::shared_ptr<SpeechSynthesizer> synthesizer, bool force = false)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_refresh.valid() && m_refresh.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return m_refresh;
+        }
+
+        if (!force && m_catalog != nullptr && std::chrono::system_clock::now() - m_catalog->GetFetchTime() < m_maxAge)
+        {
+            std::promise<bool> unchanged;
+            unchanged.set_value(false);
+            return unchanged.get_future().share();
+        }
+
+        m_refresh = std::async(std::launch::async, [this, synthesizer]() { return Update(FetchVoices(*synthesizer)); }).share();
+        return m_refresh;
+    }
+
+    /// <summary>
+    /// Destructor. Waits for a pending refresh.
+    /// </summary>
+    ~VoiceCatalogCache()
+    {
+        std::shared_future<bool> refresh;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            refresh = m_refresh;
+        }
+        if (refresh.valid())
+        {
+            refresh.wait();
+        }
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(VoiceCatalogCache);
+
+    static std::shared_ptr<SynthesisVoicesResult> FetchVoices(const SpeechSynthesizer& synthesizer)
+    {
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(::synthesizer_get_voices_list_async(static_cast<SPXSYNTHHANDLE>(synthesizer), "", &hasync));
+
+        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+        auto hr = ::synthesizer_get_voices_list_async_wait_for(hasync, UINT32_MAX, &hresult);
+        auto releaseHr = ::synthesizer_async_handle_release(hasync);
+        SPX_REPORT_ON_FAIL(releaseHr);
+        SPX_THROW_ON_FAIL(hr);
+        return std::make_shared<SynthesisVoicesResult>(hresult);
+    }
+
+    bool Update(const std::shared_ptr<SynthesisVoicesResult>& result)
+    {
+        if (result == nullptr || result->Reason != ResultReason::VoicesListRetrieved)
+        {
+            return false;
+        }
+
+        auto fetched = VoiceCatalog::FromResult(*result);
+        bool changed;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            changed = m_catalog == nullptr || m_catalog->GetFingerprint() != fetched->GetFingerprint();
+            m_catalog = fetched;
+        }
+
+        // Saved even when unchanged, so that the fetch time survives a restart.
+        fetched->Save(m_path);
+        return changed;
+    }
+
+    const std::string m_path;
+    const std::chrono::seconds m_maxAge;
+
+    mutable std::mutex m_mutex;
+    std::shared_ptr<const VoiceCatalog> m_catalog;
+    std::shared_future<bool> m_refresh;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -38,7 +38,7 @@ private:
                     SPXPROPERTYBAGHANDLE hpropbag = SPXHANDLE_INVALID;
                     result_get_property_bag(hresult, &hpropbag);
                     return hpropbag;
-                }())
+                }(), true)
         {
         }
     };
@@ -10,10 +10,14 @@
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_smart_handle.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_object_pool.h"
+#include "speechapi_cxx_json.h"
 
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_audio_stream_format.h"
 #include "speechapi_cxx_audio_stream.h"
+#include "speechapi_cxx_flac_codec.h"
 #include "speechapi_cxx_speech_config.h"
 #include "speechapi_cxx_embedded_speech_config.h"
 #include "speechapi_cxx_hybrid_speech_config.h"
@@ -69,6 +73,7 @@
 
 #include "speechapi_cxx_connection.h"
 #include "speechapi_cxx_connection_eventargs.h"
+#include "speechapi_cxx_session_multiplexer.h"
 
 #include "speechapi_cxx_audio_data_stream.h"
 
@@ -81,6 +86,7 @@
 #include "speechapi_cxx_speech_synthesizer.h"
 #include "speechapi_cxx_synthesis_voices_result.h"
 #include "speechapi_cxx_voice_info.h"
+#include "speechapi_cxx_voice_catalog.h"
 
 #include "speechapi_cxx_keyword_recognition_result.h"
 #include "speechapi_cxx_keyword_recognition_eventargs.h"
@@ -115,3 +121,4 @@
 #include "speechapi_cxx_file_logger.h"
 #include "speechapi_cxx_event_logger.h"
 #include "speechapi_cxx_memory_logger.h"
+#include "speechapi_cxx_ring_logger.h"
@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_smart_handle.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_utils.h"
@@ -176,7 +177,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this, fileName]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this, fileName]() -> void {
             SPX_THROW_ON_FAIL(audio_data_stream_save_to_wave_file(m_haudioStream, Utils::ToUTF8(fileName).c_str()));
         });
 
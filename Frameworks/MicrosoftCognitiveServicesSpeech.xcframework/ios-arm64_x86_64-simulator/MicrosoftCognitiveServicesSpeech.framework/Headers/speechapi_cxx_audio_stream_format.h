@@ -7,8 +7,11 @@
 
 #pragma once
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_smart_handle.h"
 #include "speechapi_c_audio_stream_format.h"
@@ -97,6 +100,10 @@ enum class AudioStreamWaveFormat
 /// Class to represent the audio stream format used for custom audio input configurations.
 /// Updated in version 1.5.0.
 /// </summary>
+/// <remarks>
+/// Format objects are immutable. The factory methods intern them in a process-wide table, so calls with the same
+/// arguments return the same shared object and native handle instead of creating new ones.
+/// </remarks>
 class AudioStreamFormat
 {
 public:
@@ -118,11 +125,11 @@ public:
     /// <returns>A shared pointer to AudioStreamFormat</returns>
     static std::shared_ptr<AudioStreamFormat> GetDefaultInputFormat()
     {
-        SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(audio_stream_format_create_from_default_input(&hformat));
-
-        auto format = new AudioStreamFormat(hformat);
-        return std::shared_ptr<AudioStreamFormat>(format);
+        return Intern(FormatKey{ FormatKind::DefaultInput, 0, 0, 0, 0 }, []() {
+            SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(audio_stream_format_create_from_default_input(&hformat));
+            return hformat;
+        });
     }
 
     /// <summary>
@@ -135,11 +142,11 @@ public:
     /// <returns>A shared pointer to AudioStreamFormat</returns>
     static std::shared_ptr<AudioStreamFormat> GetWaveFormat(uint32_t samplesPerSecond, uint8_t bitsPerSample, uint8_t channels, AudioStreamWaveFormat waveFormat)
     {
-        SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(audio_stream_format_create_from_waveformat(&hformat, samplesPerSecond, bitsPerSample, channels, (Audio_Stream_Wave_Format)waveFormat));
-
-        auto format = new AudioStreamFormat(hformat);
-        return std::shared_ptr<AudioStreamFormat>(format);
+        return Intern(FormatKey{ FormatKind::Wave, samplesPerSecond, bitsPerSample, channels, static_cast<uint32_t>(waveFormat) }, [=]() {
+            SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(audio_stream_format_create_from_waveformat(&hformat, samplesPerSecond, bitsPerSample, channels, (Audio_Stream_Wave_Format)waveFormat));
+            return hformat;
+        });
     }
 
     /// <summary>
@@ -151,11 +158,11 @@ public:
     /// <returns>A shared pointer to AudioStreamFormat</returns>
     static std::shared_ptr<AudioStreamFormat> GetWaveFormatPCM(uint32_t samplesPerSecond, uint8_t bitsPerSample = 16, uint8_t channels = 1)
     {
-        SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(audio_stream_format_create_from_waveformat(&hformat, samplesPerSecond, bitsPerSample, channels, Audio_Stream_Wave_Format::StreamWaveFormat_PCM));
-
-        auto format = new AudioStreamFormat(hformat);
-        return std::shared_ptr<AudioStreamFormat>(format);
+        return Intern(FormatKey{ FormatKind::Wave, samplesPerSecond, bitsPerSample, channels, static_cast<uint32_t>(AudioStreamWaveFormat::PCM) }, [=]() {
+            SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(audio_stream_format_create_from_waveformat(&hformat, samplesPerSecond, bitsPerSample, channels, Audio_Stream_Wave_Format::StreamWaveFormat_PCM));
+            return hformat;
+        });
     }
 
     /// <summary>
@@ -165,11 +172,11 @@ public:
     /// <returns>A shared pointer to AudioStreamFormat</returns>
     static std::shared_ptr<AudioStreamFormat> GetDefaultOutputFormat()
     {
-        SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(audio_stream_format_create_from_default_output(&hformat));
-
-        auto format = new AudioStreamFormat(hformat);
-        return std::shared_ptr<AudioStreamFormat>(format);
+        return Intern(FormatKey{ FormatKind::DefaultOutput, 0, 0, 0, 0 }, []() {
+            SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(audio_stream_format_create_from_default_output(&hformat));
+            return hformat;
+        });
     }
 
     /// <summary>
@@ -183,11 +190,11 @@ public:
     /// <returns>A shared pointer to AudioStreamFormat.</returns>
     static std::shared_ptr<AudioStreamFormat> GetCompressedFormat(AudioStreamContainerFormat compressedFormat)
     {
-        SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(audio_stream_format_create_from_compressed_format(&hformat, (Audio_Stream_Container_Format)compressedFormat));
-
-        auto format = new AudioStreamFormat(hformat);
-        return std::shared_ptr<AudioStreamFormat>(format);
+        return Intern(FormatKey{ FormatKind::Compressed, 0, 0, 0, static_cast<uint32_t>(compressedFormat) }, [=]() {
+            SPXAUDIOSTREAMFORMATHANDLE hformat = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(audio_stream_format_create_from_compressed_format(&hformat, (Audio_Stream_Container_Format)compressedFormat));
+            return hformat;
+        });
     }
 
 protected:
@@ -205,6 +212,57 @@ private:
 
     DISABLE_COPY_AND_MOVE(AudioStreamFormat);
 
+    enum class FormatKind
+    {
+        DefaultInput,
+        DefaultOutput,
+        Wave,
+        Compressed
+    };
+
+    struct FormatKey
+    {
+        FormatKind kind;
+        uint32_t samplesPerSecond;
+        uint8_t bitsPerSample;
+        uint8_t channels;
+        uint32_t format;
+
+        bool operator<(const FormatKey& other) const
+        {
+            return std::tie(kind, samplesPerSecond, bitsPerSample, channels, format) < std::tie(other.kind, other.samplesPerSecond, other.bitsPerSample, other.channels, other.format);
+        }
+    };
+
+    struct InternTable
+    {
+        std::mutex mutex;
+        std::map<FormatKey, std::shared_ptr<AudioStreamFormat>> formats;
+
+        static InternTable& Instance()
+        {
+            // Intentionally leaked, like the handles it holds; applications use only a handful of distinct formats.
+            static InternTable* instance = new InternTable();
+            return *instance;
+        }
+    };
+
+    template<class F>
+    static std::shared_ptr<AudioStreamFormat> Intern(const FormatKey& key, F createHandle)
+    {
+        auto& table = InternTable::Instance();
+
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto it = table.formats.find(key);
+        if (it == table.formats.end())
+        {
+            // The handle is released by the format if the insertion fails.
+            std::shared_ptr<AudioStreamFormat> format(new AudioStreamFormat(createHandle()));
+            it = table.formats.emplace(key, std::move(format)).first;
+        }
+        return it->second;
+    }
+
     /// <summary>
     /// Internal member variable that holds the smart handle.
     /// </summary>
@@ -8,6 +8,7 @@
 #pragma once
 #include <string>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_object_pool.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_eventargs.h"
 #include "speechapi_cxx_connection_message.h"
@@ -44,6 +45,17 @@ public:
     {
     };
 
+    /// <summary>
+    /// Constructor. The message is created in storage drawn from the pool.
+    /// </summary>
+    /// <param name="hevent">Event handle.</param>
+    /// <param name="pool">Pool of the connection that raised the event.</param>
+    ConnectionMessageEventArgs(SPXEVENTHANDLE hevent, const std::shared_ptr<Utils::ObjectPool>& pool) :
+        m_hevent(hevent),
+        m_message(Utils::MakePooledShared<ConnectionMessage>(pool, MessageHandleFromEventHandle(hevent)))
+    {
+    };
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -7,10 +7,15 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "speechapi_cxx_common.h"
 
@@ -24,6 +29,10 @@ namespace Speech {
 /// <remarks>
 /// At construction time, connect and disconnect callbacks can be provided that are called when
 /// the number of connected clients changes from zero to one or one to zero, respectively.
+/// Registration changes publish an immutable snapshot of the connected callbacks. Signalling reads the
+/// current snapshot without taking a lock or allocating, and invokes the callbacks without holding any lock.
+/// A replaced snapshot is freed by a later registration change once the Signal calls that could still read it have
+/// returned; Signal calls that start later do not hold it back.
 /// </remarks>
 // <typeparam name="T">
 template <class T>
@@ -34,8 +43,13 @@ public:
     /// Constructs an event signal with empty connect and disconnect actions.
     /// <summary>
     EventSignalBase() :
-        m_nextCallbackToken(0)
+        m_nextCallbackToken(0),
+        m_snapshot(nullptr),
+        m_epoch(0),
+        m_flips(0)
     {
+        m_readers[0].store(0);
+        m_readers[1].store(0);
     }
 
     /// <summary>
@@ -44,6 +58,7 @@ public:
     virtual ~EventSignalBase()
     {
         UnregisterAllCallbacks();
+        delete m_snapshot.load();
     }
 
     /// <summary>
@@ -75,7 +90,8 @@ public:
         auto token = m_nextCallbackToken;
         m_nextCallbackToken++;
 
-        m_callbacks.emplace(token, callback);
+        m_callbacks.emplace(token, std::make_shared<CallbackEntry>(token, std::move(callback)));
+        PublishSnapshot();
 
         return token;
     }
@@ -84,6 +100,10 @@ public:
     /// If present, unregisters a callback from this EventSource associated with the provided token. Tokens are
     /// returned from RegisterCallback at the time of registration.
     /// </summary>
+    /// <remarks>
+    /// If the callback is running on another thread, this waits for it to return, unless it is called from a callback
+    /// of this event signal.
+    /// </remarks>
     /// <param name="token">
     /// The token associated with the callback to be removed. This token is provided by the return value of
     /// RegisterCallback at the time of registration.
@@ -92,7 +112,11 @@ public:
     bool UnregisterCallback(CallbackToken token)
     {
         std::unique_lock<std::recursive_mutex> lock(m_mutex);
-        return (bool)m_callbacks.erase(token);
+        auto entry = RemoveCallback(token);
+        lock.unlock();
+
+        WaitForCallbackToReturn(entry);
+        return entry != nullptr;
     }
 
     /// <summary>
@@ -111,7 +135,13 @@ public:
     void UnregisterAllCallbacks()
     {
         std::unique_lock<std::recursive_mutex> lock(m_mutex);
-        m_callbacks.clear();
+        auto entries = RemoveAllCallbacks();
+        lock.unlock();
+
+        for (auto& entry : entries)
+        {
+            WaitForCallbackToReturn(entry);
+        }
     }
 
     /// <summary>
@@ -120,21 +150,22 @@ public:
     /// <param name="t">Event arguments to signal.</param>
     void Signal(T t)
     {
-        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        ReaderScope reader(m_readers, m_epoch);
 
-        auto callbacksSnapshot = m_callbacks;
-        for (auto callbackCopyPair : callbacksSnapshot)
+        auto snapshot = m_snapshot.load();
+        if (snapshot == nullptr)
         {
-            // now, while a callback is in progress, it can disconnect itself and any other connected
-            // callback. Check to see if the next one stored in the copy container is still connected.
-            bool stillConnected = (std::find_if(m_callbacks.begin(), m_callbacks.end(),
-                [&](const std::pair<CallbackToken, CallbackFunction> item) {
-                return callbackCopyPair.first == item.first;
-            }) != m_callbacks.end());
+            return;
+        }
 
-            if (stillConnected)
+        for (auto& entry : *snapshot)
+        {
+            // now, while a callback is in progress, it can disconnect itself and any other connected
+            // callback. Check to see if the next one in the snapshot is still connected.
+            InvocationScope invocation(*entry, this);
+            if (entry->connected.load())
             {
-                callbackCopyPair.second(t);
+                entry->callback(t);
             }
         }
     }
@@ -150,11 +181,201 @@ public:
     }
 
 protected:
-    std::map<CallbackToken, CallbackFunction> m_callbacks;
+
+    /*! \cond PROTECTED */
+
+    struct CallbackEntry
+    {
+        CallbackEntry(CallbackToken t, CallbackFunction cb) :
+            token(t), callback(std::move(cb)), connected(true), inFlight(0), waiters(0)
+        {
+        }
+
+        const CallbackToken token;
+        const CallbackFunction callback;
+        std::atomic<bool> connected;
+        std::atomic<uint32_t> inFlight;
+
+        // Disconnecting threads that block until inFlight drops to zero.
+        std::atomic<uint32_t> waiters;
+        std::mutex returnedMutex;
+        std::condition_variable returned;
+    };
+
+    using CallbackList = std::vector<std::shared_ptr<CallbackEntry>>;
+
+    // Removes a callback; must be called with m_mutex held. The caller waits for it with WaitForCallbackToReturn after unlocking.
+    std::shared_ptr<CallbackEntry> RemoveCallback(CallbackToken token)
+    {
+        auto it = m_callbacks.find(token);
+        if (it == m_callbacks.end())
+        {
+            return nullptr;
+        }
+
+        auto entry = it->second;
+        entry->connected.store(false);
+        m_callbacks.erase(it);
+        PublishSnapshot();
+        return entry;
+    }
+
+    // Removes all callbacks; must be called with m_mutex held.
+    CallbackList RemoveAllCallbacks()
+    {
+        CallbackList entries;
+        entries.reserve(m_callbacks.size());
+        for (auto& item : m_callbacks)
+        {
+            item.second->connected.store(false);
+            entries.push_back(item.second);
+        }
+
+        m_callbacks.clear();
+        PublishSnapshot();
+        return entries;
+    }
+
+    // Waits until the disconnected callback is no longer running on other threads. Must not be called with m_mutex held,
+    // as the callback may itself connect or disconnect. Called from a callback of this signal, it does not wait at all:
+    // the callbacks running on other threads may be waiting for this one, e.g. a callback that disconnects itself while
+    // it is signalled on two threads. Spins briefly, as callbacks are usually short, then blocks until the last
+    // invocation returns.
+    void WaitForCallbackToReturn(const std::shared_ptr<CallbackEntry>& entry) const
+    {
+        if (entry == nullptr || IsInCallback())
+        {
+            return;
+        }
+
+        for (int spin = 0; spin < 64 && entry->inFlight.load() != 0; spin++)
+        {
+            std::this_thread::yield();
+        }
+        if (entry->inFlight.load() == 0)
+        {
+            return;
+        }
+
+        entry->waiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(entry->returnedMutex);
+            entry->returned.wait(lock, [&entry]() { return entry->inFlight.load() == 0; });
+        }
+        entry->waiters.fetch_sub(1);
+    }
+
+    std::map<CallbackToken, std::shared_ptr<CallbackEntry>> m_callbacks;
     CallbackToken m_nextCallbackToken;
     mutable std::recursive_mutex m_mutex;
 
+    /*! \endcond */
+
 private:
+
+    struct InvocationFrame
+    {
+        const EventSignalBase* signal;
+        InvocationFrame* previous;
+    };
+
+    static InvocationFrame*& CurrentInvocation()
+    {
+        static thread_local InvocationFrame* current = nullptr;
+        return current;
+    }
+
+    bool IsInCallback() const
+    {
+        for (auto frame = CurrentInvocation(); frame != nullptr; frame = frame->previous)
+        {
+            if (frame->signal == this)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Counts a Signal in progress in the reader epoch current when it started.
+    struct ReaderScope
+    {
+        ReaderScope(std::atomic<uint32_t>* readers, const std::atomic<uint32_t>& epoch) : m_readers(readers[epoch.load()]) { m_readers.fetch_add(1); }
+        ~ReaderScope() { m_readers.fetch_sub(1); }
+        std::atomic<uint32_t>& m_readers;
+    };
+
+    struct InvocationScope
+    {
+        InvocationScope(CallbackEntry& entry, const EventSignalBase* signal) :
+            m_entry(entry),
+            m_frame{ signal, CurrentInvocation() }
+        {
+            m_entry.inFlight.fetch_add(1);
+            CurrentInvocation() = &m_frame;
+        }
+
+        ~InvocationScope()
+        {
+            CurrentInvocation() = m_frame.previous;
+            if (m_entry.inFlight.fetch_sub(1) == 1 && m_entry.waiters.load() != 0)
+            {
+                std::lock_guard<std::mutex> lock(m_entry.returnedMutex);
+                m_entry.returned.notify_all();
+            }
+        }
+
+        CallbackEntry& m_entry;
+        InvocationFrame m_frame;
+    };
+
+    struct RetiredSnapshot
+    {
+        uint64_t flips;
+        std::unique_ptr<const CallbackList> list;
+    };
+
+    // Replaces the published snapshot; must be called with m_mutex held. A replaced snapshot can still be read by
+    // a concurrent Signal, so it is retired. Signals are counted per reader epoch, and the epoch is only flipped to
+    // the other one once the Signals counted in that one have returned. After two flips that follow the replacement,
+    // every Signal that could have read the retired snapshot has returned, however many Signals started since.
+    void PublishSnapshot()
+    {
+        std::unique_ptr<CallbackList> next;
+        if (!m_callbacks.empty())
+        {
+            next.reset(new CallbackList());
+            next->reserve(m_callbacks.size());
+            for (auto& item : m_callbacks)
+            {
+                next->push_back(item.second);
+            }
+        }
+
+        auto previous = m_snapshot.exchange(next.release());
+        if (previous != nullptr)
+        {
+            m_retired.push_back(RetiredSnapshot{ m_flips, std::unique_ptr<const CallbackList>(previous) });
+        }
+
+        for (int flip = 0; flip < 2 && m_readers[(m_flips + 1) & 1].load() == 0; flip++)
+        {
+            m_flips++;
+            m_epoch.store(static_cast<uint32_t>(m_flips & 1));
+        }
+
+        auto flips = m_flips;
+        m_retired.erase(
+            std::remove_if(m_retired.begin(), m_retired.end(), [flips](const RetiredSnapshot& retired) { return retired.flips + 2 <= flips; }),
+            m_retired.end());
+    }
+
+    std::atomic<const CallbackList*> m_snapshot;
+    std::atomic<uint32_t> m_epoch;
+    std::atomic<uint32_t> m_readers[2];
+    uint64_t m_flips;
+    std::vector<RetiredSnapshot> m_retired;
+
     EventSignalBase(const EventSignalBase&) = delete;
     EventSignalBase(const EventSignalBase&&) = delete;
     EventSignalBase& operator=(const EventSignalBase&) = delete;
@@ -0,0 +1,823 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_flac_codec.h: Public API declarations for the in-process FLAC encoder and its codec plugin
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_audio_stream.h"
+#include "speechapi_cxx_audio_stream_format.h"
+#include "speechapi_c_ext_audiocompression.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Audio {
+
+/// <summary>
+/// Streaming, lossless FLAC encoder for 16-bit PCM.
+/// Each block is coded with the best of the fixed linear predictors of order 0 to 4 and a partitioned Rice code,
+/// or as a constant or verbatim subframe when that is smaller. The stream uses variable block sizes so that
+/// <see cref="Flush"/> can emit a short block without waiting for a full one.
+/// </summary>
+/// <remarks>Speech typically compresses to a third to a half of its PCM size, more with pauses.</remarks>
+class FlacEncoder
+{
+public:
+
+    /// <summary>
+    /// Callback receiving the encoded data: the stream header first, then one call per frame.
+    /// </summary>
+    /// <param name="data">The encoded bytes; only valid during the call.</param>
+    /// <param name="size">The number of bytes.</param>
+    /// <param name="samplesPerChannel">The number of samples per channel in the frame; zero for the stream header.</param>
+    using DataCallback = std::function<void(const uint8_t* data, size_t size, uint32_t samplesPerChannel)>;
+
+    /// <summary>
+    /// Samples per channel in a block by default; 256 ms at 16 kHz.
+    /// </summary>
+    static constexpr uint32_t DefaultBlockSize = 4096;
+
+    /// <summary>
+    /// Samples per channel in a block in low-delay mode; 64 ms at 16 kHz.
+    /// </summary>
+    static constexpr uint32_t LowDelayBlockSize = 1024;
+
+    /// <summary>
+    /// Creates an encoder.
+    /// </summary>
+    /// <param name="samplesPerSecond">The sample rate.</param>
+    /// <param name="channels">The number of interleaved channels, 1 to 8.</param>
+    /// <param name="callback">The callback receiving the encoded data.</param>
+    /// <param name="blockSize">Samples per channel in a block, 16 to 65535.</param>
+    FlacEncoder(uint32_t samplesPerSecond, uint8_t channels, DataCallback callback, uint32_t blockSize = DefaultBlockSize) :
+        m_samplesPerSecond(samplesPerSecond),
+        m_channels(channels),
+        m_blockSize(blockSize),
+        m_callback(std::move(callback))
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, samplesPerSecond == 0 || samplesPerSecond >= (1u << 20));
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, channels == 0 || channels > 8);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, blockSize < MinBlockSize || blockSize > 65535);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, m_callback == nullptr);
+
+        m_block.resize(static_cast<size_t>(channels) * blockSize);
+        m_residual.resize(blockSize);
+        m_frame.reserve(static_cast<size_t>(channels) * blockSize * 2 + 64);
+    }
+
+    /// <summary>
+    /// Encodes little-endian 16-bit PCM. A trailing partial sample frame is kept until the next call.
+    /// </summary>
+    /// <param name="pcm">The PCM data, interleaved by channel.</param>
+    /// <param name="size">The size of the data in bytes.</param>
+    void Encode(const uint8_t* pcm, size_t size)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, pcm == nullptr && size > 0);
+
+        const size_t bytesPerFrame = 2 * static_cast<size_t>(m_channels);
+        while (size > 0 && m_partialSize > 0)
+        {
+            m_partial[m_partialSize++] = *pcm++;
+            size--;
+            if (m_partialSize == bytesPerFrame)
+            {
+                m_partialSize = 0;
+                Append(m_partial, 1);
+            }
+        }
+
+        auto frames = size / bytesPerFrame;
+        Append(pcm, frames);
+
+        pcm += frames * bytesPerFrame;
+        size -= frames * bytesPerFrame;
+        std::memcpy(m_partial, pcm, size);
+        m_partialSize = size;
+    }
+
+    /// <summary>
+    /// Encodes 16-bit PCM samples.
+    /// </summary>
+    /// <param name="samples">The samples, interleaved by channel.</param>
+    /// <param name="count">The number of samples, a multiple of the number of channels.</param>
+    void Encode(const int16_t* samples, size_t count)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, count % m_channels != 0);
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_partialSize != 0);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, samples == nullptr && count > 0);
+
+        const size_t frames = count / m_channels;
+        for (size_t frame = 0; frame < frames; )
+        {
+            auto n = std::min<size_t>(frames - frame, m_blockSize - m_pending);
+            for (uint8_t channel = 0; channel < m_channels; channel++)
+            {
+                auto dst = &m_block[channel * static_cast<size_t>(m_blockSize) + m_pending];
+                auto src = samples + frame * m_channels + channel;
+                for (size_t i = 0; i < n; i++)
+                {
+                    dst[i] = src[i * m_channels];
+                }
+            }
+            frame += n;
+            m_pending += static_cast<uint32_t>(n);
+            if (m_pending == m_blockSize)
+            {
+                EncodeBlock();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Emits the buffered samples as a short frame, unless there are fewer than 16 of them.
+    /// </summary>
+    void Flush()
+    {
+        if (m_pending >= MinBlockSize)
+        {
+            EncodeBlock();
+        }
+    }
+
+    /// <summary>
+    /// Emits all buffered samples; makes sure the stream header was emitted even for an empty stream.
+    /// </summary>
+    void Finish()
+    {
+        if (m_pending > 0)
+        {
+            EncodeBlock();
+        }
+        WriteStreamHeader();
+    }
+
+    /// <summary>
+    /// Gets the number of samples per channel encoded so far.
+    /// </summary>
+    /// <returns>The number of samples.</returns>
+    uint64_t GetEncodedSamples() const { return m_sampleNumber; }
+
+    /// <summary>
+    /// Gets the number of bytes emitted so far, including the stream header.
+    /// </summary>
+    /// <returns>The number of bytes.</returns>
+    uint64_t GetEncodedBytes() const { return m_encodedBytes; }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(FlacEncoder);
+
+    static constexpr uint32_t MinBlockSize = 16;
+    static constexpr uint32_t MaxFixedOrder = 4;
+    static constexpr uint32_t MaxPartitionOrder = 8;
+
+    class BitWriter
+    {
+    public:
+
+        explicit BitWriter(std::vector<uint8_t>& bytes) : m_bytes(bytes) {}
+
+        void Write(uint32_t value, uint32_t bits)
+        {
+            if (bits == 0)
+            {
+                return;
+            }
+            m_accumulator = (m_accumulator << bits) | (bits < 32 ? value & ((1u << bits) - 1) : value);
+            m_count += bits;
+            while (m_count >= 8)
+            {
+                m_count -= 8;
+                m_bytes.push_back(static_cast<uint8_t>(m_accumulator >> m_count));
+            }
+        }
+
+        void WriteSigned(int32_t value, uint32_t bits)
+        {
+            Write(static_cast<uint32_t>(value), bits);
+        }
+
+        void WriteZeros(uint32_t count)
+        {
+            for (; count > 24; count -= 24)
+            {
+                Write(0, 24);
+            }
+            Write(0, count);
+        }
+
+        void WriteRice(uint32_t value, uint32_t parameter)
+        {
+            WriteZeros(value >> parameter);
+            Write(1, 1);
+            Write(value, parameter);
+        }
+
+        void WriteUtf8(uint64_t value)
+        {
+            if (value < 0x80)
+            {
+                Write(static_cast<uint32_t>(value), 8);
+                return;
+            }
+
+            uint32_t bytes = value < 0x800 ? 2 : value < 0x10000 ? 3 : value < 0x200000 ? 4 : value < 0x4000000 ? 5 : value < 0x80000000 ? 6 : 7;
+            Write(((0xFF00u >> bytes) & 0xFF) | static_cast<uint32_t>(value >> (6 * (bytes - 1))), 8);
+            for (auto i = bytes - 1; i-- > 0; )
+            {
+                Write(0x80 | static_cast<uint32_t>((value >> (6 * i)) & 0x3F), 8);
+            }
+        }
+
+        void AlignToByte()
+        {
+            Write(0, (8 - m_count) & 7);
+        }
+
+    private:
+
+        std::vector<uint8_t>& m_bytes;
+        uint64_t m_accumulator = 0;
+        uint32_t m_count = 0;
+    };
+
+    void Append(const uint8_t* pcm, size_t frames)
+    {
+        const size_t bytesPerFrame = 2 * static_cast<size_t>(m_channels);
+        while (frames > 0)
+        {
+            auto n = std::min<size_t>(frames, m_blockSize - m_pending);
+            for (uint8_t channel = 0; channel < m_channels; channel++)
+            {
+                auto dst = &m_block[channel * static_cast<size_t>(m_blockSize) + m_pending];
+                auto src = pcm + 2 * channel;
+                for (size_t i = 0; i < n; i++)
+                {
+                    dst[i] = static_cast<int16_t>(src[i * bytesPerFrame] | (src[i * bytesPerFrame + 1] << 8));
+                }
+            }
+            pcm += n * bytesPerFrame;
+            frames -= n;
+            m_pending += static_cast<uint32_t>(n);
+            if (m_pending == m_blockSize)
+            {
+                EncodeBlock();
+            }
+        }
+    }
+
+    void Emit(uint32_t samplesPerChannel)
+    {
+        m_encodedBytes += m_frame.size();
+        m_callback(m_frame.data(), m_frame.size(), samplesPerChannel);
+        m_frame.clear();
+    }
+
+    void WriteStreamHeader()
+    {
+        if (m_headerWritten)
+        {
+            return;
+        }
+        m_headerWritten = true;
+
+        static const uint8_t marker[4] = { 'f', 'L', 'a', 'C' };
+        m_frame.assign(marker, marker + sizeof(marker));
+
+        BitWriter bits(m_frame);
+        bits.Write(1, 1);                       // last metadata block
+        bits.Write(0, 7);                       // STREAMINFO
+        bits.Write(34, 24);
+        bits.Write(MinBlockSize, 16);
+        bits.Write(m_blockSize, 16);
+        bits.Write(0, 24);                      // minimum and maximum frame size unknown
+        bits.Write(0, 24);
+        bits.Write(m_samplesPerSecond, 20);
+        bits.Write(m_channels - 1u, 3);
+        bits.Write(15, 5);                      // 16 bits per sample
+        bits.Write(0, 4);                       // total samples unknown, the stream is written as it is encoded
+        bits.Write(0, 32);
+        for (int i = 0; i < 4; i++)
+        {
+            bits.Write(0, 32);                  // no MD5 signature
+        }
+
+        Emit(0);
+    }
+
+    void EncodeBlock()
+    {
+        WriteStreamHeader();
+
+        const auto blockSize = m_pending;
+        BitWriter bits(m_frame);
+        bits.Write(0xFFF9, 16);                 // sync code, variable block size
+        bits.Write(7, 4);                       // block size - 1 follows as 16 bits
+        bits.Write(SampleRateCode(m_samplesPerSecond), 4);
+        bits.Write(m_channels - 1u, 4);         // independent channels
+        bits.Write(4, 3);                       // 16 bits per sample
+        bits.Write(0, 1);
+        bits.WriteUtf8(m_sampleNumber);
+        bits.Write(blockSize - 1, 16);
+        bits.Write(Crc8(m_frame.data(), m_frame.size()), 8);
+
+        for (uint8_t channel = 0; channel < m_channels; channel++)
+        {
+            EncodeSubframe(bits, &m_block[channel * static_cast<size_t>(m_blockSize)], blockSize);
+        }
+
+        bits.AlignToByte();
+        bits.Write(Crc16(m_frame.data(), m_frame.size()), 16);
+
+        m_sampleNumber += blockSize;
+        m_pending = 0;
+        Emit(blockSize);
+    }
+
+    void EncodeSubframe(BitWriter& bits, const int16_t* samples, uint32_t count)
+    {
+        if (std::all_of(samples + 1, samples + count, [&](int16_t sample) { return sample == samples[0]; }))
+        {
+            bits.Write(0, 8);                   // constant subframe
+            bits.WriteSigned(samples[0], 16);
+            return;
+        }
+
+        auto order = ChooseFixedOrder(samples, count);
+        ComputeResidual(samples, count, order);
+
+        uint32_t parameters[1 << MaxPartitionOrder];
+        uint32_t partitionOrder = 0;
+        auto residualBits = ChooseRiceParameters(count, order, partitionOrder, parameters);
+        auto fixedBits = 8 + 16ull * order + residualBits;
+        auto verbatimBits = 8 + 16ull * count;
+
+        if (fixedBits >= verbatimBits)
+        {
+            bits.Write(2, 8);                   // verbatim subframe
+            for (uint32_t i = 0; i < count; i++)
+            {
+                bits.WriteSigned(samples[i], 16);
+            }
+            return;
+        }
+
+        bits.Write(0x10 | (order << 1), 8);     // fixed subframe of the given order
+        for (uint32_t i = 0; i < order; i++)
+        {
+            bits.WriteSigned(samples[i], 16);
+        }
+
+        auto partitions = 1u << partitionOrder;
+        auto useRice2 = std::any_of(parameters, parameters + partitions, [](uint32_t parameter) { return parameter > 14; });
+        bits.Write(useRice2 ? 1 : 0, 2);
+        bits.Write(partitionOrder, 4);
+
+        auto residual = m_residual.data();
+        for (uint32_t partition = 0; partition < partitions; partition++)
+        {
+            auto n = (count >> partitionOrder) - (partition == 0 ? order : 0);
+            bits.Write(parameters[partition], useRice2 ? 5 : 4);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                bits.WriteRice(*residual++, parameters[partition]);
+            }
+        }
+    }
+
+    // Picks the fixed predictor order with the smallest sum of absolute residuals. The differences are computed
+    // in one branch-free pass over the block so that the loop vectorizes.
+    static uint32_t ChooseFixedOrder(const int16_t* samples, uint32_t count)
+    {
+        if (count <= MaxFixedOrder)
+        {
+            return 0;
+        }
+
+        uint64_t sums[MaxFixedOrder + 1] = {};
+        for (uint32_t i = MaxFixedOrder; i < count; i++)
+        {
+            int32_t e0 = samples[i];
+            int32_t e1 = e0 - samples[i - 1];
+            int32_t e2 = e1 - (samples[i - 1] - samples[i - 2]);
+            int32_t e3 = e2 - (samples[i - 1] - 2 * samples[i - 2] + samples[i - 3]);
+            int32_t e4 = e3 - (samples[i - 1] - 3 * samples[i - 2] + 3 * samples[i - 3] - samples[i - 4]);
+            sums[0] += static_cast<uint32_t>(std::abs(e0));
+            sums[1] += static_cast<uint32_t>(std::abs(e1));
+            sums[2] += static_cast<uint32_t>(std::abs(e2));
+            sums[3] += static_cast<uint32_t>(std::abs(e3));
+            sums[4] += static_cast<uint32_t>(std::abs(e4));
+        }
+        return static_cast<uint32_t>(std::min_element(sums, sums + MaxFixedOrder + 1) - sums);
+    }
+
+    // Stores the zigzag-folded residual of the fixed predictor of the given order.
+    void ComputeResidual(const int16_t* samples, uint32_t count, uint32_t order)
+    {
+        auto out = m_residual.data();
+        for (uint32_t i = order; i < count; i++)
+        {
+            int32_t prediction = 0;
+            switch (order)
+            {
+            case 1: prediction = samples[i - 1]; break;
+            case 2: prediction = 2 * samples[i - 1] - samples[i - 2]; break;
+            case 3: prediction = 3 * samples[i - 1] - 3 * samples[i - 2] + samples[i - 3]; break;
+            case 4: prediction = 4 * samples[i - 1] - 6 * samples[i - 2] + 4 * samples[i - 3] - samples[i - 4]; break;
+            default: break;
+            }
+            int32_t residual = samples[i] - prediction;
+            *out++ = (static_cast<uint32_t>(residual) << 1) ^ static_cast<uint32_t>(residual >> 31);
+        }
+    }
+
+    // Chooses the partition order and the Rice parameter of each partition, estimating the cost of a partition
+    // from the sum of its folded residuals. Returns the estimated number of residual bits.
+    uint64_t ChooseRiceParameters(uint32_t count, uint32_t order, uint32_t& bestOrder, uint32_t* bestParameters) const
+    {
+        uint32_t maxOrder = 0;
+        while (maxOrder < MaxPartitionOrder && (count % (2u << maxOrder)) == 0 && (count >> (maxOrder + 1)) > order)
+        {
+            maxOrder++;
+        }
+
+        uint64_t sums[1 << MaxPartitionOrder];
+        auto finest = 1u << maxOrder;
+        auto residual = m_residual.data();
+        for (uint32_t partition = 0; partition < finest; partition++)
+        {
+            auto n = (count >> maxOrder) - (partition == 0 ? order : 0);
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                sum += residual[i];
+            }
+            sums[partition] = sum;
+            residual += n;
+        }
+
+        uint64_t bestBits = UINT64_MAX;
+        for (auto partitionOrder = static_cast<int32_t>(maxOrder); partitionOrder >= 0; partitionOrder--)
+        {
+            auto partitions = 1u << partitionOrder;
+            uint32_t parameters[1 << MaxPartitionOrder];
+            uint64_t bits = 6;
+            for (uint32_t partition = 0; partition < partitions; partition++)
+            {
+                uint64_t n = (count >> partitionOrder) - (partition == 0 ? order : 0);
+                parameters[partition] = RiceParameter(sums[partition], n);
+                bits += 5 + n * (parameters[partition] + 1) + (sums[partition] >> parameters[partition]);
+            }
+
+            if (bits < bestBits)
+            {
+                bestBits = bits;
+                bestOrder = static_cast<uint32_t>(partitionOrder);
+                std::copy(parameters, parameters + partitions, bestParameters);
+            }
+
+            for (uint32_t partition = 0; partition < partitions / 2; partition++)
+            {
+                sums[partition] = sums[2 * partition] + sums[2 * partition + 1];
+            }
+        }
+        return bestBits;
+    }
+
+    static uint32_t RiceParameter(uint64_t sum, uint64_t count)
+    {
+        uint32_t parameter = 0;
+        while (parameter < 30 && (count << (parameter + 1)) < sum)
+        {
+            parameter++;
+        }
+        return parameter;
+    }
+
+    static uint32_t SampleRateCode(uint32_t samplesPerSecond)
+    {
+        switch (samplesPerSecond)
+        {
+        case 8000: return 4;
+        case 16000: return 5;
+        case 22050: return 6;
+        case 24000: return 7;
+        case 32000: return 8;
+        case 44100: return 9;
+        case 48000: return 10;
+        default: return 0;                      // taken from STREAMINFO
+        }
+    }
+
+    static uint8_t Crc8(const uint8_t* data, size_t size)
+    {
+        uint8_t crc = 0;
+        for (size_t i = 0; i < size; i++)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = static_cast<uint8_t>((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    static uint16_t Crc16(const uint8_t* data, size_t size)
+    {
+        uint16_t crc = 0;
+        for (size_t i = 0; i < size; i++)
+        {
+            crc ^= static_cast<uint16_t>(data[i] << 8);
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x8005 : crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    const uint32_t m_samplesPerSecond;
+    const uint8_t m_channels;
+    const uint32_t m_blockSize;
+    DataCallback m_callback;
+
+    std::vector<int16_t> m_block;
+    std::vector<uint32_t> m_residual;
+    std::vector<uint8_t> m_frame;
+    uint32_t m_pending = 0;
+    uint64_t m_sampleNumber = 0;
+    uint64_t m_encodedBytes = 0;
+    bool m_headerWritten = false;
+
+    uint8_t m_partial[16] = {};
+    size_t m_partialSize = 0;
+};
+
+/// <summary>
+/// Codec plugin implementing the audio compression plugin interface with <see cref="FlacEncoder"/>.
+/// A codec module exports it with <see cref="SPX_FLAC_CODEC_EXPORT"/>.
+/// </summary>
+/// <remarks>The codec id "flac" or an empty id selects the default block size, "flac-lowdelay" the low-delay one.</remarks>
+class FlacCodec : private codec_c_interface
+{
+public:
+
+    /// <summary>
+    /// The format reported by the codec.
+    /// </summary>
+    static constexpr const char* FormatType = "audio/flac";
+
+    /// <summary>
+    /// Creates a codec object.
+    /// </summary>
+    /// <param name="codecid">The codec id, see the remarks of the class.</param>
+    /// <param name="codecContext">Context of the caller; not used.</param>
+    /// <param name="propertyRead">Function to read properties; not used.</param>
+    /// <returns>The codec object, or nullptr for an unknown codec id.</returns>
+    static SPXCODECCTYPE Create(const char* codecid, void* codecContext, SPX_CODEC_CLIENT_GET_PROPERTY propertyRead)
+    {
+        UNUSED(codecContext);
+        UNUSED(propertyRead);
+
+        uint32_t blockSize = 0;
+        if (codecid == nullptr || *codecid == '\0' || std::strcmp(codecid, "flac") == 0)
+        {
+            blockSize = FlacEncoder::DefaultBlockSize;
+        }
+        else if (std::strcmp(codecid, "flac-lowdelay") == 0)
+        {
+            blockSize = FlacEncoder::LowDelayBlockSize;
+        }
+        else
+        {
+            return nullptr;
+        }
+
+        auto codec = new (std::nothrow) FlacCodec(blockSize);
+        return codec == nullptr ? nullptr : static_cast<SPXCODECCTYPE>(codec);
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(FlacCodec);
+
+    explicit FlacCodec(uint32_t blockSize) : codec_c_interface(), m_blockSize(blockSize)
+    {
+        init = Init;
+        get_format_type = GetFormatType;
+        encode = EncodeThunk;
+        flush = FlushThunk;
+        endstream = EndStream;
+        destroy = Destroy;
+    }
+
+    static FlacCodec* From(SPXCODECCTYPE codec)
+    {
+        return static_cast<FlacCodec*>(codec);
+    }
+
+    template<class F>
+    static SPXAPI_RESULTTYPE Invoke(SPXCODECCTYPE codec, F&& function)
+    {
+        if (codec == nullptr)
+        {
+            return SPXERR_INVALID_ARG;
+        }
+        try
+        {
+            return function(*From(codec));
+        }
+        catch (SPXHR hr)
+        {
+            return hr;
+        }
+        catch (...)
+        {
+            return SPXERR_UNHANDLED_EXCEPTION;
+        }
+    }
+
+    static SPXAPI_RESULTTYPE SPXAPI_CALLTYPE Init(SPXCODECCTYPE codec, uint32_t inputSamplesPerSecond, uint8_t inputBitsPerSample, uint8_t inputChannels, AUDIO_ENCODER_ONENCODEDDATA dataCallback, void* pContext)
+    {
+        return Invoke(codec, [&](FlacCodec& self) -> SPXAPI_RESULTTYPE {
+            if (inputBitsPerSample != 16 || dataCallback == nullptr)
+            {
+                return inputBitsPerSample != 16 ? SPXERR_UNSUPPORTED_FORMAT : SPXERR_INVALID_ARG;
+            }
+
+            auto samplesPerSecond = inputSamplesPerSecond;
+            self.m_encoder.reset(new FlacEncoder(inputSamplesPerSecond, inputChannels, [=](const uint8_t* data, size_t size, uint32_t samples) {
+                dataCallback(data, size, samples * 10000000ull / samplesPerSecond, pContext);
+            }, self.m_blockSize));
+            return SPX_NOERROR;
+        });
+    }
+
+    static SPXAPI_RESULTTYPE SPXAPI_CALLTYPE GetFormatType(SPXCODECCTYPE codec, char* buffer, uint64_t* buffersize)
+    {
+        return Invoke(codec, [&](FlacCodec&) -> SPXAPI_RESULTTYPE {
+            if (buffersize == nullptr)
+            {
+                return SPXERR_INVALID_ARG;
+            }
+
+            auto required = static_cast<uint64_t>(std::strlen(FormatType) + 1);
+            if (buffer == nullptr)
+            {
+                *buffersize = required;
+                return SPX_NOERROR;
+            }
+            if (*buffersize < required)
+            {
+                return SPXERR_BUFFER_TOO_SMALL;
+            }
+
+            std::memcpy(buffer, FormatType, static_cast<size_t>(required));
+            *buffersize = required;
+            return SPX_NOERROR;
+        });
+    }
+
+    static SPXAPI_RESULTTYPE SPXAPI_CALLTYPE EncodeThunk(SPXCODECCTYPE codec, const uint8_t* pBuffer, size_t bytesToWrite)
+    {
+        return Invoke(codec, [&](FlacCodec& self) -> SPXAPI_RESULTTYPE {
+            if (self.m_encoder == nullptr)
+            {
+                return SPXERR_INVALID_STATE;
+            }
+            self.m_encoder->Encode(pBuffer, bytesToWrite);
+            return SPX_NOERROR;
+        });
+    }
+
+    static SPXAPI_RESULTTYPE SPXAPI_CALLTYPE FlushThunk(SPXCODECCTYPE codec)
+    {
+        return Invoke(codec, [&](FlacCodec& self) -> SPXAPI_RESULTTYPE {
+            if (self.m_encoder != nullptr)
+            {
+                self.m_encoder->Flush();
+            }
+            return SPX_NOERROR;
+        });
+    }
+
+    static SPXAPI_RESULTTYPE SPXAPI_CALLTYPE EndStream(SPXCODECCTYPE codec)
+    {
+        return Invoke(codec, [&](FlacCodec& self) -> SPXAPI_RESULTTYPE {
+            if (self.m_encoder != nullptr)
+            {
+                self.m_encoder->Finish();
+            }
+            return SPX_NOERROR;
+        });
+    }
+
+    static SPXAPI_RESULTTYPE SPXAPI_CALLTYPE Destroy(SPXCODECCTYPE codec)
+    {
+        delete From(codec);
+        return SPX_NOERROR;
+    }
+
+    const uint32_t m_blockSize;
+    std::unique_ptr<FlacEncoder> m_encoder;
+};
+
+/// <summary>
+/// Writes 16-bit PCM into a push stream as FLAC, for recognizers that should upload compressed audio.
+/// </summary>
+class FlacPushAudioInputStreamWriter
+{
+public:
+
+    /// <summary>
+    /// Creates a writer together with a push stream in the FLAC container format.
+    /// </summary>
+    /// <param name="samplesPerSecond">The sample rate of the PCM.</param>
+    /// <param name="channels">The number of interleaved channels of the PCM.</param>
+    /// <param name="lowDelay">Whether to use the low-delay block size.</param>
+    /// <returns>The writer.</returns>
+    static std::shared_ptr<FlacPushAudioInputStreamWriter> Create(uint32_t samplesPerSecond = 16000, uint8_t channels = 1, bool lowDelay = false)
+    {
+        auto stream = PushAudioInputStream::Create(AudioStreamFormat::GetCompressedFormat(AudioStreamContainerFormat::FLAC));
+        return std::shared_ptr<FlacPushAudioInputStreamWriter>(new FlacPushAudioInputStreamWriter(std::move(stream), samplesPerSecond, channels,
+            lowDelay ? FlacEncoder::LowDelayBlockSize : FlacEncoder::DefaultBlockSize));
+    }
+
+    /// <summary>
+    /// Gets the push stream receiving the encoded audio, e.g. for AudioConfig::FromStreamInput.
+    /// </summary>
+    /// <returns>The stream.</returns>
+    std::shared_ptr<PushAudioInputStream> GetStream() const { return m_stream; }
+
+    /// <summary>
+    /// Encodes PCM samples into the stream.
+    /// </summary>
+    /// <param name="samples">The samples, interleaved by channel.</param>
+    /// <param name="count">The number of samples.</param>
+    void Write(const int16_t* samples, size_t count)
+    {
+        m_encoder.Encode(samples, count);
+    }
+
+    /// <summary>
+    /// Emits the buffered samples to the stream, e.g. at the end of an utterance.
+    /// </summary>
+    void Flush()
+    {
+        m_encoder.Flush();
+    }
+
+    /// <summary>
+    /// Emits the remaining samples and closes the stream.
+    /// </summary>
+    void Close()
+    {
+        m_encoder.Finish();
+        m_stream->Close();
+    }
+
+    /// <summary>
+    /// Gets the encoder, e.g. to read its counters.
+    /// </summary>
+    /// <returns>The encoder.</returns>
+    const FlacEncoder& GetEncoder() const { return m_encoder; }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(FlacPushAudioInputStreamWriter);
+
+    FlacPushAudioInputStreamWriter(std::shared_ptr<PushAudioInputStream> stream, uint32_t samplesPerSecond, uint8_t channels, uint32_t blockSize) :
+        m_stream(std::move(stream)),
+        m_encoder(samplesPerSecond, channels, [this](const uint8_t* data, size_t size, uint32_t) {
+            m_stream->Write(const_cast<uint8_t*>(data), static_cast<uint32_t>(size));
+        }, blockSize)
+    {
+    }
+
+    std::shared_ptr<PushAudioInputStream> m_stream;
+    FlacEncoder m_encoder;
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Audio
+
+/// <summary>
+/// Defines the exported codec_create function of a codec module backed by <see cref="FlacCodec"/>.
+/// Use it in exactly one translation unit of the module.
+/// </summary>
+#define SPX_FLAC_CODEC_EXPORT()                                                                                             \
+    SPX_EXTERN_C SPXDLL_EXPORT SPXCODECCTYPE codec_create(const char* codecid, void* codecContext, SPX_CODEC_CLIENT_GET_PROPERTY property_read_func) \
+    {                                                                                                                       \
+        return ::Microsoft::CognitiveServices::Speech::Audio::FlacCodec::Create(codecid, codecContext, property_read_func); \
+    }
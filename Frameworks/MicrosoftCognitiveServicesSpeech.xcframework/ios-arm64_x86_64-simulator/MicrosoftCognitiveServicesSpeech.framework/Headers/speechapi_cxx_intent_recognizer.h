@@ -7,6 +7,7 @@
 
 #pragma once
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_c.h"
 #include "speechapi_c_json.h"
@@ -120,7 +121,7 @@ namespace Intent {
         std::future<std::shared_ptr<IntentRecognitionResult>> RecognizeOnceAsync(SPXSTRING text)
         {
             auto keepAlive = this->shared_from_this();
-            auto future = std::async(std::launch::async, [keepAlive, this, text]() -> std::shared_ptr<IntentRecognitionResult> {
+            auto future = Utils::RunAsync([keepAlive, this, text]() -> std::shared_ptr<IntentRecognitionResult> {
                 SPX_INIT_HR(hr);
 
                 SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
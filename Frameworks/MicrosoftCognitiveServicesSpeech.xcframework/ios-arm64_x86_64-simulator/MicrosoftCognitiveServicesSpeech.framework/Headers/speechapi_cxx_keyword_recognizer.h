@@ -18,6 +18,7 @@
 #include "speechapi_cxx_keyword_recognition_result.h"
 #include "speechapi_cxx_utils.h"
 #include "speechapi_cxx_properties.h"
+#include "speechapi_cxx_async_executor.h"
 
 namespace Microsoft {
 namespace CognitiveServices {
@@ -108,7 +109,7 @@ public:
     inline std::future<std::shared_ptr<KeywordRecognitionResult>> RecognizeOnceAsync(std::shared_ptr<KeywordRecognitionModel> model)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, model, this]()
+        auto future = Utils::RunAsync([keepAlive, model, this]()
         {
             auto modelHandle = static_cast<SPXKEYWORDHANDLE>(*model);
 
@@ -127,7 +128,7 @@ public:
     inline std::future<void> StopRecognitionAsync()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]()
+        auto future = Utils::RunAsync([keepAlive, this]()
         {
             SPX_THROW_ON_FAIL(recognizer_stop_keyword_recognition(m_handle));
         });
@@ -4,6 +4,9 @@
 //
 
 #pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace Microsoft {
 namespace CognitiveServices {
@@ -60,6 +63,47 @@ namespace Details
         case Level::Verbose: return "verbose";
         }
     }
+
+    // A shared pointer replaced by one thread while log callbacks read it on SDK threads. Uses
+    // std::atomic<std::shared_ptr> where the standard library has it, since the std::atomic_load and
+    // std::atomic_store overloads for shared_ptr are deprecated in C++20, and a mutex otherwise. libstdc++ is
+    // left on the mutex: its load releases the internal lock with relaxed ordering, which races with a store.
+#if defined(__cpp_lib_atomic_shared_ptr) && !defined(__GLIBCXX__)
+#define AZAC_ATOMIC_SHARED_PTR 1
+#endif
+    template <class T>
+    class AtomicSharedPtr
+    {
+    public:
+        std::shared_ptr<T> load() const
+        {
+#if defined(AZAC_ATOMIC_SHARED_PTR)
+            return m_value.load(std::memory_order_acquire);
+#else
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_value;
+#endif
+        }
+
+        // The previous value is released after the lock, as its destructor may log.
+        void store(std::shared_ptr<T> value)
+        {
+#if defined(AZAC_ATOMIC_SHARED_PTR)
+            value = m_value.exchange(std::move(value), std::memory_order_acq_rel);
+#else
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_value.swap(value);
+#endif
+        }
+
+    private:
+#if defined(AZAC_ATOMIC_SHARED_PTR)
+        std::atomic<std::shared_ptr<T>> m_value;
+#else
+        mutable std::mutex m_mutex;
+        std::shared_ptr<T> m_value;
+#endif
+    };
 }
 /*! \endcond */
 
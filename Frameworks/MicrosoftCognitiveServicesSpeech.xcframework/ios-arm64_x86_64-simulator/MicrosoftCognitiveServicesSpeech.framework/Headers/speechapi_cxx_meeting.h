@@ -18,6 +18,7 @@
 #include "speechapi_cxx_utils.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_user.h"
@@ -46,7 +47,7 @@ public:
     static std::future<std::shared_ptr<Meeting>> CreateMeetingAsync(std::shared_ptr<SpeechConfig> speechConfig, const SPXSTRING& meetingId)
     {
         SPX_THROW_HR_IF(SPXERR_INVALID_ARG, meetingId.empty());
-        auto future = std::async(std::launch::async, [meetingId, speechConfig]() -> std::shared_ptr<Meeting> {
+        auto future = Utils::RunAsync([meetingId, speechConfig]() -> std::shared_ptr<Meeting> {
             SPXMEETINGHANDLE hmeeting;
             SPX_THROW_ON_FAIL(meeting_create_from_config(&hmeeting, (SPXSPEECHCONFIGHANDLE)(*speechConfig), Utils::ToUTF8(meetingId).c_str()));
             return std::make_shared<Meeting>(hmeeting);
@@ -106,7 +107,7 @@ public:
     std::future<std::shared_ptr<Participant>> AddParticipantAsync(const SPXSTRING& userId)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this, userId]() -> std::shared_ptr<Participant> {
+        auto future = Utils::RunAsync([keepAlive, this, userId]() -> std::shared_ptr<Participant> {
             const auto participant = Participant::From(userId);
             SPX_THROW_ON_FAIL(meeting_update_participant(m_hmeeting, true, (SPXPARTICIPANTHANDLE)(*participant)));
             return participant;
@@ -122,7 +123,7 @@ public:
     std::future<std::shared_ptr<User>> AddParticipantAsync(const std::shared_ptr<User>& user)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this, user]() -> std::shared_ptr<User> {
+        auto future = Utils::RunAsync([keepAlive, this, user]() -> std::shared_ptr<User> {
             SPX_THROW_ON_FAIL(meeting_update_participant_by_user(m_hmeeting, true, (SPXUSERHANDLE)(*user)));
             return user;
         });
@@ -137,7 +138,7 @@ public:
     std::future<std::shared_ptr<Participant>> AddParticipantAsync(const std::shared_ptr<Participant>& participant)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this, participant]() -> std::shared_ptr<Participant> {
+        auto future = Utils::RunAsync([keepAlive, this, participant]() -> std::shared_ptr<Participant> {
             SPX_THROW_ON_FAIL(meeting_update_participant(m_hmeeting, true, (SPXPARTICIPANTHANDLE)(*participant)));
             return participant;
         });
@@ -152,7 +153,7 @@ public:
     std::future<void> RemoveParticipantAsync(const std::shared_ptr<Participant>& participant)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this, participant]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this, participant]() -> void {
             SPX_THROW_ON_FAIL(meeting_update_participant(m_hmeeting, false, (SPXPARTICIPANTHANDLE)(*participant)));
         });
         return future;
@@ -166,7 +167,7 @@ public:
     std::future<void> RemoveParticipantAsync(const std::shared_ptr<User>& user)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this, user]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this, user]() -> void {
             SPX_THROW_ON_FAIL(meeting_update_participant_by_user(m_hmeeting, false, SPXUSERHANDLE(*user)));
         });
         return future;
@@ -180,7 +181,7 @@ public:
     std::future<void> RemoveParticipantAsync(const SPXSTRING& userId)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this, userId]() -> void {
+        auto future = Utils::RunAsync([keepAlive, this, userId]() -> void {
             SPX_THROW_ON_FAIL(meeting_update_participant_by_user_id(m_hmeeting, false, Utils::ToUTF8(userId.c_str())));
         });
         return future;
@@ -321,7 +322,7 @@ private:
     inline std::future<void> RunAsync(std::function<SPXHR(SPXMEETINGHANDLE)> func)
     {
         auto keepalive = this->shared_from_this();
-        return std::async(std::launch::async, [keepalive, this, func]()
+        return Utils::RunAsync([keepalive, this, func]()
         {
             SPX_THROW_ON_FAIL(func(m_hmeeting));
         });
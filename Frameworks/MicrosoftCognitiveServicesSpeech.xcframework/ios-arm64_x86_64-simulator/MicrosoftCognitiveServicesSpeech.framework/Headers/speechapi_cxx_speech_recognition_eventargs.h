@@ -8,6 +8,7 @@
 #pragma once
 #include <string>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_object_pool.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_recognition_eventargs.h"
 #include "speechapi_cxx_speech_recognition_result.h"
@@ -43,6 +44,20 @@ public:
         SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)m_hevent);
     };
 
+    /// <summary>
+    /// Constructor. The result is created in storage drawn from the pool.
+    /// </summary>
+    /// <param name="hevent">Event handle</param>
+    /// <param name="pool">Pool of the recognizer that raised the event.</param>
+    SpeechRecognitionEventArgs(SPXEVENTHANDLE hevent, const std::shared_ptr<Utils::ObjectPool>& pool) :
+        RecognitionEventArgs(hevent),
+        m_hevent(hevent),
+        m_result(Utils::MakePooledShared<SpeechRecognitionResult>(pool, ResultHandleFromEventHandle(hevent))),
+        Result(m_result)
+    {
+        SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)m_hevent);
+    };
+
     /// <inheritdoc/>
     virtual ~SpeechRecognitionEventArgs()
     {
@@ -7,6 +7,7 @@
 
 #pragma once
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_object_pool.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_eventargs.h"
 #include "speechapi_cxx_speech_synthesis_result.h"
@@ -41,6 +42,19 @@ public:
         SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)m_hevent);
     };
 
+    /// <summary>
+    /// Constructor. The result is created in storage drawn from the pool.
+    /// </summary>
+    /// <param name="hevent">Event handle</param>
+    /// <param name="pool">Pool of the synthesizer that raised the event.</param>
+    SpeechSynthesisEventArgs(SPXEVENTHANDLE hevent, const std::shared_ptr<Utils::ObjectPool>& pool) :
+        m_hevent(hevent),
+        m_result(Utils::MakePooledShared<SpeechSynthesisResult>(pool, ResultHandleFromEventHandle(hevent))),
+        Result(m_result)
+    {
+        SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)m_hevent);
+    };
+
     /// <inheritdoc/>
     virtual ~SpeechSynthesisEventArgs()
     {
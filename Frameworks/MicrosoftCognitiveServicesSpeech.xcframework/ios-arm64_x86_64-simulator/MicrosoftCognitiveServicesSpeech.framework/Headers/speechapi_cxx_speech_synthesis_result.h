@@ -8,6 +8,7 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include <mutex>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_enums.h"
@@ -44,7 +45,7 @@ private:
             SPXPROPERTYBAGHANDLE hpropbag = SPXHANDLE_INVALID;
             synth_result_get_property_bag(hresult, &hpropbag);
             return hpropbag;
-        }())
+        }(), true)
         {
         }
     };
@@ -82,18 +83,29 @@ public:
         SPX_THROW_ON_FAIL(synth_result_get_reason(hresult, &resultReason));
         m_reason = static_cast<ResultReason>(resultReason);
 
-        uint32_t audioLength = 0;
         uint64_t audioDuration = 0;
-        SPX_THROW_ON_FAIL(synth_result_get_audio_length_duration(m_hresult, &audioLength, &audioDuration));
+        SPX_THROW_ON_FAIL(synth_result_get_audio_length_duration(m_hresult, &m_audioLength, &audioDuration));
         m_audioDuration = std::chrono::milliseconds(audioDuration);
+    }
 
-        m_audioData = std::make_shared<std::vector<uint8_t>>(audioLength);
-
-        if (audioLength > 0)
-        {
-            uint32_t filledSize = 0;
-            SPX_THROW_ON_FAIL(synth_result_get_audio_data(m_hresult, m_audioData->data(), audioLength, &filledSize));
-        }
+    /// <summary>
+    /// Move constructor. The result takes over the handle of the other result, which must not be used afterwards.
+    /// </summary>
+    /// <param name="other">The result to move from.</param>
+    SpeechSynthesisResult(SpeechSynthesisResult&& other) :
+        m_hresult(other.m_hresult),
+        m_properties(std::move(other.m_properties)),
+        ResultId(m_resultId),
+        Reason(m_reason),
+        AudioDuration(m_audioDuration),
+        Properties(m_properties),
+        m_resultId(std::move(other.m_resultId)),
+        m_reason(other.m_reason),
+        m_audioLength(other.m_audioLength),
+        m_audioData(std::move(other.m_audioData)),
+        m_audioDuration(other.m_audioDuration)
+    {
+        other.m_hresult = SPXHANDLE_INVALID;
     }
 
     /// <summary>
@@ -102,18 +114,56 @@ public:
     /// <returns>Length of synthesized audio</returns>
     uint32_t GetAudioLength()
     {
-        return static_cast<uint32_t>(m_audioData->size());
+        return m_audioLength;
     }
 
     /// <summary>
     /// Gets the synthesized audio.
+    /// The audio is copied from the native result on the first call; later calls return the same buffer.
     /// </summary>
     /// <returns>Synthesized audio data</returns>
     std::shared_ptr<std::vector<uint8_t>> GetAudioData()
     {
+        std::call_once(m_audioDataOnce, [this]() {
+            if (m_audioData != nullptr)
+            {
+                return;
+            }
+            auto audioData = std::make_shared<std::vector<uint8_t>>(m_audioLength);
+            if (m_audioLength > 0)
+            {
+                uint32_t filledSize = 0;
+                SPX_THROW_ON_FAIL(synth_result_get_audio_data(m_hresult, audioData->data(), m_audioLength, &filledSize));
+                audioData->resize(filledSize);
+            }
+            m_audioData = audioData;
+        });
         return m_audioData;
     }
 
+    /// <summary>
+    /// Copies the synthesized audio directly into the provided buffer, without allocating.
+    /// Use this instead of <see cref="GetAudioData"/> to forward audio (e.g. each Synthesizing chunk) to a player or socket
+    /// buffer with a single copy.
+    /// </summary>
+    /// <param name="buffer">Buffer receiving the audio; must hold at least <see cref="GetAudioLength"/> bytes.</param>
+    /// <param name="bufferSize">Size of the buffer in bytes.</param>
+    /// <returns>Number of bytes copied into the buffer.</returns>
+    uint32_t ReadAudioData(uint8_t* buffer, uint32_t bufferSize)
+    {
+        if (m_audioLength == 0)
+        {
+            return 0;
+        }
+
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, buffer == nullptr);
+        SPX_THROW_HR_IF(SPXERR_BUFFER_TOO_SMALL, bufferSize < m_audioLength);
+
+        uint32_t filledSize = 0;
+        SPX_THROW_ON_FAIL(synth_result_get_audio_data(m_hresult, buffer, bufferSize, &filledSize));
+        return filledSize;
+    }
+
     /// <summary>
     /// Explicit conversion operator.
     /// </summary>
@@ -152,7 +202,8 @@ public:
 
 private:
 
-    DISABLE_DEFAULT_CTORS(SpeechSynthesisResult);
+    SpeechSynthesisResult() = delete;
+    DISABLE_COPY_AND_ASSIGNMENT(SpeechSynthesisResult);
 
     /// <summary>
     /// Internal member variable that holds the result ID.
@@ -165,9 +216,15 @@ private:
     ResultReason m_reason;
 
     /// <summary>
-    /// Internal member variable that holds the audio data
+    /// Internal member variable that holds the audio length in bytes
+    /// </summary>
+    uint32_t m_audioLength = 0;
+
+    /// <summary>
+    /// Internal member variable that holds the audio data, copied from the native result on first use
     /// </summary>
     std::shared_ptr<std::vector<uint8_t>> m_audioData;
+    std::once_flag m_audioDataOnce;
 
     /// <summary>
     /// Internal member variable that holds the audio duration
@@ -5,12 +5,19 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <codecvt>
 #include <locale>
 #include <wchar.h>
 #include <vector>
 #include <limits>
+#if defined(__has_include)
+#if __has_include(<string_view>)
+#include <string_view>
+#endif
+#endif
 
 #include "azac_api_c_pal.h"
 #include "speechapi_cxx_common.h"
@@ -27,21 +34,173 @@ namespace Utils {
 
 namespace Details {
 
+    // Text is usually ASCII (property names and values, SSML markup, most transcripts), which converts between UTF-8 and
+    // wide strings by widening or narrowing each character. These checks look at eight bytes, or a block of wide
+    // characters, at a time; the widening and narrowing loops are left to the compiler to vectorize. A NUL character
+    // also fails the checks, since the platform conversion stops there.
+
+    inline bool IsAsciiWithoutNul(const char* value, size_t length)
+    {
+        const uint64_t highBits = 0x8080808080808080ull;
+        const uint64_t lowBits = 0x0101010101010101ull;
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, value + i, sizeof(word));
+            // The high bit of a byte is set in word - lowBits when the byte is zero (or a lower byte was), and in word
+            // when the byte is not ASCII.
+            if (((word - lowBits) | word) & highBits)
+            {
+                return false;
+            }
+        }
+        for (; i < length; i++)
+        {
+            if (static_cast<unsigned char>(value[i]) - 1u >= 0x7Fu)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool IsAsciiWithoutNul(const wchar_t* value, size_t length)
+    {
+        const size_t blockSize = 16;
+
+        size_t i = 0;
+        for (; i + blockSize <= length; i += blockSize)
+        {
+            uint32_t outside = 0;
+            for (size_t j = 0; j < blockSize; j++)
+            {
+                outside |= static_cast<uint32_t>(value[i + j]) - 1u >= 0x7Fu;
+            }
+            if (outside != 0)
+            {
+                return false;
+            }
+        }
+        for (; i < length; i++)
+        {
+            if (static_cast<uint32_t>(value[i]) - 1u >= 0x7Fu)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class TTo, class TFrom>
+    inline std::basic_string<TTo> ConvertAscii(const TFrom* value, size_t length)
+    {
+        const size_t blockSize = 16;
+
+        std::basic_string<TTo> result(length, TTo());
+        auto out = &result[0];
+        size_t i = 0;
+        for (; i + blockSize <= length; i += blockSize)
+        {
+            // Converting into a local block first tells the compiler the output does not overlap the input.
+            TTo block[blockSize];
+            for (size_t j = 0; j < blockSize; j++)
+            {
+                block[j] = static_cast<TTo>(value[i + j]);
+            }
+            std::memcpy(out + i, block, sizeof(block));
+        }
+        for (; i < length; i++)
+        {
+            out[i] = static_cast<TTo>(value[i]);
+        }
+        return result;
+    }
+
+    // Converts a NUL-terminated string with the platform functions, straight into the storage of the result. The size
+    // returned by the first call includes the terminator, which the result already has room for.
+    inline std::string ConvertWide(const wchar_t* value)
+    {
+        const auto size = pal_wstring_to_string(nullptr, value, 0);
+        if (size <= 1)
+        {
+            return std::string();
+        }
+        std::string result(size - 1, '\0');
+        pal_wstring_to_string(&result[0], value, size);
+        result.resize(std::char_traits<char>::length(result.c_str()));
+        return result;
+    }
+
+    inline std::wstring ConvertNarrow(const char* value)
+    {
+        const auto size = pal_string_to_wstring(nullptr, value, 0);
+        if (size <= 1)
+        {
+            return std::wstring();
+        }
+        std::wstring result(size - 1, L'\0');
+        pal_string_to_wstring(&result[0], value, size);
+        result.resize(std::char_traits<wchar_t>::length(result.c_str()));
+        return result;
+    }
+
     inline std::string to_string(const std::wstring& value)
     {
-        const auto size = pal_wstring_to_string(nullptr, value.c_str(), 0);
-        auto buffer = std::make_unique<std::string::value_type[]>(size);
-        pal_wstring_to_string(buffer.get(), value.c_str(), size);
-        return std::string{ buffer.get() };
+        return IsAsciiWithoutNul(value.data(), value.size())
+            ? ConvertAscii<char>(value.data(), value.size())
+            : ConvertWide(value.c_str());
     }
 
     inline std::wstring to_string(const std::string& value)
     {
-        const auto size = pal_string_to_wstring(nullptr, value.c_str(), 0);
-        auto buffer = std::make_unique<std::wstring::value_type[]>(size);
-        pal_string_to_wstring(buffer.get(), value.c_str(), size);
-        return std::wstring{ buffer.get() };
+        return IsAsciiWithoutNul(value.data(), value.size())
+            ? ConvertAscii<wchar_t>(value.data(), value.size())
+            : ConvertNarrow(value.c_str());
+    }
+
+    // Exact matches for literals and pointers, which would otherwise be ambiguous between the string and view overloads.
+    inline std::string to_string(const wchar_t* value)
+    {
+        if (value == nullptr)
+        {
+            return std::string();
+        }
+        const auto length = wcslen(value);
+        return IsAsciiWithoutNul(value, length)
+            ? ConvertAscii<char>(value, length)
+            : ConvertWide(value);
+    }
+
+    inline std::wstring to_string(const char* value)
+    {
+        if (value == nullptr)
+        {
+            return std::wstring();
+        }
+        const auto length = std::strlen(value);
+        return IsAsciiWithoutNul(value, length)
+            ? ConvertAscii<wchar_t>(value, length)
+            : ConvertNarrow(value);
+    }
+
+#if defined(__cpp_lib_string_view)
+    // Views are not NUL-terminated, so only ASCII ones are converted without a temporary copy.
+    inline std::string to_string(std::wstring_view value)
+    {
+        return IsAsciiWithoutNul(value.data(), value.size())
+            ? ConvertAscii<char>(value.data(), value.size())
+            : ConvertWide(std::wstring(value).c_str());
+    }
+
+    inline std::wstring to_string(std::string_view value)
+    {
+        return IsAsciiWithoutNul(value.data(), value.size())
+            ? ConvertAscii<wchar_t>(value.data(), value.size())
+            : ConvertNarrow(std::string(value).c_str());
     }
+#endif
 }
 
 inline std::string ToSPXString(const char* value)
@@ -61,9 +220,7 @@ inline std::string ToUTF8(const std::wstring& value)
 
 inline std::string ToUTF8(const wchar_t* value)
 {
-    if (!value)
-        return "";
-    return ToUTF8(std::wstring(value));
+    return Details::to_string(value);
 }
 
 inline std::string ToUTF8(const std::string& value)
@@ -76,6 +233,23 @@ inline const char* ToUTF8(const char* value)
     return value;
 }
 
+#if defined(__cpp_lib_string_view)
+inline std::string ToSPXString(std::string_view value)
+{
+    return std::string(value);
+}
+
+inline std::string ToUTF8(std::wstring_view value)
+{
+    return Details::to_string(value);
+}
+
+inline std::string ToUTF8(std::string_view value)
+{
+    return std::string(value);
+}
+#endif
+
 inline static std::string CopyAndFreePropertyString(const char* value)
 {
     std::string copy = (value == nullptr) ? "" : value;
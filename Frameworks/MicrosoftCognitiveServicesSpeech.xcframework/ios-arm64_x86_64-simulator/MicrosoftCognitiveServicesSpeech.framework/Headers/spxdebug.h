@@ -145,6 +145,18 @@
 #define SPX_CONFIG_TRACE_EXITFN_ON_FAIL AZAC_CONFIG_TRACE_EXITFN_ON_FAIL
 #endif
 
+#if defined(SPX_CONFIG_TRACE_LEVEL_MASK) && !defined(AZAC_CONFIG_TRACE_LEVEL_MASK)
+#define AZAC_CONFIG_TRACE_LEVEL_MASK SPX_CONFIG_TRACE_LEVEL_MASK
+#elif !defined(SPX_CONFIG_TRACE_LEVEL_MASK) && defined(AZAC_CONFIG_TRACE_LEVEL_MASK)
+#define SPX_CONFIG_TRACE_LEVEL_MASK AZAC_CONFIG_TRACE_LEVEL_MASK
+#endif
+
+#if defined(SPX_CONFIG_TRACE_SAMPLE_RATE) && !defined(AZAC_CONFIG_TRACE_SAMPLE_RATE)
+#define AZAC_CONFIG_TRACE_SAMPLE_RATE SPX_CONFIG_TRACE_SAMPLE_RATE
+#elif !defined(SPX_CONFIG_TRACE_SAMPLE_RATE) && defined(AZAC_CONFIG_TRACE_SAMPLE_RATE)
+#define SPX_CONFIG_TRACE_SAMPLE_RATE AZAC_CONFIG_TRACE_SAMPLE_RATE
+#endif
+
 #if !defined(__AZAC_THROW_HR_IMPL) && defined(__SPX_THROW_HR_IMPL)
 #define __AZAC_THROW_HR_IMPL __SPX_THROW_HR_IMPL
 #elif !defined(__SPX_THROW_HR_IMPL) && defined(__AZAC_THROW_HR_IMPL)
@@ -14,3 +14,11 @@
 
 #define DISABLE_COPY_AND_MOVE(T)    AZAC_DISABLE_COPY_AND_MOVE(T)
 #define DISABLE_DEFAULT_CTORS(T)    AZAC_DISABLE_DEFAULT_CTORS(T)
+
+// For move-only types: disables copying, and move assignment for types that can only be move constructed.
+#define DISABLE_COPY(T)             \
+    T(const T&) = delete;           \
+    T& operator=(const T&) = delete
+#define DISABLE_COPY_AND_ASSIGNMENT(T) \
+    DISABLE_COPY(T);                \
+    T& operator=(T&&) = delete
@@ -19,6 +19,7 @@
 #include "speechapi_cxx_conversation.h"
 #include "speechapi_cxx_conversation_translator_events.h"
 #include "speechapi_cxx_conversation_transcription_eventargs.h"
+#include "speechapi_cxx_async_executor.h"
 
 namespace Microsoft {
 namespace CognitiveServices {
@@ -391,7 +392,7 @@ namespace Transcription {
         inline std::future<void> RunAsync(std::function<SPXHR(SPXCONVERSATIONHANDLE)> func)
         {
             auto keepalive = this->shared_from_this();
-            return std::async(std::launch::async, [keepalive, this, func]()
+            return Utils::RunAsync([keepalive, this, func]()
             {
                 SPX_THROW_ON_FAIL(func(m_handle));
             });
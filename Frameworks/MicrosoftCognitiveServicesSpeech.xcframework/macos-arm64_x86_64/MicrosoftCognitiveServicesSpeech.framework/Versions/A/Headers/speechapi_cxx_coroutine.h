@@ -0,0 +1,712 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_coroutine.h: Public API declarations for the opt-in C++20 coroutine layer: the CompletionLoop,
+// AsyncOperation and EventStream classes and the awaitable recognition, synthesis and connection functions
+//
+
+#pragma once
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#define SPX_CONFIG_CXX_COROUTINES 1
+#endif
+#endif
+
+#ifdef SPX_CONFIG_CXX_COROUTINES
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_string_helpers.h"
+#include "speechapi_c.h"
+#include "speechapi_cxx_eventsignal.h"
+#include "speechapi_cxx_recognizer.h"
+#include "speechapi_cxx_speech_synthesizer.h"
+#include "speechapi_cxx_connection.h"
+#include "speechapi_cxx_async_executor.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Coroutines {
+
+/// <summary>
+/// The single thread that resumes the coroutines awaiting native asynchronous operations.
+/// </summary>
+/// <remarks>
+/// Operations are completed from the completion events of the native object (Recognized and Canceled for
+/// recognition, SynthesisCompleted and SynthesisCanceled for synthesis), so nothing is polled and the loop thread
+/// sleeps until a coroutine has to be resumed. Coroutines are resumed on the loop thread rather than on the SDK
+/// callback thread; long-running work after a co_await should be moved elsewhere.
+/// </remarks>
+class CompletionLoop
+{
+public:
+
+    /// <summary>
+    /// Gets the process-wide loop. The loop thread is started on first use.
+    /// </summary>
+    /// <returns>The loop.</returns>
+    static CompletionLoop& Instance()
+    {
+        // Intentionally leaked: pending operations may still reference the loop at process exit.
+        static CompletionLoop* instance = new CompletionLoop();
+        return *instance;
+    }
+
+    /// <summary>
+    /// Schedules a coroutine to be resumed on the loop thread.
+    /// </summary>
+    /// <param name="handle">The coroutine to resume.</param>
+    void Resume(std::coroutine_handle<> handle)
+    {
+        Post([handle]() { handle.resume(); });
+    }
+
+    /// <summary>
+    /// Schedules a function to run on the loop thread.
+    /// </summary>
+    /// <param name="work">The function to run.</param>
+    void Post(std::function<void()> work)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ready.push_back(std::move(work));
+        }
+        m_wakeUp.notify_one();
+    }
+
+    /// <summary>
+    /// Checks whether the caller is running on the loop thread.
+    /// </summary>
+    /// <returns>true if called from the loop thread.</returns>
+    bool IsLoopThread() const
+    {
+        return std::this_thread::get_id() == m_thread.get_id();
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(CompletionLoop);
+
+    CompletionLoop() :
+        m_thread([this]() { Run(); })
+    {
+    }
+
+    void Run()
+    {
+        for (;;)
+        {
+            std::deque<std::function<void()>> ready;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeUp.wait(lock, [this]() { return !m_ready.empty(); });
+                ready.swap(m_ready);
+            }
+
+            // Not under the lock: the work can re-enter Resume or Post.
+            for (auto& work : ready)
+            {
+                work();
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::deque<std::function<void()>> m_ready;
+    std::thread m_thread;
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+template <class T>
+class OperationState
+{
+public:
+
+    void SetValue(T value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_value.emplace(std::move(value));
+        Complete(lock);
+    }
+
+    void SetException(std::exception_ptr exception)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_exception = exception;
+        Complete(lock);
+    }
+
+    bool IsDone() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_done;
+    }
+
+    bool Suspend(std::coroutine_handle<> continuation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_done)
+        {
+            return false;
+        }
+        m_continuation = continuation;
+        return true;
+    }
+
+    T TakeResult()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+        return std::move(*m_value);
+    }
+
+private:
+
+    void Complete(std::unique_lock<std::mutex>& lock)
+    {
+        m_done = true;
+        auto continuation = std::exchange(m_continuation, nullptr);
+        lock.unlock();
+
+        if (continuation)
+        {
+            if (CompletionLoop::Instance().IsLoopThread())
+            {
+                continuation.resume();
+            }
+            else
+            {
+                CompletionLoop::Instance().Resume(continuation);
+            }
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    bool m_done = false;
+    std::optional<T> m_value;
+    std::exception_ptr m_exception;
+    std::coroutine_handle<> m_continuation;
+};
+
+struct Unit {};
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// Awaitable representing a native asynchronous operation. The awaiting coroutine is resumed on the
+/// <see cref="CompletionLoop"/> thread once the operation completes.
+/// </summary>
+/// <typeparam name="T">The result type; void for operations without a result.</typeparam>
+template <class T>
+class AsyncOperation
+{
+    using StateValue = typename std::conditional<std::is_void<T>::value, Details::Unit, T>::type;
+
+public:
+
+    /*! \cond PRIVATE */
+
+    using State = Details::OperationState<StateValue>;
+
+    explicit AsyncOperation(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+    bool await_ready() const { return m_state->IsDone(); }
+
+    bool await_suspend(std::coroutine_handle<> continuation) { return m_state->Suspend(continuation); }
+
+    T await_resume()
+    {
+        if constexpr (std::is_void<T>::value)
+        {
+            m_state->TakeResult();
+        }
+        else
+        {
+            return m_state->TakeResult();
+        }
+    }
+
+    /*! \endcond */
+
+private:
+
+    std::shared_ptr<State> m_state;
+};
+
+/// <summary>
+/// Asynchronous generator over the events of an <see cref="EventSignal"/>.
+/// Each event is projected to a value while the event arguments are still alive, then buffered until awaited.
+/// </summary>
+/// <typeparam name="T">The value type produced for each event.</typeparam>
+template <class T>
+class EventStream
+{
+    struct State
+    {
+        std::mutex mutex;
+        std::deque<T> items;
+        std::coroutine_handle<> waiter;
+        bool closed = false;
+
+        void Push(T item)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (closed)
+            {
+                return;
+            }
+            items.push_back(std::move(item));
+            ResumeWaiter(lock);
+        }
+
+        void Close()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            closed = true;
+            ResumeWaiter(lock);
+        }
+
+        void ResumeWaiter(std::unique_lock<std::mutex>& lock)
+        {
+            auto handle = std::exchange(waiter, nullptr);
+            lock.unlock();
+            if (handle)
+            {
+                // Never resume on the SDK callback thread; that would block further events of the recognizer or synthesizer.
+                CompletionLoop::Instance().Resume(handle);
+            }
+        }
+    };
+
+public:
+
+    /// <summary>
+    /// Creates a stream connected to the event signal.
+    /// </summary>
+    /// <param name="signal">The event signal.</param>
+    /// <param name="owner">The object owning the signal; kept alive as long as the stream is connected.</param>
+    /// <param name="project">Projection applied to each event.</param>
+    template <class TArgs, class TOwner, class TProject>
+    EventStream(EventSignal<TArgs>& signal, std::shared_ptr<TOwner> owner, TProject project) :
+        m_state(std::make_shared<State>())
+    {
+        std::weak_ptr<State> weakState = m_state;
+        auto token = signal.Connect([weakState, project](TArgs args) {
+            if (auto state = weakState.lock())
+            {
+                state->Push(project(args));
+            }
+        });
+        m_disconnect = [owner, &signal, token]() { signal.Disconnect(token); };
+    }
+
+    /// <summary>
+    /// Destructor. Disconnects from the event signal.
+    /// </summary>
+    ~EventStream()
+    {
+        Close();
+    }
+
+    /// <summary>
+    /// Disconnects from the event signal. Buffered values can still be read; afterwards Next() produces an empty value.
+    /// </summary>
+    void Close()
+    {
+        if (m_disconnect)
+        {
+            std::exchange(m_disconnect, nullptr)();
+            m_state->Close();
+        }
+    }
+
+    /// <summary>
+    /// Awaits the next value. The result is empty once the stream is closed and drained.
+    /// </summary>
+    /// <returns>An awaitable producing the next value.</returns>
+    auto Next()
+    {
+        struct Awaiter
+        {
+            std::shared_ptr<State> state;
+
+            bool await_ready()
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                return !state->items.empty() || state->closed;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->items.empty() || state->closed)
+                {
+                    return false;
+                }
+                state->waiter = handle;
+                return true;
+            }
+
+            std::optional<T> await_resume()
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->items.empty())
+                {
+                    return std::nullopt;
+                }
+                auto item = std::move(state->items.front());
+                state->items.pop_front();
+                return item;
+            }
+        };
+        return Awaiter{ m_state };
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(EventStream);
+
+    std::shared_ptr<State> m_state;
+    std::function<void()> m_disconnect;
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+// A started native operation, completed exactly once: from a completion event of the native object when the result
+// is already available, otherwise from a blocking *_wait_for on the executor of the *Async methods.
+class PendingOperation : public std::enable_shared_from_this<PendingOperation>
+{
+public:
+
+    // Calls the *_wait_for of the operation with the given timeout and completes the awaited state.
+    // Returns false if the operation has not completed within the timeout.
+    using Finish = std::function<bool(uint32_t timeout)>;
+
+    // Called from a completion event, on the SDK callback thread.
+    void Signal()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_claimed)
+        {
+            return;
+        }
+        if (!m_finish)
+        {
+            // Not armed yet: the event raced with the start of the operation.
+            m_signaled = true;
+            return;
+        }
+        m_claimed = true;
+        lock.unlock();
+        TryFinish();
+    }
+
+    // Called once the native operation has started. Operations without completion events pass waitNow.
+    void Arm(Finish finish, bool waitNow)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finish = std::move(finish);
+        if (!m_signaled && !waitNow)
+        {
+            return;
+        }
+        m_claimed = true;
+        lock.unlock();
+
+        if (waitNow)
+        {
+            WaitOnExecutor();
+        }
+        else
+        {
+            TryFinish();
+        }
+    }
+
+    void Hold(std::shared_ptr<void> keepAlive)
+    {
+        m_keepAlive = std::move(keepAlive);
+    }
+
+    // Drops the event connections; used when the operation failed to start.
+    void Abandon()
+    {
+        Release();
+    }
+
+private:
+
+    void TryFinish()
+    {
+        if (m_finish(0))
+        {
+            Release();
+        }
+        else
+        {
+            // A completion event can precede the native result by a few instructions, or belong to another operation.
+            WaitOnExecutor();
+        }
+    }
+
+    void WaitOnExecutor()
+    {
+        auto self = shared_from_this();
+        AsyncExecutor::GetDefault()->Post([self]() {
+            self->m_finish(UINT32_MAX);
+            self->Release();
+        });
+    }
+
+    void Release()
+    {
+        // The connections hold this object; drop them on the loop thread, never inside the event being raised.
+        auto keepAlive = std::move(m_keepAlive);
+        CompletionLoop::Instance().Post([keepAlive]() {});
+    }
+
+    std::mutex m_mutex;
+    Finish m_finish;
+    bool m_signaled = false;
+    bool m_claimed = false;
+    std::shared_ptr<void> m_keepAlive;
+};
+
+// Connects a handler that signals the operation whenever the signal fires; disconnects when the returned guard is released.
+template <class TSignal, class TOwner>
+std::shared_ptr<void> SignalOn(TSignal& signal, std::shared_ptr<TOwner> owner, std::shared_ptr<PendingOperation> operation)
+{
+    auto token = signal.Connect([operation](typename TSignal::CallbackArgument) { operation->Signal(); });
+    return std::shared_ptr<void>(nullptr, [owner, &signal, token](void*) { signal.Disconnect(token); });
+}
+
+// Starts a native operation. 'start' begins it and returns its async handle; 'wait' calls the matching *_wait_for
+// with the given timeout and completes the state unless it returned SPXERR_TIMEOUT.
+template <class TState, class TStart, class TWait, class TRelease>
+void StartOperation(std::shared_ptr<TState> state, std::shared_ptr<PendingOperation> operation, bool hasCompletionEvents, TStart start, TWait wait, TRelease release)
+{
+    SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+    auto hr = start(&hasync);
+    if (SPX_FAILED(hr))
+    {
+        operation->Abandon();
+        SPX_THROW_ON_FAIL(hr);
+    }
+
+    operation->Arm([state, hasync, wait, release](uint32_t timeout) {
+        try
+        {
+            if (!wait(hasync, timeout, *state))
+            {
+                return false;
+            }
+        }
+        catch (...)
+        {
+            state->SetException(std::current_exception());
+        }
+        SPX_REPORT_ON_FAIL(release(hasync));
+        return true;
+    }, !hasCompletionEvents);
+}
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// Performs single-shot recognition without blocking a thread.
+/// </summary>
+/// <param name="recognizer">The recognizer, for example a SpeechRecognizer.</param>
+/// <returns>An awaitable producing the recognition result.</returns>
+template <class TRecognizer, class TResult = typename decltype(std::declval<TRecognizer&>().RecognizeOnceAsync().get())::element_type>
+AsyncOperation<std::shared_ptr<TResult>> RecognizeOnceAsync(std::shared_ptr<TRecognizer> recognizer)
+{
+    SPX_THROW_HR_IF(SPXERR_INVALID_ARG, recognizer == nullptr);
+
+    using Operation = AsyncOperation<std::shared_ptr<TResult>>;
+
+    auto state = std::make_shared<typename Operation::State>();
+    auto hreco = static_cast<SPXRECOHANDLE>(*recognizer);
+    auto operation = std::make_shared<Details::PendingOperation>();
+    operation->Hold(std::make_shared<std::vector<std::shared_ptr<void>>>(std::initializer_list<std::shared_ptr<void>>{
+        Details::SignalOn(recognizer->Recognized, recognizer, operation),
+        Details::SignalOn(recognizer->Canceled, recognizer, operation) }));
+
+    Details::StartOperation(state, operation, true,
+        [hreco](SPXASYNCHANDLE* phasync) { return ::recognizer_recognize_once_async(hreco, phasync); },
+        [](SPXASYNCHANDLE hasync, uint32_t timeout, typename Operation::State& s) {
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            auto hr = ::recognizer_recognize_once_async_wait_for(hasync, timeout, &hresult);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                return false;
+            }
+            SPX_THROW_ON_FAIL(hr);
+            s.SetValue(std::make_shared<TResult>(hresult));
+            return true;
+        },
+        ::recognizer_async_handle_release);
+
+    return Operation(state);
+}
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+template <class TStart>
+AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> SpeakAsync(std::shared_ptr<SpeechSynthesizer> synthesizer, TStart start)
+{
+    SPX_THROW_HR_IF(SPXERR_INVALID_ARG, synthesizer == nullptr);
+
+    using Operation = AsyncOperation<std::shared_ptr<SpeechSynthesisResult>>;
+
+    auto state = std::make_shared<Operation::State>();
+    auto operation = std::make_shared<PendingOperation>();
+    operation->Hold(std::make_shared<std::vector<std::shared_ptr<void>>>(std::initializer_list<std::shared_ptr<void>>{
+        SignalOn(synthesizer->SynthesisCompleted, synthesizer, operation),
+        SignalOn(synthesizer->SynthesisCanceled, synthesizer, operation) }));
+
+    StartOperation(state, operation, true, start,
+        [](SPXASYNCHANDLE hasync, uint32_t timeout, Operation::State& s) {
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            auto hr = ::synthesizer_speak_async_wait_for(hasync, timeout, &hresult);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                return false;
+            }
+            SPX_THROW_ON_FAIL(hr);
+            s.SetValue(std::make_shared<SpeechSynthesisResult>(hresult));
+            return true;
+        },
+        ::synthesizer_async_handle_release);
+
+    return Operation(state);
+}
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// Executes speech synthesis on plain text without blocking a thread.
+/// </summary>
+/// <param name="synthesizer">The speech synthesizer.</param>
+/// <param name="text">The plain text for synthesis.</param>
+/// <returns>An awaitable producing the speech synthesis result.</returns>
+inline AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> SpeakTextAsync(std::shared_ptr<SpeechSynthesizer> synthesizer, const std::string& text)
+{
+    auto hsynth = synthesizer != nullptr ? static_cast<SPXSYNTHHANDLE>(*synthesizer) : SPXHANDLE_INVALID;
+    return Details::SpeakAsync(synthesizer, [hsynth, &text](SPXASYNCHANDLE* phasync) {
+        return ::synthesizer_speak_text_async(hsynth, text.data(), static_cast<uint32_t>(text.length()), phasync);
+    });
+}
+
+/// <summary>
+/// Executes speech synthesis on SSML without blocking a thread.
+/// </summary>
+/// <param name="synthesizer">The speech synthesizer.</param>
+/// <param name="ssml">The SSML for synthesis.</param>
+/// <returns>An awaitable producing the speech synthesis result.</returns>
+inline AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> SpeakSsmlAsync(std::shared_ptr<SpeechSynthesizer> synthesizer, const std::string& ssml)
+{
+    auto hsynth = synthesizer != nullptr ? static_cast<SPXSYNTHHANDLE>(*synthesizer) : SPXHANDLE_INVALID;
+    return Details::SpeakAsync(synthesizer, [hsynth, &ssml](SPXASYNCHANDLE* phasync) {
+        return ::synthesizer_speak_ssml_async(hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+    });
+}
+
+/// <summary>
+/// Sends a message to the speech service without blocking a thread.
+/// </summary>
+/// <param name="connection">The connection.</param>
+/// <param name="path">The path of the message.</param>
+/// <param name="payload">The payload of the message. This is a json string.</param>
+/// <returns>An awaitable that completes once the message has been sent.</returns>
+inline AsyncOperation<void> SendMessageAsync(std::shared_ptr<Connection> connection, const SPXSTRING& path, const SPXSTRING& payload)
+{
+    SPX_THROW_HR_IF(SPXERR_INVALID_ARG, connection == nullptr);
+
+    using Operation = AsyncOperation<void>;
+    auto state = std::make_shared<Operation::State>();
+    auto hconnection = static_cast<SPXCONNECTIONHANDLE>(*connection);
+    SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, hconnection == SPXHANDLE_INVALID);
+
+    // Sending a message raises no completion event, so its wait runs on the executor of the *Async methods.
+    auto operation = std::make_shared<Details::PendingOperation>();
+    operation->Hold(connection);
+
+    Details::StartOperation(state, operation, false,
+        [hconnection, &path, &payload](SPXASYNCHANDLE* phasync) {
+            return ::connection_send_message_async(hconnection, Utils::ToUTF8(path).c_str(), Utils::ToUTF8(payload).c_str(), phasync);
+        },
+        [](SPXASYNCHANDLE hasync, uint32_t timeout, Operation::State& s) {
+            auto hr = ::connection_send_message_wait_for(hasync, timeout);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                return false;
+            }
+            SPX_THROW_ON_FAIL(hr);
+            s.SetValue(Details::Unit{});
+            return true;
+        },
+        ::connection_async_handle_release);
+
+    return Operation(state);
+}
+
+/// <summary>
+/// Creates an asynchronous generator over the intermediate results of a recognizer.
+/// </summary>
+/// <param name="recognizer">The recognizer, for example a SpeechRecognizer.</param>
+/// <returns>A stream producing the result of each Recognizing event.</returns>
+template <class TRecognizer>
+auto Recognizing(std::shared_ptr<TRecognizer> recognizer)
+{
+    using TArgs = typename std::decay<typename decltype(recognizer->Recognizing)::CallbackArgument>::type;
+    using TResult = typename std::decay<decltype(std::declval<TArgs&>().Result)>::type;
+    SPX_THROW_HR_IF(SPXERR_INVALID_ARG, recognizer == nullptr);
+    return std::make_unique<EventStream<TResult>>(recognizer->Recognizing, recognizer, [](const auto& e) { return e.Result; });
+}
+
+/// <summary>
+/// Creates an asynchronous generator over the audio chunks produced by a speech synthesizer.
+/// </summary>
+/// <param name="synthesizer">The speech synthesizer.</param>
+/// <returns>A stream producing the result of each Synthesizing event.</returns>
+inline std::unique_ptr<EventStream<std::shared_ptr<SpeechSynthesisResult>>> Synthesizing(std::shared_ptr<SpeechSynthesizer> synthesizer)
+{
+    SPX_THROW_HR_IF(SPXERR_INVALID_ARG, synthesizer == nullptr);
+    return std::make_unique<EventStream<std::shared_ptr<SpeechSynthesisResult>>>(synthesizer->Synthesizing, synthesizer,
+        [](const SpeechSynthesisEventArgs& e) { return e.Result; });
+}
+
+} } } } // Microsoft::CognitiveServices::Speech::Coroutines
+
+#endif // SPX_CONFIG_CXX_COROUTINES
@@ -106,13 +106,14 @@ public:
     /// When the number of connected clients changes from zero to one, the connect callback will be called, if provided.
     /// </remarks>
     /// <param name="callback">Callback to connect.</param>
-    void Connect(CallbackFunction callback)
+    /// <returns>The token that can be passed to <see cref="Disconnect(CallbackToken)"/>.</returns>
+    CallbackToken Connect(CallbackFunction callback)
     {
         std::unique_lock<std::recursive_mutex> lock(m_mutex);
 
         auto shouldFireFirstConnected = m_callbacks.empty() && m_firstConnectedCallback != nullptr;
 
-        (void)EventSignalBase<T>::RegisterCallback(callback);
+        auto token = EventSignalBase<T>::RegisterCallback(callback);
 
         lock.unlock();
 
@@ -120,6 +121,33 @@ public:
         {
             m_firstConnectedCallback(*this);
         }
+
+        return token;
+    }
+
+    /// <summary>
+    /// Disconnects the callback associated with the token returned by <see cref="Connect"/>.
+    /// Unlike disconnecting by callback, this does not require runtime type information and never
+    /// disconnects another callback of the same type.
+    /// </summary>
+    /// <remarks>
+    /// When the number of connected clients changes from one to zero, the disconnect callback will be called, if provided.
+    /// </remarks>
+    /// <param name="token">Token returned by <see cref="Connect"/>.</param>
+    void Disconnect(CallbackToken token)
+    {
+        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+
+        auto removed = EventSignalBase<T>::RemoveCallback(token);
+        auto shouldFireLastDisconnected = removed != nullptr && m_callbacks.empty() && m_lastDisconnectedCallback != nullptr;
+
+        lock.unlock();
+
+        EventSignalBase<T>::WaitForCallbackToReturn(removed);
+        if (shouldFireLastDisconnected)
+        {
+            m_lastDisconnectedCallback(*this);
+        }
     }
 
 #ifndef AZAC_CONFIG_CXX_NO_RTTI
@@ -137,14 +165,21 @@ public:
         auto itMatchingCallback = std::find_if(
             m_callbacks.begin(),
             m_callbacks.end(),
-            [&](const std::pair<CallbackToken, CallbackFunction>& item)
+            [&](const typename decltype(m_callbacks)::value_type& item)
             {
-                return callback.target_type() == item.second.target_type();
+                return callback.target_type() == item.second->callback.target_type();
             });
+        if (itMatchingCallback == m_callbacks.end())
+        {
+            return;
+        }
 
-        auto removeHappened = EventSignal<T>::UnregisterCallback(itMatchingCallback->first);
+        auto removed = EventSignalBase<T>::RemoveCallback(itMatchingCallback->first);
+        auto shouldFireLastDisconnected = m_callbacks.empty() && m_lastDisconnectedCallback != nullptr;
         lock.unlock();
-        if (removeHappened && m_callbacks.empty() && m_lastDisconnectedCallback != nullptr)
+
+        EventSignalBase<T>::WaitForCallbackToReturn(removed);
+        if (shouldFireLastDisconnected)
         {
             m_lastDisconnectedCallback(*this);
         }
@@ -166,10 +201,15 @@ public:
         std::unique_lock<std::recursive_mutex> lock(m_mutex);
         auto shouldFireLastDisconnected = !m_callbacks.empty() && m_lastDisconnectedCallback != nullptr;
 
-        EventSignal<T>::UnregisterAllCallbacks();
+        auto removed = EventSignalBase<T>::RemoveAllCallbacks();
 
         lock.unlock();
 
+        for (auto& entry : removed)
+        {
+            EventSignalBase<T>::WaitForCallbackToReturn(entry);
+        }
+
         if (shouldFireLastDisconnected)
         {
             m_lastDisconnectedCallback(*this);
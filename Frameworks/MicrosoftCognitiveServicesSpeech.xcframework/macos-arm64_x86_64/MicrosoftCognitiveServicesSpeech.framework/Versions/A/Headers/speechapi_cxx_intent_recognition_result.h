@@ -13,8 +13,7 @@
 #include "speechapi_cxx_recognition_result.h"
 #include "speechapi_c.h"
 #include "speechapi_cxx_utils.h"
-
-#include "speechapi_c_json.h"
+#include "speechapi_cxx_json.h"
 
 namespace Microsoft {
 namespace CognitiveServices {
@@ -84,31 +83,12 @@ private:
         }
 
         auto jsonSLE = Properties.GetProperty("LanguageUnderstandingSLE_JsonResult");
-        SPXHANDLE parserHandle = SPXHANDLE_INVALID;
-        auto scopeGuard = Utils::MakeScopeGuard([&parserHandle]()
-        {
-            if (parserHandle != SPXHANDLE_INVALID)
-            {
-                ai_core_json_parser_handle_release(parserHandle);
-            }
-        });
-
-        auto root = ai_core_json_parser_create(&parserHandle, jsonSLE.c_str(), jsonSLE.size());
-        int count = ai_core_json_item_count(parserHandle, root);
-        for (int i = 0; i < count; i++)
+        Utils::JsonDocument document(jsonSLE);
+        for (auto item : document.Root())
         {
-            auto itemInt = ai_core_json_item_at(parserHandle, root, i, nullptr);
-            auto nameInt = ai_core_json_item_name(parserHandle, itemInt);
-
             // Need to use string copy here to force the ajv json parser to convert back to utf8.
-            auto name = ai_core_json_value_as_string_copy(parserHandle, nameInt, "");
-            auto value = ai_core_json_value_as_string_copy(parserHandle, itemInt, "");
-            if (value != nullptr && name != nullptr)
-            {
-                m_entities[name] = value;
-            }
+            m_entities[item.NameValue().AsString()] = item.AsString();
         }
-         
     }
 
     SPXSTRING m_intentId;
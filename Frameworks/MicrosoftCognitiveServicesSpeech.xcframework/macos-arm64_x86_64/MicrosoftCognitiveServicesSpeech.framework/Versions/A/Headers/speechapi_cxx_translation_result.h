@@ -6,9 +6,13 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
-#include <map>
 #include <new>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
@@ -22,48 +26,165 @@ namespace Speech {
 namespace Translation {
 
 /// <summary>
-/// Defines the translation text result.
+/// Read-only map from target language to translated text, see <see cref="TranslationRecognitionResult::Translations"/>.
+/// The entries are kept sorted by language in a single vector, and are read from the native result on first access.
 /// </summary>
-class TranslationRecognitionResult : public RecognitionResult
+/// <remarks>
+/// TranslationMap replaces the std::map&lt;SPXSTRING, SPXSTRING&gt; that Translations used to be. It has the const members
+/// of std::map that callers use, converts implicitly to a std::map and can be copied, so code that iterates, looks up,
+/// copies or passes the translations on keeps compiling. This is a breaking change for code that names the iterator type
+/// of std::map (std::map&lt;SPXSTRING, SPXSTRING&gt;::const_iterator it = Translations.find(...)), or that relies on the
+/// entries being std::pair&lt;const SPXSTRING, SPXSTRING&gt;: use auto, or convert the translations to a std::map first.
+/// </remarks>
+class TranslationMap
 {
-private:
+public:
 
-    std::map<SPXSTRING, SPXSTRING> m_translations;
+    /// <summary>
+    /// Type of the language tags.
+    /// </summary>
+    using key_type = SPXSTRING;
 
-public:
     /// <summary>
-    /// It is intended for internal use only. It creates an instance of <see cref="TranslationRecognitionResult"/>.
+    /// Type of the translated texts.
     /// </summary>
-    /// <param name="resultHandle">The handle of the result returned by recognizer in C-API.</param>
-    explicit TranslationRecognitionResult(SPXRESULTHANDLE resultHandle) :
-        RecognitionResult(resultHandle),
-        Translations(m_translations)
+    using mapped_type = SPXSTRING;
+
+    /// <summary>
+    /// Type of an entry: the language tag and the translated text.
+    /// </summary>
+    using value_type = std::pair<SPXSTRING, SPXSTRING>;
+
+    /// <summary>
+    /// Type of the number of entries.
+    /// </summary>
+    using size_type = size_t;
+
+    /// <summary>
+    /// Iterator over the entries, in language order.
+    /// </summary>
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    /// <summary>
+    /// Iterator over the entries; the entries cannot be modified.
+    /// </summary>
+    using iterator = const_iterator;
+
+    /// <summary>
+    /// Copies the translations, reading them from the native result first if needed.
+    /// The copy does not refer to the result.
+    /// </summary>
+    TranslationMap(const TranslationMap& other) :
+        m_resultHandle(SPXHANDLE_INVALID),
+        m_entries(other.Entries())
     {
-        PopulateResultFields(resultHandle);
-        SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p) -- resultid=%s.", __FUNCTION__, (void*)this, (void*)Handle, ResultId.c_str());
-    };
+        std::call_once(m_populateOnce, []() {});
+    }
 
     /// <summary>
-    /// Destructs the instance.
+    /// Replaces the translations with a copy of other's.
     /// </summary>
-    virtual ~TranslationRecognitionResult()
+    TranslationMap& operator=(const TranslationMap& other)
     {
-        SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)Handle);
+        if (this != &other)
+        {
+            std::call_once(m_populateOnce, []() {});
+            m_entries = other.Entries();
+            m_resultHandle = SPXHANDLE_INVALID;
+        }
+        return *this;
     }
 
     /// <summary>
-    /// Presents the translation results. Each item in the map is a key value pair, where key is the language tag of the translated text,
-    /// and value is the translation text in that language.
+    /// Converts the translations to a std::map, the type Translations had before.
+    /// </summary>
+    operator std::map<SPXSTRING, SPXSTRING>() const
+    {
+        return std::map<SPXSTRING, SPXSTRING>(begin(), end());
+    }
+
+    /// <summary>
+    /// Returns an iterator to the first entry.
     /// </summary>
-    const std::map<SPXSTRING, SPXSTRING>& Translations;
+    const_iterator begin() const { return Entries().begin(); }
+
+    /// <summary>
+    /// Returns an iterator past the last entry.
+    /// </summary>
+    const_iterator end() const { return Entries().end(); }
+
+    /// <summary>
+    /// Returns an iterator to the first entry.
+    /// </summary>
+    const_iterator cbegin() const { return begin(); }
+
+    /// <summary>
+    /// Returns an iterator past the last entry.
+    /// </summary>
+    const_iterator cend() const { return end(); }
+
+    /// <summary>
+    /// Returns the number of translations.
+    /// </summary>
+    size_t size() const { return Entries().size(); }
+
+    /// <summary>
+    /// Checks whether there are no translations.
+    /// </summary>
+    bool empty() const { return Entries().empty(); }
+
+    /// <summary>
+    /// Finds the translation for a language.
+    /// </summary>
+    /// <param name="language">The language tag.</param>
+    /// <returns>An iterator to the entry, or end() if there is no translation for the language.</returns>
+    const_iterator find(const SPXSTRING& language) const
+    {
+        auto& entries = Entries();
+        auto it = std::lower_bound(entries.begin(), entries.end(), language, LanguageLess);
+        return (it != entries.end() && it->first == language) ? it : entries.end();
+    }
+
+    /// <summary>
+    /// Returns 1 if there is a translation for the language, 0 otherwise.
+    /// </summary>
+    /// <param name="language">The language tag.</param>
+    size_t count(const SPXSTRING& language) const { return find(language) != end() ? 1 : 0; }
+
+    /// <summary>
+    /// Returns the translation for a language. Throws std::out_of_range if there is none.
+    /// </summary>
+    /// <param name="language">The language tag.</param>
+    const SPXSTRING& at(const SPXSTRING& language) const
+    {
+        auto it = find(language);
+        if (it == end())
+        {
+            throw std::out_of_range("no translation for the language");
+        }
+        return it->second;
+    }
 
 private:
-    void PopulateResultFields(SPXRESULTHANDLE resultHandle)
+
+    friend class TranslationRecognitionResult;
+
+    explicit TranslationMap(SPXRESULTHANDLE resultHandle) : m_resultHandle(resultHandle) {}
+
+    static bool LanguageLess(const value_type& entry, const SPXSTRING& language) { return entry.first < language; }
+
+    const std::vector<value_type>& Entries() const
+    {
+        std::call_once(m_populateOnce, [this]() { Populate(); });
+        return m_entries;
+    }
+
+    void Populate() const
     {
         SPX_INIT_HR(hr);
 
         size_t count = 0;
-        hr = translation_text_result_get_translation_count(resultHandle, &count);
+        hr = translation_text_result_get_translation_count(m_resultHandle, &count);
         SPX_THROW_ON_FAIL(hr);
 
         size_t maxLanguageSize = 0;
@@ -74,32 +195,93 @@ private:
             size_t languageSize = 0;
             size_t textSize = 0;
 
-            hr = translation_text_result_get_translation(resultHandle, i, nullptr, nullptr, &languageSize, &textSize);
+            hr = translation_text_result_get_translation(m_resultHandle, i, nullptr, nullptr, &languageSize, &textSize);
             SPX_THROW_ON_FAIL(hr);
 
             maxLanguageSize = (std::max)(maxLanguageSize, languageSize);
             maxTextSize = (std::max)(maxTextSize, textSize);
         }
 
+        std::vector<value_type> entries;
+        entries.reserve(count);
+
         auto targetLanguage = std::make_unique<char[]>(maxLanguageSize);
         auto translationText = std::make_unique<char[]>(maxTextSize);
         for (size_t i = 0; i < count; i++)
         {
-            hr = translation_text_result_get_translation(resultHandle, i, targetLanguage.get(), translationText.get(), &maxLanguageSize, &maxTextSize);
+            hr = translation_text_result_get_translation(m_resultHandle, i, targetLanguage.get(), translationText.get(), &maxLanguageSize, &maxTextSize);
             SPX_THROW_ON_FAIL(hr);
-            m_translations[Utils::ToSPXString(targetLanguage.get())] = Utils::ToSPXString(translationText.get());
+
+            // Keep the entries sorted by language, like the std::map this replaces.
+            auto language = Utils::ToSPXString(targetLanguage.get());
+            auto it = std::lower_bound(entries.begin(), entries.end(), language, LanguageLess);
+            if (it != entries.end() && it->first == language)
+            {
+                it->second = Utils::ToSPXString(translationText.get());
+            }
+            else
+            {
+                entries.emplace(it, std::move(language), Utils::ToSPXString(translationText.get()));
+            }
         }
 
-        SPX_DBG_TRACE_VERBOSE("Translation phrases: numberentries: %d", (int)m_translations.size());
+        m_entries = std::move(entries);
+
+        SPX_DBG_TRACE_VERBOSE("Translation phrases: numberentries: %d", (int)m_entries.size());
 #ifdef _DEBUG
-        for (const auto& cf : m_translations)
+        for (const auto& cf : m_entries)
         {
             (void)(cf); // prevent warning for cf when compiling release builds
             SPX_DBG_TRACE_VERBOSE(" phrase for %s: %s", cf.first.c_str(), cf.second.c_str());
         }
 #endif
+    }
+
+    SPXRESULTHANDLE m_resultHandle;
+    mutable std::vector<value_type> m_entries;
+    mutable std::once_flag m_populateOnce;
+};
+
+/// <summary>
+/// Defines the translation text result.
+/// </summary>
+class TranslationRecognitionResult : public RecognitionResult
+{
+private:
+
+    TranslationMap m_translations;
+
+public:
+    /// <summary>
+    /// It is intended for internal use only. It creates an instance of <see cref="TranslationRecognitionResult"/>.
+    /// </summary>
+    /// <param name="resultHandle">The handle of the result returned by recognizer in C-API.</param>
+    explicit TranslationRecognitionResult(SPXRESULTHANDLE resultHandle) :
+        RecognitionResult(resultHandle),
+        m_translations(resultHandle),
+        Translations(m_translations)
+    {
+        SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p) -- resultid=%s.", __FUNCTION__, (void*)this, (void*)Handle, ResultId.c_str());
     };
 
+    /// <summary>
+    /// Destructs the instance.
+    /// </summary>
+    virtual ~TranslationRecognitionResult()
+    {
+        SPX_DBG_TRACE_VERBOSE("%s (this=0x%p, handle=0x%p)", __FUNCTION__, (void*)this, (void*)Handle);
+    }
+
+    /// <summary>
+    /// Presents the translation results. Each item in the map is a key value pair, where key is the language tag of the translated text,
+    /// and value is the translation text in that language.
+    /// The translations are read from the native result on first access. See <see cref="TranslationMap"/> for how it differs
+    /// from the std::map this member used to be.
+    /// </summary>
+    const TranslationMap& Translations;
+
+private:
+
     DISABLE_DEFAULT_CTORS(TranslationRecognitionResult);
 };
 
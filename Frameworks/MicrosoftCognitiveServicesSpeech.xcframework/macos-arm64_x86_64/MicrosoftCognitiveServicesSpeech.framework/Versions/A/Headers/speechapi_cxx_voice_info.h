@@ -41,7 +41,7 @@ private:
             SPXPROPERTYBAGHANDLE hpropbag = SPXHANDLE_INVALID;
             voice_info_get_property_bag(hresult, &hpropbag);
             return hpropbag;
-        }())
+        }(), true)
         {
         }
     };
@@ -95,6 +95,36 @@ public:
                   : SynthesisVoiceStatus::Unknown;
     }
 
+    /// <summary>
+    /// Move constructor. The voice info takes over the handle of the other voice info, which must not be used afterwards.
+    /// </summary>
+    /// <param name="other">The voice info to move from.</param>
+    VoiceInfo(VoiceInfo&& other) :
+        m_hresult(other.m_hresult),
+        m_properties(std::move(other.m_properties)),
+        Name(m_name),
+        Locale(m_locale),
+        ShortName(m_shortName),
+        LocalName(m_localName),
+        Gender(m_gender),
+        VoiceType(m_voiceType),
+        StyleList(m_styleList),
+        VoicePath(m_voicePath),
+        Status(m_status),
+        Properties(m_properties),
+        m_name(std::move(other.m_name)),
+        m_locale(std::move(other.m_locale)),
+        m_shortName(std::move(other.m_shortName)),
+        m_localName(std::move(other.m_localName)),
+        m_gender(other.m_gender),
+        m_voiceType(other.m_voiceType),
+        m_styleList(std::move(other.m_styleList)),
+        m_voicePath(std::move(other.m_voicePath)),
+        m_status(other.m_status)
+    {
+        other.m_hresult = SPXHANDLE_INVALID;
+    }
+
     /// <summary>
     /// Explicit conversion operator.
     /// </summary>
@@ -162,7 +192,8 @@ public:
 
 private:
 
-    DISABLE_DEFAULT_CTORS(VoiceInfo);
+    VoiceInfo() = delete;
+    DISABLE_COPY_AND_ASSIGNMENT(VoiceInfo);
 
     /// <summary>
     /// Internal member variable that holds the name.
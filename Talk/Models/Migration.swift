@@ -11,4 +11,50 @@ enum AppSchemaV1: VersionedSchema {
     static var models: [any PersistentModel.Type] {
         [ChatMessage.self, SettingsModel.self]
     }
+
+    /// Settings as stored before the wake word and hybrid recognition settings, and the whisper.cpp upload format
+    @Model
+    final class SettingsModel {
+        var selectedRecordingMode: Talk.SettingsModel.RecordingMode = Talk.SettingsModel.RecordingMode.auto
+        var selectedLLMService: Talk.SettingsModel.LLMServiceType = Talk.SettingsModel.LLMServiceType.openAI
+        var selectedSpeechService: Talk.SettingsModel.SpeechServiceType = Talk.SettingsModel.SpeechServiceType.system
+        var selectedTTSService: Talk.SettingsModel.TTSServiceType = Talk.SettingsModel.TTSServiceType.system
+
+        @Attribute var cobraSettings: CobraSettings = CobraSettings()
+        @Attribute var openAILLMSettings: OpenAILLMSettings = OpenAILLMSettings()
+        @Attribute var difySettings: DifySettings = DifySettings()
+        @Attribute var whisperCppSettings: WhisperCppSettings = WhisperCppSettings()
+        @Attribute var whisperKitSettings: WhisperKitSettings = WhisperKitSettings()
+        @Attribute var microsoftTTSSettings: MicrosoftTTSSettings = MicrosoftTTSSettings()
+        @Attribute var openAITTSSettings: OpenAITTSSettings = OpenAITTSSettings()
+        @Attribute var appleSpeechSettings: AppleSpeechSettings = AppleSpeechSettings()
+        @Attribute var systemTTSSettings: SystemTTSSettings = SystemTTSSettings()
+
+        init() {}
+    }
+
+    struct WhisperCppSettings: Codable, Hashable {
+        var serverURL: String = "http://localhost:8080/inference"
+    }
+}
+
+/// Adds the wake word and hybrid recognition settings, and the upload format of the whisper.cpp settings
+enum AppSchemaV2: VersionedSchema {
+    static var versionIdentifier = Schema.Version(2, 0, 0)
+    static var models: [any PersistentModel.Type] {
+        [ChatMessage.self, SettingsModel.self]
+    }
+}
+
+/// Every attribute added since V1 has a default value, so stores are migrated without custom stages
+enum AppMigrationPlan: SchemaMigrationPlan {
+    static var schemas: [any VersionedSchema.Type] {
+        [AppSchemaV1.self, AppSchemaV2.self]
+    }
+
+    static var stages: [MigrationStage] {
+        [migrateV1toV2]
+    }
+
+    static let migrateV1toV2 = MigrationStage.lightweight(fromVersion: AppSchemaV1.self, toVersion: AppSchemaV2.self)
 }
@@ -9,6 +9,7 @@ final class SettingsModel {
     var selectedTTSService: TTSServiceType = TTSServiceType.system
 
     @Attribute var cobraSettings: CobraSettings = CobraSettings()
+    @Attribute var wakeWordSettings: WakeWordSettings = WakeWordSettings()
     @Attribute var openAILLMSettings: OpenAILLMSettings = OpenAILLMSettings()
     @Attribute var difySettings: DifySettings = DifySettings()
     @Attribute var whisperCppSettings: WhisperCppSettings = WhisperCppSettings()
@@ -16,11 +17,13 @@ final class SettingsModel {
     @Attribute var microsoftTTSSettings: MicrosoftTTSSettings = MicrosoftTTSSettings()
     @Attribute var openAITTSSettings: OpenAITTSSettings = OpenAITTSSettings()
     @Attribute var appleSpeechSettings: AppleSpeechSettings = AppleSpeechSettings()
+    @Attribute var hybridSpeechSettings: HybridSpeechSettings = HybridSpeechSettings()
     @Attribute var systemTTSSettings: SystemTTSSettings = SystemTTSSettings()
 
     enum RecordingMode: String, Codable, CaseIterable, Identifiable {
         case manual = "Manual"
         case auto = "Auto Detect"
+        case wakeWord = "Wake Word"
 
         var id: String { rawValue }
     }
@@ -36,6 +39,7 @@ final class SettingsModel {
         case whisperKit = "WhisperKit"
         case whisperCpp = "Whisper.cpp"
         case system = "System"
+        case hybrid = "Hybrid"
 
         var id: String { rawValue }
     }
@@ -52,55 +56,87 @@ final class SettingsModel {
 }
 
 extension SettingsModel {
-    var settingsHash: String {
-        [
-            selectedRecordingMode.rawValue,
-            selectedLLMService.rawValue,
-            selectedSpeechService.rawValue,
-            selectedTTSService.rawValue,
-
-            cobraSettings.accessKey,
-
-            openAILLMSettings.apiKey,
-            openAILLMSettings.baseURL,
-            openAILLMSettings.model,
-            openAILLMSettings.prompt,
-            String(openAILLMSettings.temperature),
-            String(openAILLMSettings.top_p),
-
-            difySettings.apiKey,
-            difySettings.baseURL,
-
-            whisperCppSettings.serverURL,
-
-            whisperKitSettings.modelName,
-
-            microsoftTTSSettings.subscriptionKey,
-            microsoftTTSSettings.region,
-            microsoftTTSSettings.voiceName,
-
-            openAITTSSettings.apiKey,
-            openAITTSSettings.model,
-            openAITTSSettings.voice,
-            String(openAITTSSettings.speed),
-            openAITTSSettings.instructions,
-            openAITTSSettings.baseURL,
-
-            appleSpeechSettings.language,
-
-            systemTTSSettings.voiceIdentifier,
-            systemTTSSettings.language,
-            String(systemTTSSettings.rate),
-            String(systemTTSSettings.pitch),
-            String(systemTTSSettings.volume),
-        ].joined(separator: "-")
+    /// Settings each service is created from, compared per service to rebuild only what changed
+    /// Only the settings of the selected service are included, and settings read per request
+    /// (LLM prompt, temperature, top_p) are left out on purpose
+    var serviceConfigurations: ServiceConfigurations {
+        ServiceConfigurations(
+            capture: CaptureConfiguration(
+                recordingMode: selectedRecordingMode,
+                cobraSettings: cobraSettings,
+                wakeWordSettings: selectedRecordingMode == .wakeWord ? wakeWordSettings : nil
+            ),
+            speechRecognition: SpeechRecognitionConfiguration(
+                service: selectedSpeechService,
+                whisperCppSettings: selectedSpeechService == .whisperCpp ? whisperCppSettings : nil,
+                whisperKitSettings: selectedSpeechService == .whisperKit ? whisperKitSettings : nil,
+                appleSpeechSettings: selectedSpeechService == .system ? appleSpeechSettings : nil,
+                hybridSpeechSettings: selectedSpeechService == .hybrid ? hybridSpeechSettings : nil
+            ),
+            llm: LLMConfiguration(
+                service: selectedLLMService,
+                openAIAPIKey: selectedLLMService == .openAI ? openAILLMSettings.apiKey : nil,
+                openAIBaseURL: selectedLLMService == .openAI ? openAILLMSettings.baseURL : nil,
+                openAIModel: selectedLLMService == .openAI ? openAILLMSettings.model : nil,
+                difySettings: selectedLLMService == .dify ? difySettings : nil
+            ),
+            tts: TTSConfiguration(
+                service: selectedTTSService,
+                microsoftTTSSettings: selectedTTSService == .microsoft ? microsoftTTSSettings : nil,
+                openAITTSSettings: selectedTTSService == .openAI ? openAITTSSettings : nil,
+                systemTTSSettings: selectedTTSService == .system ? systemTTSSettings : nil
+            )
+        )
     }
 }
 
+struct ServiceConfigurations: Equatable {
+    var capture: CaptureConfiguration
+    var speechRecognition: SpeechRecognitionConfiguration
+    var llm: LLMConfiguration
+    var tts: TTSConfiguration
+}
+
+/// Recording mode, VAD and wake word
+struct CaptureConfiguration: Equatable {
+    var recordingMode: SettingsModel.RecordingMode
+    var cobraSettings: CobraSettings
+    var wakeWordSettings: WakeWordSettings?
+}
+
+struct SpeechRecognitionConfiguration: Equatable {
+    var service: SettingsModel.SpeechServiceType
+    var whisperCppSettings: WhisperCppSettings?
+    var whisperKitSettings: WhisperKitSettings?
+    var appleSpeechSettings: AppleSpeechSettings?
+    var hybridSpeechSettings: HybridSpeechSettings?
+}
+
+struct LLMConfiguration: Equatable {
+    var service: SettingsModel.LLMServiceType
+    var openAIAPIKey: String?
+    var openAIBaseURL: String?
+    /// Sent with each request, but validated when the service is created
+    var openAIModel: String?
+    var difySettings: DifySettings?
+}
+
+struct TTSConfiguration: Equatable {
+    var service: SettingsModel.TTSServiceType
+    var microsoftTTSSettings: MicrosoftTTSSettings?
+    var openAITTSSettings: OpenAITTSSettings?
+    var systemTTSSettings: SystemTTSSettings?
+}
+
 struct CobraSettings: Codable, Hashable {
     var accessKey: String = ""
 }
 
+struct WakeWordSettings: Codable, Hashable {
+    /// Keyword model (.table) file, absolute or relative to the app's Documents directory
+    var keywordModelPath: String = ""
+}
+
 struct OpenAILLMSettings: Codable, Hashable {
     var apiKey: String = ""
     var baseURL: String = ""
@@ -117,6 +153,17 @@ struct DifySettings: Codable, Hashable {
 
 struct WhisperCppSettings: Codable, Hashable {
     var serverURL: String = "http://localhost:8080/inference"
+    /// FLAC halves the upload but needs a server that can decode it
+    var uploadFormat: WhisperCppServerAdapter.UploadFormat = .wav
+}
+
+extension WhisperCppSettings {
+    /// Settings saved before the upload format existed decode with the default one
+    init(from decoder: Decoder) throws {
+        let container = try decoder.container(keyedBy: CodingKeys.self)
+        serverURL = try container.decode(String.self, forKey: .serverURL)
+        uploadFormat = try container.decodeIfPresent(WhisperCppServerAdapter.UploadFormat.self, forKey: .uploadFormat) ?? .wav
+    }
 }
 
 struct WhisperKitSettings: Codable, Hashable {
@@ -142,6 +189,18 @@ struct AppleSpeechSettings: Codable, Hashable {
     var language: String = "en-US"
 }
 
+struct HybridSpeechSettings: Codable, Hashable {
+    var subscriptionKey: String = ""
+    var region: String = ""
+    var language: String = "en-US"
+    /// Embedded model directory, absolute or relative to the app's Documents directory
+    var embeddedModelPath: String = ""
+    var embeddedModelName: String = ""
+    var embeddedModelLicense: String = ""
+    /// Slowest network round trip at which the cloud result is still used
+    var maxRoundTripMs: Int = 300
+}
+
 struct SystemTTSSettings: Codable, Hashable {
     var voiceIdentifier: String = ""
     var language: String = "en-US"
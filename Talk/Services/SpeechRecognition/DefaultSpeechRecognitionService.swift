@@ -8,18 +8,18 @@ public class DefaultSpeechRecognitionService: SpeechRecognitionService {
         self.adapter = adapter
     }
 
-    public func recognizeSpeech(pcmData: [Int16]) async throws -> SpeechRecognitionResult {
+    public func recognizeSpeech(pcmData: [Int16], onPartialResult: PartialResultHandler?) async throws -> SpeechRecognitionResult {
         guard !pcmData.isEmpty else {
             throw SpeechRecognitionError.invalidInput
         }
 
-        return try await adapter.recognize(pcmData: pcmData)
+        return try await adapter.recognize(pcmData: pcmData, onPartialResult: onPartialResult)
     }
 }
 
 public enum SpeechRecognitionServiceFactory {
-    public static func createWhisperCppService(serverURL: URL) -> SpeechRecognitionService {
-        let adapter = WhisperCppServerAdapter(serverURL: serverURL)
+    public static func createWhisperCppService(serverURL: URL, uploadFormat: WhisperCppServerAdapter.UploadFormat = .wav) -> SpeechRecognitionService {
+        let adapter = WhisperCppServerAdapter(serverURL: serverURL, uploadFormat: uploadFormat)
         return DefaultSpeechRecognitionService(adapter: adapter)
     }
 
@@ -34,4 +34,22 @@ public enum SpeechRecognitionServiceFactory {
         let adapter = AppleSpeechAdapter(language: language)
         return DefaultSpeechRecognitionService(adapter: adapter)
     }
+
+    public static func createHybridService(
+        subscriptionKey: String,
+        region: String,
+        language: String,
+        embeddedModelPath: String,
+        embeddedModelName: String,
+        embeddedModelLicense: String,
+        maxCloudRoundTrip: TimeInterval
+    ) throws -> SpeechRecognitionService {
+        let local = try MicrosoftSpeechAdapter(modelPath: embeddedModelPath, modelName: embeddedModelName, license: embeddedModelLicense, language: language)
+        let cloud = try MicrosoftSpeechAdapter(subscriptionKey: subscriptionKey, region: region, language: language)
+        guard let probe = HTTPLatencyProbe(region: region) else {
+            throw SpeechRecognitionError.processingFailed("invalid region: \(region)")
+        }
+        let adapter = HybridSpeechRecognitionAdapter(local: local, cloud: cloud, probe: probe, maxCloudRoundTrip: maxCloudRoundTrip)
+        return DefaultSpeechRecognitionService(adapter: adapter)
+    }
 }
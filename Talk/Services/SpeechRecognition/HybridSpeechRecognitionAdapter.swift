@@ -0,0 +1,237 @@
+import Foundation
+
+/// Measures the round trip time to the cloud recognition service
+public protocol NetworkLatencyProbe {
+    /// Round trip time in seconds, or nil when the service is unreachable
+    func measureRoundTrip() async -> TimeInterval?
+}
+
+/// Times a HEAD request to the service endpoint. Any HTTP response counts, only transport errors mean unreachable
+public struct HTTPLatencyProbe: NetworkLatencyProbe {
+    private let url: URL
+    private let timeout: TimeInterval
+
+    public init(url: URL, timeout: TimeInterval = 2) {
+        self.url = url
+        self.timeout = timeout
+    }
+
+    /// Probe for the speech endpoint of an Azure region
+    public init?(region: String, timeout: TimeInterval = 2) {
+        guard let url = URL(string: "https://\(region).stt.speech.microsoft.com/") else {
+            return nil
+        }
+        self.init(url: url, timeout: timeout)
+    }
+
+    public func measureRoundTrip() async -> TimeInterval? {
+        var request = URLRequest(url: url, cachePolicy: .reloadIgnoringLocalCacheData, timeoutInterval: timeout)
+        request.httpMethod = "HEAD"
+
+        let start = Date()
+        do {
+            _ = try await URLSession.shared.data(for: request)
+        } catch {
+            return nil
+        }
+        return Date().timeIntervalSince(start)
+    }
+}
+
+/// Recognizes with an on-device recognizer first and with the cloud recognizer when the network is fast enough
+/// The local result arrives without network latency and is reported as a partial result; when the measured
+/// round trip is within `maxCloudRoundTrip`, the cloud result is returned as the final one, otherwise the local result is.
+/// A failed or timed out cloud request falls back to the local result.
+public final class HybridSpeechRecognitionAdapter: SpeechRecognitionAdapter {
+    public enum Source: String {
+        case local
+        case cloud
+    }
+
+    private let logger = DebugLogger(tag: "HybridSpeech")
+
+    private let local: SpeechRecognitionAdapter
+    private let cloud: SpeechRecognitionAdapter
+    private let roundTrip: RoundTripEstimator
+    private let maxCloudRoundTrip: TimeInterval
+    private let cloudTimeout: TimeInterval
+
+    /// - Parameters:
+    ///   - local: On-device recognizer, used for partial results and as the fallback
+    ///   - cloud: Cloud recognizer, used for the final result while the network is fast enough
+    ///   - probe: Measures the round trip to the cloud service
+    ///   - maxCloudRoundTrip: Slowest round trip, in seconds, at which the cloud result is still awaited
+    ///   - cloudTimeout: Time after which a cloud request is given up for the local result
+    ///   - probeInterval: Age after which the round trip is measured again
+    public init(
+        local: SpeechRecognitionAdapter,
+        cloud: SpeechRecognitionAdapter,
+        probe: NetworkLatencyProbe,
+        maxCloudRoundTrip: TimeInterval = 0.3,
+        cloudTimeout: TimeInterval = 5,
+        probeInterval: TimeInterval = 30
+    ) {
+        self.local = local
+        self.cloud = cloud
+        self.maxCloudRoundTrip = maxCloudRoundTrip
+        self.cloudTimeout = cloudTimeout
+        roundTrip = RoundTripEstimator(probe: probe, maxAge: probeInterval, firstProbeTimeout: maxCloudRoundTrip * 2)
+    }
+
+    public func recognize(pcmData: [Int16]) async throws -> SpeechRecognitionResult {
+        try await recognize(pcmData: pcmData, onPartialResult: nil)
+    }
+
+    /// - Parameter onPartialResult: Called with the local result while the cloud request is still running
+    public func recognize(pcmData: [Int16], onPartialResult: PartialResultHandler?) async throws -> SpeechRecognitionResult {
+        let local = self.local
+        let localTask = Task { try await local.recognize(pcmData: pcmData) }
+
+        // The local request is not a child task, so it is cancelled along with this one by hand
+        return try await withTaskCancellationHandler {
+            let roundTrip = await self.roundTrip.current()
+            guard let roundTrip, roundTrip <= maxCloudRoundTrip else {
+                let result = try await localTask.value
+                return annotate(result, source: .local, roundTrip: roundTrip)
+            }
+
+            let partialTask = Task {
+                guard let result = try? await localTask.value, !Task.isCancelled else { return }
+                onPartialResult?(self.annotate(result, source: .local, roundTrip: roundTrip))
+            }
+
+            do {
+                let result = try await recognizeInCloud(pcmData: pcmData)
+                partialTask.cancel()
+                return annotate(result, source: .cloud, roundTrip: roundTrip)
+            } catch {
+                if Task.isCancelled {
+                    throw error
+                }
+                logger.warning("Cloud recognition failed, using the local result: \(error)")
+                await self.roundTrip.invalidate()
+                let result = try await localTask.value
+                return annotate(result, source: .local, roundTrip: roundTrip)
+            }
+        } onCancel: {
+            localTask.cancel()
+        }
+    }
+
+    /// The group waits for both children, so the cloud adapter must return promptly once cancelled for the
+    /// timeout to bound the latency, as `MicrosoftSpeechAdapter` does
+    private func recognizeInCloud(pcmData: [Int16]) async throws -> SpeechRecognitionResult {
+        let cloud = self.cloud
+        let timeout = cloudTimeout
+        return try await withThrowingTaskGroup(of: SpeechRecognitionResult.self) { group in
+            group.addTask {
+                try await cloud.recognize(pcmData: pcmData)
+            }
+            group.addTask {
+                try await Task.sleep(nanoseconds: UInt64(timeout * 1_000_000_000))
+                throw SpeechRecognitionError.processingFailed("cloud recognition timed out")
+            }
+            defer { group.cancelAll() }
+            return try await group.next()!
+        }
+    }
+
+    private func annotate(_ result: SpeechRecognitionResult, source: Source, roundTrip: TimeInterval?) -> SpeechRecognitionResult {
+        var info = result.additionalInfo ?? [:]
+        info["source"] = source.rawValue
+        if let roundTrip {
+            info["networkRTT"] = roundTrip
+        }
+        return SpeechRecognitionResult(text: result.text, language: result.language, additionalInfo: info)
+    }
+}
+
+/// Smoothed network round trip, measured in the background once it is older than `maxAge`
+/// Only the very first measurement is awaited, and no longer than `firstProbeTimeout`
+actor RoundTripEstimator {
+    private let probe: NetworkLatencyProbe
+    private let maxAge: TimeInterval
+    private let firstProbeTimeout: TimeInterval
+
+    /// Weight of a new measurement in the moving average
+    private let smoothing = 0.3
+
+    private var estimate: TimeInterval?
+    private var measuredAt: Date?
+    private var probeTask: Task<Void, Never>?
+
+    init(probe: NetworkLatencyProbe, maxAge: TimeInterval, firstProbeTimeout: TimeInterval) {
+        self.probe = probe
+        self.maxAge = maxAge
+        self.firstProbeTimeout = firstProbeTimeout
+    }
+
+    /// Current estimate in seconds, nil while the service is considered unreachable
+    func current() async -> TimeInterval? {
+        let isStale = measuredAt.map { Date().timeIntervalSince($0) > maxAge } ?? true
+        if isStale, probeTask == nil {
+            let probe = self.probe
+            probeTask = Task {
+                let measured = await probe.measureRoundTrip()
+                self.record(measured)
+            }
+        }
+
+        // A task group would wait for the probe even after the deadline, since waiting on an unstructured task cannot
+        // be cancelled; the probe and the deadline race through a continuation instead, and the probe keeps running
+        if measuredAt == nil, let probeTask {
+            let timeout = firstProbeTimeout
+            let deadline = Task {
+                try? await Task.sleep(nanoseconds: UInt64(timeout * 1_000_000_000))
+            }
+            await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+                let race = FirstCompletion(continuation)
+                Task {
+                    await probeTask.value
+                    race.complete()
+                }
+                Task {
+                    await deadline.value
+                    race.complete()
+                }
+            }
+            deadline.cancel()
+        }
+        return estimate
+    }
+
+    /// Forget the estimate after a failed cloud request, so the next request measures again
+    func invalidate() {
+        estimate = nil
+        measuredAt = nil
+    }
+
+    private func record(_ measured: TimeInterval?) {
+        if let measured {
+            estimate = estimate.map { $0 + smoothing * (measured - $0) } ?? measured
+        } else {
+            estimate = nil
+        }
+        measuredAt = Date()
+        probeTask = nil
+    }
+}
+
+/// Resumes a continuation once, for whichever of several racing tasks completes first
+private final class FirstCompletion {
+    private let lock = NSLock()
+    private var continuation: CheckedContinuation<Void, Never>?
+
+    init(_ continuation: CheckedContinuation<Void, Never>) {
+        self.continuation = continuation
+    }
+
+    func complete() {
+        lock.lock()
+        let continuation = self.continuation
+        self.continuation = nil
+        lock.unlock()
+
+        continuation?.resume()
+    }
+}
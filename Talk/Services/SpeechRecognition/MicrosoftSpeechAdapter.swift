@@ -0,0 +1,174 @@
+import Foundation
+import MicrosoftCognitiveServicesSpeech
+
+/// Speech recognition with the Microsoft Speech SDK, either against the cloud service or an on-device (embedded) model
+/// The utterance is pushed through an `SPXPushAudioInputStream`, so each request gets its own recognizer
+public class MicrosoftSpeechAdapter: SpeechRecognitionAdapter {
+    private enum Configuration {
+        case cloud(SPXSpeechConfiguration)
+        case embedded(SPXEmbeddedSpeechConfiguration)
+    }
+
+    private let configuration: Configuration
+    private let language: String
+
+    /// Cloud recognition
+    public init(subscriptionKey: String, region: String, language: String = "en-US") throws {
+        let speechConfig = try SPXSpeechConfiguration(subscription: subscriptionKey, region: region)
+        speechConfig.speechRecognitionLanguage = language
+        configuration = .cloud(speechConfig)
+        self.language = language
+    }
+
+    /// On-device recognition
+    /// - Parameters:
+    ///   - modelPath: Directory that contains the embedded speech recognition model
+    ///   - modelName: Name of the model to use, as listed in the model's configuration
+    ///   - license: License text of the model
+    public init(modelPath: String, modelName: String, license: String, language: String = "en-US") throws {
+        let speechConfig = try SPXEmbeddedSpeechConfiguration(fromPath: modelPath)
+        speechConfig.setSpeechRecognitionModel(modelName, license: license)
+        configuration = .embedded(speechConfig)
+        self.language = language
+    }
+
+    public func recognize(pcmData: [Int16]) async throws -> SpeechRecognitionResult {
+        // The default stream format is 16kHz, 16-bit, mono PCM
+        let stream = SPXPushAudioInputStream()
+        guard let audioConfig = SPXAudioConfiguration(streamInput: stream) else {
+            throw SpeechRecognitionError.processingFailed("cannot create audio stream")
+        }
+
+        let recognizer: SPXSpeechRecognizer
+        do {
+            switch configuration {
+            case let .cloud(speechConfig):
+                recognizer = try SPXSpeechRecognizer(speechConfiguration: speechConfig, audioConfiguration: audioConfig)
+            case let .embedded(speechConfig):
+                recognizer = try SPXSpeechRecognizer(embeddedSpeechConfiguration: speechConfig, audioConfiguration: audioConfig)
+            }
+        } catch {
+            throw SpeechRecognitionError.processingFailed(error.localizedDescription)
+        }
+
+        // Stopping blocks until the session ends, so it runs on a dispatch queue instead of the cooperative pool
+        defer {
+            DispatchQueue.global(qos: .utility).async {
+                try? recognizer.stopContinuousRecognition()
+            }
+        }
+
+        // A cancelled request, e.g. a timed out cloud request of the hybrid adapter, returns right away
+        let completion = RecognitionCompletion()
+        let text: String = try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                guard completion.start(continuation) else { return }
+                startRecognition(recognizer, stream: stream, pcmData: pcmData, completion: completion)
+            }
+        } onCancel: {
+            completion.cancel()
+        }
+
+        return SpeechRecognitionResult(
+            text: text,
+            language: language.components(separatedBy: "-").first ?? "en",
+            additionalInfo: nil
+        )
+    }
+
+    private func startRecognition(
+        _ recognizer: SPXSpeechRecognizer,
+        stream: SPXPushAudioInputStream,
+        pcmData: [Int16],
+        completion: RecognitionCompletion
+    ) {
+        recognizer.addRecognizedEventHandler { _, args in
+            if args.result.reason == .recognizedSpeech, let text = args.result.text, !text.isEmpty {
+                completion.append(text)
+            }
+        }
+        recognizer.addCanceledEventHandler { _, args in
+            if args.reason == .endOfStream {
+                completion.finish()
+            } else {
+                completion.fail(args.errorDetails ?? "recognition canceled (\(args.errorCode.rawValue))")
+            }
+        }
+        recognizer.addSessionStoppedEventHandler { _, _ in
+            completion.finish()
+        }
+
+        do {
+            try recognizer.startContinuousRecognition()
+        } catch {
+            completion.fail(error.localizedDescription)
+            return
+        }
+
+        pcmData.withUnsafeBufferPointer { buffer in
+            stream.write(Data(buffer: buffer))
+        }
+        stream.close()
+    }
+}
+
+/// Collects the phrases of one utterance and resumes the continuation exactly once,
+/// whichever of session stopped, end of stream, error or cancellation arrives first
+private final class RecognitionCompletion {
+    private let lock = NSLock()
+    private var continuation: CheckedContinuation<String, Error>?
+    private var phrases: [String] = []
+
+    /// Set by the first of finish, fail or cancel
+    private var outcome: Result<String, Error>?
+
+    /// Hands over the continuation; returns false, after resuming it, when the recognition already ended
+    func start(_ continuation: CheckedContinuation<String, Error>) -> Bool {
+        lock.lock()
+        guard let outcome else {
+            self.continuation = continuation
+            lock.unlock()
+            return true
+        }
+        lock.unlock()
+
+        continuation.resume(with: outcome)
+        return false
+    }
+
+    func append(_ text: String) {
+        lock.lock()
+        defer { lock.unlock() }
+        phrases.append(text)
+    }
+
+    func finish() {
+        lock.lock()
+        let text = phrases.joined(separator: " ")
+        lock.unlock()
+
+        complete(.success(text))
+    }
+
+    func fail(_ message: String) {
+        complete(.failure(SpeechRecognitionError.processingFailed(message)))
+    }
+
+    func cancel() {
+        complete(.failure(CancellationError()))
+    }
+
+    private func complete(_ result: Result<String, Error>) {
+        lock.lock()
+        guard outcome == nil else {
+            lock.unlock()
+            return
+        }
+        outcome = result
+        let continuation = self.continuation
+        self.continuation = nil
+        lock.unlock()
+
+        continuation?.resume(with: result)
+    }
+}
@@ -20,10 +20,27 @@ public enum SpeechRecognitionError: Error {
     case adapterNotAvailable
 }
 
+/// Called with an early result while the final one is still pending, on an arbitrary thread
+public typealias PartialResultHandler = (SpeechRecognitionResult) -> Void
+
 public protocol SpeechRecognitionService {
-    func recognizeSpeech(pcmData: [Int16]) async throws -> SpeechRecognitionResult
+    func recognizeSpeech(pcmData: [Int16], onPartialResult: PartialResultHandler?) async throws -> SpeechRecognitionResult
+}
+
+public extension SpeechRecognitionService {
+    func recognizeSpeech(pcmData: [Int16]) async throws -> SpeechRecognitionResult {
+        try await recognizeSpeech(pcmData: pcmData, onPartialResult: nil)
+    }
 }
 
 public protocol SpeechRecognitionAdapter {
     func recognize(pcmData: [Int16]) async throws -> SpeechRecognitionResult
+    func recognize(pcmData: [Int16], onPartialResult: PartialResultHandler?) async throws -> SpeechRecognitionResult
+}
+
+public extension SpeechRecognitionAdapter {
+    /// Adapters without early results only report the final one
+    func recognize(pcmData: [Int16], onPartialResult _: PartialResultHandler?) async throws -> SpeechRecognitionResult {
+        try await recognize(pcmData: pcmData)
+    }
 }
@@ -2,20 +2,36 @@ import Alamofire
 import Foundation
 
 public class WhisperCppServerAdapter: SpeechRecognitionAdapter {
+    /// Container of the uploaded audio. FLAC is lossless and about half the size of WAV for speech,
+    /// but needs a server built with FLAC decoding (whisper.cpp with miniaudio, or started with `--convert`).
+    public enum UploadFormat: String, Codable, CaseIterable, Identifiable {
+        case wav = "WAV"
+        case flac = "FLAC"
+
+        public var id: String { rawValue }
+    }
+
     private let serverURL: URL
     private let language: String?
+    private let uploadFormat: UploadFormat
 
-    public init(serverURL: URL, language: String? = nil) {
+    public init(serverURL: URL, language: String? = nil, uploadFormat: UploadFormat = .wav) {
         self.serverURL = serverURL
         self.language = language
+        self.uploadFormat = uploadFormat
     }
 
     public func recognize(pcmData: [Int16]) async throws -> SpeechRecognitionResult {
         let fileData = MultipartFormData()
 
-        let wavData = AudioHelper.convertToWavData(pcmData)
-
-        fileData.append(wavData, withName: "file", fileName: "audio.wav", mimeType: "audio/wav")
+        switch uploadFormat {
+        case .wav:
+            let wavData = AudioHelper.convertToWavData(pcmData)
+            fileData.append(wavData, withName: "file", fileName: "audio.wav", mimeType: "audio/wav")
+        case .flac:
+            let flacData = FlacEncoder.encode(pcmData)
+            fileData.append(flacData, withName: "file", fileName: "audio.flac", mimeType: "audio/flac")
+        }
 
         if let language = language {
             fileData.append(language.data(using: .utf8)!, withName: "language")
@@ -15,11 +15,14 @@ struct TalkApp: App {
     var modelContainerError: Bool = false
 
     init() {
+        LaunchTimer.markLaunch()
+
         do {
-            let schema = Schema(versionedSchema: AppSchemaV1.self)
+            let schema = Schema(versionedSchema: AppSchemaV2.self)
 
             modelContainer = try ModelContainer(
                 for: schema,
+                migrationPlan: AppMigrationPlan.self
             )
         } catch {
             modelContainerError = true
@@ -0,0 +1,255 @@
+//
+//  FlacEncoder.swift
+//  Talk
+//
+
+import Foundation
+
+/// Lossless FLAC encoder for mono 16-bit PCM, used to shrink speech uploads.
+/// Same scheme as `FlacEncoder` in speechapi_cxx_flac_codec.h: fixed predictors of order 0...4,
+/// partitioned Rice coding, and constant or verbatim subframes when they are smaller.
+enum FlacEncoder {
+    static let blockSize = 4096
+
+    static func encode(_ pcmData: [Int16], sampleRate: UInt32 = 16000) -> Data {
+        var writer = BitWriter()
+        writer.bytes.reserveCapacity(pcmData.count + 64)
+
+        writer.bytes.append(contentsOf: Array("fLaC".utf8))
+        writer.write(1, 1) // last metadata block
+        writer.write(0, 7) // STREAMINFO
+        writer.write(34, 24)
+        writer.write(16, 16)
+        writer.write(UInt32(blockSize), 16)
+        writer.write(0, 24)
+        writer.write(0, 24)
+        writer.write(sampleRate, 20)
+        writer.write(0, 3) // one channel
+        writer.write(15, 5) // 16 bits per sample
+        writer.write(UInt32(UInt64(pcmData.count) >> 32), 4)
+        writer.write(UInt32(truncatingIfNeeded: pcmData.count), 32)
+        for _ in 0 ..< 4 {
+            writer.write(0, 32) // no MD5 signature
+        }
+
+        pcmData.withUnsafeBufferPointer { samples in
+            var residual = [UInt32](repeating: 0, count: blockSize)
+            var start = 0
+            while start < samples.count {
+                let count = min(blockSize, samples.count - start)
+                let block = UnsafeBufferPointer(rebasing: samples[start ..< start + count])
+                encodeFrame(block, sampleNumber: UInt64(start), sampleRate: sampleRate, residual: &residual, writer: &writer)
+                start += count
+            }
+        }
+
+        return Data(writer.bytes)
+    }
+
+    private static func encodeFrame(_ samples: UnsafeBufferPointer<Int16>, sampleNumber: UInt64, sampleRate: UInt32, residual: inout [UInt32], writer: inout BitWriter) {
+        let frameStart = writer.bytes.count
+        writer.write(0xFFF9, 16) // sync code, variable block size
+        writer.write(7, 4) // block size - 1 follows as 16 bits
+        writer.write(sampleRateCode(sampleRate), 4)
+        writer.write(0, 4) // one channel
+        writer.write(4, 3) // 16 bits per sample
+        writer.write(0, 1)
+        writer.writeUTF8(sampleNumber)
+        writer.write(UInt32(samples.count - 1), 16)
+        writer.write(UInt32(crc8(writer.bytes[frameStart...])), 8)
+
+        encodeSubframe(samples, residual: &residual, writer: &writer)
+
+        writer.alignToByte()
+        writer.write(UInt32(crc16(writer.bytes[frameStart...])), 16)
+    }
+
+    private static func encodeSubframe(_ samples: UnsafeBufferPointer<Int16>, residual: inout [UInt32], writer: inout BitWriter) {
+        let count = samples.count
+        if samples.allSatisfy({ $0 == samples[0] }) {
+            writer.write(0, 8) // constant subframe
+            writer.write(UInt32(UInt16(bitPattern: samples[0])), 16)
+            return
+        }
+
+        let order = chooseFixedOrder(samples)
+        for i in order ..< count {
+            let x = Int32(samples[i])
+            var prediction: Int32 = 0
+            switch order {
+            case 1: prediction = Int32(samples[i - 1])
+            case 2: prediction = 2 * Int32(samples[i - 1]) - Int32(samples[i - 2])
+            case 3: prediction = 3 * Int32(samples[i - 1]) - 3 * Int32(samples[i - 2]) + Int32(samples[i - 3])
+            case 4: prediction = 4 * Int32(samples[i - 1]) - 6 * Int32(samples[i - 2]) + 4 * Int32(samples[i - 3]) - Int32(samples[i - 4])
+            default: break
+            }
+            let e = x - prediction
+            residual[i - order] = UInt32(bitPattern: e << 1) ^ UInt32(bitPattern: e >> 31)
+        }
+
+        let (partitionOrder, parameters, residualBits) = chooseRiceParameters(residual, count: count, order: order)
+        if 8 + 16 * order + residualBits >= 8 + 16 * count {
+            writer.write(2, 8) // verbatim subframe
+            for sample in samples {
+                writer.write(UInt32(UInt16(bitPattern: sample)), 16)
+            }
+            return
+        }
+
+        writer.write(UInt32(0x10 | (order << 1)), 8) // fixed subframe
+        for i in 0 ..< order {
+            writer.write(UInt32(UInt16(bitPattern: samples[i])), 16)
+        }
+
+        let useRice2 = parameters.contains { $0 > 14 }
+        writer.write(useRice2 ? 1 : 0, 2)
+        writer.write(UInt32(partitionOrder), 4)
+
+        var index = 0
+        for (partition, parameter) in parameters.enumerated() {
+            let n = (count >> partitionOrder) - (partition == 0 ? order : 0)
+            writer.write(parameter, useRice2 ? 5 : 4)
+            for _ in 0 ..< n {
+                writer.writeRice(residual[index], parameter)
+                index += 1
+            }
+        }
+    }
+
+    private static func chooseFixedOrder(_ samples: UnsafeBufferPointer<Int16>) -> Int {
+        guard samples.count > 4 else { return 0 }
+
+        var sums = [UInt64](repeating: 0, count: 5)
+        for i in 4 ..< samples.count {
+            let e0 = Int32(samples[i])
+            let e1 = e0 - Int32(samples[i - 1])
+            let e2 = e1 - (Int32(samples[i - 1]) - Int32(samples[i - 2]))
+            let e3 = e2 - (Int32(samples[i - 1]) - 2 * Int32(samples[i - 2]) + Int32(samples[i - 3]))
+            let e4 = e3 - (Int32(samples[i - 1]) - 3 * Int32(samples[i - 2]) + 3 * Int32(samples[i - 3]) - Int32(samples[i - 4]))
+            sums[0] += UInt64(e0.magnitude)
+            sums[1] += UInt64(e1.magnitude)
+            sums[2] += UInt64(e2.magnitude)
+            sums[3] += UInt64(e3.magnitude)
+            sums[4] += UInt64(e4.magnitude)
+        }
+        return sums.indices.min { sums[$0] < sums[$1] }!
+    }
+
+    private static func chooseRiceParameters(_ residual: [UInt32], count: Int, order: Int) -> (Int, [UInt32], Int) {
+        var maxOrder = 0
+        while maxOrder < 8, count % (2 << maxOrder) == 0, (count >> (maxOrder + 1)) > order {
+            maxOrder += 1
+        }
+
+        var sums = [UInt64]()
+        var index = 0
+        for partition in 0 ..< (1 << maxOrder) {
+            let n = (count >> maxOrder) - (partition == 0 ? order : 0)
+            var sum: UInt64 = 0
+            for i in index ..< index + n {
+                sum += UInt64(residual[i])
+            }
+            sums.append(sum)
+            index += n
+        }
+
+        var best: (Int, [UInt32], Int) = (0, [], Int.max)
+        for partitionOrder in stride(from: maxOrder, through: 0, by: -1) {
+            var parameters = [UInt32]()
+            var bits = 6
+            for partition in 0 ..< (1 << partitionOrder) {
+                let n = UInt64((count >> partitionOrder) - (partition == 0 ? order : 0))
+                var parameter: UInt32 = 0
+                while parameter < 30, (n << (parameter + 1)) < sums[partition] {
+                    parameter += 1
+                }
+                parameters.append(parameter)
+                bits += 5 + Int(n) * Int(parameter + 1) + Int(sums[partition] >> parameter)
+            }
+            if bits < best.2 {
+                best = (partitionOrder, parameters, bits)
+            }
+            sums = stride(from: 0, to: sums.count - 1, by: 2).map { sums[$0] + sums[$0 + 1] }
+        }
+        return best
+    }
+
+    private static func sampleRateCode(_ sampleRate: UInt32) -> UInt32 {
+        switch sampleRate {
+        case 8000: return 4
+        case 16000: return 5
+        case 22050: return 6
+        case 24000: return 7
+        case 32000: return 8
+        case 44100: return 9
+        case 48000: return 10
+        default: return 0
+        }
+    }
+
+    private static func crc8(_ bytes: ArraySlice<UInt8>) -> UInt8 {
+        var crc: UInt8 = 0
+        for byte in bytes {
+            crc ^= byte
+            for _ in 0 ..< 8 {
+                crc = crc & 0x80 != 0 ? (crc << 1) ^ 0x07 : crc << 1
+            }
+        }
+        return crc
+    }
+
+    private static func crc16(_ bytes: ArraySlice<UInt8>) -> UInt16 {
+        var crc: UInt16 = 0
+        for byte in bytes {
+            crc ^= UInt16(byte) << 8
+            for _ in 0 ..< 8 {
+                crc = crc & 0x8000 != 0 ? (crc << 1) ^ 0x8005 : crc << 1
+            }
+        }
+        return crc
+    }
+
+    private struct BitWriter {
+        var bytes = [UInt8]()
+        private var accumulator: UInt64 = 0
+        private var count: UInt32 = 0
+
+        mutating func write(_ value: UInt32, _ bits: UInt32) {
+            guard bits > 0 else { return }
+            let masked = bits < 32 ? UInt64(value) & ((1 << UInt64(bits)) - 1) : UInt64(value)
+            accumulator = (accumulator << UInt64(bits)) | masked
+            count += bits
+            while count >= 8 {
+                count -= 8
+                bytes.append(UInt8(truncatingIfNeeded: accumulator >> UInt64(count)))
+            }
+        }
+
+        mutating func writeRice(_ value: UInt32, _ parameter: UInt32) {
+            var zeros = value >> parameter
+            while zeros > 24 {
+                write(0, 24)
+                zeros -= 24
+            }
+            write(0, zeros)
+            write(1, 1)
+            write(value, parameter)
+        }
+
+        mutating func writeUTF8(_ value: UInt64) {
+            if value < 0x80 {
+                write(UInt32(value), 8)
+                return
+            }
+            let count: UInt64 = value < 0x800 ? 2 : value < 0x10000 ? 3 : value < 0x200000 ? 4 : value < 0x4000000 ? 5 : value < 0x8000_0000 ? 6 : 7
+            write(UInt32((0xFF00 >> count) & 0xFF) | UInt32(value >> (6 * (count - 1))), 8)
+            for i in stride(from: count - 1, to: 0, by: -1) {
+                write(0x80 | UInt32((value >> (6 * (i - 1))) & 0x3F), 8)
+            }
+        }
+
+        mutating func alignToByte() {
+            write(0, (8 - count) & 7)
+        }
+    }
+}
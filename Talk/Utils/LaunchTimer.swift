@@ -0,0 +1,38 @@
+//
+//  LaunchTimer.swift
+//  Talk
+//
+
+import Foundation
+
+/// Measures the cold start: the time from app launch to audio capture and each service being ready,
+/// and to the first time the microphone listens. Each milestone is logged once per launch
+enum LaunchTimer {
+    private static let logger = DebugLogger(tag: "LaunchTimer")
+
+    private static var launchTime: Date?
+    private static var reported: Set<String> = []
+
+    /// Call once when the app starts
+    static func markLaunch() {
+        launchTime = Date()
+    }
+
+    /// Logs the time from launch to `name` being ready, the first time it is called for `name`
+    static func markReady(_ name: String) {
+        guard let elapsed = elapsedOnce(for: name) else { return }
+        logger.success("Cold start to \(name) ready: \(elapsed) ms")
+    }
+
+    /// Logs the cold start time the first time it is called after launch
+    static func markFirstListen() {
+        guard let elapsed = elapsedOnce(for: "first listen") else { return }
+        logger.success("Cold start to first listen: \(elapsed) ms")
+    }
+
+    /// Milliseconds since launch, or nil when the milestone was already reported
+    private static func elapsedOnce(for milestone: String) -> Int? {
+        guard let launchTime, reported.insert(milestone).inserted else { return nil }
+        return Int(Date().timeIntervalSince(launchTime) * 1000)
+    }
+}
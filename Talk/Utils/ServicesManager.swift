@@ -15,6 +15,30 @@ enum ServicesManager {
         return EnergyVADEngine()
     }
 
+    static func createKeywordSpotter(selectedRecordingMode: SettingsModel.RecordingMode, wakeWordSettings: WakeWordSettings) throws -> KeywordSpotter? {
+        guard selectedRecordingMode == .wakeWord else {
+            return nil
+        }
+        if wakeWordSettings.keywordModelPath.isEmpty {
+            throw SettingsServiceError.invalidConfiguration("Wake word keyword model is not configured, please check your settings")
+        }
+
+        var modelURL = URL(fileURLWithPath: wakeWordSettings.keywordModelPath)
+        if !wakeWordSettings.keywordModelPath.hasPrefix("/") {
+            let documents = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+            modelURL = documents.appendingPathComponent(wakeWordSettings.keywordModelPath)
+        }
+        guard FileManager.default.fileExists(atPath: modelURL.path) else {
+            throw SettingsServiceError.invalidConfiguration("Wake word keyword model \(modelURL.lastPathComponent) was not found, please check your settings")
+        }
+
+        do {
+            return try MicrosoftKeywordSpotter(modelPath: modelURL.path)
+        } catch {
+            throw SettingsServiceError.invalidConfiguration("Wake word keyword model could not be loaded: \(error.localizedDescription)")
+        }
+    }
+
     static func createLLMService(selectedLLMService: SettingsModel.LLMServiceType, openAILLMSettings: OpenAILLMSettings, difySettings: DifySettings) throws -> LLMService {
         switch selectedLLMService {
         case .openAI:
@@ -48,7 +72,8 @@ enum ServicesManager {
         selectedSpeechService: SettingsModel.SpeechServiceType,
         whisperCppSettings: WhisperCppSettings,
         whisperKitSettings: WhisperKitSettings,
-        appleSpeechSettings: AppleSpeechSettings
+        appleSpeechSettings: AppleSpeechSettings,
+        hybridSpeechSettings: HybridSpeechSettings
     ) async throws -> SpeechRecognitionService {
         switch selectedSpeechService {
         case .whisperCpp:
@@ -56,11 +81,44 @@ enum ServicesManager {
                 throw SettingsServiceError.invalidConfiguration("You choose Whisper.cpp, but you haven't configured the server URL, please check your settings")
             }
             let serverURL = URL(string: whisperCppSettings.serverURL) ?? URL(string: "http://localhost:8080/inference")!
-            return SpeechRecognitionServiceFactory.createWhisperCppService(serverURL: serverURL)
+            return SpeechRecognitionServiceFactory.createWhisperCppService(serverURL: serverURL, uploadFormat: whisperCppSettings.uploadFormat)
         case .whisperKit:
             return try await SpeechRecognitionServiceFactory.createWhisperKitService(modelName: whisperKitSettings.modelName)
         case .system:
             return SpeechRecognitionServiceFactory.createAppleSpeechService(language: appleSpeechSettings.language)
+        case .hybrid:
+            if hybridSpeechSettings.subscriptionKey.isEmpty {
+                throw SettingsServiceError.invalidConfiguration("Hybrid speech recognition subscription key is not configured, please check your settings")
+            }
+            if hybridSpeechSettings.region.isEmpty {
+                throw SettingsServiceError.invalidConfiguration("Hybrid speech recognition region is not configured, please check your settings")
+            }
+            if hybridSpeechSettings.embeddedModelPath.isEmpty || hybridSpeechSettings.embeddedModelName.isEmpty {
+                throw SettingsServiceError.invalidConfiguration("Hybrid speech recognition on-device model is not configured, please check your settings")
+            }
+
+            var modelURL = URL(fileURLWithPath: hybridSpeechSettings.embeddedModelPath)
+            if !hybridSpeechSettings.embeddedModelPath.hasPrefix("/") {
+                let documents = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+                modelURL = documents.appendingPathComponent(hybridSpeechSettings.embeddedModelPath)
+            }
+            guard FileManager.default.fileExists(atPath: modelURL.path) else {
+                throw SettingsServiceError.invalidConfiguration("Hybrid speech recognition model \(modelURL.lastPathComponent) was not found, please check your settings")
+            }
+
+            do {
+                return try SpeechRecognitionServiceFactory.createHybridService(
+                    subscriptionKey: hybridSpeechSettings.subscriptionKey,
+                    region: hybridSpeechSettings.region,
+                    language: hybridSpeechSettings.language,
+                    embeddedModelPath: modelURL.path,
+                    embeddedModelName: hybridSpeechSettings.embeddedModelName,
+                    embeddedModelLicense: hybridSpeechSettings.embeddedModelLicense,
+                    maxCloudRoundTrip: TimeInterval(hybridSpeechSettings.maxRoundTripMs) / 1000
+                )
+            } catch {
+                throw SettingsServiceError.invalidConfiguration("Hybrid speech recognition could not be created: \(error.localizedDescription)")
+            }
         }
     }
 
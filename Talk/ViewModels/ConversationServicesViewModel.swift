@@ -0,0 +1,282 @@
+//
+//  ConversationServicesViewModel.swift
+//  Talk
+//
+
+import Combine
+import Foundation
+
+/// Creates the services of a conversation and tracks the readiness of each one
+/// Audio capture only depends on the recording settings, so it is ready right away; speech recognition,
+/// LLM and TTS are created concurrently and each is awaited only where the conversation first needs it,
+/// so a slow backend (e.g. a WhisperKit CoreML model) no longer delays listening.
+/// A settings change rebuilds only the services whose configuration changed
+@MainActor
+final class ConversationServicesViewModel: ObservableObject {
+    enum Readiness: Equatable {
+        case idle
+        case loading
+        case ready
+        case failed(String)
+
+        var isSettled: Bool {
+            switch self {
+            case .ready, .failed: return true
+            case .idle, .loading: return false
+            }
+        }
+
+        var isFailed: Bool {
+            if case .failed = self {
+                return true
+            }
+            return false
+        }
+    }
+
+    private let logger = DebugLogger(tag: "ConversationServices")
+
+    @Published private(set) var captureReadiness: Readiness = .idle
+    @Published private(set) var speechRecognitionReadiness: Readiness = .idle
+    @Published private(set) var llmReadiness: Readiness = .idle
+    @Published private(set) var ttsReadiness: Readiness = .idle
+
+    private var speechRecognition: SpeechRecognitionService?
+    private var llm: LLMService?
+    private var tts: TTSService?
+
+    /// Configurations the current services were created from
+    private var applied: ServiceConfigurations?
+
+    /// Incremented by every rebuild of a service, so the result of a superseded rebuild is dropped
+    private var speechRecognitionGeneration = 0
+    private var llmGeneration = 0
+    private var ttsGeneration = 0
+
+    /// First configuration error among the services, if any
+    var configurationError: String? {
+        for readiness in [captureReadiness, speechRecognitionReadiness, llmReadiness, ttsReadiness] {
+            if case let .failed(message) = readiness {
+                return message
+            }
+        }
+        return nil
+    }
+
+    /// Bring the services in line with the given settings
+    /// Only services whose configuration changed since the last call, or that failed, are rebuilt; the others,
+    /// and any request already running on a rebuilt service, keep their instances
+    func apply(settings: SettingsModel?, speechMonitor: SpeechMonitorViewModel) {
+        guard let settings else {
+            let message = "Please open the settings page to configure your preferences for the first time."
+            applied = nil
+            captureReadiness = .failed(message)
+            speechRecognitionReadiness = .failed(message)
+            llmReadiness = .failed(message)
+            ttsReadiness = .failed(message)
+            return
+        }
+
+        let configurations = settings.serviceConfigurations
+        let previous = applied
+        applied = configurations
+
+        // Capture first, it is cheap and everything else can finish while the user speaks
+        if previous?.capture != configurations.capture || captureReadiness.isFailed {
+            configureCapture(configurations.capture, speechMonitor: speechMonitor)
+        }
+
+        let rebuildSpeechRecognition = previous?.speechRecognition != configurations.speechRecognition || speechRecognitionReadiness.isFailed
+        let rebuildLLM = previous?.llm != configurations.llm || llmReadiness.isFailed
+        let rebuildTTS = previous?.tts != configurations.tts || ttsReadiness.isFailed
+        guard rebuildSpeechRecognition || rebuildLLM || rebuildTTS else {
+            return
+        }
+
+        if rebuildSpeechRecognition {
+            speechRecognitionGeneration += 1
+            speechRecognition = nil
+            speechRecognitionReadiness = .loading
+        }
+        if rebuildLLM {
+            llmGeneration += 1
+            llm = nil
+            llmReadiness = .loading
+        }
+        if rebuildTTS {
+            ttsGeneration += 1
+            tts = nil
+            ttsReadiness = .loading
+        }
+
+        let speechRecognitionGeneration = self.speechRecognitionGeneration
+        let llmGeneration = self.llmGeneration
+        let ttsGeneration = self.ttsGeneration
+
+        let start = Date()
+        Task {
+            await withTaskGroup(of: Void.self) { group in
+                if rebuildSpeechRecognition {
+                    group.addTask {
+                        do {
+                            let service = try await Self.createSpeechRecognitionService(configurations.speechRecognition)
+                            await self.setSpeechRecognition(.success(service), generation: speechRecognitionGeneration, since: start)
+                        } catch {
+                            await self.setSpeechRecognition(.failure(error), generation: speechRecognitionGeneration, since: start)
+                        }
+                    }
+                }
+
+                if rebuildLLM {
+                    group.addTask {
+                        do {
+                            let service = try Self.createLLMService(configurations.llm)
+                            await self.setLLM(.success(service), generation: llmGeneration, since: start)
+                        } catch {
+                            await self.setLLM(.failure(error), generation: llmGeneration, since: start)
+                        }
+                    }
+                }
+
+                if rebuildTTS {
+                    group.addTask {
+                        do {
+                            let service = try Self.createTTSService(configurations.tts)
+                            await self.setTTS(.success(service), generation: ttsGeneration, since: start)
+                        } catch {
+                            await self.setTTS(.failure(error), generation: ttsGeneration, since: start)
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // MARK: - Services
+
+    /// Speech recognition service, waiting for it while it is still being created
+    func speechRecognitionService() async throws -> SpeechRecognitionService {
+        try await service(\.speechRecognition, readiness: $speechRecognitionReadiness)
+    }
+
+    /// LLM service, waiting for it while it is still being created
+    func llmService() async throws -> LLMService {
+        try await service(\.llm, readiness: $llmReadiness)
+    }
+
+    /// TTS service, waiting for it while it is still being created
+    func ttsService() async throws -> TTSService {
+        try await service(\.tts, readiness: $ttsReadiness)
+    }
+
+    private func service<Service>(
+        _ keyPath: KeyPath<ConversationServicesViewModel, Service?>,
+        readiness: Published<Readiness>.Publisher
+    ) async throws -> Service {
+        var state = Readiness.idle
+        for await value in readiness.values where value.isSettled || value == .idle {
+            state = value
+            break
+        }
+
+        if case let .failed(message) = state {
+            throw SettingsServiceError.invalidConfiguration(message)
+        }
+        guard let service = self[keyPath: keyPath] else {
+            throw SettingsServiceError.invalidConfiguration("Services not properly initialized")
+        }
+        return service
+    }
+
+    // MARK: - Private Methods
+
+    private func configureCapture(_ configuration: CaptureConfiguration, speechMonitor: SpeechMonitorViewModel) {
+        // The monitor stops according to its current mode, so stop it before switching modes
+        if speechMonitor.listening {
+            speechMonitor.stopMonitoring()
+        }
+
+        do {
+            speechMonitor.setManualRecording(configuration.recordingMode == .manual)
+            let keywordSpotter = try ServicesManager.createKeywordSpotter(
+                selectedRecordingMode: configuration.recordingMode,
+                wakeWordSettings: configuration.wakeWordSettings ?? WakeWordSettings()
+            )
+            speechMonitor.setKeywordSpotter(keywordSpotter)
+            captureReadiness = .ready
+            LaunchTimer.markReady("capture")
+        } catch {
+            speechMonitor.setKeywordSpotter(nil)
+            captureReadiness = .failed(Self.message(for: error))
+        }
+    }
+
+    private nonisolated static func createSpeechRecognitionService(_ configuration: SpeechRecognitionConfiguration) async throws -> SpeechRecognitionService {
+        try await ServicesManager.createSpeechRecognitionService(
+            selectedSpeechService: configuration.service,
+            whisperCppSettings: configuration.whisperCppSettings ?? WhisperCppSettings(),
+            whisperKitSettings: configuration.whisperKitSettings ?? WhisperKitSettings(),
+            appleSpeechSettings: configuration.appleSpeechSettings ?? AppleSpeechSettings(),
+            hybridSpeechSettings: configuration.hybridSpeechSettings ?? HybridSpeechSettings()
+        )
+    }
+
+    private nonisolated static func createLLMService(_ configuration: LLMConfiguration) throws -> LLMService {
+        var openAILLMSettings = OpenAILLMSettings()
+        openAILLMSettings.apiKey = configuration.openAIAPIKey ?? ""
+        openAILLMSettings.baseURL = configuration.openAIBaseURL ?? ""
+        openAILLMSettings.model = configuration.openAIModel ?? ""
+
+        return try ServicesManager.createLLMService(
+            selectedLLMService: configuration.service,
+            openAILLMSettings: openAILLMSettings,
+            difySettings: configuration.difySettings ?? DifySettings()
+        )
+    }
+
+    private nonisolated static func createTTSService(_ configuration: TTSConfiguration) throws -> TTSService {
+        try ServicesManager.createTTSService(
+            selectedTTSService: configuration.service,
+            microsoftTTSSettings: configuration.microsoftTTSSettings ?? MicrosoftTTSSettings(),
+            openAITTSSettings: configuration.openAITTSSettings ?? OpenAITTSSettings(),
+            systemTTSSettings: configuration.systemTTSSettings ?? SystemTTSSettings()
+        )
+    }
+
+    private func setSpeechRecognition(_ result: Result<SpeechRecognitionService, Error>, generation: Int, since start: Date) {
+        guard generation == speechRecognitionGeneration else { return }
+        speechRecognition = try? result.get()
+        speechRecognitionReadiness = readiness(of: result, name: "Speech recognition", since: start)
+    }
+
+    private func setLLM(_ result: Result<LLMService, Error>, generation: Int, since start: Date) {
+        guard generation == llmGeneration else { return }
+        llm = try? result.get()
+        llmReadiness = readiness(of: result, name: "LLM", since: start)
+    }
+
+    private func setTTS(_ result: Result<TTSService, Error>, generation: Int, since start: Date) {
+        guard generation == ttsGeneration else { return }
+        tts = try? result.get()
+        ttsReadiness = readiness(of: result, name: "TTS", since: start)
+    }
+
+    private func readiness<Service>(of result: Result<Service, Error>, name: String, since start: Date) -> Readiness {
+        switch result {
+        case .success:
+            logger.success("\(name) service ready in \(Int(Date().timeIntervalSince(start) * 1000)) ms")
+            LaunchTimer.markReady("\(name) service")
+            return .ready
+        case let .failure(error):
+            logger.error("\(name) service failed: \(error)")
+            return .failed(Self.message(for: error))
+        }
+    }
+
+    private static func message(for error: Error) -> String {
+        if case let SettingsServiceError.invalidConfiguration(message) = error {
+            return message
+        }
+        return "Unknown error occurred: \(error.localizedDescription)"
+    }
+}
@@ -21,6 +21,12 @@ class SettingsViewModel: ObservableObject {
         }
     }
 
+    @Published var wakeWordSettings: WakeWordSettings {
+        didSet {
+            saveSettings()
+        }
+    }
+
     @Published var selectedLLMService: SettingsModel.LLMServiceType {
         didSet {
             saveSettings()
@@ -63,6 +69,12 @@ class SettingsViewModel: ObservableObject {
         }
     }
 
+    @Published var hybridSpeechSettings: HybridSpeechSettings {
+        didSet {
+            saveSettings()
+        }
+    }
+
     @Published var selectedTTSService: SettingsModel.TTSServiceType {
         didSet {
             saveSettings()
@@ -112,6 +124,7 @@ class SettingsViewModel: ObservableObject {
 
         selectedRecordingMode = settings.selectedRecordingMode
         cobraSettings = settings.cobraSettings
+        wakeWordSettings = settings.wakeWordSettings
         selectedLLMService = settings.selectedLLMService
         openAILLMSettings = settings.openAILLMSettings
         difySettings = settings.difySettings
@@ -119,6 +132,7 @@ class SettingsViewModel: ObservableObject {
         whisperCppSettings = settings.whisperCppSettings
         whisperKitSettings = settings.whisperKitSettings
         appleSpeechSettings = settings.appleSpeechSettings
+        hybridSpeechSettings = settings.hybridSpeechSettings
         selectedTTSService = settings.selectedTTSService
         microsoftTTSSettings = settings.microsoftTTSSettings
         openAITTSSettings = settings.openAITTSSettings
@@ -130,6 +144,7 @@ class SettingsViewModel: ObservableObject {
     private func saveSettings() {
         settings.selectedRecordingMode = selectedRecordingMode
         settings.cobraSettings = cobraSettings
+        settings.wakeWordSettings = wakeWordSettings
         settings.selectedLLMService = selectedLLMService
         settings.openAILLMSettings = openAILLMSettings
         settings.difySettings = difySettings
@@ -137,6 +152,7 @@ class SettingsViewModel: ObservableObject {
         settings.whisperCppSettings = whisperCppSettings
         settings.whisperKitSettings = whisperKitSettings
         settings.appleSpeechSettings = appleSpeechSettings
+        settings.hybridSpeechSettings = hybridSpeechSettings
         settings.selectedTTSService = selectedTTSService
         settings.microsoftTTSSettings = microsoftTTSSettings
         settings.openAITTSSettings = openAITTSSettings
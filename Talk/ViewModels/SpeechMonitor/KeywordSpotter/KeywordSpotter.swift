@@ -0,0 +1,21 @@
+//
+//  KeywordSpotter.swift
+//  Talk
+//
+
+/// Low-cost wake word detector that gates the VAD pipeline
+/// Receives the same 16kHz mono frames as `VADEngine`
+protocol KeywordSpotter: AnyObject {
+    /// Called once per `start()` when the keyword is detected, on an arbitrary thread, with the keyword and the
+    /// number of samples fed from `start()` to the end of the keyword, nil when the spotter cannot tell
+    var onKeywordDetected: ((_ keyword: String, _ keywordEndSample: Int?) -> Void)? { get set }
+
+    /// Start listening for the keyword
+    func start() throws
+
+    /// Feed an audio frame to the spotter
+    func process(frame: [Int16])
+
+    /// Stop listening and release the audio stream
+    func stop()
+}
@@ -0,0 +1,86 @@
+//
+//  MicrosoftKeywordSpotter.swift
+//  Talk
+//
+
+import Foundation
+import MicrosoftCognitiveServicesSpeech
+
+/// On-device keyword spotter backed by `SPXKeywordRecognizer`
+/// Audio is pushed through an `SPXPushAudioInputStream`, so the spotter can be driven
+/// by the microphone frames of `SpeechMonitorViewModel` or by recorded audio alike
+class MicrosoftKeywordSpotter: KeywordSpotter {
+    private let logger = DebugLogger(tag: "KeywordSpotter")
+
+    private let keywordModel: SPXKeywordRecognitionModel
+
+    /// Guards the stream, which is written from the audio thread
+    private let lock = NSLock()
+
+    private var stream: SPXPushAudioInputStream?
+    private var recognizer: SPXKeywordRecognizer?
+
+    var onKeywordDetected: ((_ keyword: String, _ keywordEndSample: Int?) -> Void)?
+
+    /// - Parameter modelPath: Path of the keyword model (.table) file
+    init(modelPath: String) throws {
+        keywordModel = try SPXKeywordRecognitionModel(fromFile: modelPath)
+    }
+
+    deinit {
+        stop()
+    }
+
+    func start() throws {
+        stop()
+
+        // The default stream format is 16kHz, 16-bit, mono PCM
+        let stream = SPXPushAudioInputStream()
+        guard let audioConfig = SPXAudioConfiguration(streamInput: stream) else {
+            throw NSError(domain: "KeywordSpotter", code: 1, userInfo: [NSLocalizedDescriptionKey: "Failed to create keyword audio stream"])
+        }
+
+        let recognizer = try SPXKeywordRecognizer(audioConfig)
+        try recognizer.recognizeOnceAsync({ [weak self] result in
+            guard let self else { return }
+            if result.reason == .recognizedKeyword {
+                let keyword = result.text ?? ""
+                // Offset and duration are in 100 ns ticks from the start of the stream, which is 16kHz audio
+                let keywordEndSample = Int((result.offset + result.duration) * 16000 / 10_000_000)
+                self.logger.voice("Keyword detected: \(keyword)")
+                self.onKeywordDetected?(keyword, keywordEndSample)
+            } else {
+                self.logger.info("Keyword recognition ended without a keyword, reason: \(result.reason.rawValue)")
+            }
+        }, keywordModel: keywordModel)
+
+        lock.lock()
+        self.stream = stream
+        lock.unlock()
+        self.recognizer = recognizer
+        logger.success("Keyword spotting started")
+    }
+
+    func process(frame: [Int16]) {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard let stream else { return }
+        frame.withUnsafeBufferPointer { buffer in
+            stream.write(Data(buffer: buffer))
+        }
+    }
+
+    func stop() {
+        guard let recognizer else { return }
+
+        lock.lock()
+        stream?.close()
+        stream = nil
+        lock.unlock()
+
+        try? recognizer.stopRecognitionAsync { _, _ in }
+        self.recognizer = nil
+        logger.info("Keyword spotting stopped")
+    }
+}
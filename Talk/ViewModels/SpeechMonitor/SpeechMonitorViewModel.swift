@@ -28,9 +28,27 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
     /// Whether to use manual recording mode (without VAD)
     private var manualRecording = false
 
+    /// Keyword spotter gating the VAD pipeline in wake word mode, nil when disabled
+    private var keywordSpotter: KeywordSpotter?
+
+    /// Whether frames currently go to the keyword spotter instead of the VAD
+    private var awaitingKeyword = false
+
+    /// Timer that returns to keyword spotting when no speech follows the keyword
+    private var keywordFollowUpTimer: Timer?
+
+    /// Time to wait for speech after the keyword before spotting again (in seconds)
+    private let keywordFollowUpTimeout: TimeInterval = 5.0
+
     /// Ring buffer to store recent audio frames for "pre-recording"
     private var ringBuffer: [Int16] = []
 
+    /// Samples appended to the ring buffer since monitoring started
+    private var ringBufferSamples = 0
+
+    /// Value of `ringBufferSamples` when the keyword spotter started, to place the end of the keyword in the ring buffer
+    private var keywordStreamStart = 0
+
     /// Maximum size of ring buffer in samples (not frames)
     /// Stores about 1.5 second of audio at 16kHz (24000 samples)
     private let maxRingBufferSize = 24000
@@ -127,6 +145,9 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
     /// Whether speech is currently detected
     @Published private(set) var speaking: Bool = false
 
+    /// Whether only the keyword spotter is running, waiting for the wake word
+    @Published private(set) var waitingForKeyword = false
+
     /// Current speaking volume (0 to 1)
     /// Only updates when speaking is true
     @Published private(set) var voiceVolume: Float = 0.0
@@ -191,6 +212,7 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
         logger.info("Releasing resources")
         stopMonitoring()
         vadEngine.delete()
+        keywordSpotter?.stop()
 
         cancellables.forEach { $0.cancel() }
         cancellables.removeAll()
@@ -205,6 +227,28 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
         manualRecording = isManual
     }
 
+    /// Set the keyword spotter used in wake word mode
+    /// - Parameter spotter: Keyword spotter instance, or nil to run the VAD continuously
+    func setKeywordSpotter(_ spotter: KeywordSpotter?) {
+        let wasListening = listening
+        if wasListening {
+            stopMonitoring()
+        }
+
+        keywordSpotter?.stop()
+        keywordSpotter = spotter
+        keywordSpotter?.onKeywordDetected = { [weak self] _, keywordEndSample in
+            Task { @MainActor [weak self] in
+                self?.onKeywordDetected(keywordEndSample: keywordEndSample)
+            }
+        }
+        logger.info(spotter == nil ? "Keyword spotter removed" : "Keyword spotter set")
+
+        if wasListening {
+            startMonitoring()
+        }
+    }
+
     /// Set the VAD engine
     /// - Parameter engine: VAD engine instance to use
     func setVADEngine(_: VADEngine) {
@@ -287,6 +331,7 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
             Task { @MainActor in
                 self.listening = true
                 self.error = nil
+                self.startKeywordSpotting()
             }
         } catch {
             Task { @MainActor in
@@ -326,6 +371,7 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
 
         vadTimeoutTimer?.invalidate()
         vadTimeoutTimer = nil
+        stopKeywordSpotting()
     }
 
     /// Start audio monitoring without VAD
@@ -471,6 +517,12 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
         // Add frame to ring buffer with proper management
         updateRingBuffer(with: frame)
 
+        // In wake word mode only the keyword spotter runs until the keyword is detected
+        if awaitingKeyword, let keywordSpotter {
+            keywordSpotter.process(frame: frame)
+            return
+        }
+
         // For manual recording, just add the frame to recording
         if manualRecording && recording {
             addFrameToRecording(frame)
@@ -545,6 +597,7 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
 
         // Add new frame samples to the ring buffer
         ringBuffer.append(contentsOf: frame)
+        ringBufferSamples += frame.count
     }
 
     /// Calculate energy level of audio samples with better weighting
@@ -645,6 +698,8 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
             // First-time speech detection
             if !speaking && activeFramesCount >= minActiveFrames {
                 speaking = true
+                keywordFollowUpTimer?.invalidate()
+                keywordFollowUpTimer = nil
                 logger.voice("Speech started")
                 beginRecordingWithPreSpeech()
             }
@@ -916,6 +971,7 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
             logger.warning("Recording too short (\(currentRecording.count) samples < minimum \(minSamples)), discarding")
             currentRecording.removeAll()
             resetStateCounters()
+            startKeywordSpotting()
             return
         }
 
@@ -968,6 +1024,67 @@ class SpeechMonitorViewModel: NSObject, ObservableObject {
         return samples
     }
 
+    // MARK: - Keyword Spotting
+
+    /// Hand the audio frames to the keyword spotter, idling the VAD pipeline
+    @MainActor
+    private func startKeywordSpotting() {
+        guard let keywordSpotter, listening, !manualRecording else { return }
+
+        do {
+            try keywordSpotter.start()
+            keywordStreamStart = ringBufferSamples
+            awaitingKeyword = true
+            waitingForKeyword = true
+            logger.info("Waiting for wake word")
+        } catch {
+            // Without a working spotter, fall back to running the VAD continuously
+            self.error = error
+            logger.error("Keyword spotter start error: \(error)")
+        }
+    }
+
+    /// Stop the keyword spotter and its follow-up timer
+    private func stopKeywordSpotting() {
+        keywordFollowUpTimer?.invalidate()
+        keywordFollowUpTimer = nil
+        awaitingKeyword = false
+        keywordSpotter?.stop()
+
+        Task { @MainActor in
+            self.waitingForKeyword = false
+        }
+    }
+
+    /// Start the VAD pipeline after the wake word
+    /// - Parameter keywordEndSample: End of the keyword in samples since the spotter started, nil if unknown
+    @MainActor
+    private func onKeywordDetected(keywordEndSample: Int?) {
+        guard awaitingKeyword, listening else { return }
+
+        awaitingKeyword = false
+        waitingForKeyword = false
+        keywordSpotter?.stop()
+
+        // Pre-roll should hold the request that follows the wake word, not the wake word itself. The spotter reports
+        // the keyword while audio keeps arriving, so a request spoken without a pause has already started; keep the
+        // samples after the end of the keyword and drop the rest. Without a keyword end, drop all of it.
+        let samplesAfterKeyword = keywordEndSample.map { ringBufferSamples - (keywordStreamStart + $0) } ?? 0
+        ringBuffer.removeFirst(ringBuffer.count - min(max(samplesAfterKeyword, 0), ringBuffer.count))
+        resetStateCounters()
+        vadEngine.delete()
+
+        keywordFollowUpTimer?.invalidate()
+        keywordFollowUpTimer = Timer.scheduledTimer(withTimeInterval: keywordFollowUpTimeout, repeats: false) { [weak self] _ in
+            Task { @MainActor [weak self] in
+                guard let self, !self.speaking, !self.recording else { return }
+                self.logger.info("No speech after wake word, waiting for wake word again")
+                self.startKeywordSpotting()
+            }
+        }
+        logger.voice("Wake word detected, starting speech detection")
+    }
+
     /// Reset all state counters and buffers
     private func resetStateCounters() {
         activeFramesCount = 0
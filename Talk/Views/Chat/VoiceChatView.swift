@@ -20,15 +20,14 @@ struct VoiceChatView: View {
     @State private var showingErrorAlert = false
     @State private var errorMessage = ""
 
-    @State private var speechRecognitionService: SpeechRecognitionService?
-    @State private var llmService: LLMService?
-    @State private var ttsService: TTSService?
-
-    @State private var servicesInitialed: Bool = false
-    @State private var prepareForSpeak: Bool = false
+    @StateObject private var services = ConversationServicesViewModel()
 
     @State private var responding: Bool = false
 
+    /// Early transcript of the utterance being recognized, shown until the final one arrives
+    @State private var partialTranscript: String?
+    @State private var recognizing = false
+
     @State private var showingChatHistory = false
 
     private var currentSettings: SettingsModel? {
@@ -53,13 +52,18 @@ struct VoiceChatView: View {
                 .onChange(of: speechMonitor.recordedAudioData) { _, newValue in
                     onSpeakEnd(data: newValue)
                 }
-                .onChange(of: currentSettings?.settingsHash) { _, _ in
-                    debugPrint("Settings changed")
-                    if speechMonitor.listening {
-                        speechMonitor.stopMonitoring()
+                .onChange(of: speechMonitor.listening) { _, listening in
+                    if listening {
+                        LaunchTimer.markFirstListen()
                     }
-
-                    servicesInitialed = false
+                }
+                .onChange(of: currentSettings?.serviceConfigurations) { _, _ in
+                    debugPrint("Settings changed")
+                    services.apply(settings: currentSettings, speechMonitor: speechMonitor)
+                }
+                .task {
+                    // Start creating the services at launch instead of on the first tap
+                    services.apply(settings: currentSettings, speechMonitor: speechMonitor)
                 }
                 .alert("Configuration Information", isPresented: $showingErrorAlert) {
                     Button("OK", role: .cancel) {}
@@ -70,6 +74,13 @@ struct VoiceChatView: View {
             VStack {
                 Spacer()
 
+                if let partialTranscript {
+                    Text(partialTranscript)
+                        .font(.system(size: 13, weight: .medium))
+                        .foregroundColor(ColorTheme.secondaryTextColor())
+                        .padding(.horizontal)
+                }
+
                 HStack {
                     Spacer()
 
@@ -100,60 +111,32 @@ struct VoiceChatView: View {
             return
         }
 
-        prepareForSpeak = true
+        // Only configuration errors stop listening, services still loading are awaited when speech ends
+        if let message = services.configurationError {
+            showErrorAlert(message)
+            // Retry the failed services, so the next tap can succeed
+            services.apply(settings: currentSettings, speechMonitor: speechMonitor)
+            return
+        }
 
-        Task {
-            if !servicesInitialed {
-                servicesInitialed = await initializeServices()
-                if !servicesInitialed {
-                    prepareForSpeak = false
-                    return
-                }
-            }
-            speechMonitor.toggleMonitoring()
+        speechMonitor.toggleMonitoring()
+    }
 
-            prepareForSpeak = false
+    /// Recognizes the utterance, showing its partial transcript while the final one is pending
+    private func recognize(_ data: [Int16], with service: SpeechRecognitionService) async throws -> String {
+        recognizing = true
+        defer {
+            recognizing = false
+            partialTranscript = nil
         }
-    }
 
-    @discardableResult
-    private func initializeServices() async -> Bool {
-        do {
-            guard let currentSettings else {
-                throw SettingsServiceError.invalidConfiguration("Please open the settings page to configure your preferences for the first time.")
+        return try await service.recognizeSpeech(pcmData: data) { partial in
+            Task { @MainActor in
+                if recognizing {
+                    partialTranscript = partial.text
+                }
             }
-
-            let manualRecording = currentSettings.selectedRecordingMode == .manual
-            speechMonitor.setManualRecording(manualRecording)
-
-            speechRecognitionService = try await ServicesManager.createSpeechRecognitionService(
-                selectedSpeechService: currentSettings.selectedSpeechService,
-                whisperCppSettings: currentSettings.whisperCppSettings,
-                whisperKitSettings: currentSettings.whisperKitSettings,
-                appleSpeechSettings: currentSettings.appleSpeechSettings
-            )
-
-            llmService = try ServicesManager.createLLMService(
-                selectedLLMService: currentSettings.selectedLLMService,
-                openAILLMSettings: currentSettings.openAILLMSettings,
-                difySettings: currentSettings.difySettings
-            )
-
-            ttsService = try ServicesManager.createTTSService(
-                selectedTTSService: currentSettings.selectedTTSService,
-                microsoftTTSSettings: currentSettings.microsoftTTSSettings,
-                openAITTSSettings: currentSettings.openAITTSSettings,
-                systemTTSSettings: currentSettings.systemTTSSettings
-            )
-
-            return true
-        } catch let SettingsServiceError.invalidConfiguration(message) {
-            showErrorAlert(message)
-            return false
-        } catch {
-            showErrorAlert("Unknown error occurred: \(error.localizedDescription)")
-            return false
-        }
+        }.text
     }
 
     private func showErrorAlert(_ message: String) {
@@ -172,15 +155,7 @@ struct VoiceChatView: View {
             return
         }
 
-        guard let speechRecognitionService = speechRecognitionService,
-              let llmService = llmService,
-              let ttsService = ttsService
-        else {
-            showErrorAlert("Services not properly initialized")
-            return
-        }
-
-        if currentSettings.selectedRecordingMode == .auto {
+        if currentSettings.selectedRecordingMode != .manual {
             speechMonitor.stopMonitoring()
         }
 
@@ -188,7 +163,8 @@ struct VoiceChatView: View {
             do {
                 responding = true
 
-                let sttText = try await speechRecognitionService.recognizeSpeech(pcmData: data).text
+                let speechRecognitionService = try await services.speechRecognitionService()
+                let sttText = try await recognize(data, with: speechRecognitionService)
 
                 ChatHistory.addMessage(content: sttText, isUserMessage: true, in: modelContext)
 
@@ -230,16 +206,18 @@ struct VoiceChatView: View {
                     additionalParams: additionalParams
                 )
 
+                let llmService = try await services.llmService()
                 let llmResponse = try await llmService.sendMessage(request)
 
                 ChatHistory.addMessage(content: llmResponse.content, isUserMessage: false, in: modelContext)
 
+                let ttsService = try await services.ttsService()
                 let playback = try await ttsService.speak(llmResponse.content)
                 await playback.waitForCompletion()
 
                 responding = false
 
-                if currentSettings.selectedRecordingMode == .auto {
+                if currentSettings.selectedRecordingMode != .manual {
                     speechMonitor.startMonitoring()
                 }
             } catch {
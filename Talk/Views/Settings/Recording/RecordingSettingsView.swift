@@ -30,6 +30,23 @@ struct RecordingSettingsView: View {
                     Text("Tap to start recording, system automatically detects speech pauses and sends message. Next conversation begins with voice recording.")
                         .font(.system(size: 13, weight: .medium))
                         .foregroundColor(ColorTheme.secondaryTextColor())
+                } else if viewModel.selectedRecordingMode == .wakeWord {
+                    Text("Tap to start listening for the wake word. Only an on-device keyword spotter runs until the wake word is heard, then speech is detected and sent as in Auto Detect mode.")
+                        .font(.system(size: 13, weight: .medium))
+                        .foregroundColor(ColorTheme.secondaryTextColor())
+
+                    SettingsTextField(
+                        title: "Keyword Model",
+                        text: Binding(
+                            get: { viewModel.wakeWordSettings.keywordModelPath },
+                            set: { viewModel.wakeWordSettings.keywordModelPath = $0 }
+                        ),
+                        placeholder: "keyword.table"
+                    )
+
+                    Text("A .table keyword model created with Custom Keyword in Speech Studio, copied to the app's Documents folder.")
+                        .font(.system(size: 13, weight: .medium))
+                        .foregroundColor(ColorTheme.secondaryTextColor())
                 }
             }
             .padding(20)
@@ -0,0 +1,124 @@
+import SwiftData
+import SwiftUI
+
+struct HybridSpeechSettingsView: View {
+    @ObservedObject var viewModel: SettingsViewModel
+
+    var body: some View {
+        VStack(alignment: .leading, spacing: 16) {
+            SettingsTextField(
+                title: "Subscription Key",
+                text: Binding(
+                    get: { viewModel.hybridSpeechSettings.subscriptionKey },
+                    set: {
+                        var settings = viewModel.hybridSpeechSettings
+                        settings.subscriptionKey = $0
+                        viewModel.hybridSpeechSettings = settings
+                    }
+                ),
+                placeholder: "Enter Microsoft Speech Service subscription key",
+                isSecure: true
+            )
+
+            SettingsTextField(
+                title: "Region",
+                text: Binding(
+                    get: { viewModel.hybridSpeechSettings.region },
+                    set: {
+                        var settings = viewModel.hybridSpeechSettings
+                        settings.region = $0
+                        viewModel.hybridSpeechSettings = settings
+                    }
+                ),
+                placeholder: "Enter region (e.g. eastasia)"
+            )
+
+            SettingsTextField(
+                title: "Recognition Language",
+                text: Binding(
+                    get: { viewModel.hybridSpeechSettings.language },
+                    set: {
+                        var settings = viewModel.hybridSpeechSettings
+                        settings.language = $0
+                        viewModel.hybridSpeechSettings = settings
+                    }
+                ),
+                placeholder: "Enter language (e.g. en-US)"
+            )
+
+            SettingsTextField(
+                title: "On-device Model Path",
+                text: Binding(
+                    get: { viewModel.hybridSpeechSettings.embeddedModelPath },
+                    set: {
+                        var settings = viewModel.hybridSpeechSettings
+                        settings.embeddedModelPath = $0
+                        viewModel.hybridSpeechSettings = settings
+                    }
+                ),
+                placeholder: "Enter model directory (absolute or relative to Documents)"
+            )
+
+            SettingsTextField(
+                title: "On-device Model Name",
+                text: Binding(
+                    get: { viewModel.hybridSpeechSettings.embeddedModelName },
+                    set: {
+                        var settings = viewModel.hybridSpeechSettings
+                        settings.embeddedModelName = $0
+                        viewModel.hybridSpeechSettings = settings
+                    }
+                ),
+                placeholder: "Enter model name"
+            )
+
+            SettingsTextField(
+                title: "On-device Model License",
+                text: Binding(
+                    get: { viewModel.hybridSpeechSettings.embeddedModelLicense },
+                    set: {
+                        var settings = viewModel.hybridSpeechSettings
+                        settings.embeddedModelLicense = $0
+                        viewModel.hybridSpeechSettings = settings
+                    }
+                ),
+                placeholder: "Enter model license",
+                isSecure: true
+            )
+
+            SettingsTextField(
+                title: "Max Network Round Trip (ms)",
+                text: Binding(
+                    get: { String(viewModel.hybridSpeechSettings.maxRoundTripMs) },
+                    set: {
+                        guard let value = Int($0) else { return }
+                        var settings = viewModel.hybridSpeechSettings
+                        settings.maxRoundTripMs = value
+                        viewModel.hybridSpeechSettings = settings
+                    }
+                ),
+                placeholder: "Slower networks use the on-device result (e.g. 300)"
+            )
+
+            Text("The on-device model answers first; the cloud result replaces it while the network round trip stays under the limit.")
+                .font(.system(size: 13, weight: .medium))
+                .foregroundColor(ColorTheme.secondaryTextColor())
+        }
+    }
+}
+
+#Preview("HybridSpeechSettingsView") {
+    let config = ModelConfiguration(isStoredInMemoryOnly: true)
+    let container = try! ModelContainer(for: SettingsModel.self, configurations: config)
+
+    let context = container.mainContext
+    if try! context.fetch(FetchDescriptor<SettingsModel>()).isEmpty {
+        context.insert(SettingsModel())
+    }
+
+    let viewModel = SettingsViewModel(modelContext: context)
+
+    return ScrollView {
+        HybridSpeechSettingsView(viewModel: viewModel).padding()
+    }
+}
@@ -21,6 +21,8 @@ struct SpeechRecognitionSettingsView: View {
                     WhisperKitSettingsView(viewModel: viewModel)
                 } else if viewModel.selectedSpeechService == .system {
                     AppleSpeechSettingsView(viewModel: viewModel)
+                } else if viewModel.selectedSpeechService == .hybrid {
+                    HybridSpeechSettingsView(viewModel: viewModel)
                 }
             }
             .padding(20)
@@ -18,6 +18,22 @@ struct WhisperCppSettingsView: View {
                 ),
                 placeholder: "Enter server URL (e.g. http://localhost:8080/inference)"
             )
+
+            SettingsPicker(
+                title: "Upload Format",
+                selection: Binding(
+                    get: { viewModel.whisperCppSettings.uploadFormat },
+                    set: {
+                        var settings = viewModel.whisperCppSettings
+                        settings.uploadFormat = $0
+                        viewModel.whisperCppSettings = settings
+                    }
+                )
+            )
+
+            Text("FLAC uploads are about half the size of WAV. The server must be able to decode FLAC, e.g. whisper.cpp started with --convert.")
+                .font(.system(size: 13, weight: .medium))
+                .foregroundColor(ColorTheme.secondaryTextColor())
         }
     }
 }
@@ -0,0 +1,855 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_benchmarks.cpp: Benchmarks of the hot paths of the C++ API, run against the loopback C API.
+//
+// Besides the time per operation, every benchmark reports the heap allocations and the threads created per
+// operation, counted by replacing the global allocation functions and interposing pthread_create. Those two counters
+// do not depend on the host, so they are the ones to compare when the headers are updated.
+//
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <new>
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "speechapi_cxx.h"
+#include "speechapi_loopback.h"
+
+using namespace Microsoft::CognitiveServices::Speech;
+using namespace Microsoft::CognitiveServices::Speech::Audio;
+
+namespace {
+
+std::atomic<uint64_t> g_allocations { 0 };
+std::atomic<uint64_t> g_threads { 0 };
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------------------------------------------
+// Allocation and thread counting
+// ---------------------------------------------------------------------------------------------------------------
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto p = malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+// Out of line, so the compiler does not pair the inlined malloc of operator new with free.
+__attribute__((noinline)) void Deallocate(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p) noexcept { Deallocate(p); }
+void operator delete[](void* p) noexcept { Deallocate(p); }
+void operator delete(void* p, size_t) noexcept { Deallocate(p); }
+void operator delete[](void* p, size_t) noexcept { Deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Deallocate(p); }
+
+extern "C" int pthread_create(pthread_t* thread, const pthread_attr_t* attr, void* (*start)(void*), void* arg)
+{
+    using Create = int (*)(pthread_t*, const pthread_attr_t*, void* (*)(void*), void*);
+    static auto create = reinterpret_cast<Create>(dlsym(RTLD_NEXT, "pthread_create"));
+    g_threads.fetch_add(1, std::memory_order_relaxed);
+    return create(thread, attr, start, arg);
+}
+
+namespace {
+
+/// <summary>
+/// Adds the allocations/op and threads/op counters to a benchmark, from its construction to its destruction.
+/// Work run through Untimed is excluded from both the time and the counters.
+/// </summary>
+class Measurement
+{
+public:
+
+    explicit Measurement(benchmark::State& state) :
+        m_state(state),
+        m_allocations(g_allocations.load()),
+        m_threads(g_threads.load())
+    {
+    }
+
+    ~Measurement()
+    {
+        m_state.counters["allocs/op"] = benchmark::Counter(double(g_allocations.load() - m_allocations - m_excludedAllocations), benchmark::Counter::kAvgIterations);
+        m_state.counters["threads/op"] = benchmark::Counter(double(g_threads.load() - m_threads - m_excludedThreads), benchmark::Counter::kAvgIterations);
+    }
+
+    template <class F>
+    void Untimed(F work)
+    {
+        m_state.PauseTiming();
+        auto allocations = g_allocations.load();
+        auto threads = g_threads.load();
+        work();
+        m_excludedAllocations += g_allocations.load() - allocations;
+        m_excludedThreads += g_threads.load() - threads;
+        m_state.ResumeTiming();
+    }
+
+private:
+
+    benchmark::State& m_state;
+    uint64_t m_allocations;
+    uint64_t m_threads;
+    uint64_t m_excludedAllocations = 0;
+    uint64_t m_excludedThreads = 0;
+};
+
+/// <summary>
+/// Event handles created ahead of the timed loop in batches, since the C++ layer takes ownership of each.
+/// </summary>
+class EventHandles
+{
+public:
+
+    explicit EventHandles(SPXHR (*release)(SPXEVENTHANDLE)) :
+        m_release(release)
+    {
+    }
+
+    template <class Create>
+    SPXEVENTHANDLE Next(Measurement& measurement, Create create)
+    {
+        if (m_next == m_handles.size())
+        {
+            measurement.Untimed([&]() {
+                m_handles.assign(BatchSize, SPXHANDLE_INVALID);
+                for (auto& handle : m_handles)
+                {
+                    SPX_THROW_ON_FAIL(create(&handle));
+                }
+                m_next = 0;
+            });
+        }
+        return m_handles[m_next++];
+    }
+
+    ~EventHandles()
+    {
+        for (; m_next < m_handles.size(); m_next++)
+        {
+            m_release(m_handles[m_next]);
+        }
+    }
+
+private:
+    static constexpr size_t BatchSize = 1024;
+    SPXHR (*m_release)(SPXEVENTHANDLE);
+    std::vector<SPXEVENTHANDLE> m_handles;
+    size_t m_next = 0;
+};
+
+std::shared_ptr<SpeechConfig> LoopbackConfig()
+{
+    auto config = SpeechConfig::FromSubscription("loopback", "loopback");
+    config->SetProperty("Loopback-EventIntervalMs", "0");
+    config->SetProperty("Loopback-RecognizingPerPhrase", "0");
+    config->SetProperty("Loopback-SynthesizingChunks", "1");
+    config->SetProperty("Loopback-AudioBytes", "3200");
+    return config;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Events
+// ---------------------------------------------------------------------------------------------------------------
+
+void EventSignal_Signal(benchmark::State& state)
+{
+    EventSignal<const std::string&> signal;
+    std::atomic<uint64_t> received { 0 };
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        signal.Connect([&received](const std::string& value) { received.fetch_add(value.size(), std::memory_order_relaxed); });
+    }
+
+    std::string args = "event";
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        signal.Signal(args);
+    }
+    benchmark::DoNotOptimize(received.load());
+}
+BENCHMARK(EventSignal_Signal)->RangeMultiplier(2)->Range(1, 32);
+
+// Connecting and disconnecting a callback while another thread raises the event, as recognizers do when handlers
+// are added during a session. Each change publishes a snapshot and frees the ones no Signal can still read.
+void EventSignal_ConnectDisconnect(benchmark::State& state)
+{
+    EventSignal<const std::string&> signal;
+    std::atomic<uint64_t> received { 0 };
+    signal.Connect([&received](const std::string& value) { received.fetch_add(value.size(), std::memory_order_relaxed); });
+
+    std::atomic<bool> stop { false };
+    std::thread signalling([&signal, &stop]() {
+        std::string args = "event";
+        while (!stop.load())
+        {
+            signal.Signal(args);
+        }
+    });
+
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        auto token = signal.Connect([&received](const std::string& value) { received.fetch_add(value.size(), std::memory_order_relaxed); });
+        signal.Disconnect(token);
+    }
+
+    stop.store(true);
+    signalling.join();
+    benchmark::DoNotOptimize(received.load());
+}
+BENCHMARK(EventSignal_ConnectDisconnect)->UseRealTime();
+
+void SpeechSynthesisEventArgs_Chunk(benchmark::State& state)
+{
+    auto size = static_cast<uint32_t>(state.range(0));
+    EventHandles handles(synthesizer_event_handle_release);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        SpeechSynthesisEventArgs args(handles.Next(measurement, [size](SPXEVENTHANDLE* h) { return loopback_synthesizing_event_create(h, size); }));
+        benchmark::DoNotOptimize(args.Result->GetAudioData());
+    }
+}
+BENCHMARK(SpeechSynthesisEventArgs_Chunk)->Arg(640)->Arg(3200)->Arg(32000);
+
+// The path the synthesizer takes: pooled event arguments, with the audio copied into a reused buffer.
+void SpeechSynthesisEventArgs_PooledChunk(benchmark::State& state)
+{
+    auto size = static_cast<uint32_t>(state.range(0));
+    auto pool = std::make_shared<Utils::ObjectPool>();
+    std::vector<uint8_t> buffer(size);
+    EventHandles handles(synthesizer_event_handle_release);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        SpeechSynthesisEventArgs args(handles.Next(measurement, [size](SPXEVENTHANDLE* h) { return loopback_synthesizing_event_create(h, size); }), pool);
+        benchmark::DoNotOptimize(args.Result->ReadAudioData(buffer.data(), size));
+    }
+}
+BENCHMARK(SpeechSynthesisEventArgs_PooledChunk)->Arg(640)->Arg(3200)->Arg(32000);
+
+// ---------------------------------------------------------------------------------------------------------------
+// Properties and strings
+// ---------------------------------------------------------------------------------------------------------------
+
+void PropertyCollection_GetProperty(benchmark::State& state)
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(recognizer->Properties.GetProperty(PropertyId::SpeechServiceConnection_Region));
+    }
+}
+BENCHMARK(PropertyCollection_GetProperty);
+
+void PropertyCollection_GetPropertyByName(benchmark::State& state)
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(recognizer->Properties.GetProperty("Loopback-EventIntervalMs"));
+    }
+}
+BENCHMARK(PropertyCollection_GetPropertyByName);
+
+// The property collections of results cache what is read from them: after the first read, a property is copied
+// from the cache without calling into the native property bag, whether or not it is defined.
+void RecognitionResult_GetProperty(benchmark::State& state)
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    auto result = recognizer->RecognizeOnceAsync().get();
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(result->Properties.GetProperty(PropertyId::SpeechServiceResponse_JsonResult));
+    }
+}
+BENCHMARK(RecognitionResult_GetProperty);
+
+// A literal default is only copied when it is returned; a short one fits in the returned string without allocating.
+void RecognitionResult_GetPropertyDefault(benchmark::State& state)
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    auto result = recognizer->RecognizeOnceAsync().get();
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(result->Properties.GetProperty("AccuracyScore", "-1"));
+    }
+}
+BENCHMARK(RecognitionResult_GetPropertyDefault);
+
+void RecognitionResult_GetIntUndefined(benchmark::State& state)
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    auto result = recognizer->RecognizeOnceAsync().get();
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(result->Properties.GetInt("Loopback-Undefined", -1));
+    }
+}
+BENCHMARK(RecognitionResult_GetIntUndefined);
+
+// Parsing the detailed JSON of a result and reading the display text of each alternative as a view into the text.
+void JsonDocument_NBest(benchmark::State& state)
+{
+    auto config = LoopbackConfig();
+    config->SetProperty("Loopback-PayloadBytes", std::to_string(state.range(0)));
+    auto recognizer = SpeechRecognizer::FromConfig(config, nullptr);
+    auto json = recognizer->RecognizeOnceAsync().get()->Properties.GetProperty(PropertyId::SpeechServiceResponse_JsonResult);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        Utils::JsonDocument document(json);
+        for (auto alternative : document.Root()["NBest"])
+        {
+            benchmark::DoNotOptimize(alternative["Display"].AsStringView().Data());
+        }
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+BENCHMARK(JsonDocument_NBest)->Arg(64)->Arg(4096);
+
+std::string Text(size_t size)
+{
+    // Mostly ASCII, with two- and three-byte sequences as in transcripts with accents and CJK.
+    static const std::string pattern = "speech \xC3\xA9t\xC3\xA9 \xE8\xAA\x9E ";
+    std::string text;
+    while (text.size() < size)
+    {
+        text += pattern;
+    }
+    return text;
+}
+
+void Utils_ToUTF8(benchmark::State& state)
+{
+    auto text = Utils::Details::to_string(Text(static_cast<size_t>(state.range(0))));
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::ToUTF8(text));
+    }
+}
+BENCHMARK(Utils_ToUTF8)->Arg(16)->Arg(256)->Arg(4096);
+
+void Details_ToWString(benchmark::State& state)
+{
+    auto text = Text(static_cast<size_t>(state.range(0)));
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::Details::to_string(text));
+    }
+}
+BENCHMARK(Details_ToWString)->Arg(16)->Arg(256)->Arg(4096);
+
+// An all-ASCII SSML document of about the given size, as sent by SpeakSsmlAsync.
+std::string Ssml(size_t size)
+{
+    static const std::string sentence = "The quick brown fox jumps over the <emphasis>lazy</emphasis> dog. ";
+    std::string ssml = "<speak version='1.0' xmlns='http://www.w3.org/2001/10/synthesis' xml:lang='en-US'><voice name='en-US-JennyNeural'>";
+    while (ssml.size() + sentence.size() < size)
+    {
+        ssml += sentence;
+    }
+    return ssml + "</voice></speak>";
+}
+
+void Utils_ToUTF8_Ssml(benchmark::State& state)
+{
+    auto ssml = Utils::Details::to_string(Ssml(static_cast<size_t>(state.range(0))));
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::ToUTF8(ssml));
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(ssml.size()));
+}
+BENCHMARK(Utils_ToUTF8_Ssml)->Arg(256)->Arg(1024)->Arg(4096)->Arg(16384);
+
+void Details_ToWString_Ssml(benchmark::State& state)
+{
+    auto ssml = Ssml(static_cast<size_t>(state.range(0)));
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::Details::to_string(ssml));
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(ssml.size()));
+}
+BENCHMARK(Details_ToWString_Ssml)->Arg(256)->Arg(1024)->Arg(4096)->Arg(16384);
+
+// ---------------------------------------------------------------------------------------------------------------
+// Audio and connection messages
+// ---------------------------------------------------------------------------------------------------------------
+
+// Formats are interned, so after the first request for a format this is a table lookup that creates no handle.
+void AudioStreamFormat_GetWaveFormatPCM(benchmark::State& state)
+{
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(AudioStreamFormat::GetWaveFormatPCM(16000, 16, 1));
+    }
+}
+BENCHMARK(AudioStreamFormat_GetWaveFormatPCM);
+
+// A push stream with the default format, which reuses the interned default input format.
+void PushAudioInputStream_Create(benchmark::State& state)
+{
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(AudioInputStream::CreatePushStream());
+    }
+}
+BENCHMARK(PushAudioInputStream_Create);
+
+// 10 ms of 16 kHz, 16-bit mono audio per write.
+void PushAudioInputStream_Write(benchmark::State& state)
+{
+    auto stream = AudioInputStream::CreatePushStream();
+    std::vector<uint8_t> frame(320);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        stream->Write(frame.data(), static_cast<uint32_t>(frame.size()));
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(frame.size()));
+}
+BENCHMARK(PushAudioInputStream_Write);
+
+// A 100 ms chunk of synthesized audio handed from the native stream to the reader: the pump thread moves it into the
+// ring buffer, and the reader takes it out through views, without copying.
+void PullAudioOutputStream_ReadView(benchmark::State& state)
+{
+    auto stream = PullAudioOutputStream::Create(static_cast<uint32_t>(state.range(0)));
+    auto hstream = static_cast<SPXAUDIOSTREAMHANDLE>(*stream);
+    std::vector<uint8_t> chunk(3200, 0x5A);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        SPX_THROW_ON_FAIL(loopback_pull_audio_output_stream_write(hstream, chunk.data(), static_cast<uint32_t>(chunk.size())));
+        for (size_t remaining = chunk.size(); remaining > 0;)
+        {
+            auto view = stream->ReadView();
+            benchmark::DoNotOptimize(view.data);
+            stream->Consume(view.size);
+            remaining -= view.size;
+        }
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(chunk.size()));
+    loopback_pull_audio_output_stream_close(hstream);
+}
+BENCHMARK(PullAudioOutputStream_ReadView)->Arg(4096)->Arg(65536)->UseRealTime();
+
+// One second of 16 kHz, 16-bit mono audio: two tones with a gliding pitch and low noise, then a pause, as in speech.
+std::vector<int16_t> SpeechSamples()
+{
+    std::vector<int16_t> samples(16000);
+    uint32_t noise = 12345;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        noise = noise * 1103515245 + 12345;
+        auto t = double(i) / 16000;
+        auto pitch = 120.0 + 80.0 * std::sin(t * 3);
+        auto value = 6000 * std::sin(2 * M_PI * pitch * t) + 2000 * std::sin(6 * M_PI * pitch * t) + int32_t(noise >> 16) % 200;
+        samples[i] = i < 11200 ? static_cast<int16_t>(value) : 0;
+    }
+    return samples;
+}
+
+// Encodes one second of speech in 20 ms writes with a block size of N samples; ratio is the encoded size over
+// the PCM size.
+void FlacEncoder_Encode(benchmark::State& state)
+{
+    auto samples = SpeechSamples();
+    uint64_t encodedBytes = 0;
+    FlacEncoder encoder(16000, 1, [&](const uint8_t*, size_t size, uint32_t) { encodedBytes += size; }, static_cast<uint32_t>(state.range(0)));
+    auto& ratio = state.counters["ratio"];
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        for (size_t offset = 0; offset < samples.size(); offset += 320)
+        {
+            encoder.Encode(samples.data() + offset, 320);
+        }
+        encoder.Flush();
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(samples.size() * 2));
+    ratio = double(encodedBytes) / (double(state.iterations()) * samples.size() * 2);
+}
+BENCHMARK(FlacEncoder_Encode)->Arg(FlacEncoder::LowDelayBlockSize)->Arg(FlacEncoder::DefaultBlockSize);
+
+void ConnectionMessage_GetBinaryMessage(benchmark::State& state)
+{
+    std::vector<uint8_t> payload(static_cast<size_t>(state.range(0)), 0x5A);
+    SPXEVENTHANDLE hevent = SPXHANDLE_INVALID;
+    SPX_THROW_ON_FAIL(loopback_connection_message_event_create(&hevent, "audio", payload.data(), static_cast<uint32_t>(payload.size()), true));
+    ConnectionMessageEventArgs args(hevent);
+    auto message = args.GetMessage();
+
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(message->GetBinaryMessage());
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(payload.size()));
+}
+BENCHMARK(ConnectionMessage_GetBinaryMessage)->Arg(1024)->Arg(65536);
+
+void ConnectionMessageEventArgs_TextMessage(benchmark::State& state)
+{
+    std::string payload(static_cast<size_t>(state.range(0)), 'x');
+    EventHandles handles(connection_message_received_event_handle_release);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        ConnectionMessageEventArgs args(handles.Next(measurement, [&payload](SPXEVENTHANDLE* h) {
+            return loopback_connection_message_event_create(h, "speech.phrase", reinterpret_cast<const uint8_t*>(payload.data()), static_cast<uint32_t>(payload.size()), false);
+        }));
+        benchmark::DoNotOptimize(args.GetMessage()->GetTextMessage());
+    }
+}
+BENCHMARK(ConnectionMessageEventArgs_TextMessage)->Arg(256)->Arg(4096);
+
+// The text is read once into the message and returned by reference; reading it again copies nothing.
+void ConnectionMessageEventArgs_TextMessageRef(benchmark::State& state)
+{
+    std::string payload(static_cast<size_t>(state.range(0)), 'x');
+    EventHandles handles(connection_message_received_event_handle_release);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        ConnectionMessageEventArgs args(handles.Next(measurement, [&payload](SPXEVENTHANDLE* h) {
+            return loopback_connection_message_event_create(h, "speech.phrase", reinterpret_cast<const uint8_t*>(payload.data()), static_cast<uint32_t>(payload.size()), false);
+        }));
+        auto message = args.GetMessage();
+        benchmark::DoNotOptimize(message->GetTextMessageRef().data());
+        benchmark::DoNotOptimize(message->GetTextMessageRef().data());
+    }
+}
+BENCHMARK(ConnectionMessageEventArgs_TextMessageRef)->Arg(256)->Arg(4096);
+
+// ---------------------------------------------------------------------------------------------------------------
+// Voice catalog
+// ---------------------------------------------------------------------------------------------------------------
+
+// Saves the loopback voice list once and returns the path of the catalog file.
+const std::string& VoiceCatalogFile()
+{
+    static const std::string path = []() {
+        auto file = std::string(P_tmpdir) + "/speechapi_cxx_benchmarks_voices.bin";
+        VoiceCatalogCache cache(file);
+        cache.RefreshAsync(SpeechSynthesizer::FromConfig(LoopbackConfig(), nullptr), true).get();
+        return file;
+    }();
+    return path;
+}
+
+// Memory-maps the saved catalog and checks it; the hash indexes are part of the file, so nothing is built.
+void VoiceCatalog_Load(benchmark::State& state)
+{
+    const auto& path = VoiceCatalogFile();
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(VoiceCatalog::Load(path));
+    }
+}
+BENCHMARK(VoiceCatalog_Load);
+
+void VoiceCatalog_FindByShortName(benchmark::State& state)
+{
+    auto catalog = VoiceCatalog::Load(VoiceCatalogFile());
+    VoiceCatalog::Voice voice;
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(catalog->FindByShortName("ja-JP-NanamiNeural", voice));
+    }
+}
+BENCHMARK(VoiceCatalog_FindByShortName);
+
+// ---------------------------------------------------------------------------------------------------------------
+// Ring logger
+// ---------------------------------------------------------------------------------------------------------------
+
+using Diagnostics::Logging::RingLogger;
+
+const std::string& LogLine()
+{
+    static const std::string line =
+        "[12345]: 1000ms SPX_TRACE_INFO: usp_reco_engine_adapter.cpp:1234 Response: Speech.Hypothesis message";
+    return line;
+}
+
+// Copies an application line into the ring; the loopback does not forward SDK lines, so the ring holds only these.
+void RingLogger_Log(benchmark::State& state)
+{
+    RingLogger::Start();
+    const auto& line = LogLine();
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        RingLogger::Log(Diagnostics::Logging::Level::Info, line.data(), line.size());
+    }
+    RingLogger::Stop();
+}
+BENCHMARK(RingLogger_Log);
+
+// The same while two filters are set, so each line loads the filter snapshot and searches it.
+void RingLogger_Log_Filtered(benchmark::State& state)
+{
+    RingLogger::SetFilters({ "Speech.Hypothesis", "Speech.Phrase" });
+    RingLogger::Start();
+    const auto& line = LogLine();
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        RingLogger::Log(Diagnostics::Logging::Level::Info, line.data(), line.size());
+    }
+    RingLogger::Stop();
+    RingLogger::SetFilters();
+}
+BENCHMARK(RingLogger_Log_Filtered);
+
+// An SDK line as it arrives through the native log callback.
+void RingLogger_NativeLine(benchmark::State& state)
+{
+    RingLogger::Start();
+    const auto& line = LogLine();
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        loopback_log_line(line.c_str());
+    }
+    RingLogger::Stop();
+}
+BENCHMARK(RingLogger_NativeLine);
+
+// ---------------------------------------------------------------------------------------------------------------
+// Tracing
+// ---------------------------------------------------------------------------------------------------------------
+
+uint64_t g_traceLines = 0;
+
+void CountTraceLine(int, const char*, const char*, const int, const char*, ...) throw()
+{
+    g_traceLines++;
+}
+
+// A release build compiles no trace level in, so the call site and its arguments are gone.
+void Trace_CompiledOut(benchmark::State& state)
+{
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        __SPX_TRACE_VERBOSE("SPX_TRACE_VERBOSE: ", __FILE__, __LINE__, "%s (this=0x%p)", __FUNCTION__, (void*)&state);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(Trace_CompiledOut);
+
+// The trace macros read the level mask and the implementation where they expand, so the call site below is
+// compiled in as with AZAC_CONFIG_TRACE_LEVEL_MASK and __AZAC_DO_TRACE_IMPL set, with a sink that only counts.
+#pragma push_macro("AZAC_CONFIG_TRACE_LEVEL_MASK")
+#pragma push_macro("__AZAC_DO_TRACE_IMPL")
+#undef AZAC_CONFIG_TRACE_LEVEL_MASK
+#undef __AZAC_DO_TRACE_IMPL
+#define AZAC_CONFIG_TRACE_LEVEL_MASK __AZAC_TRACE_LEVEL_ALL
+#define __AZAC_DO_TRACE_IMPL CountTraceLine
+
+// A verbose call site that emits one in N hits; lines/op counts the lines that reach the trace implementation.
+void Trace_Sampled(benchmark::State& state)
+{
+    __azac_trace_set_sample_rate(__AZAC_TRACE_LEVEL_VERBOSE, static_cast<uint32_t>(state.range(0)));
+    auto& linesPerOp = state.counters["lines/op"];
+    auto lines = g_traceLines;
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        __SPX_TRACE_VERBOSE("SPX_TRACE_VERBOSE: ", __FILE__, __LINE__, "%s (this=0x%p)", __FUNCTION__, (void*)&state);
+        benchmark::ClobberMemory();
+    }
+    linesPerOp = benchmark::Counter(double(g_traceLines - lines), benchmark::Counter::kAvgIterations);
+    __azac_trace_set_sample_rate(__AZAC_TRACE_LEVEL_VERBOSE, AZAC_CONFIG_TRACE_SAMPLE_RATE);
+}
+BENCHMARK(Trace_Sampled)->Arg(1)->Arg(16)->Arg(256);
+
+#pragma pop_macro("__AZAC_DO_TRACE_IMPL")
+#pragma pop_macro("AZAC_CONFIG_TRACE_LEVEL_MASK")
+
+// ---------------------------------------------------------------------------------------------------------------
+// Executor
+// ---------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Installs an executor as the default for the lifetime of the object.
+/// </summary>
+class DefaultExecutor
+{
+public:
+
+    explicit DefaultExecutor(std::shared_ptr<AsyncExecutor> executor)
+    {
+        AsyncExecutor::SetDefault(std::move(executor));
+    }
+
+    ~DefaultExecutor()
+    {
+        AsyncExecutor::SetDefault(nullptr);
+    }
+};
+
+void Utils_RunAsync(benchmark::State& state)
+{
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::RunAsync([]() { return 1; }).get());
+    }
+}
+BENCHMARK(Utils_RunAsync)->UseRealTime();
+
+// A work item that waits for a nested operation, on a pool of one thread: the nested operation gets its own thread.
+void Utils_RunAsync_Nested(benchmark::State& state)
+{
+    DefaultExecutor executor(std::make_shared<ThreadPoolExecutor>(1, 1));
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Utils::RunAsync([]() { return Utils::RunAsync([]() { return 1; }).get(); }).get());
+    }
+}
+BENCHMARK(Utils_RunAsync_Nested)->UseRealTime();
+
+// ---------------------------------------------------------------------------------------------------------------
+// Asynchronous round trips
+// ---------------------------------------------------------------------------------------------------------------
+
+void Connection_SendMessageAsync(benchmark::State& state)
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    auto connection = Connection::FromRecognizer(recognizer);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        connection->SendMessageAsync("speech.context", "{}").get();
+    }
+}
+BENCHMARK(Connection_SendMessageAsync)->UseRealTime();
+
+void SpeechSynthesizer_StopSpeakingAsync(benchmark::State& state)
+{
+    auto synthesizer = SpeechSynthesizer::FromConfig(LoopbackConfig(), nullptr);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        synthesizer->StopSpeakingAsync().get();
+    }
+}
+BENCHMARK(SpeechSynthesizer_StopSpeakingAsync)->UseRealTime();
+
+void SpeechSynthesizer_SpeakTextAsync(benchmark::State& state)
+{
+    auto synthesizer = SpeechSynthesizer::FromConfig(LoopbackConfig(), nullptr);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(synthesizer->SpeakTextAsync("hello").get());
+    }
+}
+BENCHMARK(SpeechSynthesizer_SpeakTextAsync)->UseRealTime();
+
+void SpeechSynthesizer_GetVoicesAsync(benchmark::State& state)
+{
+    auto synthesizer = SpeechSynthesizer::FromConfig(LoopbackConfig(), nullptr);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(synthesizer->GetVoicesAsync().get());
+    }
+}
+BENCHMARK(SpeechSynthesizer_GetVoicesAsync)->UseRealTime();
+
+void SpeechRecognizer_RecognizeOnceAsync(benchmark::State& state)
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(recognizer->RecognizeOnceAsync().get());
+    }
+}
+BENCHMARK(SpeechRecognizer_RecognizeOnceAsync)->UseRealTime();
+
+// The same with handlers on the session, speech detection and recognition events, and four intermediate results per
+// phrase: the event arguments and results of every event are drawn from the recognizer's pool.
+void SpeechRecognizer_RecognizeOnceAsync_Events(benchmark::State& state)
+{
+    auto config = LoopbackConfig();
+    config->SetProperty("Loopback-RecognizingPerPhrase", "4");
+    auto recognizer = SpeechRecognizer::FromConfig(config, nullptr);
+
+    std::atomic<uint64_t> events { 0 };
+    auto count = [&events](const SessionEventArgs&) { events.fetch_add(1, std::memory_order_relaxed); };
+    recognizer->SessionStarted.Connect(count);
+    recognizer->SessionStopped.Connect(count);
+    recognizer->SpeechStartDetected.Connect(count);
+    recognizer->SpeechEndDetected.Connect(count);
+    recognizer->Recognizing.Connect(count);
+    recognizer->Recognized.Connect(count);
+
+    Measurement measurement(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(recognizer->RecognizeOnceAsync().get());
+    }
+    state.counters["events/op"] = benchmark::Counter(double(events.load()), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(SpeechRecognizer_RecognizeOnceAsync_Events)->UseRealTime();
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,216 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// coroutine_test.cpp: Runs many concurrent coroutines over the awaitable functions of speechapi_cxx_coroutine.h
+// against loopback recognizers, synthesizers and connections. It checks that every await completes with the expected
+// result and resumes on the completion loop thread, and that the event streams deliver the live events of an
+// operation in order and end once closed. Requires C++20.
+//
+// Usage: coroutine_test [sessions] [streams]
+//
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "speechapi_cxx.h"
+#include "speechapi_cxx_coroutine.h"
+
+#ifndef SPX_CONFIG_CXX_COROUTINES
+#error coroutine_test needs C++20 coroutines
+#endif
+
+using namespace Microsoft::CognitiveServices::Speech;
+using namespace Microsoft::CognitiveServices::Speech::Coroutines;
+
+namespace {
+
+constexpr int RecognizingPerPhrase = 5;
+constexpr int SynthesizingChunks = 4;
+constexpr int AudioBytes = 3200;
+
+// Coroutine started eagerly and destroyed when it finishes; the outcome is reported through Results.
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+class Results
+{
+public:
+
+    explicit Results(int expected) : m_pending(expected), m_mainThread(std::this_thread::get_id()) {}
+
+    void Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_failures++ < 10)
+            {
+                printf("  FAILED: %s\n", what.c_str());
+            }
+        }
+    }
+
+    // An operation that completed before it was awaited continues on the thread that started the coroutine.
+    void CheckResumedOnLoop()
+    {
+        if (CompletionLoop::Instance().IsLoopThread())
+        {
+            m_resumedOnLoop++;
+        }
+        else
+        {
+            Check(std::this_thread::get_id() == m_mainThread, "resumed on a thread other than the completion loop");
+        }
+    }
+
+    void Done()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0)
+        {
+            m_finished.notify_all();
+        }
+    }
+
+    bool Wait(std::chrono::seconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_finished.wait_for(lock, timeout, [this]() { return m_pending == 0; });
+    }
+
+    int Failures() const { return m_failures; }
+    int ResumedOnLoop() const { return m_resumedOnLoop; }
+
+private:
+
+    std::mutex m_mutex;
+    std::condition_variable m_finished;
+    int m_pending;
+    int m_failures = 0;
+    std::atomic<int> m_resumedOnLoop{ 0 };
+    std::thread::id m_mainThread;
+};
+
+std::shared_ptr<SpeechConfig> LoopbackConfig(int latencyMs)
+{
+    auto config = SpeechConfig::FromSubscription("loopback", "loopback");
+    config->SetProperty("Loopback-EventIntervalMs", "1");
+    config->SetProperty("Loopback-LatencyMs", std::to_string(latencyMs));
+    config->SetProperty("Loopback-RecognizingPerPhrase", std::to_string(RecognizingPerPhrase));
+    config->SetProperty("Loopback-SynthesizingChunks", std::to_string(SynthesizingChunks));
+    config->SetProperty("Loopback-AudioBytes", std::to_string(AudioBytes));
+    return config;
+}
+
+// One session: a recognition, a message on its connection and a synthesis, each awaited in turn.
+Detached RunSession(std::shared_ptr<SpeechRecognizer> recognizer, std::shared_ptr<SpeechSynthesizer> synthesizer, Results& results)
+{
+    auto recognized = co_await RecognizeOnceAsync(recognizer);
+    results.CheckResumedOnLoop();
+    results.Check(recognized != nullptr && recognized->Reason == ResultReason::RecognizedSpeech, "recognition did not recognize speech");
+
+    auto connection = Connection::FromRecognizer(recognizer);
+    co_await SendMessageAsync(connection, "speech.context", "{}");
+    results.CheckResumedOnLoop();
+
+    auto synthesized = co_await SpeakTextAsync(synthesizer, "hello from a coroutine");
+    results.CheckResumedOnLoop();
+    results.Check(synthesized != nullptr && synthesized->Reason == ResultReason::SynthesizingAudioCompleted, "synthesis did not complete");
+
+    results.Done();
+}
+
+// Reads the events of an operation while it runs: the operation is awaited only after its events were drained.
+Detached Drain(std::shared_ptr<SpeechRecognizer> recognizer, std::shared_ptr<SpeechSynthesizer> synthesizer, Results& results)
+{
+    auto recognizing = Recognizing(recognizer);
+    auto recognition = RecognizeOnceAsync(recognizer);
+    for (int i = 0; i < RecognizingPerPhrase; i++)
+    {
+        auto result = co_await recognizing->Next();
+        results.CheckResumedOnLoop();
+        results.Check(result.has_value() && (*result)->Reason == ResultReason::RecognizingSpeech, "missing Recognizing event " + std::to_string(i));
+    }
+    auto recognized = co_await recognition;
+    results.Check(recognized != nullptr && recognized->Reason == ResultReason::RecognizedSpeech, "recognition did not recognize speech");
+    recognizing->Close();
+    results.Check(!(co_await recognizing->Next()).has_value(), "closed Recognizing stream produced a value");
+
+    auto synthesizing = Synthesizing(synthesizer);
+    auto synthesis = SpeakTextAsync(synthesizer, "hello from a stream");
+    int chunks = 0;
+    size_t bytes = 0;
+    for (; chunks < SynthesizingChunks; chunks++)
+    {
+        auto chunk = co_await synthesizing->Next();
+        if (!chunk.has_value())
+        {
+            break;
+        }
+        bytes += (*chunk)->GetAudioLength();
+    }
+    auto synthesized = co_await synthesis;
+    synthesizing->Close();
+    results.Check(chunks == SynthesizingChunks, "got " + std::to_string(chunks) + " Synthesizing events");
+    results.Check(bytes == AudioBytes, "Synthesizing events carried " + std::to_string(bytes) + " bytes");
+    results.Check(synthesized != nullptr && synthesized->Reason == ResultReason::SynthesizingAudioCompleted, "synthesis did not complete");
+    results.Check(!(co_await synthesizing->Next()).has_value(), "closed Synthesizing stream produced a value");
+
+    results.Done();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    const int sessions = argc > 1 ? atoi(argv[1]) : 1000;
+    const int streams = argc > 2 ? atoi(argv[2]) : 100;
+
+    // The latency keeps each operation pending when it is awaited, so nearly every await suspends.
+    auto config = LoopbackConfig(20);
+    std::vector<std::shared_ptr<SpeechRecognizer>> recognizers;
+    std::vector<std::shared_ptr<SpeechSynthesizer>> synthesizers;
+    for (int i = 0; i < sessions + streams; i++)
+    {
+        recognizers.push_back(SpeechRecognizer::FromConfig(config, nullptr));
+        synthesizers.push_back(SpeechSynthesizer::FromConfig(config, nullptr));
+    }
+
+    Results results(sessions + streams);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < sessions; i++)
+    {
+        RunSession(recognizers[i], synthesizers[i], results);
+    }
+    for (int i = sessions; i < sessions + streams; i++)
+    {
+        Drain(recognizers[i], synthesizers[i], results);
+    }
+
+    if (!results.Wait(std::chrono::seconds(120)))
+    {
+        printf("FAILED: not every coroutine finished within 120 s\n");
+        return 1;
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%d sessions and %d streams in %.2f s, %d resumes on the completion loop: %s\n", sessions, streams, elapsed,
+        results.ResumedOnLoop(), results.Failures() == 0 ? "ok" : "FAILED");
+    return results.Failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,607 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// flac_round_trip_test.cpp: Encodes PCM with FlacEncoder and through the FlacCodec plugin interface, decodes the
+// stream with the minimal decoder below, and checks the frame CRCs, the sample numbers and that every sample
+// comes back unchanged.
+//
+// Usage: flac_round_trip_test
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "speechapi_cxx.h"
+#include "speechapi_cxx_flac_codec.h"
+
+using namespace Microsoft::CognitiveServices::Speech::Audio;
+
+namespace {
+
+class BitReader
+{
+public:
+
+    BitReader(const std::vector<uint8_t>& bytes, size_t position) : m_bytes(bytes), m_bit(position * 8) {}
+
+    bool Read(uint32_t bits, uint32_t& value)
+    {
+        if (m_bit + bits > m_bytes.size() * 8)
+        {
+            return false;
+        }
+        value = 0;
+        for (uint32_t i = 0; i < bits; i++, m_bit++)
+        {
+            value = (value << 1) | ((m_bytes[m_bit / 8] >> (7 - m_bit % 8)) & 1);
+        }
+        return true;
+    }
+
+    bool ReadSigned(uint32_t bits, int32_t& value)
+    {
+        uint32_t raw = 0;
+        if (!Read(bits, raw))
+        {
+            return false;
+        }
+        value = bits == 0 ? 0 : static_cast<int32_t>(raw << (32 - bits)) >> (32 - bits);
+        return true;
+    }
+
+    bool ReadUnary(uint32_t& zeros)
+    {
+        uint32_t bit = 0;
+        for (zeros = 0; Read(1, bit); zeros++)
+        {
+            if (bit == 1)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ReadUtf8(uint64_t& value)
+    {
+        uint32_t byte = 0;
+        if (!Read(8, byte))
+        {
+            return false;
+        }
+        uint32_t continuation = 0;
+        while (continuation < 7 && (byte & (0x80u >> continuation)) != 0)
+        {
+            continuation++;
+        }
+        if (continuation == 1 || continuation == 7)
+        {
+            return false;
+        }
+        value = continuation == 0 ? byte : byte & (0x7Fu >> continuation);
+        for (uint32_t i = 1; i < continuation; i++)
+        {
+            if (!Read(8, byte) || (byte & 0xC0) != 0x80)
+            {
+                return false;
+            }
+            value = (value << 6) | (byte & 0x3F);
+        }
+        return true;
+    }
+
+    void AlignToByte() { m_bit = (m_bit + 7) & ~size_t(7); }
+    size_t BytePosition() const { return m_bit / 8; }
+
+private:
+
+    const std::vector<uint8_t>& m_bytes;
+    size_t m_bit;
+};
+
+uint8_t Crc8(const uint8_t* data, size_t size)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = static_cast<uint8_t>((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint16_t Crc16(const uint8_t* data, size_t size)
+{
+    uint16_t crc = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= static_cast<uint16_t>(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x8005 : crc << 1);
+        }
+    }
+    return crc;
+}
+
+struct Decoded
+{
+    uint32_t SamplesPerSecond = 0;
+    uint32_t Channels = 0;
+    uint32_t MaxBlockSize = 0;
+    uint32_t Frames = 0;
+    std::vector<int16_t> Samples;
+};
+
+bool DecodeResidual(BitReader& bits, uint32_t blockSize, uint32_t order, std::vector<int32_t>& out, std::string& error)
+{
+    uint32_t method = 0, partitionOrder = 0;
+    if (!bits.Read(2, method) || method > 1 || !bits.Read(4, partitionOrder))
+    {
+        error = "bad residual header";
+        return false;
+    }
+
+    const uint32_t parameterBits = method == 0 ? 4 : 5;
+    const uint32_t escape = (1u << parameterBits) - 1;
+    const uint32_t partitions = 1u << partitionOrder;
+    if ((blockSize % partitions) != 0 || (blockSize >> partitionOrder) < order)
+    {
+        error = "bad partition order";
+        return false;
+    }
+
+    for (uint32_t partition = 0; partition < partitions; partition++)
+    {
+        uint32_t parameter = 0;
+        if (!bits.Read(parameterBits, parameter))
+        {
+            error = "truncated residual";
+            return false;
+        }
+        auto n = (blockSize >> partitionOrder) - (partition == 0 ? order : 0);
+        uint32_t rawBits = 0;
+        if (parameter == escape && !bits.Read(5, rawBits))
+        {
+            error = "truncated residual";
+            return false;
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int32_t value = 0;
+            if (parameter == escape)
+            {
+                if (!bits.ReadSigned(rawBits, value))
+                {
+                    error = "truncated residual";
+                    return false;
+                }
+            }
+            else
+            {
+                uint32_t quotient = 0, remainder = 0;
+                if (!bits.ReadUnary(quotient) || !bits.Read(parameter, remainder))
+                {
+                    error = "truncated residual";
+                    return false;
+                }
+                auto folded = (quotient << parameter) | remainder;
+                value = static_cast<int32_t>(folded >> 1) ^ -static_cast<int32_t>(folded & 1);
+            }
+            out.push_back(value);
+        }
+    }
+    return true;
+}
+
+bool DecodeSubframe(BitReader& bits, uint32_t blockSize, std::vector<int32_t>& samples, std::string& error)
+{
+    uint32_t zero = 0, type = 0, wasted = 0;
+    if (!bits.Read(1, zero) || zero != 0 || !bits.Read(6, type) || !bits.Read(1, wasted) || wasted != 0)
+    {
+        error = "bad subframe header";
+        return false;
+    }
+
+    samples.clear();
+    int32_t value = 0;
+    if (type == 0)
+    {
+        if (!bits.ReadSigned(16, value))
+        {
+            error = "truncated constant subframe";
+            return false;
+        }
+        samples.assign(blockSize, value);
+        return true;
+    }
+    if (type == 1)
+    {
+        for (uint32_t i = 0; i < blockSize; i++)
+        {
+            if (!bits.ReadSigned(16, value))
+            {
+                error = "truncated verbatim subframe";
+                return false;
+            }
+            samples.push_back(value);
+        }
+        return true;
+    }
+    if (type < 8 || type > 12)
+    {
+        error = "unexpected subframe type " + std::to_string(type);
+        return false;
+    }
+
+    const uint32_t order = type - 8;
+    for (uint32_t i = 0; i < order; i++)
+    {
+        if (!bits.ReadSigned(16, value))
+        {
+            error = "truncated warm-up samples";
+            return false;
+        }
+        samples.push_back(value);
+    }
+
+    std::vector<int32_t> residual;
+    if (!DecodeResidual(bits, blockSize, order, residual, error))
+    {
+        return false;
+    }
+    for (auto r : residual)
+    {
+        auto i = samples.size();
+        int32_t prediction = 0;
+        switch (order)
+        {
+        case 1: prediction = samples[i - 1]; break;
+        case 2: prediction = 2 * samples[i - 1] - samples[i - 2]; break;
+        case 3: prediction = 3 * samples[i - 1] - 3 * samples[i - 2] + samples[i - 3]; break;
+        case 4: prediction = 4 * samples[i - 1] - 6 * samples[i - 2] + 4 * samples[i - 3] - samples[i - 4]; break;
+        default: break;
+        }
+        samples.push_back(prediction + r);
+    }
+    return true;
+}
+
+bool Decode(const std::vector<uint8_t>& stream, Decoded& decoded, std::string& error)
+{
+    if (stream.size() < 42 || std::memcmp(stream.data(), "fLaC", 4) != 0)
+    {
+        error = "missing stream marker";
+        return false;
+    }
+
+    BitReader header(stream, 4);
+    uint32_t last = 0, type = 0, length = 0, minBlockSize = 0, frameSizes = 0, bitsPerSample = 0;
+    header.Read(1, last);
+    header.Read(7, type);
+    header.Read(24, length);
+    if (last != 1 || type != 0 || length != 34)
+    {
+        error = "expected a single STREAMINFO block";
+        return false;
+    }
+    header.Read(16, minBlockSize);
+    header.Read(16, decoded.MaxBlockSize);
+    header.Read(24, frameSizes);
+    header.Read(24, frameSizes);
+    header.Read(20, decoded.SamplesPerSecond);
+    header.Read(3, decoded.Channels);
+    header.Read(5, bitsPerSample);
+    decoded.Channels++;
+    if (bitsPerSample != 15 || minBlockSize != 16)
+    {
+        error = "unexpected STREAMINFO";
+        return false;
+    }
+
+    size_t position = 42;
+    uint64_t sampleNumber = 0;
+    std::vector<std::vector<int32_t>> channels(decoded.Channels);
+    while (position < stream.size())
+    {
+        BitReader bits(stream, position);
+        uint32_t sync = 0, blocking = 0, blockSizeCode = 0, rateCode = 0, assignment = 0, sizeCode = 0, reserved = 0;
+        uint64_t number = 0;
+        bits.Read(15, sync);
+        bits.Read(1, blocking);
+        bits.Read(4, blockSizeCode);
+        bits.Read(4, rateCode);
+        bits.Read(4, assignment);
+        bits.Read(3, sizeCode);
+        bits.Read(1, reserved);
+        if (sync != 0x7FFC || blocking != 1 || reserved != 0 || sizeCode != 4 || assignment + 1 != decoded.Channels)
+        {
+            error = "bad frame header at byte " + std::to_string(position);
+            return false;
+        }
+        if (!bits.ReadUtf8(number) || number != sampleNumber)
+        {
+            error = "bad sample number at byte " + std::to_string(position);
+            return false;
+        }
+
+        uint32_t blockSize = 0;
+        if (blockSizeCode == 6 || blockSizeCode == 7)
+        {
+            bits.Read(blockSizeCode == 6 ? 8 : 16, blockSize);
+            blockSize++;
+        }
+        else
+        {
+            error = "unexpected block size code";
+            return false;
+        }
+        uint32_t extraRate = 0;
+        if (rateCode >= 12 && rateCode <= 14)
+        {
+            bits.Read(rateCode == 12 ? 8 : 16, extraRate);
+        }
+
+        uint32_t crc8 = 0;
+        auto headerSize = bits.BytePosition() - position;
+        if (!bits.Read(8, crc8) || crc8 != Crc8(&stream[position], headerSize))
+        {
+            error = "frame header CRC mismatch at byte " + std::to_string(position);
+            return false;
+        }
+        if (blockSize > decoded.MaxBlockSize)
+        {
+            error = "block larger than STREAMINFO allows";
+            return false;
+        }
+
+        for (auto& channel : channels)
+        {
+            if (!DecodeSubframe(bits, blockSize, channel, error))
+            {
+                error += " at byte " + std::to_string(position);
+                return false;
+            }
+        }
+
+        bits.AlignToByte();
+        uint32_t crc16 = 0;
+        auto frameSize = bits.BytePosition() - position;
+        if (!bits.Read(16, crc16) || crc16 != Crc16(&stream[position], frameSize))
+        {
+            error = "frame CRC mismatch at byte " + std::to_string(position);
+            return false;
+        }
+
+        for (uint32_t i = 0; i < blockSize; i++)
+        {
+            for (auto& channel : channels)
+            {
+                decoded.Samples.push_back(static_cast<int16_t>(channel[i]));
+            }
+        }
+        sampleNumber += blockSize;
+        position = bits.BytePosition();
+        decoded.Frames++;
+    }
+    return true;
+}
+
+// Speech-like test signal: tones with a changing pitch and some noise, separated by pauses of digital silence.
+std::vector<int16_t> Speech(uint32_t samplesPerSecond, uint32_t channels, double seconds)
+{
+    std::vector<int16_t> samples;
+    uint32_t noise = 12345;
+    auto frames = static_cast<uint32_t>(samplesPerSecond * seconds);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        auto t = double(i) / samplesPerSecond;
+        bool pause = std::fmod(t, 1.0) > 0.7;
+        for (uint32_t channel = 0; channel < channels; channel++)
+        {
+            noise = noise * 1103515245 + 12345;
+            auto pitch = 120.0 + 80.0 * std::sin(t * 3) + 40.0 * channel;
+            auto value = pause ? 0.0 : 6000 * std::sin(2 * M_PI * pitch * t) + 2000 * std::sin(2 * M_PI * 3 * pitch * t) + int32_t(noise >> 16) % 200;
+            samples.push_back(static_cast<int16_t>(value));
+        }
+    }
+    return samples;
+}
+
+// Full-scale noise, which only a verbatim subframe stores compactly, and alternating extremes, whose residuals
+// need Rice parameters above 14.
+std::vector<int16_t> Extremes(uint32_t count)
+{
+    std::vector<int16_t> samples;
+    uint32_t noise = 1;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        noise = noise * 1664525 + 1013904223;
+        samples.push_back(i < count / 2 ? static_cast<int16_t>(noise >> 16) : (i % 2 ? 32767 : -32768));
+    }
+    return samples;
+}
+
+struct Encoded
+{
+    std::vector<uint8_t> Stream;
+    uint64_t SamplesPerChannel = 0;
+    uint64_t Duration = 0;
+};
+
+FlacEncoder::DataCallback Collect(Encoded& encoded)
+{
+    return [&encoded](const uint8_t* data, size_t size, uint32_t samplesPerChannel) {
+        encoded.Stream.insert(encoded.Stream.end(), data, data + size);
+        encoded.SamplesPerChannel += samplesPerChannel;
+    };
+}
+
+int g_failures = 0;
+
+void Check(const char* name, const Encoded& encoded, const std::vector<int16_t>& input, uint32_t samplesPerSecond, uint32_t channels)
+{
+    Decoded decoded;
+    std::string error;
+    if (!Decode(encoded.Stream, decoded, error))
+    {
+    }
+    else if (decoded.SamplesPerSecond != samplesPerSecond || decoded.Channels != channels)
+    {
+        error = "wrong stream format";
+    }
+    else if (decoded.Samples != input)
+    {
+        error = "decoded samples differ from the input";
+    }
+    else if (encoded.SamplesPerChannel != input.size() / channels)
+    {
+        error = "callback reported " + std::to_string(encoded.SamplesPerChannel) + " samples per channel";
+    }
+
+    if (!error.empty())
+    {
+        g_failures++;
+        printf("%-28s FAILED: %s\n", name, error.c_str());
+        return;
+    }
+    printf("%-28s ok: %zu samples, %u frames, %zu bytes, %.1f%% of PCM\n", name, input.size(), decoded.Frames,
+        encoded.Stream.size(), 100.0 * encoded.Stream.size() / std::max<size_t>(1, input.size() * 2));
+}
+
+void TestSpeechMono()
+{
+    auto input = Speech(16000, 1, 5);
+    Encoded encoded;
+    FlacEncoder encoder(16000, 1, Collect(encoded));
+    for (size_t offset = 0, chunk = 0; offset < input.size(); offset += 160, chunk++)
+    {
+        encoder.Encode(input.data() + offset, std::min<size_t>(160, input.size() - offset));
+        if (chunk % 37 == 36)
+        {
+            encoder.Flush();
+        }
+    }
+    encoder.Finish();
+    Check("speech, mono, flushes", encoded, input, 16000, 1);
+}
+
+void TestStereoBytes()
+{
+    auto input = Speech(48000, 2, 2);
+    Encoded encoded;
+    FlacEncoder encoder(48000, 2, Collect(encoded), 1152);
+    auto bytes = reinterpret_cast<const uint8_t*>(input.data());
+    auto size = input.size() * 2;
+    for (size_t offset = 0; offset < size; offset += 7)
+    {
+        encoder.Encode(bytes + offset, std::min<size_t>(7, size - offset));
+    }
+    encoder.Finish();
+    Check("speech, stereo, 7-byte writes", encoded, input, 48000, 2);
+}
+
+void TestExtremes()
+{
+    auto input = Extremes(3 * 4096 + 5);
+    Encoded encoded;
+    FlacEncoder encoder(22050, 1, Collect(encoded));
+    encoder.Encode(input.data(), input.size());
+    encoder.Finish();
+    Check("noise and extremes", encoded, input, 22050, 1);
+}
+
+void TestEmpty()
+{
+    Encoded encoded;
+    FlacEncoder encoder(16000, 1, Collect(encoded));
+    encoder.Finish();
+    Check("empty stream", encoded, {}, 16000, 1);
+}
+
+void SPXAPI_CALLTYPE OnEncodedData(const uint8_t* data, size_t size, uint64_t duration, void* context)
+{
+    auto encoded = static_cast<Encoded*>(context);
+    encoded->Stream.insert(encoded->Stream.end(), data, data + size);
+    encoded->Duration += duration;
+}
+
+void TestCodecInterface()
+{
+    auto input = Speech(16000, 1, 3);
+    Encoded encoded;
+    auto codec = FlacCodec::Create("flac-lowdelay", nullptr, nullptr);
+    char format[32] = {};
+    uint64_t formatSize = sizeof(format);
+    if (codec == nullptr ||
+        codec->init(codec, 16000, 16, 1, OnEncodedData, &encoded) != SPX_NOERROR ||
+        codec->get_format_type(codec, format, &formatSize) != SPX_NOERROR ||
+        codec->encode(codec, reinterpret_cast<const uint8_t*>(input.data()), input.size() * 2) != SPX_NOERROR ||
+        codec->flush(codec) != SPX_NOERROR ||
+        codec->endstream(codec) != SPX_NOERROR ||
+        codec->destroy(codec) != SPX_NOERROR)
+    {
+        g_failures++;
+        printf("%-28s FAILED: codec call failed\n", "codec interface, low delay");
+        return;
+    }
+    encoded.SamplesPerChannel = encoded.Duration * 16000 / 10000000;
+
+    Decoded decoded;
+    std::string error;
+    if (std::strcmp(format, FlacCodec::FormatType) != 0)
+    {
+        g_failures++;
+        printf("%-28s FAILED: format type %s\n", "codec interface, low delay", format);
+    }
+    else if (Decode(encoded.Stream, decoded, error) && decoded.MaxBlockSize != FlacEncoder::LowDelayBlockSize)
+    {
+        g_failures++;
+        printf("%-28s FAILED: block size %u\n", "codec interface, low delay", decoded.MaxBlockSize);
+    }
+    else
+    {
+        Check("codec interface, low delay", encoded, input, 16000, 1);
+    }
+}
+
+void TestCorruption()
+{
+    auto input = Speech(16000, 1, 1);
+    Encoded encoded;
+    FlacEncoder encoder(16000, 1, Collect(encoded));
+    encoder.Encode(input.data(), input.size());
+    encoder.Finish();
+
+    encoded.Stream[encoded.Stream.size() / 2] ^= 0x10;
+    Decoded decoded;
+    std::string error;
+    if (Decode(encoded.Stream, decoded, error) && decoded.Samples == input)
+    {
+        g_failures++;
+        printf("%-28s FAILED: a flipped bit went unnoticed\n", "corruption is detected");
+        return;
+    }
+    printf("%-28s ok: %s\n", "corruption is detected", error.empty() ? "samples differ" : error.c_str());
+}
+
+} // anonymous namespace
+
+int main()
+{
+    TestSpeechMono();
+    TestStereoBytes();
+    TestExtremes();
+    TestEmpty();
+    TestCodecInterface();
+    TestCorruption();
+    return g_failures == 0 ? 0 : 1;
+}
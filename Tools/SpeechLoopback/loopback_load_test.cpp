@@ -0,0 +1,179 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// loopback_load_test.cpp: Drives the C++ API against the loopback C API and reports event throughput.
+//
+// Usage: loopback_load_test [recognizers] [seconds] [event interval ms] [payload bytes] [latency ms] [synthesizers]
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "speechapi_cxx.h"
+
+using namespace Microsoft::CognitiveServices::Speech;
+using namespace Microsoft::CognitiveServices::Speech::Audio;
+
+namespace {
+
+struct Counters
+{
+    std::atomic<uint64_t> SessionsStarted { 0 };
+    std::atomic<uint64_t> Recognizing { 0 };
+    std::atomic<uint64_t> Recognized { 0 };
+    std::atomic<uint64_t> Canceled { 0 };
+    std::atomic<uint64_t> Messages { 0 };
+    std::atomic<uint64_t> JsonBytes { 0 };
+    std::atomic<uint64_t> NBest { 0 };
+    std::atomic<uint64_t> Utterances { 0 };
+    std::atomic<uint64_t> Synthesizing { 0 };
+    std::atomic<uint64_t> AudioBytes { 0 };
+};
+
+uint32_t Argument(int argc, char* argv[], int index, uint32_t defaultValue)
+{
+    return argc > index ? static_cast<uint32_t>(strtoul(argv[index], nullptr, 10)) : defaultValue;
+}
+
+// Closing the push stream ends the recognition, so the stream is kept for the whole run.
+struct Client
+{
+    std::shared_ptr<PushAudioInputStream> Stream;
+    std::shared_ptr<SpeechRecognizer> Recognizer;
+    std::shared_ptr<Microsoft::CognitiveServices::Speech::Connection> Connection;
+};
+
+Client CreateClient(const std::shared_ptr<SpeechConfig>& config, Counters& counters)
+{
+    auto stream = AudioInputStream::CreatePushStream();
+    auto recognizer = SpeechRecognizer::FromConfig(config, AudioConfig::FromStreamInput(stream));
+
+    recognizer->SessionStarted.Connect([&counters](const SessionEventArgs& e) {
+        (void)e.SessionId;
+        counters.SessionsStarted++;
+    });
+    recognizer->Recognizing.Connect([&counters](const SpeechRecognitionEventArgs& e) {
+        (void)e.Result->Text;
+        counters.Recognizing++;
+    });
+    recognizer->Recognized.Connect([&counters](const SpeechRecognitionEventArgs& e) {
+        auto json = e.Result->Properties.GetProperty(PropertyId::SpeechServiceResponse_JsonResult);
+        Utils::JsonDocument document(json);
+        for (auto alternative : document.Root()["NBest"])
+        {
+            (void)alternative["Display"].AsString();
+            counters.NBest++;
+        }
+        counters.JsonBytes += json.size();
+        counters.Recognized++;
+    });
+    recognizer->Canceled.Connect([&counters](const SpeechRecognitionCanceledEventArgs& e) {
+        (void)e.Reason;
+        counters.Canceled++;
+    });
+
+    auto connection = Connection::FromRecognizer(recognizer);
+    connection->MessageReceived.Connect([&counters](const ConnectionMessageEventArgs& e) {
+        (void)e.GetMessage()->GetTextMessage();
+        counters.Messages++;
+    });
+    return { stream, recognizer, connection };
+}
+
+void RunSynthesizer(const std::shared_ptr<SpeechConfig>& config, Counters& counters, const std::atomic<bool>& running)
+{
+    auto synthesizer = SpeechSynthesizer::FromConfig(config, nullptr);
+    synthesizer->Synthesizing.Connect([&counters](const SpeechSynthesisEventArgs& e) {
+        counters.AudioBytes += e.Result->GetAudioLength();
+        counters.Synthesizing++;
+    });
+
+    while (running)
+    {
+        auto result = synthesizer->SpeakTextAsync("The quick brown fox jumps over the lazy dog").get();
+        if (result->Reason == ResultReason::SynthesizingAudioCompleted)
+        {
+            counters.Utterances++;
+        }
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    auto recognizerCount = Argument(argc, argv, 1, 8);
+    auto seconds = Argument(argc, argv, 2, 5);
+    auto interval = Argument(argc, argv, 3, 10);
+    auto payload = Argument(argc, argv, 4, 256);
+    auto latency = Argument(argc, argv, 5, 0);
+    auto synthesizerCount = Argument(argc, argv, 6, 1);
+
+    auto config = SpeechConfig::FromSubscription("loopback", "loopback");
+    config->SetProperty("Loopback-EventIntervalMs", std::to_string(interval));
+    config->SetProperty("Loopback-PayloadBytes", std::to_string(payload));
+    config->SetProperty("Loopback-LatencyMs", std::to_string(latency));
+
+    Counters counters;
+    std::vector<Client> clients;
+    for (uint32_t i = 0; i < recognizerCount; i++)
+    {
+        clients.push_back(CreateClient(config, counters));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> pending;
+    for (auto& client : clients)
+    {
+        pending.push_back(client.Recognizer->StartContinuousRecognitionAsync());
+    }
+    for (auto& future : pending)
+    {
+        future.get();
+    }
+
+    std::atomic<bool> running { true };
+    std::vector<std::thread> synthesizers;
+    for (uint32_t i = 0; i < synthesizerCount; i++)
+    {
+        synthesizers.emplace_back([&]() { RunSynthesizer(config, counters, running); });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+    pending.clear();
+    for (auto& client : clients)
+    {
+        pending.push_back(client.Recognizer->StopContinuousRecognitionAsync());
+    }
+    for (auto& future : pending)
+    {
+        future.get();
+    }
+    running = false;
+    for (auto& thread : synthesizers)
+    {
+        thread.join();
+    }
+    clients.clear();
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto events = counters.Recognizing + counters.Recognized + counters.Messages + counters.Synthesizing;
+    printf("recognizers %u, synthesizers %u, %.2f s, interval %u ms, payload %u bytes, latency %u ms\n",
+        recognizerCount, synthesizerCount, elapsed, interval, payload, latency);
+    printf("sessions     %llu\n", static_cast<unsigned long long>(counters.SessionsStarted));
+    printf("recognizing  %llu\n", static_cast<unsigned long long>(counters.Recognizing));
+    printf("recognized   %llu (%llu alternatives, %llu JSON bytes)\n", static_cast<unsigned long long>(counters.Recognized),
+        static_cast<unsigned long long>(counters.NBest), static_cast<unsigned long long>(counters.JsonBytes));
+    printf("messages     %llu\n", static_cast<unsigned long long>(counters.Messages));
+    printf("canceled     %llu\n", static_cast<unsigned long long>(counters.Canceled));
+    printf("utterances   %llu (%llu chunks, %llu audio bytes)\n", static_cast<unsigned long long>(counters.Utterances),
+        static_cast<unsigned long long>(counters.Synthesizing), static_cast<unsigned long long>(counters.AudioBytes));
+    printf("events/s     %.0f\n", events / elapsed);
+    return 0;
+}
@@ -0,0 +1,322 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// multiplexer_throughput_test.cpp: Runs batches of sessions through a BatchSessionMultiplexer against the loopback
+// C API, checks that every result is routed to the session whose audio produced it and that every session stops
+// without stopping the multiplexer, and reports the throughput. Then fails one connection mid-run and checks that
+// only its session with audio in flight is canceled, while its other sessions finish on the remaining connections.
+//
+// Usage: multiplexer_throughput_test [connections] [worker threads] [sessions...]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "speechapi_cxx.h"
+#include "speechapi_loopback.h"
+
+using namespace Microsoft::CognitiveServices::Speech;
+
+namespace {
+
+constexpr uint32_t BytesPerMillisecond = 32;
+constexpr uint32_t ChunkBytes = 100 * BytesPerMillisecond;
+
+// Audio of every session: two phrases whose samples all carry the session marker, each followed by silence longer
+// than the segmentation silence timeout.
+constexpr uint32_t PhraseBytes = 500 * BytesPerMillisecond;
+constexpr uint32_t SilenceBytes = 600 * BytesPerMillisecond;
+constexpr uint32_t PhrasesPerSession = 2;
+constexpr uint32_t SessionBytes = PhrasesPerSession * (PhraseBytes + SilenceBytes);
+
+// The loopback answers at once, so a short idle timeout lets the last sessions of each connection stop quickly.
+constexpr std::chrono::milliseconds IdleTimeout(200);
+constexpr std::chrono::seconds StopTimeout(60);
+
+int16_t Marker(uint32_t session)
+{
+    return static_cast<int16_t>(session % 32000 + 1);
+}
+
+bool IsSpeech(uint64_t byteOffset)
+{
+    return byteOffset % (PhraseBytes + SilenceBytes) < PhraseBytes;
+}
+
+uint32_t Argument(int argc, char* argv[], int index, uint32_t defaultValue)
+{
+    return argc > index ? static_cast<uint32_t>(strtoul(argv[index], nullptr, 10)) : defaultValue;
+}
+
+struct SessionState
+{
+    std::shared_ptr<MultiplexedSession> Session;
+    int16_t Marker = 0;
+    uint32_t Recognized = 0;
+    bool Canceled = false;
+    bool Stopped = false;
+};
+
+struct Totals
+{
+    std::mutex Mutex;
+    std::condition_variable Changed;
+    uint64_t Recognizing = 0;
+    uint64_t Recognized = 0;
+    uint64_t Canceled = 0;
+    uint64_t Stopped = 0;
+    uint64_t Errors = 0;
+};
+
+void Fail(Totals& totals, const char* message, uint32_t session, const std::string& detail)
+{
+    std::lock_guard<std::mutex> lock(totals.Mutex);
+    if (totals.Errors++ < 10)
+    {
+        fprintf(stderr, "session %u: %s (%s)\n", session, message, detail.c_str());
+    }
+}
+
+void Open(BatchSessionMultiplexer& multiplexer, SessionState& state, uint32_t i, Totals& totals)
+{
+    state.Marker = Marker(i);
+    state.Session = multiplexer.OpenSession();
+
+    state.Session->Recognizing.Connect([&totals](const MultiplexedSessionEventArgs&) {
+        std::lock_guard<std::mutex> lock(totals.Mutex);
+        totals.Recognizing++;
+    });
+    state.Session->Recognized.Connect([&totals, &state, i](const MultiplexedSessionEventArgs& e) {
+        auto text = e.Result->Text;
+        auto expected = " sample " + std::to_string(state.Marker);
+        if (text.size() < expected.size() || text.compare(text.size() - expected.size(), expected.size(), expected) != 0)
+        {
+            Fail(totals, "result of another session", i, text);
+        }
+        if (!IsSpeech(e.Offset * 2 / 625))
+        {
+            Fail(totals, "offset outside of the speech of the session", i, std::to_string(e.Offset));
+        }
+        state.Recognized++;
+        std::lock_guard<std::mutex> lock(totals.Mutex);
+        totals.Recognized++;
+    });
+    state.Session->Canceled.Connect([&totals, &state, i](const MultiplexedSessionCanceledEventArgs& e) {
+        if (e.Reason != CancellationReason::Error || e.ErrorCode != CancellationErrorCode::ConnectionFailure || e.ErrorDetails.empty())
+        {
+            Fail(totals, "unexpected cancellation details", i, e.ErrorDetails);
+        }
+        bool late = false;
+        {
+            std::lock_guard<std::mutex> lock(totals.Mutex);
+            late = state.Canceled || state.Stopped;
+            state.Canceled = true;
+            totals.Canceled++;
+            totals.Changed.notify_all();
+        }
+        if (late)
+        {
+            Fail(totals, "canceled twice or after SessionStopped", i, "");
+        }
+    });
+    state.Session->SessionStopped.Connect([&totals, &state, i](const MultiplexedSessionEventArgs&) {
+        bool twice = false;
+        {
+            std::lock_guard<std::mutex> lock(totals.Mutex);
+            twice = state.Stopped;
+            state.Stopped = true;
+            totals.Stopped++;
+            totals.Changed.notify_all();
+        }
+        if (twice)
+        {
+            Fail(totals, "stopped twice", i, "");
+        }
+    });
+}
+
+// Writes the audio of the sessions in 100 ms chunks, round-robin, as recordings read side by side, then closes them.
+void Write(std::vector<SessionState>::iterator begin, std::vector<SessionState>::iterator end)
+{
+    std::vector<uint8_t> speech(ChunkBytes);
+    std::vector<uint8_t> silence(ChunkBytes, 0);
+    for (uint32_t offset = 0; offset < SessionBytes; offset += ChunkBytes)
+    {
+        for (auto state = begin; state != end; ++state)
+        {
+            if (!IsSpeech(offset))
+            {
+                state->Session->Write(silence.data(), ChunkBytes);
+                continue;
+            }
+            for (uint32_t byte = 0; byte < ChunkBytes; byte += 2)
+            {
+                speech[byte] = static_cast<uint8_t>(state->Marker & 0xFF);
+                speech[byte + 1] = static_cast<uint8_t>(state->Marker >> 8);
+            }
+            state->Session->Write(speech.data(), ChunkBytes);
+        }
+    }
+    for (auto state = begin; state != end; ++state)
+    {
+        state->Session->Close();
+    }
+}
+
+// Waits for every session to stop on its own, including the last one of each connection, which no later turn
+// acknowledges, then stops the multiplexer and checks the results of the sessions that were not canceled.
+void Finish(BatchSessionMultiplexer& multiplexer, std::vector<SessionState>& sessions, Totals& totals)
+{
+    std::vector<uint32_t> running;
+    {
+        std::unique_lock<std::mutex> lock(totals.Mutex);
+        totals.Changed.wait_for(lock, StopTimeout, [&]() { return totals.Stopped == sessions.size(); });
+        for (uint32_t i = 0; i < sessions.size(); i++)
+        {
+            if (!sessions[i].Stopped)
+            {
+                running.push_back(i);
+            }
+        }
+    }
+
+    multiplexer.Stop();
+    {
+        std::unique_lock<std::mutex> lock(totals.Mutex);
+        totals.Changed.wait(lock, [&]() { return totals.Stopped == sessions.size(); });
+    }
+    for (auto i : running)
+    {
+        Fail(totals, "stopped only when the multiplexer stopped", i, "");
+    }
+
+    for (uint32_t i = 0; i < sessions.size(); i++)
+    {
+        if (!sessions[i].Canceled && sessions[i].Recognized != PhrasesPerSession)
+        {
+            Fail(totals, "unexpected number of results", i, std::to_string(sessions[i].Recognized));
+        }
+    }
+}
+
+bool Run(const std::shared_ptr<SpeechConfig>& config, uint32_t sessionCount, uint32_t connections, uint32_t workers)
+{
+    connections = std::min(connections, sessionCount);
+    auto multiplexer = BatchSessionMultiplexer::FromConfig(config, connections, workers, std::chrono::seconds(2), std::chrono::milliseconds(600), IdleTimeout);
+
+    Totals totals;
+    std::vector<SessionState> sessions(sessionCount);
+    for (uint32_t i = 0; i < sessionCount; i++)
+    {
+        Open(*multiplexer, sessions[i], i, totals);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Write(sessions.begin(), sessions.end());
+    {
+        std::unique_lock<std::mutex> lock(totals.Mutex);
+        totals.Changed.wait_for(lock, StopTimeout, [&]() { return totals.Stopped == sessionCount; });
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto threads = multiplexer->GetThreadCount();
+
+    Finish(*multiplexer, sessions, totals);
+    if (totals.Canceled != 0)
+    {
+        Fail(totals, "canceled without a connection failure", 0, std::to_string(totals.Canceled) + " sessions");
+    }
+
+    auto audioSeconds = double(sessionCount) * SessionBytes / (BytesPerMillisecond * 1000);
+    printf("%8u %11u %8u %10.0f %9.3f %10.0f %9.0f %7llu\n", sessionCount, connections, static_cast<unsigned>(threads),
+        audioSeconds, elapsed, totals.Recognized / elapsed, audioSeconds / elapsed, static_cast<unsigned long long>(totals.Errors));
+
+    sessions.clear();
+    multiplexer.reset();
+    return totals.Errors == 0;
+}
+
+// Opens sessionsPerConnection sessions per connection, which the multiplexer spreads round-robin, and runs the first
+// one of each connection while the loopback fails the first connection to recognize a phrase. Only the session whose
+// audio that connection holds may be canceled. The other sessions of the failed connection have no audio in flight,
+// so they must move to the remaining connections, where they run with the sessions opened after the failure.
+bool RunConnectionFailure(const std::shared_ptr<SpeechConfig>& config, uint32_t connections, uint32_t workers, uint32_t sessionsPerConnection)
+{
+    connections = std::max(connections, 2u);
+    auto multiplexer = BatchSessionMultiplexer::FromConfig(config, connections, workers, std::chrono::seconds(2), std::chrono::milliseconds(600), IdleTimeout);
+
+    Totals totals;
+    const uint32_t sessionCount = connections * (sessionsPerConnection + 1);
+    const uint32_t openedBefore = connections * sessionsPerConnection;
+    std::vector<SessionState> sessions(sessionCount);
+    for (uint32_t i = 0; i < openedBefore; i++)
+    {
+        Open(*multiplexer, sessions[i], i, totals);
+    }
+
+    loopback_recognition_fail(1);
+    Write(sessions.begin(), sessions.begin() + connections);
+    bool canceled = false;
+    {
+        std::unique_lock<std::mutex> lock(totals.Mutex);
+        canceled = totals.Changed.wait_for(lock, StopTimeout, [&]() { return totals.Canceled != 0; });
+    }
+    if (!canceled)
+    {
+        Fail(totals, "no session canceled by the connection failure", 0, "");
+    }
+
+    for (uint32_t i = openedBefore; i < sessionCount; i++)
+    {
+        Open(*multiplexer, sessions[i], i, totals);
+    }
+    Write(sessions.begin() + connections, sessions.end());
+    Finish(*multiplexer, sessions, totals);
+    if (totals.Canceled > 1)
+    {
+        Fail(totals, "sessions without audio in flight canceled", 0, std::to_string(totals.Canceled) + " sessions");
+    }
+
+    printf("connection failure: %u sessions on %u connections, %llu canceled, %llu errors\n", sessionCount, connections,
+        static_cast<unsigned long long>(totals.Canceled), static_cast<unsigned long long>(totals.Errors));
+
+    sessions.clear();
+    multiplexer.reset();
+    return totals.Errors == 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    auto connections = Argument(argc, argv, 1, 8);
+    auto workers = Argument(argc, argv, 2, 4);
+    std::vector<uint32_t> sessionCounts;
+    for (int i = 3; i < argc; i++)
+    {
+        sessionCounts.push_back(Argument(argc, argv, i, 1));
+    }
+    if (sessionCounts.empty())
+    {
+        sessionCounts = { 1, 10, 100, 1000 };
+    }
+
+    auto config = SpeechConfig::FromSubscription("loopback", "loopback");
+    config->SetProperty("Loopback-AudioDriven", "1");
+    config->SetProperty("Loopback-EventIntervalMs", "0");
+    config->SetProperty("Loopback-RecognizingPerPhrase", "1");
+
+    printf("sessions connections  workers  audio (s)  wall (s)  results/s  realtime  errors\n");
+    bool passed = true;
+    for (auto count : sessionCounts)
+    {
+        passed = Run(config, count, connections, workers) && passed;
+    }
+    passed = RunConnectionFailure(config, connections, workers, 10) && passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// property_collection_test.cpp: Checks that the GetProperty overloads taking UTF-8 literals return what the SPXSTRING
+// overloads return, for defined, empty and undefined properties of cached and uncached collections, and that the
+// typed accessors keep the default value for values out of their range.
+//
+// Usage: property_collection_test
+//
+
+#include <climits>
+#include <cstdio>
+#include <string>
+#include "speechapi_cxx.h"
+
+using namespace Microsoft::CognitiveServices::Speech;
+
+namespace {
+
+int g_failures = 0;
+
+template<class T>
+void Expect(const char* name, const T& actual, const T& expected)
+{
+    if (actual != expected)
+    {
+        g_failures++;
+        printf("%-52s FAILED\n", name);
+        return;
+    }
+    printf("%-52s ok\n", name);
+}
+
+// A literal default resolves to the const char* overloads; the same call with std::string arguments resolves to the
+// SPXSTRING ones, which is what the call resolved to before those overloads existed.
+void ExpectSameByName(const char* name, const PropertyCollection& properties, const char* property, const char* defaultValue)
+{
+    Expect(name, properties.GetProperty(property, defaultValue), properties.GetProperty(std::string(property), std::string(defaultValue)));
+}
+
+void ExpectSameById(const char* name, const PropertyCollection& properties, PropertyId id, const char* defaultValue)
+{
+    Expect(name, properties.GetProperty(id, defaultValue), properties.GetProperty(id, std::string(defaultValue)));
+#if defined(__cpp_lib_string_view)
+    Expect(name, properties.GetProperty(id, std::string_view(defaultValue)), properties.GetProperty(id, std::string(defaultValue)));
+#endif
+}
+
+std::shared_ptr<SpeechConfig> LoopbackConfig()
+{
+    auto config = SpeechConfig::FromSubscription("loopback", "loopback");
+    config->SetProperty("Loopback-EventIntervalMs", "0");
+    config->SetProperty("Loopback-RecognizingPerPhrase", "0");
+    return config;
+}
+
+void TestUncached()
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    auto& properties = recognizer->Properties;
+
+    ExpectSameByName("uncached, undefined name", properties, "AccuracyScore", "-1");
+    Expect("uncached, undefined name returns the default", properties.GetProperty("AccuracyScore", "-1"), std::string("-1"));
+
+    properties.SetProperty("AccuracyScore", "");
+    ExpectSameByName("uncached, empty name", properties, "AccuracyScore", "-1");
+
+    properties.SetProperty("AccuracyScore", "87");
+    ExpectSameByName("uncached, defined name", properties, "AccuracyScore", "-1");
+    Expect("uncached, defined name without default", properties.GetProperty("AccuracyScore"), std::string("87"));
+
+    ExpectSameById("uncached, defined id", properties, PropertyId::SpeechServiceConnection_Region, "none");
+    ExpectSameById("uncached, undefined id", properties, PropertyId::SpeechServiceResponse_JsonResult, "none");
+    properties.SetProperty(PropertyId::SpeechServiceConnection_EndpointId, "");
+    ExpectSameById("uncached, empty id", properties, PropertyId::SpeechServiceConnection_EndpointId, "none");
+}
+
+void TestCached()
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    auto result = recognizer->RecognizeOnceAsync().get();
+    const auto& properties = result->Properties;
+
+    // Each case reads twice, so the second read comes from the cache
+    for (int read = 0; read < 2; read++)
+    {
+        ExpectSameByName("cached, undefined name", properties, "AccuracyScore", "-1");
+        Expect("cached, undefined name returns the default", properties.GetProperty("AccuracyScore", "-1"), std::string("-1"));
+        ExpectSameById("cached, defined id", properties, PropertyId::SpeechServiceResponse_JsonResult, "none");
+        ExpectSameById("cached, undefined id", properties, PropertyId::SpeechServiceResponse_RecognitionLatencyMs, "none");
+    }
+}
+
+void TestIntegerRange()
+{
+    auto recognizer = SpeechRecognizer::FromConfig(LoopbackConfig(), nullptr);
+    auto& properties = recognizer->Properties;
+
+    properties.SetProperty("Value", "2147483647");
+    Expect("int, largest", properties.GetInt("Value", 7), INT_MAX);
+    properties.SetProperty("Value", "-2147483648");
+    Expect("int, smallest", properties.GetInt("Value", 7), INT_MIN);
+    properties.SetProperty("Value", "2147483648");
+    Expect("int, above the range keeps the default", properties.GetInt("Value", 7), 7);
+    properties.SetProperty("Value", "-2147483649");
+    Expect("int, below the range keeps the default", properties.GetInt("Value", 7), 7);
+    properties.SetProperty("Value", "99999999999999999999");
+    Expect("int, above long long keeps the default", properties.GetInt("Value", 7), 7);
+    Expect("duration, above long long keeps the default", properties.GetDuration("Value", std::chrono::milliseconds(7)), std::chrono::milliseconds(7));
+    properties.SetProperty("Value", "4294967296");
+    Expect("duration, above int", properties.GetDuration("Value", std::chrono::milliseconds(7)), std::chrono::milliseconds(4294967296LL));
+}
+
+}
+
+int main()
+{
+    TestUncached();
+    TestCached();
+    TestIntegerRange();
+    return g_failures == 0 ? 0 : 1;
+}
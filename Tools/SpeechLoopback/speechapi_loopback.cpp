@@ -0,0 +1,3524 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_loopback.cpp: Loopback implementation of the speech C API for load testing on Linux.
+//
+// Implements the subset of the C API used by the recognizer, synthesizer, audio stream, property bag, connection
+// and JSON headers. Nothing leaves the process: recognizers and synthesizers raise synthetic events from worker
+// threads, paced by the workload properties below, so the C++ layer (event dispatch, pooling, result parsing, JSON
+// views) can be profiled and stress tested without a service or a device.
+//
+// By default recognizers ignore their audio. With Loopback-AudioDriven, a recognizer reading a push stream instead
+// segments the 16 kHz, 16-bit mono audio written to it: every run of non-zero samples not interrupted by the
+// segmentation silence (Speech_SegmentationSilenceTimeoutMs, default 500 ms) is a phrase of up to 10 s, with the
+// offset and duration of that audio and "sample N" in its text, N being its first sample.
+//
+// Workload properties, read from the speech config when a recognizer or synthesizer is created:
+//   Loopback-EventIntervalMs       delay between two events of a phrase or an utterance (default 10)
+//   Loopback-RecognizingPerPhrase  intermediate results raised before each final result (default 5)
+//   Loopback-PayloadBytes          minimum size of the detailed JSON result of each final result (default 64)
+//   Loopback-LatencyMs             delay before an operation starts producing events (default 0)
+//   Loopback-AudioBytes            PCM bytes synthesized per utterance (default 32000, one second)
+//   Loopback-SynthesizingChunks    synthesizing events per utterance (default 10)
+//   Loopback-AudioDriven           1 to recognize phrases from the audio of push streams (default 0)
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "azac_api_c_diagnostics.h"
+#include "speechapi_c.h"
+#include "speechapi_c_json.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_loopback.h"
+
+using PropertyId = Microsoft::CognitiveServices::Speech::PropertyId;
+
+namespace Loopback {
+
+constexpr uint32_t SamplesPerSecond = 16000;
+constexpr uint32_t BytesPerMillisecond = SamplesPerSecond * 2 / 1000;
+constexpr uint64_t TicksPerMillisecond = 10000;
+constexpr uint32_t MaxPhraseMs = 10000;
+
+/// <summary>
+/// Base class of every object handed out through a handle.
+/// </summary>
+class Object
+{
+public:
+    virtual ~Object() = default;
+};
+
+/// <summary>
+/// Maps handles to objects. Handles are small integers that are never reused, so a stale handle is reported as
+/// invalid instead of aliasing a newer object. The table is sharded to keep concurrent recognizers from contending
+/// on a single lock.
+/// </summary>
+class HandleTable
+{
+public:
+
+    static HandleTable& Instance()
+    {
+        // Leaked on purpose, so handles released from static destructors or late callbacks still find a table.
+        static auto table = new HandleTable();
+        return *table;
+    }
+
+    SPXHANDLE Add(std::shared_ptr<Object> object)
+    {
+        auto id = m_next.fetch_add(1, std::memory_order_relaxed);
+        auto& shard = m_shards[id % ShardCount];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        shard.objects.emplace(id, std::move(object));
+        return reinterpret_cast<SPXHANDLE>(id);
+    }
+
+    template <class T>
+    std::shared_ptr<T> Get(SPXHANDLE handle)
+    {
+        auto id = reinterpret_cast<uintptr_t>(handle);
+        auto& shard = m_shards[id % ShardCount];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = shard.objects.find(id);
+        return it != shard.objects.end() ? std::dynamic_pointer_cast<T>(it->second) : nullptr;
+    }
+
+    // Releasing SPXHANDLE_INVALID succeeds, as the C++ layer releases handles it may never have assigned.
+    template <class T>
+    SPXHR Remove(SPXHANDLE handle)
+    {
+        if (handle == SPXHANDLE_INVALID)
+        {
+            return SPX_NOERROR;
+        }
+
+        auto id = reinterpret_cast<uintptr_t>(handle);
+        auto& shard = m_shards[id % ShardCount];
+        std::shared_ptr<Object> object;
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            auto it = shard.objects.find(id);
+            if (it == shard.objects.end() || std::dynamic_pointer_cast<T>(it->second) == nullptr)
+            {
+                return SPXERR_INVALID_HANDLE;
+            }
+            object = std::move(it->second);
+            shard.objects.erase(it);
+        }
+
+        // The object is destroyed here, outside the lock, since destructors may join threads that use the table.
+        object.reset();
+        return SPX_NOERROR;
+    }
+
+private:
+
+    HandleTable() = default;
+
+    static constexpr size_t ShardCount = 16;
+
+    struct Shard
+    {
+        std::mutex lock;
+        std::unordered_map<uintptr_t, std::shared_ptr<Object>> objects;
+    };
+
+    std::atomic<uintptr_t> m_next { 1 };
+    Shard m_shards[ShardCount];
+};
+
+template <class T>
+std::shared_ptr<T> Get(SPXHANDLE handle)
+{
+    return HandleTable::Instance().Get<T>(handle);
+}
+
+template <class T>
+SPXHANDLE Add(std::shared_ptr<T> object)
+{
+    return HandleTable::Instance().Add(std::move(object));
+}
+
+template <class T>
+SPXHR Release(SPXHANDLE handle)
+{
+    return HandleTable::Instance().Remove<T>(handle);
+}
+
+template <class T>
+bool IsValid(SPXHANDLE handle)
+{
+    return Get<T>(handle) != nullptr;
+}
+
+/// <summary>
+/// Runs the body of an API function, translating exceptions into error codes; nothing may escape the C boundary.
+/// </summary>
+template <class F>
+SPXHR Try(F body)
+{
+    try
+    {
+        return body();
+    }
+    catch (const std::bad_alloc&)
+    {
+        return SPXERR_OUT_OF_MEMORY;
+    }
+    catch (...)
+    {
+        return SPXERR_UNHANDLED_EXCEPTION;
+    }
+}
+
+template <class T>
+SPXHR Store(SPXHANDLE* handle, std::shared_ptr<T> object)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, handle == nullptr);
+    *handle = Add(std::move(object));
+    return SPX_NOERROR;
+}
+
+/// <summary>
+/// Copies a string into a caller supplied buffer of cch characters, truncating it if needed.
+/// </summary>
+SPXHR CopyString(const std::string& value, char* buffer, uint32_t cch)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, buffer == nullptr || cch == 0);
+    auto size = std::min<size_t>(value.size(), cch - 1);
+    memcpy(buffer, value.data(), size);
+    buffer[size] = '\0';
+    return SPX_NOERROR;
+}
+
+/// <summary>
+/// Returns a heap copy of a string, to be released with property_bag_free_string or ai_core_string_free.
+/// </summary>
+const char* NewString(const char* value, size_t size)
+{
+    auto copy = new (std::nothrow) char[size + 1];
+    if (copy != nullptr)
+    {
+        memcpy(copy, value, size);
+        copy[size] = '\0';
+    }
+    return copy;
+}
+
+const char* NewString(const std::string& value)
+{
+    return NewString(value.data(), value.size());
+}
+
+std::string NewId(const char* prefix)
+{
+    static std::atomic<uint64_t> next { 1 };
+    char id[64];
+    snprintf(id, sizeof(id), "%s%016llx", prefix, static_cast<unsigned long long>(next.fetch_add(1, std::memory_order_relaxed)));
+    return id;
+}
+
+void Sleep(uint32_t milliseconds)
+{
+    if (milliseconds > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    }
+}
+
+std::string JsonEscape(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (auto ch : value)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += ch;
+    }
+    return escaped;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Property bags
+// ---------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Properties shared by an object and all property bag handles obtained from it.
+/// Properties set by id are stored under "#id", so the same property is not also reachable by its service name.
+/// </summary>
+class Properties
+{
+public:
+
+    static std::string Key(int id, const char* name)
+    {
+        return name != nullptr ? std::string(name) : "#" + std::to_string(id);
+    }
+
+    void Set(int id, const char* name, const char* value)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_values[Key(id, name)] = value != nullptr ? value : "";
+    }
+
+    void Set(PropertyId id, const std::string& value)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_values[Key(static_cast<int>(id), nullptr)] = value;
+    }
+
+    void Set(const char* name, const std::string& value)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_values[name] = value;
+    }
+
+    bool TryGet(int id, const char* name, std::string& value) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto it = m_values.find(Key(id, name));
+        if (it == m_values.end())
+        {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    uint32_t GetUInt(const char* name, uint32_t defaultValue) const
+    {
+        std::string value;
+        return TryGet(-1, name, value) && !value.empty() ? static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10)) : defaultValue;
+    }
+
+    uint32_t GetUInt(PropertyId id, uint32_t defaultValue) const
+    {
+        std::string value;
+        return TryGet(static_cast<int>(id), nullptr, value) && !value.empty() ? static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10)) : defaultValue;
+    }
+
+    void CopyTo(Properties& other) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        std::lock_guard<std::mutex> otherLock(other.m_lock);
+        for (auto& entry : m_values)
+        {
+            other.m_values[entry.first] = entry.second;
+        }
+    }
+
+private:
+
+    mutable std::mutex m_lock;
+    std::map<std::string, std::string> m_values;
+};
+
+class PropertyBag : public Object
+{
+public:
+    explicit PropertyBag(std::shared_ptr<Properties> properties) : m_properties(std::move(properties)) {}
+    std::shared_ptr<Properties> m_properties;
+};
+
+SPXHR GetPropertyBag(const std::shared_ptr<Properties>& properties, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Store(hpropbag, std::make_shared<PropertyBag>(properties));
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Configuration and audio input
+// ---------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Pacing of the synthetic events, see the top of this file.
+/// </summary>
+struct Workload
+{
+    explicit Workload(const Properties& properties) :
+        EventIntervalMs(properties.GetUInt("Loopback-EventIntervalMs", 10)),
+        RecognizingPerPhrase(properties.GetUInt("Loopback-RecognizingPerPhrase", 5)),
+        PayloadBytes(properties.GetUInt("Loopback-PayloadBytes", 64)),
+        LatencyMs(properties.GetUInt("Loopback-LatencyMs", 0)),
+        AudioBytes(properties.GetUInt("Loopback-AudioBytes", 32000) & ~1u),
+        SynthesizingChunks(std::max(1u, properties.GetUInt("Loopback-SynthesizingChunks", 10))),
+        AudioDriven(properties.GetUInt("Loopback-AudioDriven", 0) != 0)
+    {
+    }
+
+    uint32_t EventIntervalMs;
+    uint32_t RecognizingPerPhrase;
+    uint32_t PayloadBytes;
+    uint32_t LatencyMs;
+    uint32_t AudioBytes;
+    uint32_t SynthesizingChunks;
+    bool AudioDriven;
+};
+
+class SpeechConfig : public Object
+{
+public:
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+class AudioStreamFormat : public Object
+{
+};
+
+/// <summary>
+/// Push input stream. Written audio is only counted, unless an audio-driven recognizer reads the stream; closing the
+/// stream ends continuous recognition the way the end of the audio does with the service.
+/// </summary>
+class AudioInputStream : public Object
+{
+public:
+
+    // Samples of the audio kept for an audio-driven recognizer, at absolute byte offsets.
+    struct Reader
+    {
+        explicit Reader(AudioInputStream& stream) : m_stream(stream), m_lock(stream.m_lock) {}
+
+        // Waits up to the given time for audio or the end of the stream. Returns false once the stream is closed and
+        // every sample has been read.
+        bool Wait(std::chrono::milliseconds timeout)
+        {
+            m_stream.m_available.wait_for(m_lock, timeout, [this]() { return Available() || m_stream.m_closed; });
+            return Available() || !m_stream.m_closed;
+        }
+
+        bool Available() const { return m_stream.m_cursor + 2 <= m_stream.m_audioOffset + m_stream.m_audio.size(); }
+
+        uint64_t Cursor() const { return m_stream.m_cursor; }
+
+        int16_t Next()
+        {
+            auto index = static_cast<size_t>(m_stream.m_cursor - m_stream.m_audioOffset);
+            m_stream.m_cursor += 2;
+            return static_cast<int16_t>(m_stream.m_audio[index] | (m_stream.m_audio[index + 1] << 8));
+        }
+
+        // Drops the audio before the given offset, which is never read again, once it is at least half of the kept audio.
+        void Discard(uint64_t offset)
+        {
+            const size_t threshold = 64 * 1024;
+            auto count = static_cast<size_t>(offset - m_stream.m_audioOffset);
+            if (count >= threshold && count >= m_stream.m_audio.size() / 2)
+            {
+                m_stream.m_audio.erase(m_stream.m_audio.begin(), m_stream.m_audio.begin() + count);
+                m_stream.m_audioOffset = offset;
+            }
+        }
+
+        bool Closed() const { return m_stream.m_closed; }
+
+    private:
+        AudioInputStream& m_stream;
+        std::unique_lock<std::mutex> m_lock;
+    };
+
+    void KeepAudio()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_keepAudio = true;
+    }
+
+    void Write(const uint8_t* buffer, uint32_t size)
+    {
+        m_bytesWritten += size;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (!m_keepAudio || buffer == nullptr)
+            {
+                return;
+            }
+            m_audio.insert(m_audio.end(), buffer, buffer + size);
+        }
+        m_available.notify_all();
+    }
+
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closed = true;
+        }
+        m_available.notify_all();
+    }
+
+    std::atomic<uint64_t> m_bytesWritten { 0 };
+    std::atomic<bool> m_closed { false };
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_available;
+    bool m_keepAudio = false;
+    std::vector<uint8_t> m_audio;
+    uint64_t m_audioOffset = 0;
+    uint64_t m_cursor = 0;
+};
+
+/// <summary>
+/// Pull output stream. Nothing synthesizes into it; the loopback hooks write and close it, and reads block until
+/// audio arrives or the stream is closed, as with the service.
+/// </summary>
+class PullAudioOutputStream : public Object
+{
+public:
+
+    void Write(const uint8_t* buffer, uint32_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_audio.insert(m_audio.end(), buffer, buffer + size);
+        }
+        m_available.notify_all();
+    }
+
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closed = true;
+        }
+        m_available.notify_all();
+    }
+
+    // Returns 0 once the stream is closed and every byte has been read.
+    uint32_t Read(uint8_t* buffer, uint32_t size)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_available.wait(lock, [this]() { return m_readPos < m_audio.size() || m_closed; });
+
+        auto count = static_cast<uint32_t>(std::min<size_t>(size, m_audio.size() - m_readPos));
+        std::memcpy(buffer, m_audio.data() + m_readPos, count);
+        m_readPos += count;
+        if (m_readPos == m_audio.size())
+        {
+            m_audio.clear();
+            m_readPos = 0;
+        }
+        return count;
+    }
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_available;
+    std::vector<uint8_t> m_audio;
+    size_t m_readPos = 0;
+    bool m_closed = false;
+};
+
+class AudioConfig : public Object
+{
+public:
+    std::shared_ptr<AudioInputStream> m_stream;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+SPXHR CreateSpeechConfig(SPXSPEECHCONFIGHANDLE* hconfig, std::initializer_list<std::pair<PropertyId, const char*>> values)
+{
+    auto config = std::make_shared<SpeechConfig>();
+    for (auto& value : values)
+    {
+        if (value.second != nullptr)
+        {
+            config->m_properties->Set(value.first, value.second);
+        }
+    }
+    return Store(hconfig, config);
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Recognition
+// ---------------------------------------------------------------------------------------------------------------
+
+class RecognitionResult : public Object
+{
+public:
+    std::string m_id = NewId("");
+    Result_Reason m_reason = ResultReason_NoMatch;
+    std::string m_text;
+    uint64_t m_offset = 0;
+    uint64_t m_duration = 0;
+    Result_CancellationReason m_cancellationReason = CancellationReason_Error;
+    Result_CancellationErrorCode m_errorCode = CancellationErrorCode_NoError;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+/// <summary>
+/// Session, recognition and connection events. Each callback receives its own event handle, which the C++ layer
+/// releases once the event has been dispatched.
+/// </summary>
+class RecognitionEvent : public Object
+{
+public:
+    std::string m_sessionId;
+    uint64_t m_offset = 0;
+    std::shared_ptr<RecognitionResult> m_result;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+class ConnectionMessage : public Object
+{
+public:
+    std::string m_data;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+class ConnectionMessageEvent : public Object
+{
+public:
+    std::shared_ptr<ConnectionMessage> m_message;
+};
+
+std::shared_ptr<ConnectionMessageEvent> MakeMessageEvent(const char* path, std::string data, bool binary)
+{
+    auto message = std::make_shared<ConnectionMessage>();
+    message->m_properties->Set("connection.message.path", path);
+    message->m_properties->Set("connection.message.type", binary ? "binary" : "text");
+    if (!binary)
+    {
+        message->m_properties->Set("connection.message.text.message", data);
+        message->m_properties->Set("Content-Type", "application/json; charset=utf-8");
+    }
+    message->m_data = std::move(data);
+
+    auto event = std::make_shared<ConnectionMessageEvent>();
+    event->m_message = std::move(message);
+    return event;
+}
+
+template <class F>
+struct Callback
+{
+    F Function = nullptr;
+    void* Context = nullptr;
+};
+
+/// <summary>
+/// Callbacks registered through one connection handle. Cleared when the handle is released, since the C++ connection
+/// behind the context goes away with it while the recognizer may keep running.
+/// </summary>
+class ConnectionCallbacks
+{
+public:
+
+    void Set(Callback<CONNECTION_CALLBACK_FUNC>& callback, CONNECTION_CALLBACK_FUNC function, void* context)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_lock);
+        callback.Function = function;
+        callback.Context = context;
+    }
+
+    // Callbacks are invoked while holding the lock, so clearing a callback waits for a call in flight to return and
+    // the C++ object behind the context cannot be destroyed under it.
+    template <class MakeEvent>
+    void Fire(Callback<CONNECTION_CALLBACK_FUNC>& callback, MakeEvent makeEvent)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_lock);
+        if (callback.Function != nullptr)
+        {
+            callback.Function(Add(makeEvent()), callback.Context);
+        }
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_lock);
+        Connected = {};
+        Disconnected = {};
+        MessageReceived = {};
+    }
+
+    Callback<CONNECTION_CALLBACK_FUNC> Connected;
+    Callback<CONNECTION_CALLBACK_FUNC> Disconnected;
+    Callback<CONNECTION_CALLBACK_FUNC> MessageReceived;
+
+private:
+    std::recursive_mutex m_lock;
+};
+
+/// <summary>
+/// Connections obtained from a recognizer, each of which receives its connection events.
+/// </summary>
+class ConnectionList
+{
+public:
+
+    void Add(const std::shared_ptr<ConnectionCallbacks>& callbacks)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_connections.erase(std::remove_if(m_connections.begin(), m_connections.end(),
+            [](const std::weak_ptr<ConnectionCallbacks>& connection) { return connection.expired(); }), m_connections.end());
+        m_connections.push_back(callbacks);
+    }
+
+    template <class MakeEvent>
+    void Fire(Callback<CONNECTION_CALLBACK_FUNC> ConnectionCallbacks::* callback, MakeEvent makeEvent)
+    {
+        std::vector<std::shared_ptr<ConnectionCallbacks>> live;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            for (auto& connection : m_connections)
+            {
+                if (auto callbacks = connection.lock())
+                {
+                    live.push_back(std::move(callbacks));
+                }
+            }
+        }
+
+        for (auto& callbacks : live)
+        {
+            callbacks->Fire((*callbacks).*callback, makeEvent);
+        }
+    }
+
+private:
+    std::mutex m_lock;
+    std::vector<std::weak_ptr<ConnectionCallbacks>> m_connections;
+};
+
+class Connection : public Object
+{
+public:
+    std::shared_ptr<ConnectionCallbacks> m_callbacks = std::make_shared<ConnectionCallbacks>();
+    std::shared_ptr<Properties> m_properties;
+};
+
+// Number of continuous recognitions still to be canceled with a connection failure, set by loopback_recognition_fail.
+std::atomic<uint32_t> g_pendingFailures { 0 };
+
+class Recognizer : public Object, public std::enable_shared_from_this<Recognizer>
+{
+public:
+
+    Recognizer(const SpeechConfig& config, std::shared_ptr<AudioInputStream> stream) :
+        m_stream(std::move(stream)),
+        m_workload((config.m_properties->CopyTo(*m_properties), *m_properties))
+    {
+        if (m_workload.AudioDriven && m_stream != nullptr)
+        {
+            m_stream->KeepAudio();
+        }
+    }
+
+    ~Recognizer()
+    {
+        Stop();
+    }
+
+    void SetCallback(Callback<PRECOGNITION_CALLBACK_FUNC>& callback, PRECOGNITION_CALLBACK_FUNC function, void* context)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_callbackLock);
+        callback.Function = function;
+        callback.Context = context;
+    }
+
+    SPXHR StartContinuous()
+    {
+        std::lock_guard<std::mutex> lock(m_stateLock);
+        SPX_RETURN_HR_IF(SPXERR_START_RECOGNIZING_INVALID_STATE_TRANSITION, m_busy);
+        // The previous worker, if any, has finished: it clears m_busy as its last step.
+        Join(m_worker);
+
+        m_busy = true;
+        m_stopRequested = false;
+        auto self = shared_from_this();
+        m_worker = std::thread([self]() { self->RunContinuous(); });
+        return SPX_NOERROR;
+    }
+
+    SPXHR Stop()
+    {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> lock(m_stateLock);
+            m_stopRequested = true;
+            worker = std::move(m_worker);
+        }
+        m_wake.notify_all();
+
+        // Joined outside the lock, which the worker needs to observe the stop request and to finish.
+        Join(worker);
+        return SPX_NOERROR;
+    }
+
+    SPXHR RecognizeOnce(std::shared_ptr<RecognitionResult>& result)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_stateLock);
+            SPX_RETURN_HR_IF(SPXERR_START_RECOGNIZING_INVALID_STATE_TRANSITION, m_busy);
+            m_busy = true;
+            m_stopRequested = false;
+        }
+
+        auto sessionId = NewId("");
+        auto start = std::chrono::steady_clock::now();
+        Sleep(m_workload.LatencyMs);
+        FireSession(m_sessionStarted, sessionId);
+        if (AudioDriven())
+        {
+            Phrase phrase;
+            result = NextPhrase(phrase) ? RunAudioPhrase(sessionId, phrase, 0) : MakeResult(ResultReason_NoMatch, "", 0, 0);
+        }
+        else
+        {
+            result = RunPhrase(sessionId, start, 0);
+        }
+        FireSession(m_sessionStopped, sessionId);
+
+        std::lock_guard<std::mutex> lock(m_stateLock);
+        m_busy = false;
+        return SPX_NOERROR;
+    }
+
+    std::shared_ptr<Connection> GetConnection()
+    {
+        auto connection = std::make_shared<Connection>();
+        connection->m_properties = m_properties;
+        m_connections.Add(connection->m_callbacks);
+        return connection;
+    }
+
+    SPXRECOHANDLE m_handle = SPXHANDLE_INVALID;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+
+    Callback<PSESSION_CALLBACK_FUNC> m_sessionStarted;
+    Callback<PSESSION_CALLBACK_FUNC> m_sessionStopped;
+    Callback<PRECOGNITION_CALLBACK_FUNC> m_speechStartDetected;
+    Callback<PRECOGNITION_CALLBACK_FUNC> m_speechEndDetected;
+    Callback<PRECOGNITION_CALLBACK_FUNC> m_recognizing;
+    Callback<PRECOGNITION_CALLBACK_FUNC> m_recognized;
+    Callback<PRECOGNITION_CALLBACK_FUNC> m_canceled;
+
+    std::recursive_mutex m_callbackLock;
+    ConnectionList m_connections;
+
+private:
+
+    static void Join(std::thread& worker)
+    {
+        if (worker.joinable())
+        {
+            // A callback stopping or releasing its own recognizer must not join its own thread.
+            if (worker.get_id() == std::this_thread::get_id())
+            {
+                worker.detach();
+            }
+            else
+            {
+                worker.join();
+            }
+        }
+    }
+
+    bool WaitOrStop(uint32_t milliseconds)
+    {
+        std::unique_lock<std::mutex> lock(m_stateLock);
+        return m_wake.wait_for(lock, std::chrono::milliseconds(milliseconds), [this]() { return m_stopRequested; });
+    }
+
+    bool StopRequested()
+    {
+        std::lock_guard<std::mutex> lock(m_stateLock);
+        return m_stopRequested;
+    }
+
+    void RunContinuous()
+    {
+        auto sessionId = NewId("");
+        auto start = std::chrono::steady_clock::now();
+
+        if (!WaitOrStop(m_workload.LatencyMs))
+        {
+            FireSession(m_sessionStarted, sessionId);
+            FireConnected(&ConnectionCallbacks::Connected, sessionId);
+
+            for (uint32_t phrase = 0; !StopRequested(); phrase++)
+            {
+                if (AudioDriven())
+                {
+                    Phrase audio;
+                    if (!NextPhrase(audio))
+                    {
+                        if (!StopRequested())
+                        {
+                            FireCanceledEndOfStream(sessionId, start);
+                        }
+                        break;
+                    }
+                    RunAudioPhrase(sessionId, audio, phrase);
+                    if (TakeFailure())
+                    {
+                        FireCanceledError(sessionId, start);
+                        break;
+                    }
+                    continue;
+                }
+
+                RunPhrase(sessionId, start, phrase);
+                if (TakeFailure())
+                {
+                    FireCanceledError(sessionId, start);
+                    break;
+                }
+                if (m_stream != nullptr && m_stream->m_closed)
+                {
+                    FireCanceledEndOfStream(sessionId, start);
+                    break;
+                }
+            }
+
+            FireConnected(&ConnectionCallbacks::Disconnected, sessionId);
+            FireSession(m_sessionStopped, sessionId);
+        }
+
+        std::lock_guard<std::mutex> lock(m_stateLock);
+        m_busy = false;
+    }
+
+    std::shared_ptr<RecognitionResult> RunPhrase(const std::string& sessionId, std::chrono::steady_clock::time_point start, uint32_t phrase)
+    {
+        auto phraseOffset = Elapsed(start);
+        FireRecognition(m_speechStartDetected, sessionId, phraseOffset, nullptr);
+
+        auto words = std::max(1u, m_workload.RecognizingPerPhrase);
+        for (uint32_t i = 0; i < m_workload.RecognizingPerPhrase; i++)
+        {
+            if (WaitOrStop(m_workload.EventIntervalMs))
+            {
+                break;
+            }
+            auto partial = MakeResult(ResultReason_RecognizingSpeech, PhraseText(phrase, i + 1), phraseOffset, Elapsed(start) - phraseOffset);
+            FireRecognition(m_recognizing, sessionId, partial->m_offset, partial);
+        }
+
+        Sleep(m_workload.EventIntervalMs);
+        auto result = MakeResult(ResultReason_RecognizedSpeech, PhraseText(phrase, words), phraseOffset, Elapsed(start) - phraseOffset);
+        FireRecognition(m_recognized, sessionId, result->m_offset, result);
+        FireMessage(sessionId, result);
+        FireRecognition(m_speechEndDetected, sessionId, Elapsed(start), nullptr);
+        return result;
+    }
+
+    // A run of audio of an audio-driven recognizer, in bytes from the start of the stream.
+    struct Phrase
+    {
+        uint64_t Begin = 0;
+        uint64_t End = 0;
+        int16_t FirstSample = 0;
+    };
+
+    bool AudioDriven() const
+    {
+        return m_workload.AudioDriven && m_stream != nullptr;
+    }
+
+    // Reads the next phrase from the stream: skips silence, then reads until the segmentation silence, the maximum
+    // phrase length or the end of the stream. Returns false at the end of the stream or when stopped.
+    bool NextPhrase(Phrase& phrase)
+    {
+        const auto pollInterval = std::chrono::milliseconds(10);
+        const uint64_t maxPhraseBytes = uint64_t(MaxPhraseMs) * BytesPerMillisecond;
+        const uint64_t silenceBytes = uint64_t(m_properties->GetUInt(PropertyId::Speech_SegmentationSilenceTimeoutMs, 500)) * BytesPerMillisecond;
+
+        AudioInputStream::Reader reader(*m_stream);
+        bool inPhrase = false;
+        uint64_t silence = 0;
+        for (;;)
+        {
+            if (!reader.Available())
+            {
+                if (reader.Closed())
+                {
+                    return inPhrase;
+                }
+                if (StopRequested())
+                {
+                    return false;
+                }
+                reader.Wait(pollInterval);
+                continue;
+            }
+
+            auto sample = reader.Next();
+            if (!inPhrase)
+            {
+                if (sample != 0)
+                {
+                    inPhrase = true;
+                    phrase.Begin = reader.Cursor() - 2;
+                    phrase.End = reader.Cursor();
+                    phrase.FirstSample = sample;
+                }
+                continue;
+            }
+
+            if (sample != 0)
+            {
+                phrase.End = reader.Cursor();
+                silence = 0;
+            }
+            else
+            {
+                silence += 2;
+            }
+
+            if (silence >= silenceBytes || reader.Cursor() - phrase.Begin >= maxPhraseBytes)
+            {
+                reader.Discard(reader.Cursor());
+                return true;
+            }
+        }
+    }
+
+    std::shared_ptr<RecognitionResult> RunAudioPhrase(const std::string& sessionId, const Phrase& audio, uint32_t phrase)
+    {
+        auto offset = audio.Begin * TicksPerMillisecond / BytesPerMillisecond;
+        auto duration = (audio.End - audio.Begin) * TicksPerMillisecond / BytesPerMillisecond;
+        auto text = "loopback phrase " + std::to_string(phrase) + " sample " + std::to_string(audio.FirstSample);
+        FireRecognition(m_speechStartDetected, sessionId, offset, nullptr);
+
+        for (uint32_t i = 0; i < m_workload.RecognizingPerPhrase; i++)
+        {
+            if (WaitOrStop(m_workload.EventIntervalMs))
+            {
+                break;
+            }
+            auto partial = MakeResult(ResultReason_RecognizingSpeech, text, offset, duration * (i + 1) / (m_workload.RecognizingPerPhrase + 1));
+            FireRecognition(m_recognizing, sessionId, offset, partial);
+        }
+
+        Sleep(m_workload.EventIntervalMs);
+        auto result = MakeResult(ResultReason_RecognizedSpeech, text, offset, duration);
+        FireRecognition(m_recognized, sessionId, offset, result);
+        FireMessage(sessionId, result);
+        FireRecognition(m_speechEndDetected, sessionId, offset + duration, nullptr);
+        return result;
+    }
+
+    void FireCanceledEndOfStream(const std::string& sessionId, std::chrono::steady_clock::time_point start)
+    {
+        auto result = std::make_shared<RecognitionResult>();
+        result->m_reason = ResultReason_Canceled;
+        result->m_offset = AudioDriven() ? m_stream->m_bytesWritten * TicksPerMillisecond / BytesPerMillisecond : Elapsed(start);
+        result->m_cancellationReason = CancellationReason_EndOfStream;
+        FireRecognition(m_canceled, sessionId, result->m_offset, result);
+    }
+
+    static bool TakeFailure()
+    {
+        auto pending = g_pendingFailures.load();
+        while (pending != 0 && !g_pendingFailures.compare_exchange_weak(pending, pending - 1))
+        {
+        }
+        return pending != 0;
+    }
+
+    void FireCanceledError(const std::string& sessionId, std::chrono::steady_clock::time_point start)
+    {
+        auto result = std::make_shared<RecognitionResult>();
+        result->m_reason = ResultReason_Canceled;
+        result->m_offset = AudioDriven() ? m_stream->m_bytesWritten * TicksPerMillisecond / BytesPerMillisecond : Elapsed(start);
+        result->m_cancellationReason = CancellationReason_Error;
+        result->m_errorCode = CancellationErrorCode_ConnectionFailure;
+        result->m_properties->Set(PropertyId::SpeechServiceResponse_JsonErrorDetails, "Loopback connection failure. SessionId: " + sessionId);
+        FireRecognition(m_canceled, sessionId, result->m_offset, result);
+    }
+
+    static uint64_t Elapsed(std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()) * 10;
+    }
+
+    static std::string PhraseText(uint32_t phrase, uint32_t words)
+    {
+        std::string text = "loopback phrase " + std::to_string(phrase);
+        for (uint32_t i = 0; i < words; i++)
+        {
+            text += " word";
+        }
+        return text;
+    }
+
+    std::shared_ptr<RecognitionResult> MakeResult(Result_Reason reason, const std::string& text, uint64_t offset, uint64_t duration)
+    {
+        auto result = std::make_shared<RecognitionResult>();
+        result->m_reason = reason;
+        result->m_text = text;
+        result->m_offset = offset;
+        result->m_duration = duration;
+
+        auto escaped = JsonEscape(text);
+        std::string json;
+        json.reserve(m_workload.PayloadBytes + 256);
+        json += "{\"Id\":\"" + result->m_id + "\",\"RecognitionStatus\":\"Success\",\"Offset\":" + std::to_string(offset) +
+            ",\"Duration\":" + std::to_string(duration) + ",\"DisplayText\":\"" + escaped + "\",\"NBest\":[{\"Confidence\":0.9,\"Lexical\":\"" +
+            escaped + "\",\"ITN\":\"" + escaped + "\",\"MaskedITN\":\"" + escaped + "\",\"Display\":\"" + escaped + "\",\"Padding\":\"";
+        const size_t closing = 4;
+        if (json.size() + closing < m_workload.PayloadBytes)
+        {
+            json.append(m_workload.PayloadBytes - json.size() - closing, 'x');
+        }
+        json += "\"}]}";
+        result->m_properties->Set(PropertyId::SpeechServiceResponse_JsonResult, json);
+        return result;
+    }
+
+    void FireSession(Callback<PSESSION_CALLBACK_FUNC>& callback, const std::string& sessionId)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_callbackLock);
+        if (callback.Function != nullptr)
+        {
+            auto event = std::make_shared<RecognitionEvent>();
+            event->m_sessionId = sessionId;
+            callback.Function(m_handle, Add(event), callback.Context);
+        }
+    }
+
+    void FireRecognition(Callback<PRECOGNITION_CALLBACK_FUNC>& callback, const std::string& sessionId, uint64_t offset, std::shared_ptr<RecognitionResult> result)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_callbackLock);
+        if (callback.Function != nullptr)
+        {
+            auto event = std::make_shared<RecognitionEvent>();
+            event->m_sessionId = sessionId;
+            event->m_offset = offset;
+            event->m_result = std::move(result);
+            callback.Function(m_handle, Add(event), callback.Context);
+        }
+    }
+
+    void FireConnected(Callback<CONNECTION_CALLBACK_FUNC> ConnectionCallbacks::* callback, const std::string& sessionId)
+    {
+        m_connections.Fire(callback, [&]() {
+            auto event = std::make_shared<RecognitionEvent>();
+            event->m_sessionId = sessionId;
+            return event;
+        });
+    }
+
+    void FireMessage(const std::string& sessionId, const std::shared_ptr<RecognitionResult>& result)
+    {
+        m_connections.Fire(&ConnectionCallbacks::MessageReceived, [&]() {
+            std::string json;
+            result->m_properties->TryGet(static_cast<int>(PropertyId::SpeechServiceResponse_JsonResult), nullptr, json);
+            auto event = MakeMessageEvent("speech.phrase", std::move(json), false);
+            event->m_message->m_properties->Set("X-RequestId", sessionId);
+            return event;
+        });
+    }
+
+    std::shared_ptr<AudioInputStream> m_stream;
+    Workload m_workload;
+
+    std::mutex m_stateLock;
+    std::condition_variable m_wake;
+    std::thread m_worker;
+    bool m_busy = false;
+    bool m_stopRequested = false;
+};
+
+// ---------------------------------------------------------------------------------------------------------------
+// Synthesis
+// ---------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Audio of one utterance, appended while it is synthesized. Audio data streams read from it as it grows.
+/// </summary>
+class AudioBuffer
+{
+public:
+
+    void Append(const uint8_t* data, size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_data.insert(m_data.end(), data, data + size);
+        }
+        m_changed.notify_all();
+    }
+
+    void Complete(bool canceled)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_complete = true;
+            m_canceled = canceled;
+        }
+        m_changed.notify_all();
+    }
+
+    // Copies up to size bytes from position, waiting for them unless the utterance is complete.
+    uint32_t Read(uint8_t* buffer, uint32_t size, uint32_t position, bool wait)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (wait)
+        {
+            m_changed.wait(lock, [&]() { return m_complete || m_data.size() >= size_t(position) + size; });
+        }
+        if (position >= m_data.size())
+        {
+            return 0;
+        }
+        auto count = static_cast<uint32_t>(std::min<size_t>(size, m_data.size() - position));
+        memcpy(buffer, m_data.data() + position, count);
+        return count;
+    }
+
+    std::vector<uint8_t> Snapshot(bool waitForCompletion)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (waitForCompletion)
+        {
+            m_changed.wait(lock, [&]() { return m_complete; });
+        }
+        return m_data;
+    }
+
+    size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_data.size();
+    }
+
+    bool IsComplete() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_complete;
+    }
+
+    bool IsCanceled() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_canceled;
+    }
+
+private:
+    mutable std::mutex m_lock;
+    std::condition_variable m_changed;
+    std::vector<uint8_t> m_data;
+    bool m_complete = false;
+    bool m_canceled = false;
+};
+
+// 440 Hz tone, so saved files are audibly non-empty.
+void MakeTone(std::vector<uint8_t>& chunk, uint32_t byteOffset, uint32_t size)
+{
+    chunk.resize(size);
+    for (uint32_t i = 0; i + 1 < size; i += 2)
+    {
+        auto sample = static_cast<int16_t>(8000 * std::sin(2 * 3.14159265358979 * 440 * ((byteOffset + i) / 2) / SamplesPerSecond));
+        chunk[i] = static_cast<uint8_t>(sample & 0xFF);
+        chunk[i + 1] = static_cast<uint8_t>((sample >> 8) & 0xFF);
+    }
+}
+
+class SynthesisResult : public Object
+{
+public:
+    std::string m_id;
+    Result_Reason m_reason = ResultReason_SynthesizingAudio;
+    std::shared_ptr<AudioBuffer> m_audio = std::make_shared<AudioBuffer>();
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+class SynthesisEvent : public Object
+{
+public:
+    std::shared_ptr<SynthesisResult> m_result;
+    std::string m_resultId;
+    std::string m_text;
+    uint64_t m_audioOffset = 0;
+    uint64_t m_duration = 0;
+    uint32_t m_textOffset = 0;
+    uint32_t m_wordLength = 0;
+};
+
+struct Voice
+{
+    const char* Name;
+    const char* Locale;
+    const char* ShortName;
+    const char* LocalName;
+    const char* StyleList;
+};
+
+const Voice Voices[] = {
+    { "Microsoft Server Speech Text to Speech Voice (en-US, JennyNeural)", "en-US", "en-US-JennyNeural", "Jenny", "chat|cheerful|sad" },
+    { "Microsoft Server Speech Text to Speech Voice (en-US, GuyNeural)", "en-US", "en-US-GuyNeural", "Guy", "newscast" },
+    { "Microsoft Server Speech Text to Speech Voice (ja-JP, NanamiNeural)", "ja-JP", "ja-JP-NanamiNeural", "Nanami", "chat|cheerful" },
+    { "Microsoft Server Speech Text to Speech Voice (zh-CN, XiaoxiaoNeural)", "zh-CN", "zh-CN-XiaoxiaoNeural", "Xiaoxiao", "assistant|chat" },
+};
+
+class VoiceInfo : public Object
+{
+public:
+    explicit VoiceInfo(const Voice& voice) : m_voice(voice) {}
+    const Voice& m_voice;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+class VoicesResult : public Object
+{
+public:
+    std::string m_id = NewId("");
+    std::vector<const Voice*> m_voices;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+class Synthesizer : public Object
+{
+public:
+
+    explicit Synthesizer(const SpeechConfig& config) : m_workload((config.m_properties->CopyTo(*m_properties), *m_properties))
+    {
+    }
+
+    void SetCallback(Callback<PSYNTHESIS_CALLBACK_FUNC>& callback, PSYNTHESIS_CALLBACK_FUNC function, void* context)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_callbackLock);
+        callback.Function = function;
+        callback.Context = context;
+    }
+
+    // Creates the result of an utterance and raises SynthesisStarted; the audio is produced by Synthesize.
+    std::shared_ptr<SynthesisResult> Begin()
+    {
+        auto result = std::make_shared<SynthesisResult>();
+        result->m_id = NewId("");
+        result->m_reason = ResultReason_SynthesizingAudioStart;
+        m_stopRequested = false;
+
+        Sleep(m_workload.LatencyMs);
+        Fire(m_started, result);
+        return result;
+    }
+
+    // Produces the audio of an utterance in chunks, raising Synthesizing and WordBoundary events as it goes.
+    std::shared_ptr<SynthesisResult> Synthesize(const std::shared_ptr<SynthesisResult>& started, const std::string& text)
+    {
+        auto words = SplitWords(text);
+        auto chunkBytes = (m_workload.AudioBytes / m_workload.SynthesizingChunks) & ~1u;
+        std::vector<uint8_t> chunk;
+        uint32_t produced = 0;
+
+        for (uint32_t i = 0; i < m_workload.SynthesizingChunks && !m_stopRequested; i++)
+        {
+            Sleep(m_workload.EventIntervalMs);
+
+            auto size = i + 1 == m_workload.SynthesizingChunks ? m_workload.AudioBytes - produced : chunkBytes;
+            MakeTone(chunk, produced, size);
+            started->m_audio->Append(chunk.data(), chunk.size());
+
+            auto event = std::make_shared<SynthesisResult>();
+            event->m_id = started->m_id;
+            event->m_audio->Append(chunk.data(), chunk.size());
+            event->m_audio->Complete(false);
+            Fire(m_synthesizing, event);
+
+            if (i < words.size())
+            {
+                FireWordBoundary(started->m_id, text, words[i], produced);
+            }
+            produced += size;
+        }
+
+        auto canceled = m_stopRequested.load();
+        started->m_audio->Complete(canceled);
+
+        auto result = std::make_shared<SynthesisResult>();
+        result->m_id = started->m_id;
+        result->m_reason = canceled ? ResultReason_Canceled : ResultReason_SynthesizingAudioComplete;
+        result->m_audio = started->m_audio;
+        Fire(canceled ? m_canceled : m_completed, result);
+        return result;
+    }
+
+    void StopSpeaking()
+    {
+        m_stopRequested = true;
+    }
+
+    SPXSYNTHHANDLE m_handle = SPXHANDLE_INVALID;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+
+    Callback<PSYNTHESIS_CALLBACK_FUNC> m_started;
+    Callback<PSYNTHESIS_CALLBACK_FUNC> m_synthesizing;
+    Callback<PSYNTHESIS_CALLBACK_FUNC> m_completed;
+    Callback<PSYNTHESIS_CALLBACK_FUNC> m_canceled;
+    Callback<PSYNTHESIS_CALLBACK_FUNC> m_wordBoundary;
+    Callback<PSYNTHESIS_CALLBACK_FUNC> m_visemeReceived;
+    Callback<PSYNTHESIS_CALLBACK_FUNC> m_bookmarkReached;
+
+private:
+
+    static std::vector<std::pair<uint32_t, uint32_t>> SplitWords(const std::string& text)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> words;
+        size_t position = 0;
+        while (position < text.size())
+        {
+            auto begin = text.find_first_not_of(" \t\r\n", position);
+            if (begin == std::string::npos)
+            {
+                break;
+            }
+            auto end = std::min(text.find_first_of(" \t\r\n", begin), text.size());
+            words.emplace_back(static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin));
+            position = end;
+        }
+        return words;
+    }
+
+    void Fire(Callback<PSYNTHESIS_CALLBACK_FUNC>& callback, const std::shared_ptr<SynthesisResult>& result)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_callbackLock);
+        if (callback.Function != nullptr)
+        {
+            auto event = std::make_shared<SynthesisEvent>();
+            event->m_result = result;
+            event->m_resultId = result->m_id;
+            callback.Function(m_handle, Add(event), callback.Context);
+        }
+    }
+
+    void FireWordBoundary(const std::string& resultId, const std::string& text, std::pair<uint32_t, uint32_t> word, uint32_t byteOffset)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_callbackLock);
+        if (m_wordBoundary.Function != nullptr)
+        {
+            auto event = std::make_shared<SynthesisEvent>();
+            event->m_resultId = resultId;
+            event->m_text = text.substr(word.first, word.second);
+            event->m_textOffset = word.first;
+            event->m_wordLength = word.second;
+            event->m_audioOffset = byteOffset / BytesPerMillisecond * TicksPerMillisecond;
+            event->m_duration = m_workload.EventIntervalMs * TicksPerMillisecond;
+            m_wordBoundary.Function(m_handle, Add(event), m_wordBoundary.Context);
+        }
+    }
+
+    Workload m_workload;
+    std::recursive_mutex m_callbackLock;
+    std::atomic<bool> m_stopRequested { false };
+};
+
+/// <summary>
+/// Reads the audio of a synthesis result, blocking until the requested bytes have been synthesized.
+/// </summary>
+class AudioDataStream : public Object
+{
+public:
+    std::shared_ptr<AudioBuffer> m_audio;
+    uint32_t m_position = 0;
+    std::shared_ptr<Properties> m_properties = std::make_shared<Properties>();
+};
+
+// ---------------------------------------------------------------------------------------------------------------
+// Asynchronous operations
+// ---------------------------------------------------------------------------------------------------------------
+
+struct Outcome
+{
+    SPXHR Result = SPX_NOERROR;
+    std::shared_ptr<Object> Value;
+};
+
+class AsyncOperation : public Object
+{
+public:
+
+    template <class F>
+    static SPXHR Run(SPXASYNCHANDLE* phasync, F work)
+    {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, phasync == nullptr);
+        auto operation = std::make_shared<AsyncOperation>();
+        operation->m_future = std::async(std::launch::async, [work]() { Outcome outcome; outcome.Result = Try([&]() -> SPXHR { return work(outcome.Value); }); return outcome; }).share();
+        *phasync = Add(operation);
+        return SPX_NOERROR;
+    }
+
+    SPXHR Wait(uint32_t milliseconds, SPXHANDLE* phresult = nullptr)
+    {
+        if (milliseconds == UINT32_MAX)
+        {
+            m_future.wait();
+        }
+        else if (m_future.wait_for(std::chrono::milliseconds(milliseconds)) != std::future_status::ready)
+        {
+            return SPXERR_TIMEOUT;
+        }
+
+        auto& outcome = m_future.get();
+        if (phresult != nullptr)
+        {
+            *phresult = SPXHANDLE_INVALID;
+            if (outcome.Result == SPX_NOERROR && outcome.Value != nullptr)
+            {
+                *phresult = Add(outcome.Value);
+            }
+        }
+        return outcome.Result;
+    }
+
+private:
+    std::shared_future<Outcome> m_future;
+};
+
+SPXHR WaitFor(SPXASYNCHANDLE hasync, uint32_t milliseconds, SPXHANDLE* phresult = nullptr)
+{
+    auto operation = Get<AsyncOperation>(hasync);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, operation == nullptr);
+    return operation->Wait(milliseconds, phresult);
+}
+
+SPXHR SpeakAsync(SPXSYNTHHANDLE hsynth, const char* text, uint32_t length, bool waitForCompletion, SPXASYNCHANDLE* phasync)
+{
+    auto synthesizer = Get<Synthesizer>(hsynth);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, synthesizer == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, text == nullptr);
+
+    std::string input(text, length);
+    if (waitForCompletion)
+    {
+        return AsyncOperation::Run(phasync, [synthesizer, input](std::shared_ptr<Object>& result) -> SPXHR {
+            result = synthesizer->Synthesize(synthesizer->Begin(), input);
+            return SPX_NOERROR;
+        });
+    }
+
+    // Start speaking returns once synthesis has started; the rest of the utterance is produced in the background
+    // and read through an audio data stream.
+    return AsyncOperation::Run(phasync, [synthesizer, input](std::shared_ptr<Object>& result) -> SPXHR {
+        auto started = synthesizer->Begin();
+        std::thread([synthesizer, started, input]() { synthesizer->Synthesize(started, input); }).detach();
+        result = started;
+        return SPX_NOERROR;
+    });
+}
+
+SPXHR Speak(SPXSYNTHHANDLE hsynth, const char* text, uint32_t length, bool waitForCompletion, SPXRESULTHANDLE* phresult)
+{
+    SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+    SPX_RETURN_ON_FAIL(SpeakAsync(hsynth, text, length, waitForCompletion, &hasync));
+    auto hr = WaitFor(hasync, UINT32_MAX, phresult);
+    Release<AsyncOperation>(hasync);
+    return hr;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// JSON
+// ---------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Parsed JSON text as a flat list of items referring into the parser's copy of the text, so string views stay valid
+/// for the lifetime of the parser. Members of an object are value items linked to a separate name item.
+/// </summary>
+class JsonParser : public Object
+{
+public:
+
+    struct Item
+    {
+        char Kind = 0;          // '{', '[', '"', '1' (number), 't', 'f' or 'n'
+        const char* Data = nullptr;
+        size_t Size = 0;        // raw text; strings exclude the quotes
+        int FirstChild = -1;
+        int Next = -1;
+        int Name = -1;
+        int Count = 0;
+    };
+
+    bool Parse(const char* json, size_t size)
+    {
+        m_text.assign(json, size);
+        m_position = m_text.data();
+        m_end = m_position + size;
+        auto root = ParseValue(0);
+        SkipSpace();
+        return root == 0 && m_position == m_end;
+    }
+
+    const Item* At(int item) const
+    {
+        return item >= 0 && size_t(item) < m_items.size() ? &m_items[item] : nullptr;
+    }
+
+    int Child(int item, int index, const char* find) const
+    {
+        auto parent = At(item);
+        if (parent == nullptr || (parent->Kind != '{' && parent->Kind != '[') || (find != nullptr && parent->Kind != '{'))
+        {
+            return -1;
+        }
+
+        auto findSize = find != nullptr ? strlen(find) : 0;
+        auto child = parent->FirstChild;
+        for (int i = 0; child >= 0; i++, child = m_items[child].Next)
+        {
+            if (find == nullptr ? i == index : NameEquals(m_items[child].Name, find, findSize))
+            {
+                return child;
+            }
+        }
+        return -1;
+    }
+
+    std::string Decode(const Item& item) const
+    {
+        std::string decoded;
+        decoded.reserve(item.Size);
+        for (size_t i = 0; i < item.Size; i++)
+        {
+            auto ch = item.Data[i];
+            if (ch != '\\' || i + 1 >= item.Size)
+            {
+                decoded += ch;
+                continue;
+            }
+
+            ch = item.Data[++i];
+            switch (ch)
+            {
+            case 'b': decoded += '\b'; break;
+            case 'f': decoded += '\f'; break;
+            case 'n': decoded += '\n'; break;
+            case 'r': decoded += '\r'; break;
+            case 't': decoded += '\t'; break;
+            case 'u': i = DecodeUnicode(item, i, decoded); break;
+            default: decoded += ch; break;
+            }
+        }
+        return decoded;
+    }
+
+private:
+
+    static constexpr int MaxDepth = 64;
+
+    bool NameEquals(int name, const char* find, size_t findSize) const
+    {
+        auto item = At(name);
+        return item != nullptr && item->Size == findSize && memcmp(item->Data, find, findSize) == 0;
+    }
+
+    static int HexValue(char ch)
+    {
+        return ch >= '0' && ch <= '9' ? ch - '0' : ch >= 'a' && ch <= 'f' ? ch - 'a' + 10 : ch >= 'A' && ch <= 'F' ? ch - 'A' + 10 : -1;
+    }
+
+    static bool ReadHex4(const Item& item, size_t position, uint32_t& value)
+    {
+        if (position + 4 > item.Size)
+        {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < 4; i++)
+        {
+            auto digit = HexValue(item.Data[position + i]);
+            if (digit < 0)
+            {
+                return false;
+            }
+            value = (value << 4) | uint32_t(digit);
+        }
+        return true;
+    }
+
+    // Decodes \uXXXX (and a following low surrogate) at position 'u', returning the position of the last digit.
+    static size_t DecodeUnicode(const Item& item, size_t position, std::string& decoded)
+    {
+        uint32_t codePoint = 0;
+        if (!ReadHex4(item, position + 1, codePoint))
+        {
+            decoded += 'u';
+            return position;
+        }
+        position += 4;
+
+        uint32_t low = 0;
+        if (codePoint >= 0xD800 && codePoint < 0xDC00 && position + 2 < item.Size && item.Data[position + 1] == '\\' &&
+            item.Data[position + 2] == 'u' && ReadHex4(item, position + 3, low) && low >= 0xDC00 && low < 0xE000)
+        {
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            position += 6;
+        }
+
+        if (codePoint < 0x80)
+        {
+            decoded += char(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            decoded += char(0xC0 | (codePoint >> 6));
+            decoded += char(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            decoded += char(0xE0 | (codePoint >> 12));
+            decoded += char(0x80 | ((codePoint >> 6) & 0x3F));
+            decoded += char(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            decoded += char(0xF0 | (codePoint >> 18));
+            decoded += char(0x80 | ((codePoint >> 12) & 0x3F));
+            decoded += char(0x80 | ((codePoint >> 6) & 0x3F));
+            decoded += char(0x80 | (codePoint & 0x3F));
+        }
+        return position;
+    }
+
+    void SkipSpace()
+    {
+        while (m_position < m_end && (*m_position == ' ' || *m_position == '\t' || *m_position == '\r' || *m_position == '\n'))
+        {
+            m_position++;
+        }
+    }
+
+    bool Consume(char ch)
+    {
+        SkipSpace();
+        if (m_position < m_end && *m_position == ch)
+        {
+            m_position++;
+            return true;
+        }
+        return false;
+    }
+
+    int NewItem(char kind, const char* data)
+    {
+        Item item;
+        item.Kind = kind;
+        item.Data = data;
+        m_items.push_back(item);
+        return static_cast<int>(m_items.size() - 1);
+    }
+
+    int ParseValue(int depth)
+    {
+        SkipSpace();
+        if (m_position >= m_end || depth > MaxDepth)
+        {
+            return -1;
+        }
+
+        switch (*m_position)
+        {
+        case '{': return ParseContainer('{', '}', depth);
+        case '[': return ParseContainer('[', ']', depth);
+        case '"': return ParseString();
+        case 't': return ParseLiteral("true", 't');
+        case 'f': return ParseLiteral("false", 'f');
+        case 'n': return ParseLiteral("null", 'n');
+        default: return ParseNumber();
+        }
+    }
+
+    int ParseContainer(char open, char close, int depth)
+    {
+        auto item = NewItem(open, m_position++);
+        int last = -1;
+        if (!Consume(close))
+        {
+            do
+            {
+                int name = -1;
+                if (open == '{')
+                {
+                    SkipSpace();
+                    name = ParseString();
+                    if (name < 0 || !Consume(':'))
+                    {
+                        return -1;
+                    }
+                }
+
+                auto child = ParseValue(depth + 1);
+                if (child < 0)
+                {
+                    return -1;
+                }
+                m_items[child].Name = name;
+                (last < 0 ? m_items[item].FirstChild : m_items[last].Next) = child;
+                last = child;
+                m_items[item].Count++;
+            } while (Consume(','));
+
+            if (!Consume(close))
+            {
+                return -1;
+            }
+        }
+        m_items[item].Size = size_t(m_position - m_items[item].Data);
+        return item;
+    }
+
+    int ParseString()
+    {
+        if (m_position >= m_end || *m_position != '"')
+        {
+            return -1;
+        }
+
+        auto begin = ++m_position;
+        while (m_position < m_end && *m_position != '"')
+        {
+            m_position += *m_position == '\\' ? 2 : 1;
+        }
+        if (m_position >= m_end)
+        {
+            return -1;
+        }
+
+        auto item = NewItem('"', begin);
+        m_items[item].Size = size_t(m_position++ - begin);
+        return item;
+    }
+
+    int ParseLiteral(const char* literal, char kind)
+    {
+        auto size = strlen(literal);
+        if (size_t(m_end - m_position) < size || memcmp(m_position, literal, size) != 0)
+        {
+            return -1;
+        }
+        auto item = NewItem(kind, m_position);
+        m_items[item].Size = size;
+        m_position += size;
+        return item;
+    }
+
+    int ParseNumber()
+    {
+        auto begin = m_position;
+        while (m_position < m_end && strchr("+-0123456789.eE", *m_position) != nullptr && *m_position != '\0')
+        {
+            m_position++;
+        }
+        if (m_position == begin)
+        {
+            return -1;
+        }
+        auto item = NewItem('1', begin);
+        m_items[item].Size = size_t(m_position - begin);
+        return item;
+    }
+
+    std::string m_text;
+    std::vector<Item> m_items;
+    const char* m_position = nullptr;
+    const char* m_end = nullptr;
+};
+
+std::string NumberText(const JsonParser::Item* item)
+{
+    return item != nullptr && item->Kind == '1' ? std::string(item->Data, item->Size) : std::string();
+}
+
+} // Loopback
+
+using namespace Loopback;
+
+// ---------------------------------------------------------------------------------------------------------------
+// Errors
+// ---------------------------------------------------------------------------------------------------------------
+
+// The loopback never creates error objects: the handle passed to these functions is the error code itself.
+
+AZAC_API_(const_char_ptr) error_get_message(AZAC_HANDLE errorHandle)
+{
+    UNUSED(errorHandle);
+    return nullptr;
+}
+
+AZAC_API_(const_char_ptr) error_get_call_stack(AZAC_HANDLE errorHandle)
+{
+    UNUSED(errorHandle);
+    return nullptr;
+}
+
+AZAC_API error_get_error_code(AZAC_HANDLE errorHandle)
+{
+    return reinterpret_cast<AZACHR>(errorHandle);
+}
+
+AZAC_API error_release(AZAC_HANDLE errorHandle)
+{
+    UNUSED(errorHandle);
+    return SPX_NOERROR;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Property bags
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI property_bag_create(SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR { return GetPropertyBag(std::make_shared<Properties>(), hpropbag); });
+}
+
+SPXAPI_(bool) property_bag_is_valid(SPXPROPERTYBAGHANDLE hpropbag)
+{
+    return IsValid<PropertyBag>(hpropbag);
+}
+
+SPXAPI property_bag_set_string(SPXPROPERTYBAGHANDLE hpropbag, int id, const char* name, const char* value)
+{
+    return Try([&]() -> SPXHR {
+        auto bag = Get<PropertyBag>(hpropbag);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, bag == nullptr);
+        bag->m_properties->Set(id, name, value);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI__(const char*) property_bag_get_string(SPXPROPERTYBAGHANDLE hpropbag, int id, const char* name, const char* defaultValue)
+{
+    auto bag = Get<PropertyBag>(hpropbag);
+    std::string value;
+    if (bag != nullptr && bag->m_properties->TryGet(id, name, value))
+    {
+        return NewString(value);
+    }
+    return defaultValue != nullptr ? NewString(defaultValue, strlen(defaultValue)) : nullptr;
+}
+
+SPXAPI property_bag_free_string(const char* value)
+{
+    delete[] value;
+    return SPX_NOERROR;
+}
+
+SPXAPI property_bag_release(SPXPROPERTYBAGHANDLE hpropbag)
+{
+    return Release<PropertyBag>(hpropbag);
+}
+
+SPXAPI property_bag_copy(SPXPROPERTYBAGHANDLE hfrom, SPXPROPERTYBAGHANDLE hto)
+{
+    return Try([&]() -> SPXHR {
+        auto from = Get<PropertyBag>(hfrom);
+        auto to = Get<PropertyBag>(hto);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, from == nullptr || to == nullptr);
+        from->m_properties->CopyTo(*to->m_properties);
+        return SPX_NOERROR;
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Speech config
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI_(bool) speech_config_is_handle_valid(SPXSPEECHCONFIGHANDLE hconfig)
+{
+    return IsValid<SpeechConfig>(hconfig);
+}
+
+SPXAPI speech_config_from_subscription(SPXSPEECHCONFIGHANDLE* hconfig, const char* subscription, const char* region)
+{
+    return Try([&]() -> SPXHR {
+        return CreateSpeechConfig(hconfig, { { PropertyId::SpeechServiceConnection_Key, subscription }, { PropertyId::SpeechServiceConnection_Region, region } });
+    });
+}
+
+SPXAPI speech_config_from_authorization_token(SPXSPEECHCONFIGHANDLE* hconfig, const char* authToken, const char* region)
+{
+    return Try([&]() -> SPXHR {
+        return CreateSpeechConfig(hconfig, { { PropertyId::SpeechServiceAuthorization_Token, authToken }, { PropertyId::SpeechServiceConnection_Region, region } });
+    });
+}
+
+SPXAPI speech_config_from_endpoint(SPXSPEECHCONFIGHANDLE* hconfig, const char* endpoint, const char* subscription)
+{
+    return Try([&]() -> SPXHR {
+        return CreateSpeechConfig(hconfig, { { PropertyId::SpeechServiceConnection_Endpoint, endpoint }, { PropertyId::SpeechServiceConnection_Key, subscription } });
+    });
+}
+
+SPXAPI speech_config_from_host(SPXSPEECHCONFIGHANDLE* hconfig, const char* host, const char* subscription)
+{
+    return Try([&]() -> SPXHR {
+        return CreateSpeechConfig(hconfig, { { PropertyId::SpeechServiceConnection_Host, host }, { PropertyId::SpeechServiceConnection_Key, subscription } });
+    });
+}
+
+SPXAPI speech_config_release(SPXSPEECHCONFIGHANDLE hconfig)
+{
+    return Release<SpeechConfig>(hconfig);
+}
+
+SPXAPI speech_config_get_property_bag(SPXSPEECHCONFIGHANDLE hconfig, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto config = Get<SpeechConfig>(hconfig);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, config == nullptr);
+        return GetPropertyBag(config->m_properties, hpropbag);
+    });
+}
+
+SPXAPI speech_config_set_audio_output_format(SPXSPEECHCONFIGHANDLE hconfig, Speech_Synthesis_Output_Format formatId)
+{
+    UNUSED(formatId);
+    return IsValid<SpeechConfig>(hconfig) ? SPX_NOERROR : SPXERR_INVALID_HANDLE;
+}
+
+SPXAPI speech_config_set_service_property(SPXSPEECHCONFIGHANDLE configHandle, const char* propertyName, const char* propertyValue, SpeechConfig_ServicePropertyChannel channel)
+{
+    UNUSED(channel);
+    return Try([&]() -> SPXHR {
+        auto config = Get<SpeechConfig>(configHandle);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, config == nullptr);
+        config->m_properties->Set(-1, propertyName, propertyValue);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI speech_config_set_profanity(SPXSPEECHCONFIGHANDLE configHandle, SpeechConfig_ProfanityOption profanity)
+{
+    UNUSED(profanity);
+    return IsValid<SpeechConfig>(configHandle) ? SPX_NOERROR : SPXERR_INVALID_HANDLE;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Audio input
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI_(bool) audio_stream_format_is_handle_valid(SPXAUDIOSTREAMFORMATHANDLE hformat)
+{
+    return IsValid<AudioStreamFormat>(hformat);
+}
+
+SPXAPI audio_stream_format_create_from_default_input(SPXAUDIOSTREAMFORMATHANDLE* hformat)
+{
+    return Try([&]() -> SPXHR { return Store(hformat, std::make_shared<AudioStreamFormat>()); });
+}
+
+SPXAPI audio_stream_format_create_from_default_output(SPXAUDIOSTREAMFORMATHANDLE* hformat)
+{
+    return Try([&]() -> SPXHR { return Store(hformat, std::make_shared<AudioStreamFormat>()); });
+}
+
+SPXAPI audio_stream_format_create_from_waveformat_pcm(SPXAUDIOSTREAMFORMATHANDLE* hformat, uint32_t samplesPerSecond, uint8_t bitsPerSample, uint8_t channels)
+{
+    UNUSED(samplesPerSecond);
+    UNUSED(bitsPerSample);
+    UNUSED(channels);
+    return Try([&]() -> SPXHR { return Store(hformat, std::make_shared<AudioStreamFormat>()); });
+}
+
+SPXAPI audio_stream_format_create_from_waveformat(SPXAUDIOSTREAMFORMATHANDLE* hformat, uint32_t samplesPerSecond, uint8_t bitsPerSample, uint8_t channels, Audio_Stream_Wave_Format waveFormat)
+{
+    UNUSED(waveFormat);
+    return audio_stream_format_create_from_waveformat_pcm(hformat, samplesPerSecond, bitsPerSample, channels);
+}
+
+SPXAPI audio_stream_format_release(SPXAUDIOSTREAMFORMATHANDLE hformat)
+{
+    return Release<AudioStreamFormat>(hformat);
+}
+
+SPXAPI_(bool) audio_stream_is_handle_valid(SPXAUDIOSTREAMHANDLE haudioStream)
+{
+    return IsValid<AudioInputStream>(haudioStream) || IsValid<PullAudioOutputStream>(haudioStream);
+}
+
+SPXAPI audio_stream_create_push_audio_input_stream(SPXAUDIOSTREAMHANDLE* haudioStream, SPXAUDIOSTREAMFORMATHANDLE hformat)
+{
+    UNUSED(hformat);
+    return Try([&]() -> SPXHR { return Store(haudioStream, std::make_shared<AudioInputStream>()); });
+}
+
+SPXAPI audio_stream_create_pull_audio_output_stream(SPXAUDIOSTREAMHANDLE* haudioStream)
+{
+    return Try([&]() -> SPXHR { return Store(haudioStream, std::make_shared<PullAudioOutputStream>()); });
+}
+
+SPXAPI audio_stream_release(SPXAUDIOSTREAMHANDLE haudioStream)
+{
+    return IsValid<PullAudioOutputStream>(haudioStream) ? Release<PullAudioOutputStream>(haudioStream) : Release<AudioInputStream>(haudioStream);
+}
+
+SPXAPI pull_audio_output_stream_read(SPXAUDIOSTREAMHANDLE haudioStream, uint8_t* buffer, uint32_t bufferSize, uint32_t* pfilledSize)
+{
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, pfilledSize == nullptr || (buffer == nullptr && bufferSize > 0));
+        auto stream = Get<PullAudioOutputStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        *pfilledSize = stream->Read(buffer, bufferSize);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI push_audio_input_stream_write(SPXAUDIOSTREAMHANDLE haudioStream, uint8_t* buffer, uint32_t size)
+{
+    return Try([&]() -> SPXHR {
+        auto stream = Get<AudioInputStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        stream->Write(buffer, size);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI push_audio_input_stream_close(SPXAUDIOSTREAMHANDLE haudioStream)
+{
+    auto stream = Get<AudioInputStream>(haudioStream);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+    stream->Close();
+    return SPX_NOERROR;
+}
+
+SPXAPI push_audio_input_stream_set_property_by_id(SPXAUDIOSTREAMHANDLE haudioStream, int id, const char* value)
+{
+    return Try([&]() -> SPXHR {
+        auto stream = Get<AudioInputStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        stream->m_properties->Set(id, nullptr, value);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI push_audio_input_stream_set_property_by_name(SPXAUDIOSTREAMHANDLE haudioStream, const char* name, const char* value)
+{
+    return Try([&]() -> SPXHR {
+        auto stream = Get<AudioInputStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        stream->m_properties->Set(-1, name, value);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI_(bool) audio_config_is_handle_valid(SPXAUDIOCONFIGHANDLE haudioConfig)
+{
+    return IsValid<AudioConfig>(haudioConfig);
+}
+
+SPXAPI audio_config_create_audio_input_from_default_microphone(SPXAUDIOCONFIGHANDLE* haudioConfig)
+{
+    return Try([&]() -> SPXHR { return Store(haudioConfig, std::make_shared<AudioConfig>()); });
+}
+
+SPXAPI audio_config_create_audio_input_from_stream(SPXAUDIOCONFIGHANDLE* haudioConfig, SPXAUDIOSTREAMHANDLE haudioStream)
+{
+    return Try([&]() -> SPXHR {
+        auto stream = Get<AudioInputStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        auto config = std::make_shared<AudioConfig>();
+        config->m_stream = stream;
+        return Store(haudioConfig, config);
+    });
+}
+
+SPXAPI audio_config_create_push_audio_input_stream(SPXAUDIOCONFIGHANDLE* haudioConfig, SPXAUDIOSTREAMHANDLE* haudioStream, SPXAUDIOSTREAMFORMATHANDLE hformat)
+{
+    SPX_RETURN_ON_FAIL(audio_stream_create_push_audio_input_stream(haudioStream, hformat));
+    return audio_config_create_audio_input_from_stream(haudioConfig, *haudioStream);
+}
+
+SPXAPI audio_config_release(SPXAUDIOCONFIGHANDLE haudioConfig)
+{
+    return Release<AudioConfig>(haudioConfig);
+}
+
+SPXAPI audio_config_get_property_bag(SPXAUDIOCONFIGHANDLE haudioConfig, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto config = Get<AudioConfig>(haudioConfig);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, config == nullptr);
+        return GetPropertyBag(config->m_properties, hpropbag);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Recognizer
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI recognizer_create_speech_recognizer_from_config(SPXRECOHANDLE* phreco, SPXSPEECHCONFIGHANDLE hspeechconfig, SPXAUDIOCONFIGHANDLE haudioInput)
+{
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, phreco == nullptr);
+        auto config = Get<SpeechConfig>(hspeechconfig);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, config == nullptr);
+        auto audio = Get<AudioConfig>(haudioInput);
+
+        auto recognizer = std::make_shared<Recognizer>(*config, audio != nullptr ? audio->m_stream : nullptr);
+        *phreco = recognizer->m_handle = Add(recognizer);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI_(bool) recognizer_handle_is_valid(SPXRECOHANDLE hreco)
+{
+    return IsValid<Recognizer>(hreco);
+}
+
+SPXAPI recognizer_handle_release(SPXRECOHANDLE hreco)
+{
+    // The worker of a continuous recognition keeps its recognizer alive, so it has to be stopped explicitly.
+    auto recognizer = Get<Recognizer>(hreco);
+    if (recognizer != nullptr)
+    {
+        recognizer->Stop();
+    }
+    return Release<Recognizer>(hreco);
+}
+
+SPXAPI recognizer_get_property_bag(SPXRECOHANDLE hreco, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto recognizer = Get<Recognizer>(hreco);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+        return GetPropertyBag(recognizer->m_properties, hpropbag);
+    });
+}
+
+SPXAPI recognizer_recognize_once(SPXRECOHANDLE hreco, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, phresult == nullptr);
+        auto recognizer = Get<Recognizer>(hreco);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+
+        std::shared_ptr<RecognitionResult> result;
+        SPX_RETURN_ON_FAIL(recognizer->RecognizeOnce(result));
+        *phresult = Add(result);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI recognizer_recognize_once_async(SPXRECOHANDLE hreco, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR {
+        auto recognizer = Get<Recognizer>(hreco);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+        return AsyncOperation::Run(phasync, [recognizer](std::shared_ptr<Object>& object) -> SPXHR {
+            std::shared_ptr<RecognitionResult> result;
+            auto hr = recognizer->RecognizeOnce(result);
+            object = result;
+            return hr;
+        });
+    });
+}
+
+SPXAPI recognizer_recognize_once_async_wait_for(SPXASYNCHANDLE hasync, uint32_t milliseconds, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR { return WaitFor(hasync, milliseconds, phresult); });
+}
+
+SPXAPI recognizer_start_continuous_recognition(SPXRECOHANDLE hreco)
+{
+    return Try([&]() -> SPXHR {
+        auto recognizer = Get<Recognizer>(hreco);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+        return recognizer->StartContinuous();
+    });
+}
+
+SPXAPI recognizer_start_continuous_recognition_async(SPXRECOHANDLE hreco, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR {
+        auto recognizer = Get<Recognizer>(hreco);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+        return AsyncOperation::Run(phasync, [recognizer](std::shared_ptr<Object>&) -> SPXHR { return recognizer->StartContinuous(); });
+    });
+}
+
+SPXAPI recognizer_start_continuous_recognition_async_wait_for(SPXASYNCHANDLE hasync, uint32_t milliseconds)
+{
+    return Try([&]() -> SPXHR { return WaitFor(hasync, milliseconds); });
+}
+
+SPXAPI recognizer_stop_continuous_recognition(SPXRECOHANDLE hreco)
+{
+    return Try([&]() -> SPXHR {
+        auto recognizer = Get<Recognizer>(hreco);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+        return recognizer->Stop();
+    });
+}
+
+SPXAPI recognizer_stop_continuous_recognition_async(SPXRECOHANDLE hreco, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR {
+        auto recognizer = Get<Recognizer>(hreco);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+        return AsyncOperation::Run(phasync, [recognizer](std::shared_ptr<Object>&) -> SPXHR { return recognizer->Stop(); });
+    });
+}
+
+SPXAPI recognizer_stop_continuous_recognition_async_wait_for(SPXASYNCHANDLE hasync, uint32_t milliseconds)
+{
+    return Try([&]() -> SPXHR { return WaitFor(hasync, milliseconds); });
+}
+
+SPXAPI_(bool) recognizer_async_handle_is_valid(SPXASYNCHANDLE hasync)
+{
+    return IsValid<AsyncOperation>(hasync);
+}
+
+SPXAPI recognizer_async_handle_release(SPXASYNCHANDLE hasync)
+{
+    return Release<AsyncOperation>(hasync);
+}
+
+SPXAPI speechapi_async_handle_release(SPXASYNCHANDLE h_async)
+{
+    return Release<AsyncOperation>(h_async);
+}
+
+SPXAPI speechapi_async_wait_for(SPXASYNCHANDLE h_async, uint32_t milliseconds)
+{
+    return Try([&]() -> SPXHR { return WaitFor(h_async, milliseconds); });
+}
+
+#define LOOPBACK_RECOGNIZER_CALLBACK(api, member, type) \
+    SPXAPI api(SPXRECOHANDLE hreco, type pCallback, void* pvContext) \
+    { \
+        auto recognizer = Get<Recognizer>(hreco); \
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr); \
+        std::lock_guard<std::recursive_mutex> lock(recognizer->m_callbackLock); \
+        recognizer->member.Function = pCallback; \
+        recognizer->member.Context = pvContext; \
+        return SPX_NOERROR; \
+    }
+
+LOOPBACK_RECOGNIZER_CALLBACK(recognizer_session_started_set_callback, m_sessionStarted, PSESSION_CALLBACK_FUNC)
+LOOPBACK_RECOGNIZER_CALLBACK(recognizer_session_stopped_set_callback, m_sessionStopped, PSESSION_CALLBACK_FUNC)
+LOOPBACK_RECOGNIZER_CALLBACK(recognizer_recognizing_set_callback, m_recognizing, PRECOGNITION_CALLBACK_FUNC)
+LOOPBACK_RECOGNIZER_CALLBACK(recognizer_recognized_set_callback, m_recognized, PRECOGNITION_CALLBACK_FUNC)
+LOOPBACK_RECOGNIZER_CALLBACK(recognizer_canceled_set_callback, m_canceled, PRECOGNITION_CALLBACK_FUNC)
+LOOPBACK_RECOGNIZER_CALLBACK(recognizer_speech_start_detected_set_callback, m_speechStartDetected, PRECOGNITION_CALLBACK_FUNC)
+LOOPBACK_RECOGNIZER_CALLBACK(recognizer_speech_end_detected_set_callback, m_speechEndDetected, PRECOGNITION_CALLBACK_FUNC)
+
+#undef LOOPBACK_RECOGNIZER_CALLBACK
+
+SPXAPI_(bool) recognizer_event_handle_is_valid(SPXEVENTHANDLE hevent)
+{
+    return IsValid<RecognitionEvent>(hevent);
+}
+
+SPXAPI recognizer_event_handle_release(SPXEVENTHANDLE hevent)
+{
+    return Release<RecognitionEvent>(hevent);
+}
+
+SPXAPI recognizer_session_event_get_session_id(SPXEVENTHANDLE hevent, char* pszSessionId, uint32_t cchSessionId)
+{
+    auto event = Get<RecognitionEvent>(hevent);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr);
+    return CopyString(event->m_sessionId, pszSessionId, cchSessionId);
+}
+
+SPXAPI recognizer_recognition_event_get_offset(SPXEVENTHANDLE hevent, uint64_t* pszOffset)
+{
+    auto event = Get<RecognitionEvent>(hevent);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, pszOffset == nullptr);
+    *pszOffset = event->m_offset;
+    return SPX_NOERROR;
+}
+
+SPXAPI recognizer_recognition_event_get_result(SPXEVENTHANDLE hevent, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR {
+        auto event = Get<RecognitionEvent>(hevent);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr || event->m_result == nullptr);
+        return Store(phresult, event->m_result);
+    });
+}
+
+SPXAPI recognizer_connection_event_get_property_bag(SPXEVENTHANDLE hevent, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto event = Get<RecognitionEvent>(hevent);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr);
+        return GetPropertyBag(event->m_properties, hpropbag);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Recognition results
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI_(bool) recognizer_result_handle_is_valid(SPXRESULTHANDLE hresult)
+{
+    return IsValid<RecognitionResult>(hresult);
+}
+
+SPXAPI recognizer_result_handle_release(SPXRESULTHANDLE hresult)
+{
+    return Release<RecognitionResult>(hresult);
+}
+
+SPXAPI result_get_reason(SPXRESULTHANDLE hresult, Result_Reason* reason)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, reason == nullptr);
+    *reason = result->m_reason;
+    return SPX_NOERROR;
+}
+
+SPXAPI result_get_reason_canceled(SPXRESULTHANDLE hresult, Result_CancellationReason* reason)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, reason == nullptr);
+    *reason = result->m_cancellationReason;
+    return SPX_NOERROR;
+}
+
+SPXAPI result_get_canceled_error_code(SPXRESULTHANDLE hresult, Result_CancellationErrorCode* errorCode)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, errorCode == nullptr);
+    *errorCode = result->m_errorCode;
+    return SPX_NOERROR;
+}
+
+SPXAPI result_get_no_match_reason(SPXRESULTHANDLE hresult, Result_NoMatchReason* reason)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, reason == nullptr);
+    *reason = NoMatchReason_NotRecognized;
+    return SPX_NOERROR;
+}
+
+SPXAPI result_get_result_id(SPXRESULTHANDLE hresult, char* pszResultId, uint32_t cchResultId)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    return CopyString(result->m_id, pszResultId, cchResultId);
+}
+
+SPXAPI result_get_text(SPXRESULTHANDLE hresult, char* pszText, uint32_t cchText)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    return CopyString(result->m_text, pszText, cchText);
+}
+
+SPXAPI result_get_offset(SPXRESULTHANDLE hresult, uint64_t* offset)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, offset == nullptr);
+    *offset = result->m_offset;
+    return SPX_NOERROR;
+}
+
+SPXAPI result_get_duration(SPXRESULTHANDLE hresult, uint64_t* duration)
+{
+    auto result = Get<RecognitionResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, duration == nullptr);
+    *duration = result->m_duration;
+    return SPX_NOERROR;
+}
+
+SPXAPI result_get_property_bag(SPXRESULTHANDLE hresult, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto result = Get<RecognitionResult>(hresult);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+        return GetPropertyBag(result->m_properties, hpropbag);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Connection
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI connection_from_recognizer(SPXRECOHANDLE recognizerHandle, SPXCONNECTIONHANDLE* connectionHandle)
+{
+    return Try([&]() -> SPXHR {
+        auto recognizer = Get<Recognizer>(recognizerHandle);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, recognizer == nullptr);
+        return Store(connectionHandle, recognizer->GetConnection());
+    });
+}
+
+SPXAPI_(bool) connection_handle_is_valid(SPXCONNECTIONHANDLE handle)
+{
+    return IsValid<Connection>(handle);
+}
+
+SPXAPI connection_handle_release(SPXCONNECTIONHANDLE handle)
+{
+    // Waits for a callback in flight, as the C++ connection is destroyed right after this returns.
+    auto connection = Get<Connection>(handle);
+    if (connection != nullptr)
+    {
+        connection->m_callbacks->Clear();
+    }
+    return Release<Connection>(handle);
+}
+
+SPXAPI connection_async_handle_release(SPXASYNCHANDLE hasync)
+{
+    return Release<AsyncOperation>(hasync);
+}
+
+SPXAPI connection_open(SPXCONNECTIONHANDLE handle, bool forContinuousRecognition)
+{
+    UNUSED(forContinuousRecognition);
+    return Try([&]() -> SPXHR {
+        auto connection = Get<Connection>(handle);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, connection == nullptr);
+        connection->m_callbacks->Fire(connection->m_callbacks->Connected, [&]() { return std::make_shared<RecognitionEvent>(); });
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI connection_close(SPXCONNECTIONHANDLE handle)
+{
+    return Try([&]() -> SPXHR {
+        auto connection = Get<Connection>(handle);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, connection == nullptr);
+        connection->m_callbacks->Fire(connection->m_callbacks->Disconnected, [&]() { return std::make_shared<RecognitionEvent>(); });
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI connection_set_message_property(SPXCONNECTIONHANDLE handle, const char* path, const char* name, const char* value)
+{
+    UNUSED(path);
+    UNUSED(name);
+    UNUSED(value);
+    return IsValid<Connection>(handle) ? SPX_NOERROR : SPXERR_INVALID_HANDLE;
+}
+
+// Sent messages are dropped; there is no service to receive them.
+SPXAPI connection_send_message(SPXCONNECTIONHANDLE handle, const char* path, const char* payload)
+{
+    UNUSED(payload);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, path == nullptr);
+    return IsValid<Connection>(handle) ? SPX_NOERROR : SPXERR_INVALID_HANDLE;
+}
+
+SPXAPI connection_send_message_async(SPXCONNECTIONHANDLE handle, const char* path, const char* payload, SPXASYNCHANDLE* phasync)
+{
+    UNUSED(payload);
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, path == nullptr);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<Connection>(handle));
+        return AsyncOperation::Run(phasync, [](std::shared_ptr<Object>&) -> SPXHR { return SPX_NOERROR; });
+    });
+}
+
+SPXAPI connection_send_message_wait_for(SPXASYNCHANDLE hasync, uint32_t milliseconds)
+{
+    return Try([&]() -> SPXHR { return WaitFor(hasync, milliseconds); });
+}
+
+SPXAPI connection_send_message_data(SPXCONNECTIONHANDLE handle, const char* path, uint8_t* data, uint32_t size)
+{
+    UNUSED(data);
+    UNUSED(size);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, path == nullptr);
+    return IsValid<Connection>(handle) ? SPX_NOERROR : SPXERR_INVALID_HANDLE;
+}
+
+SPXAPI connection_get_property_bag(SPXRECOHANDLE hconn, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto connection = Get<Connection>(hconn);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, connection == nullptr);
+        return GetPropertyBag(connection->m_properties, hpropbag);
+    });
+}
+
+#define LOOPBACK_CONNECTION_CALLBACK(api, member) \
+    SPXAPI api(SPXCONNECTIONHANDLE connection, CONNECTION_CALLBACK_FUNC callback, void* context) \
+    { \
+        auto object = Get<Connection>(connection); \
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, object == nullptr); \
+        object->m_callbacks->Set(object->m_callbacks->member, callback, context); \
+        return SPX_NOERROR; \
+    }
+
+LOOPBACK_CONNECTION_CALLBACK(connection_connected_set_callback, Connected)
+LOOPBACK_CONNECTION_CALLBACK(connection_disconnected_set_callback, Disconnected)
+LOOPBACK_CONNECTION_CALLBACK(connection_message_received_set_callback, MessageReceived)
+
+#undef LOOPBACK_CONNECTION_CALLBACK
+
+SPXAPI_(bool) connection_message_received_event_handle_is_valid(SPXEVENTHANDLE hevent)
+{
+    return IsValid<ConnectionMessageEvent>(hevent);
+}
+
+SPXAPI connection_message_received_event_handle_release(SPXEVENTHANDLE hevent)
+{
+    return Release<ConnectionMessageEvent>(hevent);
+}
+
+SPXAPI connection_message_received_event_get_message(SPXEVENTHANDLE hevent, SPXCONNECTIONMESSAGEHANDLE* hcm)
+{
+    return Try([&]() -> SPXHR {
+        auto event = Get<ConnectionMessageEvent>(hevent);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr);
+        return Store(hcm, event->m_message);
+    });
+}
+
+SPXAPI_(bool) connection_message_handle_is_valid(SPXCONNECTIONMESSAGEHANDLE handle)
+{
+    return IsValid<ConnectionMessage>(handle);
+}
+
+SPXAPI connection_message_handle_release(SPXCONNECTIONMESSAGEHANDLE handle)
+{
+    return Release<ConnectionMessage>(handle);
+}
+
+SPXAPI connection_message_get_property_bag(SPXCONNECTIONMESSAGEHANDLE hcm, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto message = Get<ConnectionMessage>(hcm);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, message == nullptr);
+        return GetPropertyBag(message->m_properties, hpropbag);
+    });
+}
+
+SPXAPI connection_message_get_data(SPXCONNECTIONMESSAGEHANDLE hcm, uint8_t* data, uint32_t size)
+{
+    auto message = Get<ConnectionMessage>(hcm);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, message == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_BUFFER_TOO_SMALL, size < message->m_data.size());
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, data == nullptr && !message->m_data.empty());
+    memcpy(data, message->m_data.data(), message->m_data.size());
+    return SPX_NOERROR;
+}
+
+SPXAPI_(uint32_t) connection_message_get_data_size(SPXCONNECTIONMESSAGEHANDLE hcm)
+{
+    auto message = Get<ConnectionMessage>(hcm);
+    return message != nullptr ? static_cast<uint32_t>(message->m_data.size()) : 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Synthesizer
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI synthesizer_create_speech_synthesizer_from_config(SPXSYNTHHANDLE* phsynth, SPXSPEECHCONFIGHANDLE hspeechconfig, SPXAUDIOCONFIGHANDLE haudioOuput)
+{
+    UNUSED(haudioOuput);
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, phsynth == nullptr);
+        auto config = Get<SpeechConfig>(hspeechconfig);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, config == nullptr);
+
+        auto synthesizer = std::make_shared<Synthesizer>(*config);
+        *phsynth = synthesizer->m_handle = Add(synthesizer);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI_(bool) synthesizer_handle_is_valid(SPXSYNTHHANDLE hsynth)
+{
+    return IsValid<Synthesizer>(hsynth);
+}
+
+SPXAPI synthesizer_handle_release(SPXSYNTHHANDLE hsynth)
+{
+    return Release<Synthesizer>(hsynth);
+}
+
+SPXAPI_(bool) synthesizer_async_handle_is_valid(SPXASYNCHANDLE hasync)
+{
+    return IsValid<AsyncOperation>(hasync);
+}
+
+SPXAPI synthesizer_async_handle_release(SPXASYNCHANDLE hasync)
+{
+    return Release<AsyncOperation>(hasync);
+}
+
+SPXAPI synthesizer_get_property_bag(SPXSYNTHHANDLE hsynth, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto synthesizer = Get<Synthesizer>(hsynth);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, synthesizer == nullptr);
+        return GetPropertyBag(synthesizer->m_properties, hpropbag);
+    });
+}
+
+SPXAPI synthesizer_speak_text(SPXSYNTHHANDLE hsynth, const char* text, uint32_t textLength, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR { return Speak(hsynth, text, textLength, true, phresult); });
+}
+
+SPXAPI synthesizer_speak_ssml(SPXSYNTHHANDLE hsynth, const char* ssml, uint32_t ssmlLength, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR { return Speak(hsynth, ssml, ssmlLength, true, phresult); });
+}
+
+SPXAPI synthesizer_speak_text_async(SPXSYNTHHANDLE hsynth, const char* text, uint32_t textLength, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR { return SpeakAsync(hsynth, text, textLength, true, phasync); });
+}
+
+SPXAPI synthesizer_speak_ssml_async(SPXSYNTHHANDLE hsynth, const char* ssml, uint32_t ssmlLength, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR { return SpeakAsync(hsynth, ssml, ssmlLength, true, phasync); });
+}
+
+SPXAPI synthesizer_start_speaking_text(SPXSYNTHHANDLE hsynth, const char* text, uint32_t textLength, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR { return Speak(hsynth, text, textLength, false, phresult); });
+}
+
+SPXAPI synthesizer_start_speaking_ssml(SPXSYNTHHANDLE hsynth, const char* ssml, uint32_t ssmlLength, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR { return Speak(hsynth, ssml, ssmlLength, false, phresult); });
+}
+
+SPXAPI synthesizer_start_speaking_text_async(SPXSYNTHHANDLE hsynth, const char* text, uint32_t textLength, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR { return SpeakAsync(hsynth, text, textLength, false, phasync); });
+}
+
+SPXAPI synthesizer_start_speaking_ssml_async(SPXSYNTHHANDLE hsynth, const char* ssml, uint32_t ssmlLength, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR { return SpeakAsync(hsynth, ssml, ssmlLength, false, phasync); });
+}
+
+SPXAPI synthesizer_speak_async_wait_for(SPXASYNCHANDLE hasync, uint32_t milliseconds, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR { return WaitFor(hasync, milliseconds, phresult); });
+}
+
+SPXAPI synthesizer_stop_speaking(SPXSYNTHHANDLE hsynth)
+{
+    auto synthesizer = Get<Synthesizer>(hsynth);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, synthesizer == nullptr);
+    synthesizer->StopSpeaking();
+    return SPX_NOERROR;
+}
+
+SPXAPI synthesizer_stop_speaking_async(SPXSYNTHHANDLE hsynth, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR {
+        auto synthesizer = Get<Synthesizer>(hsynth);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, synthesizer == nullptr);
+        return AsyncOperation::Run(phasync, [synthesizer](std::shared_ptr<Object>&) -> SPXHR { synthesizer->StopSpeaking(); return SPX_NOERROR; });
+    });
+}
+
+SPXAPI synthesizer_stop_speaking_async_wait_for(SPXASYNCHANDLE hasync, uint32_t milliseconds)
+{
+    return Try([&]() -> SPXHR { return WaitFor(hasync, milliseconds); });
+}
+
+SPXAPI synthesizer_get_voices_list(SPXSYNTHHANDLE hsynth, const char* locale, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<Synthesizer>(hsynth));
+        auto result = std::make_shared<VoicesResult>();
+        for (auto& voice : Voices)
+        {
+            if (locale == nullptr || *locale == '\0' || strcmp(locale, voice.Locale) == 0)
+            {
+                result->m_voices.push_back(&voice);
+            }
+        }
+        return Store(phresult, result);
+    });
+}
+
+SPXAPI synthesizer_get_voices_list_async(SPXSYNTHHANDLE hsynth, const char* locale, SPXASYNCHANDLE* phasync)
+{
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<Synthesizer>(hsynth));
+        std::string filter = locale != nullptr ? locale : "";
+        return AsyncOperation::Run(phasync, [hsynth, filter](std::shared_ptr<Object>& object) -> SPXHR {
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            SPX_RETURN_ON_FAIL(synthesizer_get_voices_list(hsynth, filter.c_str(), &hresult));
+            object = Get<VoicesResult>(hresult);
+            return Release<VoicesResult>(hresult);
+        });
+    });
+}
+
+SPXAPI synthesizer_get_voices_list_async_wait_for(SPXASYNCHANDLE hasync, uint32_t milliseconds, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR { return WaitFor(hasync, milliseconds, phresult); });
+}
+
+#define LOOPBACK_SYNTHESIZER_CALLBACK(api, member) \
+    SPXAPI api(SPXSYNTHHANDLE hsynth, PSYNTHESIS_CALLBACK_FUNC pCallback, void* pvContext) \
+    { \
+        auto synthesizer = Get<Synthesizer>(hsynth); \
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, synthesizer == nullptr); \
+        synthesizer->SetCallback(synthesizer->member, pCallback, pvContext); \
+        return SPX_NOERROR; \
+    }
+
+LOOPBACK_SYNTHESIZER_CALLBACK(synthesizer_started_set_callback, m_started)
+LOOPBACK_SYNTHESIZER_CALLBACK(synthesizer_synthesizing_set_callback, m_synthesizing)
+LOOPBACK_SYNTHESIZER_CALLBACK(synthesizer_completed_set_callback, m_completed)
+LOOPBACK_SYNTHESIZER_CALLBACK(synthesizer_canceled_set_callback, m_canceled)
+LOOPBACK_SYNTHESIZER_CALLBACK(synthesizer_word_boundary_set_callback, m_wordBoundary)
+LOOPBACK_SYNTHESIZER_CALLBACK(synthesizer_viseme_received_set_callback, m_visemeReceived)
+LOOPBACK_SYNTHESIZER_CALLBACK(synthesizer_bookmark_reached_set_callback, m_bookmarkReached)
+
+#undef LOOPBACK_SYNTHESIZER_CALLBACK
+
+SPXAPI_(bool) synthesizer_event_handle_is_valid(SPXEVENTHANDLE hevent)
+{
+    return IsValid<SynthesisEvent>(hevent);
+}
+
+SPXAPI synthesizer_event_handle_release(SPXEVENTHANDLE hevent)
+{
+    return Release<SynthesisEvent>(hevent);
+}
+
+SPXAPI synthesizer_synthesis_event_get_result(SPXEVENTHANDLE hevent, SPXRESULTHANDLE* phresult)
+{
+    return Try([&]() -> SPXHR {
+        auto event = Get<SynthesisEvent>(hevent);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr || event->m_result == nullptr);
+        return Store(phresult, event->m_result);
+    });
+}
+
+SPXAPI synthesizer_word_boundary_event_get_values(SPXEVENTHANDLE hevent, uint64_t* pAudioOffset, uint64_t* pDuration, uint32_t* pTextOffset, uint32_t* pWordLength, SpeechSynthesis_BoundaryType* pBoundaryType)
+{
+    auto event = Get<SynthesisEvent>(hevent);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, pAudioOffset == nullptr || pDuration == nullptr || pTextOffset == nullptr || pWordLength == nullptr || pBoundaryType == nullptr);
+    *pAudioOffset = event->m_audioOffset;
+    *pDuration = event->m_duration;
+    *pTextOffset = event->m_textOffset;
+    *pWordLength = event->m_wordLength;
+    *pBoundaryType = SpeechSynthesis_BoundaryType_Word;
+    return SPX_NOERROR;
+}
+
+SPXAPI synthesizer_event_get_result_id(SPXEVENTHANDLE hEvent, char* resultId, uint32_t resultIdLength)
+{
+    auto event = Get<SynthesisEvent>(hEvent);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, event == nullptr);
+    return CopyString(event->m_resultId, resultId, resultIdLength);
+}
+
+SPXAPI__(const char*) synthesizer_event_get_text(SPXEVENTHANDLE hEvent)
+{
+    auto event = Get<SynthesisEvent>(hEvent);
+    return NewString(event != nullptr ? event->m_text : std::string());
+}
+
+// Visemes and bookmarks are never raised; their accessors only describe an empty event.
+SPXAPI synthesizer_viseme_event_get_values(SPXEVENTHANDLE hevent, uint64_t* pAudioOffset, uint32_t* pVisemeId)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<SynthesisEvent>(hevent));
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, pAudioOffset == nullptr || pVisemeId == nullptr);
+    *pAudioOffset = 0;
+    *pVisemeId = 0;
+    return SPX_NOERROR;
+}
+
+SPXAPI__(const char*) synthesizer_viseme_event_get_animation(SPXEVENTHANDLE hEvent)
+{
+    UNUSED(hEvent);
+    return NewString(std::string());
+}
+
+SPXAPI synthesizer_bookmark_event_get_values(SPXEVENTHANDLE hevent, uint64_t* pAudioOffset)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<SynthesisEvent>(hevent));
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, pAudioOffset == nullptr);
+    *pAudioOffset = 0;
+    return SPX_NOERROR;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Synthesis results and voices
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI_(bool) synthesizer_result_handle_is_valid(SPXRESULTHANDLE hresult)
+{
+    return IsValid<SynthesisResult>(hresult) || IsValid<VoicesResult>(hresult);
+}
+
+SPXAPI synthesizer_result_handle_release(SPXRESULTHANDLE hresult)
+{
+    // Voices results are released through the same function as synthesis results.
+    return IsValid<VoicesResult>(hresult) ? Release<VoicesResult>(hresult) : Release<SynthesisResult>(hresult);
+}
+
+SPXAPI synth_result_get_result_id(SPXRESULTHANDLE hresult, char* resultId, uint32_t resultIdLength)
+{
+    auto result = Get<SynthesisResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    return CopyString(result->m_id, resultId, resultIdLength);
+}
+
+SPXAPI synth_result_get_reason(SPXRESULTHANDLE hresult, Result_Reason* reason)
+{
+    auto result = Get<SynthesisResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, reason == nullptr);
+    *reason = result->m_reason;
+    return SPX_NOERROR;
+}
+
+SPXAPI synth_result_get_reason_canceled(SPXRESULTHANDLE hresult, Result_CancellationReason* reason)
+{
+    auto result = Get<SynthesisResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, reason == nullptr);
+    *reason = CancellationReason_UserCancelled;
+    return SPX_NOERROR;
+}
+
+SPXAPI synth_result_get_canceled_error_code(SPXRESULTHANDLE hresult, Result_CancellationErrorCode* errorCode)
+{
+    auto result = Get<SynthesisResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, errorCode == nullptr);
+    *errorCode = CancellationErrorCode_NoError;
+    return SPX_NOERROR;
+}
+
+SPXAPI synth_result_get_audio_data(SPXRESULTHANDLE hresult, uint8_t* buffer, uint32_t bufferSize, uint32_t* filledSize)
+{
+    auto result = Get<SynthesisResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, filledSize == nullptr || (buffer == nullptr && bufferSize > 0));
+    *filledSize = result->m_audio->Read(buffer, bufferSize, 0, false);
+    return SPX_NOERROR;
+}
+
+SPXAPI synth_result_get_audio_length_duration(SPXRESULTHANDLE hresult, uint32_t* audioLength, uint64_t* audioDuration)
+{
+    auto result = Get<SynthesisResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, audioLength == nullptr || audioDuration == nullptr);
+    *audioLength = static_cast<uint32_t>(result->m_audio->Size());
+    *audioDuration = *audioLength / BytesPerMillisecond * TicksPerMillisecond;
+    return SPX_NOERROR;
+}
+
+SPXAPI synth_result_get_audio_format(SPXRESULTHANDLE hresult, SPXAUDIOSTREAMFORMATHANDLE* hformat)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<SynthesisResult>(hresult));
+    return audio_stream_format_create_from_default_output(hformat);
+}
+
+SPXAPI synth_result_get_property_bag(SPXRESULTHANDLE hresult, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto result = Get<SynthesisResult>(hresult);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+        return GetPropertyBag(result->m_properties, hpropbag);
+    });
+}
+
+SPXAPI synthesis_voices_result_get_result_id(SPXRESULTHANDLE hresult, char* resultId, uint32_t resultIdLength)
+{
+    auto result = Get<VoicesResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    return CopyString(result->m_id, resultId, resultIdLength);
+}
+
+SPXAPI synthesis_voices_result_get_reason(SPXRESULTHANDLE hresult, Result_Reason* reason)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<VoicesResult>(hresult));
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, reason == nullptr);
+    *reason = static_cast<Result_Reason>(Microsoft::CognitiveServices::Speech::ResultReason::VoicesListRetrieved);
+    return SPX_NOERROR;
+}
+
+SPXAPI synthesis_voices_result_get_voice_num(SPXRESULTHANDLE hresult, uint32_t* voiceNum)
+{
+    auto result = Get<VoicesResult>(hresult);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, voiceNum == nullptr);
+    *voiceNum = static_cast<uint32_t>(result->m_voices.size());
+    return SPX_NOERROR;
+}
+
+SPXAPI synthesis_voices_result_get_voice_info(SPXRESULTHANDLE hresult, uint32_t index, SPXRESULTHANDLE* hVoiceInfo)
+{
+    return Try([&]() -> SPXHR {
+        auto result = Get<VoicesResult>(hresult);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+        SPX_RETURN_HR_IF(SPXERR_OUT_OF_RANGE, index >= result->m_voices.size());
+        return Store(hVoiceInfo, std::make_shared<VoiceInfo>(*result->m_voices[index]));
+    });
+}
+
+SPXAPI synthesis_voices_result_get_property_bag(SPXRESULTHANDLE hresult, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto result = Get<VoicesResult>(hresult);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+        return GetPropertyBag(result->m_properties, hpropbag);
+    });
+}
+
+SPXAPI voice_info_handle_release(SPXRESULTHANDLE hVoiceInfo)
+{
+    return Release<VoiceInfo>(hVoiceInfo);
+}
+
+#define LOOPBACK_VOICE_INFO_STRING(api, field) \
+    SPXAPI__(const char*) api(SPXRESULTHANDLE hVoiceInfo) \
+    { \
+        auto info = Get<VoiceInfo>(hVoiceInfo); \
+        return info != nullptr ? NewString(info->m_voice.field, strlen(info->m_voice.field)) : nullptr; \
+    }
+
+LOOPBACK_VOICE_INFO_STRING(voice_info_get_name, Name)
+LOOPBACK_VOICE_INFO_STRING(voice_info_get_locale, Locale)
+LOOPBACK_VOICE_INFO_STRING(voice_info_get_short_name, ShortName)
+LOOPBACK_VOICE_INFO_STRING(voice_info_get_local_name, LocalName)
+LOOPBACK_VOICE_INFO_STRING(voice_info_get_style_list, StyleList)
+
+#undef LOOPBACK_VOICE_INFO_STRING
+
+SPXAPI__(const char*) voice_info_get_voice_path(SPXRESULTHANDLE hVoiceInfo)
+{
+    return IsValid<VoiceInfo>(hVoiceInfo) ? NewString(std::string()) : nullptr;
+}
+
+SPXAPI voice_info_get_voice_type(SPXRESULTHANDLE hVoiceInfo, Synthesis_VoiceType* voiceType)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<VoiceInfo>(hVoiceInfo));
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, voiceType == nullptr);
+    *voiceType = SynthesisVoiceType_OnlineNeural;
+    return SPX_NOERROR;
+}
+
+SPXAPI voice_info_get_property_bag(SPXRESULTHANDLE hVoiceInfo, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto info = Get<VoiceInfo>(hVoiceInfo);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, info == nullptr);
+        return GetPropertyBag(info->m_properties, hpropbag);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Audio data stream
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI_(bool) audio_data_stream_is_handle_valid(SPXAUDIOSTREAMHANDLE haudioStream)
+{
+    return IsValid<AudioDataStream>(haudioStream);
+}
+
+SPXAPI audio_data_stream_create_from_result(SPXAUDIOSTREAMHANDLE* haudioStream, SPXRESULTHANDLE hresult)
+{
+    return Try([&]() -> SPXHR {
+        auto result = Get<SynthesisResult>(hresult);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, result == nullptr);
+        auto stream = std::make_shared<AudioDataStream>();
+        stream->m_audio = result->m_audio;
+        return Store(haudioStream, stream);
+    });
+}
+
+SPXAPI audio_data_stream_get_status(SPXAUDIOSTREAMHANDLE haudioStream, Stream_Status* status)
+{
+    auto stream = Get<AudioDataStream>(haudioStream);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, status == nullptr);
+    *status = stream->m_audio->IsCanceled() ? StreamStatus_Canceled :
+        stream->m_audio->IsComplete() ? StreamStatus_AllData :
+        stream->m_audio->Size() > 0 ? StreamStatus_PartialData : StreamStatus_NoData;
+    return SPX_NOERROR;
+}
+
+SPXAPI audio_data_stream_get_reason_canceled(SPXAUDIOSTREAMHANDLE haudioStream, Result_CancellationReason* reason)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<AudioDataStream>(haudioStream));
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, reason == nullptr);
+    *reason = CancellationReason_UserCancelled;
+    return SPX_NOERROR;
+}
+
+SPXAPI audio_data_stream_get_canceled_error_code(SPXAUDIOSTREAMHANDLE haudioStream, Result_CancellationErrorCode* errorCode)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, !IsValid<AudioDataStream>(haudioStream));
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, errorCode == nullptr);
+    *errorCode = CancellationErrorCode_NoError;
+    return SPX_NOERROR;
+}
+
+SPXAPI_(bool) audio_data_stream_can_read_data(SPXAUDIOSTREAMHANDLE haudioStream, uint32_t requestedSize)
+{
+    auto stream = Get<AudioDataStream>(haudioStream);
+    return stream != nullptr && stream->m_audio->Size() >= size_t(stream->m_position) + requestedSize;
+}
+
+SPXAPI_(bool) audio_data_stream_can_read_data_from_position(SPXAUDIOSTREAMHANDLE haudioStream, uint32_t requestedSize, uint32_t position)
+{
+    auto stream = Get<AudioDataStream>(haudioStream);
+    return stream != nullptr && stream->m_audio->Size() >= size_t(position) + requestedSize;
+}
+
+SPXAPI audio_data_stream_read(SPXAUDIOSTREAMHANDLE haudioStream, uint8_t* buffer, uint32_t bufferSize, uint32_t* pfilledSize)
+{
+    auto stream = Get<AudioDataStream>(haudioStream);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, pfilledSize == nullptr || (buffer == nullptr && bufferSize > 0));
+    *pfilledSize = stream->m_audio->Read(buffer, bufferSize, stream->m_position, true);
+    stream->m_position += *pfilledSize;
+    return SPX_NOERROR;
+}
+
+SPXAPI audio_data_stream_read_from_position(SPXAUDIOSTREAMHANDLE haudioStream, uint8_t* buffer, uint32_t bufferSize, uint32_t position, uint32_t* pfilledSize)
+{
+    auto stream = Get<AudioDataStream>(haudioStream);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, pfilledSize == nullptr || (buffer == nullptr && bufferSize > 0));
+    *pfilledSize = stream->m_audio->Read(buffer, bufferSize, position, true);
+    stream->m_position = position + *pfilledSize;
+    return SPX_NOERROR;
+}
+
+SPXAPI audio_data_stream_save_to_wave_file(SPXAUDIOSTREAMHANDLE haudioStream, const char* fileName)
+{
+    return Try([&]() -> SPXHR {
+        auto stream = Get<AudioDataStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, fileName == nullptr);
+
+        auto data = stream->m_audio->Snapshot(true);
+        auto file = fopen(fileName, "wb");
+        SPX_RETURN_HR_IF(SPXERR_FILE_OPEN_FAILED, file == nullptr);
+
+        auto put32 = [file](uint32_t value) { uint8_t bytes[4] = { uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24) }; fwrite(bytes, 1, 4, file); };
+        auto put16 = [file](uint16_t value) { uint8_t bytes[2] = { uint8_t(value), uint8_t(value >> 8) }; fwrite(bytes, 1, 2, file); };
+        auto size = static_cast<uint32_t>(data.size());
+
+        fwrite("RIFF", 1, 4, file);
+        put32(36 + size);
+        fwrite("WAVEfmt ", 1, 8, file);
+        put32(16);
+        put16(1);
+        put16(1);
+        put32(SamplesPerSecond);
+        put32(SamplesPerSecond * 2);
+        put16(2);
+        put16(16);
+        fwrite("data", 1, 4, file);
+        put32(size);
+        auto written = fwrite(data.data(), 1, data.size(), file);
+        auto closed = fclose(file) == 0;
+        return written == data.size() && closed ? SPX_NOERROR : SPXERR_RUNTIME_ERROR;
+    });
+}
+
+SPXAPI audio_data_stream_get_position(SPXAUDIOSTREAMHANDLE haudioStream, uint32_t* position)
+{
+    auto stream = Get<AudioDataStream>(haudioStream);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, position == nullptr);
+    *position = stream->m_position;
+    return SPX_NOERROR;
+}
+
+SPXAPI audio_data_stream_set_position(SPXAUDIOSTREAMHANDLE haudioStream, uint32_t position)
+{
+    auto stream = Get<AudioDataStream>(haudioStream);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+    stream->m_position = position;
+    return SPX_NOERROR;
+}
+
+SPXAPI audio_data_stream_detach_input(SPXAUDIOSTREAMHANDLE audioStreamHandle)
+{
+    return IsValid<AudioDataStream>(audioStreamHandle) ? SPX_NOERROR : SPXERR_INVALID_HANDLE;
+}
+
+SPXAPI audio_data_stream_get_property_bag(SPXAUDIOSTREAMHANDLE haudioStream, SPXPROPERTYBAGHANDLE* hpropbag)
+{
+    return Try([&]() -> SPXHR {
+        auto stream = Get<AudioDataStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        return GetPropertyBag(stream->m_properties, hpropbag);
+    });
+}
+
+SPXAPI audio_data_stream_release(SPXAUDIOSTREAMHANDLE haudioStream)
+{
+    return Release<AudioDataStream>(haudioStream);
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// JSON
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI__(const char*) ai_core_string_create(const char* str, size_t size)
+{
+    return str != nullptr ? NewString(str, size) : nullptr;
+}
+
+SPXAPI_(void) ai_core_string_free(const char* str)
+{
+    delete[] str;
+}
+
+SPXAPI_(int) ai_core_json_parser_create(SPXHANDLE* parser, const char* json, size_t jsize)
+{
+    if (parser == nullptr)
+    {
+        return -1;
+    }
+
+    *parser = SPXHANDLE_INVALID;
+    try
+    {
+        auto object = std::make_shared<JsonParser>();
+        if (json == nullptr || !object->Parse(json, jsize))
+        {
+            return -1;
+        }
+        *parser = Add(object);
+        return 0;
+    }
+    catch (...)
+    {
+        return -1;
+    }
+}
+
+SPXAPI_(bool) ai_core_json_parser_handle_is_valid(SPXHANDLE parser)
+{
+    return IsValid<JsonParser>(parser);
+}
+
+SPXAPI ai_core_json_parser_handle_release(SPXHANDLE parser)
+{
+    return Release<JsonParser>(parser);
+}
+
+SPXAPI_(int) ai_core_json_item_count(SPXHANDLE parserOrBuilder, int item)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    return value != nullptr ? value->Count : 0;
+}
+
+SPXAPI_(int) ai_core_json_item_at(SPXHANDLE parserOrBuilder, int item, int index, const char* find)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    return parser != nullptr ? parser->Child(item, index, find) : -1;
+}
+
+SPXAPI_(int) ai_core_json_item_next(SPXHANDLE parserOrBuilder, int item)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    return value != nullptr ? value->Next : -1;
+}
+
+SPXAPI_(int) ai_core_json_item_name(SPXHANDLE parserOrBuilder, int item)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    return value != nullptr ? value->Name : -1;
+}
+
+SPXAPI_(int) ai_core_json_value_kind(SPXHANDLE parserOrBuilder, int item)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    return value != nullptr ? value->Kind : 0;
+}
+
+SPXAPI_(bool) ai_core_json_value_as_bool(SPXHANDLE parserOrBuilder, int item, bool defaultValue)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    return value != nullptr && value->Kind == 't' ? true : value != nullptr && value->Kind == 'f' ? false : defaultValue;
+}
+
+SPXAPI_(double) ai_core_json_value_as_double(SPXHANDLE parserOrBuilder, int item, double defaultValue)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto text = NumberText(parser != nullptr ? parser->At(item) : nullptr);
+    return text.empty() ? defaultValue : strtod(text.c_str(), nullptr);
+}
+
+SPXAPI_(int64_t) ai_core_json_value_as_int(SPXHANDLE parserOrBuilder, int item, int64_t defaultValue)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto text = NumberText(parser != nullptr ? parser->At(item) : nullptr);
+    return text.empty() ? defaultValue : static_cast<int64_t>(strtoll(text.c_str(), nullptr, 10));
+}
+
+SPXAPI_(uint64_t) ai_core_json_value_as_uint(SPXHANDLE parserOrBuilder, int item, uint64_t defaultValue)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto text = NumberText(parser != nullptr ? parser->At(item) : nullptr);
+    return text.empty() ? defaultValue : static_cast<uint64_t>(strtoull(text.c_str(), nullptr, 10));
+}
+
+SPXAPI__(const char*) ai_core_json_value_as_string_ptr(SPXHANDLE parserOrBuilder, int item, size_t* size)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    if (value == nullptr || value->Kind != '"')
+    {
+        return nullptr;
+    }
+    if (size != nullptr)
+    {
+        *size = value->Size;
+    }
+    return value->Data;
+}
+
+SPXAPI__(const char*) ai_core_json_value_as_string_copy(SPXHANDLE parserOrBuilder, int item, const char* defaultValue)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    try
+    {
+        if (value != nullptr && value->Kind == '"')
+        {
+            return NewString(parser->Decode(*value));
+        }
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+    return defaultValue != nullptr ? NewString(defaultValue, strlen(defaultValue)) : nullptr;
+}
+
+SPXAPI__(const char*) ai_core_json_value_as_json_copy(SPXHANDLE parserOrBuilder, int item)
+{
+    auto parser = Get<JsonParser>(parserOrBuilder);
+    auto value = parser != nullptr ? parser->At(item) : nullptr;
+    if (value == nullptr)
+    {
+        return nullptr;
+    }
+    // Strings are stored without their quotes.
+    return value->Kind == '"' ? NewString(value->Data - 1, value->Size + 2) : NewString(value->Data, value->Size);
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Platform
+// ---------------------------------------------------------------------------------------------------------------
+
+// UTF-8 to and from wchar_t, which holds UTF-32 on Linux and UTF-16 where it is 16 bits wide. Both functions return
+// the size of the converted string including its terminator, and convert only when given a destination.
+
+SPXAPI_(size_t) pal_wstring_to_string(char* dst, const wchar_t* src, size_t dstSize)
+{
+    std::string converted;
+    for (size_t i = 0; src != nullptr && src[i] != L'\0'; i++)
+    {
+        auto codePoint = static_cast<uint32_t>(src[i]);
+        if (sizeof(wchar_t) == 2 && codePoint >= 0xD800 && codePoint < 0xDC00 && src[i + 1] >= 0xDC00 && src[i + 1] < 0xE000)
+        {
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (static_cast<uint32_t>(src[++i]) - 0xDC00);
+        }
+
+        if (codePoint < 0x80)
+        {
+            converted += char(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            converted += char(0xC0 | (codePoint >> 6));
+            converted += char(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            converted += char(0xE0 | (codePoint >> 12));
+            converted += char(0x80 | ((codePoint >> 6) & 0x3F));
+            converted += char(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            converted += char(0xF0 | (codePoint >> 18));
+            converted += char(0x80 | ((codePoint >> 12) & 0x3F));
+            converted += char(0x80 | ((codePoint >> 6) & 0x3F));
+            converted += char(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    if (dst != nullptr && dstSize > 0)
+    {
+        auto size = std::min(converted.size(), dstSize - 1);
+        memcpy(dst, converted.data(), size);
+        dst[size] = '\0';
+    }
+    return converted.size() + 1;
+}
+
+SPXAPI_(size_t) pal_string_to_wstring(wchar_t* dst, const char* src, size_t dstSize)
+{
+    std::wstring converted;
+    for (size_t i = 0; src != nullptr && src[i] != '\0';)
+    {
+        auto lead = static_cast<uint8_t>(src[i]);
+        auto length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        uint32_t codePoint = length == 1 ? lead : length == 2 ? lead & 0x1F : length == 3 ? lead & 0x0F : lead & 0x07;
+        for (int k = 1; k < length; k++)
+        {
+            auto next = static_cast<uint8_t>(src[i + k]);
+            if ((next & 0xC0) != 0x80)
+            {
+                length = 0;
+                break;
+            }
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+
+        if (length == 0)
+        {
+            converted += wchar_t(0xFFFD);
+            i++;
+            continue;
+        }
+
+        if (sizeof(wchar_t) == 2 && codePoint >= 0x10000)
+        {
+            converted += wchar_t(0xD800 + ((codePoint - 0x10000) >> 10));
+            converted += wchar_t(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+        }
+        else
+        {
+            converted += wchar_t(codePoint);
+        }
+        i += length;
+    }
+
+    if (dst != nullptr && dstSize > 0)
+    {
+        auto size = std::min(converted.size(), dstSize - 1);
+        std::copy(converted.begin(), converted.begin() + size, dst);
+        dst[size] = L'\0';
+    }
+    return converted.size() + 1;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Diagnostics
+// ---------------------------------------------------------------------------------------------------------------
+
+// The loopback logs nothing itself; loopback_log_line passes lines to the callback as the SDK would.
+std::atomic<DIAGNOSTICS_CALLBACK_FUNC> g_logCallback { nullptr };
+
+AZAC_API diagnostics_logmessage_set_callback(DIAGNOSTICS_CALLBACK_FUNC callback)
+{
+    g_logCallback.store(callback);
+    return SPX_NOERROR;
+}
+
+AZAC_API diagnostics_logmessage_set_filters(const char* filters)
+{
+    UNUSED(filters);
+    return SPX_NOERROR;
+}
+
+AZAC_API_(void) diagnostics_set_log_level(const char* logger, const char* level)
+{
+    UNUSED(logger);
+    UNUSED(level);
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Loopback hooks
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI loopback_synthesizing_event_create(SPXEVENTHANDLE* phevent, uint32_t audioSize)
+{
+    return Try([&]() -> SPXHR {
+        std::vector<uint8_t> chunk;
+        MakeTone(chunk, 0, audioSize & ~1u);
+
+        auto result = std::make_shared<SynthesisResult>();
+        result->m_id = NewId("");
+        result->m_audio->Append(chunk.data(), chunk.size());
+        result->m_audio->Complete(false);
+
+        auto event = std::make_shared<SynthesisEvent>();
+        event->m_result = result;
+        event->m_resultId = result->m_id;
+        return Store(phevent, event);
+    });
+}
+
+SPXAPI loopback_connection_message_event_create(SPXEVENTHANDLE* phevent, const char* path, const uint8_t* data, uint32_t size, bool binary)
+{
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, path == nullptr || (data == nullptr && size > 0));
+        std::string payload(reinterpret_cast<const char*>(data), size);
+        return Store(phevent, MakeMessageEvent(path, std::move(payload), binary));
+    });
+}
+
+SPXAPI loopback_pull_audio_output_stream_write(SPXAUDIOSTREAMHANDLE haudioStream, const uint8_t* data, uint32_t size)
+{
+    return Try([&]() -> SPXHR {
+        SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, data == nullptr && size > 0);
+        auto stream = Get<PullAudioOutputStream>(haudioStream);
+        SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+        stream->Write(data, size);
+        return SPX_NOERROR;
+    });
+}
+
+SPXAPI loopback_pull_audio_output_stream_close(SPXAUDIOSTREAMHANDLE haudioStream)
+{
+    auto stream = Get<PullAudioOutputStream>(haudioStream);
+    SPX_RETURN_HR_IF(SPXERR_INVALID_HANDLE, stream == nullptr);
+    stream->Close();
+    return SPX_NOERROR;
+}
+
+SPXAPI loopback_recognition_fail(uint32_t count)
+{
+    g_pendingFailures += count;
+    return SPX_NOERROR;
+}
+
+SPXAPI loopback_log_line(const char* line)
+{
+    SPX_RETURN_HR_IF(SPXERR_INVALID_ARG, line == nullptr);
+    if (auto callback = g_logCallback.load())
+    {
+        callback(line);
+    }
+    return SPX_NOERROR;
+}
@@ -0,0 +1,23 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_loopback.h: Hooks of the loopback C API that are not part of the speech C API.
+//
+// They create the event handles the C++ layer normally only receives in callbacks, so benchmarks can construct event
+// arguments in a loop without running a recognizer or a synthesizer. They also feed pull audio output streams, which
+// no loopback synthesizer writes to, pass log lines to the diagnostics callback, and fail running recognitions.
+//
+
+#pragma once
+#include "speechapi_c_common.h"
+
+SPXAPI loopback_synthesizing_event_create(SPXEVENTHANDLE* phevent, uint32_t audioSize);
+SPXAPI loopback_connection_message_event_create(SPXEVENTHANDLE* phevent, const char* path, const uint8_t* data, uint32_t size, bool binary);
+SPXAPI loopback_pull_audio_output_stream_write(SPXAUDIOSTREAMHANDLE haudioStream, const uint8_t* data, uint32_t size);
+SPXAPI loopback_pull_audio_output_stream_close(SPXAUDIOSTREAMHANDLE haudioStream);
+SPXAPI loopback_log_line(const char* line);
+
+// Cancels the next count continuous recognitions to finish a phrase with CancellationErrorCode_ConnectionFailure,
+// as a dropped connection would, whichever recognizers they belong to.
+SPXAPI loopback_recognition_fail(uint32_t count);
@@ -0,0 +1,272 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_loopback_unsupported.cpp: Entry points the loopback does not simulate.
+//
+// These are referenced by the inline C++ headers but need a service feature the loopback has no model for. They fail
+// with SPXERR_NOT_IMPL, which the C++ layer surfaces as an exception, so a load test that strays into them stops
+// loudly instead of measuring nothing.
+//
+
+#include "speechapi_c.h"
+
+// ---------------------------------------------------------------------------------------------------------------
+// Conversations and meetings
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI conversation_create_from_config(SPXCONVERSATIONHANDLE*, SPXSPEECHCONFIGHANDLE, const char*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_get_property_bag(SPXCONVERSATIONHANDLE, SPXPROPERTYBAGHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_release_handle(SPXHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_translator_participant_get_avatar(SPXEVENTHANDLE, char*, uint32_t*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_translator_participant_get_displayname(SPXEVENTHANDLE, char*, uint32_t*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_translator_participant_get_id(SPXEVENTHANDLE, char*, uint32_t*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_translator_participant_get_is_host(SPXEVENTHANDLE, bool*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_translator_participant_get_is_muted(SPXEVENTHANDLE, bool*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_translator_participant_get_is_using_tts(SPXEVENTHANDLE, bool*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_update_participant(SPXCONVERSATIONHANDLE, bool, SPXPARTICIPANTHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_update_participant_by_user(SPXCONVERSATIONHANDLE, bool, SPXUSERHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI conversation_update_participant_by_user_id(SPXCONVERSATIONHANDLE, bool, const char*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI meeting_create_from_config(SPXMEETINGHANDLE*, SPXSPEECHCONFIGHANDLE, const char*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI meeting_get_property_bag(SPXMEETINGHANDLE, SPXPROPERTYBAGHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI meeting_release_handle(SPXHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI meeting_update_participant(SPXMEETINGHANDLE, bool, SPXPARTICIPANTHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI meeting_update_participant_by_user(SPXMEETINGHANDLE, bool, SPXUSERHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI meeting_update_participant_by_user_id(SPXMEETINGHANDLE, bool, const char*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI participant_create_handle(SPXPARTICIPANTHANDLE*, const char*, const char*, const char*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI participant_get_property_bag(SPXPARTICIPANTHANDLE, SPXPROPERTYBAGHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI participant_release_handle(SPXPARTICIPANTHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_join_meeting(SPXMEETINGHANDLE, SPXRECOHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_leave_meeting(SPXRECOHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Dialog service connector
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI dialog_service_connector_connect(SPXRECOHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI dialog_service_connector_disconnect(SPXRECOHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI dialog_service_connector_listen_once(SPXRECOHANDLE, SPXRESULTHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI dialog_service_connector_send_activity(SPXRECOHANDLE, const char*, char*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI dialog_service_connector_start_keyword_recognition(SPXRECOHANDLE, SPXKEYWORDHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI dialog_service_connector_stop_keyword_recognition(SPXRECOHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI dialog_service_connector_stop_listening_async(SPXRECOHANDLE, SPXASYNCHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Intent and keyword recognition
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI intent_recognizer_recognize_text_once(SPXRECOHANDLE, const char*, SPXRESULTHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI intent_result_get_intent_id(SPXRESULTHANDLE, char*, uint32_t)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_recognize_keyword_once(SPXRECOHANDLE, SPXKEYWORDHANDLE, SPXRESULTHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_start_keyword_recognition_async(SPXRECOHANDLE, SPXKEYWORDHANDLE, SPXASYNCHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_start_keyword_recognition_async_wait_for(SPXASYNCHANDLE, uint32_t)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_stop_keyword_recognition(SPXRECOHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_stop_keyword_recognition_async(SPXRECOHANDLE, SPXASYNCHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI recognizer_stop_keyword_recognition_async_wait_for(SPXASYNCHANDLE, uint32_t)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Speaker recognition
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI create_voice_profile(SPXVOICEPROFILECLIENTHANDLE, int, const char*, SPXVOICEPROFILEHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI create_voice_profile_from_id_and_type(SPXVOICEPROFILEHANDLE*, const char*, int)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI delete_voice_profile(SPXVOICEPROFILECLIENTHANDLE, SPXVOICEPROFILEHANDLE, SPXRESULTHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI enroll_voice_profile(SPXVOICEPROFILECLIENTHANDLE, SPXVOICEPROFILEHANDLE, SPXAUDIOCONFIGHANDLE, SPXRESULTHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI get_activation_phrases(SPXVOICEPROFILECLIENTHANDLE, const char*, int, SPXRESULTHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI get_profiles_json(SPXVOICEPROFILECLIENTHANDLE, int, char**, size_t*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI reset_voice_profile(SPXVOICEPROFILECLIENTHANDLE, SPXVOICEPROFILEHANDLE, SPXRESULTHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI retrieve_enrollment_result(SPXVOICEPROFILECLIENTHANDLE, const char*, int, SPXVOICEPROFILEHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+SPXAPI voice_profile_release_handle(SPXVOICEPROFILEHANDLE)
+{
+    return SPXERR_NOT_IMPL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Synthesis requests
+// ---------------------------------------------------------------------------------------------------------------
+
+SPXAPI synthesizer_speak_request_async(SPXSYNTHHANDLE, SPXREQUESTHANDLE, SPXASYNCHANDLE*)
+{
+    return SPXERR_NOT_IMPL;
+}